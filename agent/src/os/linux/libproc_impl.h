@@ -89,6 +89,8 @@ struct core_data {
    // part of the class sharing workaround
    map_info*          class_share_maps;// class share maps in a linked list
    map_info**         map_array; // sorted (by vaddr) array of map_info pointers
+   map_info*          last_map;  // map found by the last lookup
+   struct file_cache* file_cache; // mmapped or cached files, see core_read_data
 };
 
 struct ps_prochandle {
@@ -30,9 +30,15 @@
 #include <stddef.h>
 #include <elf.h>
 #include <link.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "libproc_impl.h"
 #include "salibelf.h"
 
+#ifndef MIN
+#define MIN(x, y) (((x) < (y))? (x): (y))
+#endif
+
 // This file has the libproc implementation to read core files.
 // For live processes, refer to ps_proc.c. Portions of this is adapted
 // /modelled after Solaris libproc.so (in particular Pcore.c)
@@ -93,9 +99,164 @@ static void destroy_map_info(struct ps_prochandle* ph) {
   }
 }
 
+//----------------------------------------------------------------------
+// reading the core, executable and shared library files
+//
+// SA does many small reads from the debuggee's address space. Instead of
+// a pread for each of them, every file is mmapped read-only when it is
+// first read from. If mmap fails, e.g. for a large core file and a 32-bit
+// debugger, the reads go through a small direct-mapped page cache.
+
+#define CACHE_PAGE_SIZE  4096
+#define CACHE_PAGES      4096
+
+typedef struct mapped_file {
+   int                 fd;
+   char*               base;     // NULL if the file could not be mmapped
+   size_t              size;
+   struct mapped_file* next;
+} mapped_file;
+
+typedef struct cached_page {
+   int                 fd;       // -1 if the page is not in use
+   off_t               offset;   // file offset of the page
+   size_t              len;      // valid bytes, short at the end of the file
+   char                data[CACHE_PAGE_SIZE];
+} cached_page;
+
+struct file_cache {
+   mapped_file*        files;
+   mapped_file*        last;     // file read from last
+   cached_page*        pages;    // allocated on the first cached read
+};
+
+static void destroy_file_cache(struct ps_prochandle* ph) {
+  struct file_cache* fc = ph->core->file_cache;
+  mapped_file* mf;
+  if (fc == NULL) {
+    return;
+  }
+  mf = fc->files;
+  while (mf) {
+    mapped_file* next = mf->next;
+    if (mf->base != NULL) {
+      munmap(mf->base, mf->size);
+    }
+    free(mf);
+    mf = next;
+  }
+  free(fc->pages);
+  free(fc);
+  ph->core->file_cache = NULL;
+}
+
+static mapped_file* lookup_mapped_file(struct ps_prochandle* ph, int fd) {
+  struct file_cache* fc = ph->core->file_cache;
+  mapped_file* mf;
+  struct stat st;
+
+  if (fc == NULL) {
+    if ((fc = (struct file_cache*) calloc(1, sizeof(struct file_cache))) == NULL) {
+      return NULL;
+    }
+    ph->core->file_cache = fc;
+  }
+
+  if (fc->last != NULL && fc->last->fd == fd) {
+    return fc->last;
+  }
+  for (mf = fc->files; mf != NULL; mf = mf->next) {
+    if (mf->fd == fd) {
+      fc->last = mf;
+      return mf;
+    }
+  }
+
+  if ((mf = (mapped_file*) calloc(1, sizeof(mapped_file))) == NULL) {
+    return NULL;
+  }
+  mf->fd = fd;
+  if (fstat(fd, &st) == 0 && st.st_size > 0 &&
+      (uint64_t) st.st_size <= (uint64_t) (size_t) -1) {
+    void* base = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base != MAP_FAILED) {
+      mf->base = (char*) base;
+      mf->size = (size_t) st.st_size;
+    } else {
+      print_debug("can't mmap file (fd %d), falling back to cached reads\n", fd);
+    }
+  }
+  mf->next = fc->files;
+  fc->files = mf;
+  fc->last = mf;
+  return mf;
+}
+
+// read through the page cache, returns the number of bytes read,
+// 0 at the end of the file or -1 on error.
+static ssize_t cached_pread(struct file_cache* fc, int fd, char* buf, size_t len, off_t off) {
+  size_t done = 0;
+
+  if (fc->pages == NULL) {
+    int i;
+    if ((fc->pages = (cached_page*) malloc(sizeof(cached_page) * CACHE_PAGES)) == NULL) {
+      return pread(fd, buf, len, off);
+    }
+    for (i = 0; i < CACHE_PAGES; i++) {
+      fc->pages[i].fd = -1;
+    }
+  }
+
+  while (done < len) {
+    off_t page_off = off & ~((off_t) CACHE_PAGE_SIZE - 1);
+    size_t index = (size_t) ((page_off / CACHE_PAGE_SIZE) ^ ((off_t) fd * 31)) % CACHE_PAGES;
+    cached_page* page = &fc->pages[index];
+    size_t in_page = (size_t) (off - page_off);
+    size_t n;
+
+    if (page->fd != fd || page->offset != page_off) {
+      ssize_t r = pread(fd, page->data, CACHE_PAGE_SIZE, page_off);
+      if (r <= 0) {
+        page->fd = -1;
+        return done > 0 ? (ssize_t) done : r;
+      }
+      page->fd = fd;
+      page->offset = page_off;
+      page->len = (size_t) r;
+    }
+
+    if (in_page >= page->len) {
+      break;  // end of file
+    }
+    n = MIN(len - done, page->len - in_page);
+    memcpy(buf + done, page->data + in_page, n);
+    done += n;
+    off += n;
+  }
+  return (ssize_t) done;
+}
+
+// pread replacement for the core, executable and library files
+static ssize_t core_file_read(struct ps_prochandle* ph, int fd, char* buf, size_t len, off_t off) {
+  mapped_file* mf = lookup_mapped_file(ph, fd);
+  if (mf == NULL) {
+    return pread(fd, buf, len, off);
+  }
+  if (mf->base == NULL) {
+    return cached_pread(ph->core->file_cache, fd, buf, len, off);
+  }
+  if (off < 0 || (size_t) off >= mf->size) {
+    return 0;
+  }
+  len = MIN(len, mf->size - (size_t) off);
+  memcpy(buf, mf->base + off, len);
+  return (ssize_t) len;
+}
+
 // ps_prochandle operations
 static void core_release(struct ps_prochandle* ph) {
   if (ph->core) {
+    destroy_file_cache(ph);
     close_files(ph);
     destroy_map_info(ph);
     free(ph->core);
@@ -153,6 +314,12 @@ static map_info* core_lookup(struct ps_prochandle *ph, uintptr_t addr) {
   int mid, lo = 0, hi = ph->core->num_maps - 1;
   map_info *mp;
 
+  // consecutive reads usually hit the same mapping
+  mp = ph->core->last_map;
+  if (mp != NULL && addr >= mp->vaddr && addr < mp->vaddr + mp->memsz) {
+    return (mp);
+  }
+
   while (hi - lo > 1) {
     mid = (lo + hi) / 2;
     if (addr >= ph->core->map_array[mid]->vaddr) {
@@ -169,6 +336,7 @@ static map_info* core_lookup(struct ps_prochandle *ph, uintptr_t addr) {
   }
 
   if (addr >= mp->vaddr && addr < mp->vaddr + mp->memsz) {
+    ph->core->last_map = mp;
     return (mp);
   }
 
@@ -441,6 +609,7 @@ static bool sort_map_array(struct ps_prochandle* ph) {
   }
 
   ph->core->map_array = array;
+  ph->core->last_map = NULL;
   // sort the map_info array by base virtual address.
   qsort(ph->core->map_array, ph->core->num_maps, sizeof (map_info*),
         core_cmp_mapping);
@@ -458,13 +627,12 @@ static bool sort_map_array(struct ps_prochandle* ph) {
   return true;
 }
 
-#ifndef MIN
-#define MIN(x, y) (((x) < (y))? (x): (y))
-#endif
-
 static bool core_read_data(struct ps_prochandle* ph, uintptr_t addr, char *buf, size_t size) {
+   static int page_size = 0;
    ssize_t resid = size;
-   int page_size=sysconf(_SC_PAGE_SIZE);
+   if (page_size == 0) {
+      page_size = sysconf(_SC_PAGE_SIZE);
+   }
    while (resid != 0) {
       map_info *mp = core_lookup(ph, addr);
       uintptr_t mapoff;
@@ -481,7 +649,7 @@ static bool core_read_data(struct ps_prochandle* ph, uintptr_t addr, char *buf,
       len = MIN(resid, mp->memsz - mapoff);
       off = mp->offset + mapoff;
 
-      if ((len = pread(fd, buf, len, off)) <= 0) {
+      if ((len = core_file_read(ph, fd, buf, len, off)) <= 0) {
          break;
       }
 
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+// Benchmark for the SA core file reader (ps_core.c).
+//
+// usage: corebench <exec file> <core file> [reads]
+//
+// Walks all PT_LOAD segments of the core page by page and then does random
+// word sized reads in them, the access pattern of SA heap walks, and prints
+// the reads per second for both. The checksums of the data read have to be
+// the same for all reader implementations.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <elf.h>
+#include <sys/time.h>
+#include "libproc.h"
+#include "proc_service.h"
+
+#ifdef _LP64
+#define ELF_EHDR Elf64_Ehdr
+#define ELF_PHDR Elf64_Phdr
+#else
+#define ELF_EHDR Elf32_Ehdr
+#define ELF_PHDR Elf32_Phdr
+#endif
+
+typedef struct segment {
+  uintptr_t vaddr;
+  size_t    filesz;
+} segment;
+
+static double now() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+// collect the PT_LOAD segments with file contents from the core
+static int read_segments(const char* core_file, segment** segments) {
+  ELF_EHDR ehdr;
+  ELF_PHDR* phdrs;
+  int fd, i, n = 0;
+
+  if ((fd = open(core_file, O_RDONLY)) < 0 ||
+      pread(fd, &ehdr, sizeof(ehdr), 0) != sizeof(ehdr)) {
+    return -1;
+  }
+  phdrs = (ELF_PHDR*) calloc(ehdr.e_phnum, sizeof(ELF_PHDR));
+  *segments = (segment*) calloc(ehdr.e_phnum, sizeof(segment));
+  if (pread(fd, phdrs, ehdr.e_phnum * sizeof(ELF_PHDR), ehdr.e_phoff) !=
+      (ssize_t) (ehdr.e_phnum * sizeof(ELF_PHDR))) {
+    close(fd);
+    return -1;
+  }
+  for (i = 0; i < ehdr.e_phnum; i++) {
+    if (phdrs[i].p_type == PT_LOAD && phdrs[i].p_filesz > 0) {
+      (*segments)[n].vaddr = phdrs[i].p_vaddr;
+      (*segments)[n].filesz = phdrs[i].p_filesz;
+      n++;
+    }
+  }
+  free(phdrs);
+  close(fd);
+  return n;
+}
+
+int main(int argc, char** argv) {
+  struct ps_prochandle* ph;
+  segment* segments;
+  int num_segments, i;
+  long reads = 10 * 1000 * 1000;
+  long done = 0, failed = 0;
+  size_t total = 0;
+  uintptr_t checksum = 0;
+  uintptr_t word;
+  char page[4096];
+  double start, elapsed;
+
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s <exec file> <core file> [reads]\n", argv[0]);
+    return 1;
+  }
+  if (argc > 3) {
+    reads = atol(argv[3]);
+  }
+
+  init_libproc(getenv("LIBSAPROC_DEBUG") != NULL);
+  if ((ph = Pgrab_core(argv[1], argv[2])) == NULL) {
+    fprintf(stderr, "can't open core file\n");
+    return 1;
+  }
+  if ((num_segments = read_segments(argv[2], &segments)) <= 0) {
+    fprintf(stderr, "can't read core file segments\n");
+    return 1;
+  }
+  for (i = 0; i < num_segments; i++) {
+    total += segments[i].filesz;
+  }
+
+  // sequential walk
+  start = now();
+  for (i = 0; i < num_segments; i++) {
+    size_t off;
+    for (off = 0; off + sizeof(page) <= segments[i].filesz; off += sizeof(page)) {
+      if (ps_pdread(ph, (psaddr_t) (segments[i].vaddr + off), page, sizeof(page)) != PS_OK) {
+        failed++;
+      } else {
+        checksum = checksum * 31 + *(uintptr_t*) (page + (off / sizeof(page)) % (sizeof(page) / sizeof(uintptr_t)) * sizeof(uintptr_t));
+      }
+      done++;
+    }
+  }
+  elapsed = now() - start;
+  printf("sequential: %ld page reads (%ld failed) of %lu MB in %.3f s, %.0f reads/s, checksum %lx\n",
+         done, failed, (unsigned long) (total / (1024 * 1024)), elapsed, done / elapsed,
+         (unsigned long) checksum);
+
+  // random word reads
+  srand(42);
+  done = failed = 0;
+  checksum = 0;
+  start = now();
+  for (; done < reads; done++) {
+    segment* s = &segments[rand() % num_segments];
+    uintptr_t off = ((((uintptr_t) rand()) << 16) ^ (uintptr_t) rand()) % s->filesz;
+    off &= ~(uintptr_t) (sizeof(word) - 1);
+    if (ps_pdread(ph, (psaddr_t) (s->vaddr + off), &word, sizeof(word)) != PS_OK) {
+      failed++;
+    } else {
+      checksum = checksum * 31 + word;
+    }
+  }
+  elapsed = now() - start;
+  printf("random:     %ld word reads (%ld failed) in %.3f s, %.0f reads/s, checksum %lx\n",
+         done, failed, elapsed, done / elapsed, (unsigned long) checksum);
+
+  free(segments);
+  Prelease(ph);
+  return 0;
+}
@@ -0,0 +1,53 @@
+#!/bin/sh
+
+#
+# Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+# DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+#
+# This code is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License version 2 only, as
+# published by the Free Software Foundation.
+#
+# This code is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+# version 2 for more details (a copy is included in the LICENSE file that
+# accompanied this code).
+#
+# You should have received a copy of the GNU General Public License version
+# 2 along with this work; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+# or visit www.oracle.com if you need additional information or have any
+# questions.
+
+# Benchmark for the SA core file reader: dumps the core of a synthetic
+# Java process with gcore and walks it with corebench, see README.
+#
+# usage: corebench.sh [heap size in MB] [random reads]
+
+if [ "x$SA_JAVA" = "x" ]; then
+   SA_JAVA=java
+fi
+
+STARTDIR=`dirname $0`
+MB=${1:-1024}
+READS=${2:-10000000}
+
+tmp=/tmp/corebench.$$
+rm -f $tmp
+$SA_JAVA -Xmx$((MB * 2))m -cp $STARTDIR CoreWorkload $MB > $tmp &
+pid=$!
+while [ ! -s $tmp ] ; do
+  sleep 1
+done
+
+gcore -o /tmp/corebench $pid
+kill -9 $pid
+rm -f $tmp
+
+LD_LIBRARY_PATH=$STARTDIR/../../src/os/linux/amd64:$STARTDIR/../../src/os/linux/i386 \
+  $STARTDIR/corebench `readlink -f \`which $SA_JAVA\`` /tmp/corebench.$pid $READS
+
+rm -f /tmp/corebench.$pid
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.compiler.common.alloc;
+
+import java.util.*;
+
+import com.oracle.graal.compiler.common.cfg.*;
+
+/**
+ * Partitions the blocks of a method into traces, i.e., sequences of blocks that are connected by
+ * control flow edges. Traces are formed in the order of decreasing block
+ * {@linkplain AbstractBlockBase#probability() probability}: starting at the most frequently
+ * executed block that is not yet part of a trace, a trace is extended with the most likely
+ * successor that is not yet part of a trace. Consequently, the first traces cover the hot paths of
+ * the method.
+ */
+public final class TraceBuilder {
+
+    public static final class TraceBuilderResult<T extends AbstractBlockBase<T>> {
+
+        private final List<List<T>> traces;
+        private final int[] blockToTrace;
+
+        private TraceBuilderResult(List<List<T>> traces, int[] blockToTrace) {
+            this.traces = traces;
+            this.blockToTrace = blockToTrace;
+        }
+
+        /**
+         * Gets the traces, sorted by the probability of their first block.
+         */
+        public List<List<T>> getTraces() {
+            return traces;
+        }
+
+        /**
+         * Gets the index in {@link #getTraces()} of the trace containing {@code block}.
+         */
+        public int getTraceForBlock(AbstractBlockBase<?> block) {
+            return blockToTrace[block.getId()];
+        }
+    }
+
+    /**
+     * Computes the traces for {@code blocks}.
+     *
+     * @param blocks all blocks of a method in linear scan order
+     */
+    public static <T extends AbstractBlockBase<T>> TraceBuilderResult<T> computeTraces(List<T> blocks) {
+        int maxId = -1;
+        for (T block : blocks) {
+            maxId = Math.max(maxId, block.getId());
+        }
+        int[] blockToTrace = new int[maxId + 1];
+        Arrays.fill(blockToTrace, -1);
+
+        /*
+         * The sort is stable, so blocks with equal probability remain in linear scan order, e.g.,
+         * loop headers precede the blocks of the loop body.
+         */
+        List<T> worklist = new ArrayList<>(blocks);
+        Collections.sort(worklist, (a, b) -> Double.compare(b.probability(), a.probability()));
+
+        List<List<T>> traces = new ArrayList<>();
+        for (T start : worklist) {
+            if (blockToTrace[start.getId()] == -1) {
+                int traceNumber = traces.size();
+                List<T> trace = new ArrayList<>();
+                for (T block = start; block != null; block = selectNext(block, blockToTrace)) {
+                    blockToTrace[block.getId()] = traceNumber;
+                    trace.add(block);
+                }
+                traces.add(trace);
+            }
+        }
+        assert checkTraces(blocks, traces, blockToTrace);
+        return new TraceBuilderResult<>(traces, blockToTrace);
+    }
+
+    /**
+     * Returns the most likely successor of {@code block} that is not yet part of a trace, or null
+     * if there is no such successor.
+     */
+    private static <T extends AbstractBlockBase<T>> T selectNext(T block, int[] blockToTrace) {
+        T next = null;
+        for (T successor : block.getSuccessors()) {
+            if (successor.getId() < blockToTrace.length && blockToTrace[successor.getId()] == -1 && (next == null || successor.probability() > next.probability())) {
+                next = successor;
+            }
+        }
+        return next;
+    }
+
+    private static <T extends AbstractBlockBase<T>> boolean checkTraces(List<T> blocks, List<List<T>> traces, int[] blockToTrace) {
+        int numBlocks = 0;
+        for (int i = 0; i < traces.size(); i++) {
+            List<T> trace = traces.get(i);
+            for (int j = 0; j < trace.size(); j++) {
+                T block = trace.get(j);
+                assert blockToTrace[block.getId()] == i : "wrong trace for block " + block;
+                assert j == 0 || trace.get(j - 1).getSuccessors().contains(block) : "trace is not connected: " + trace;
+                numBlocks++;
+            }
+        }
+        assert numBlocks == blocks.size() : "blocks missing in traces";
+        return true;
+    }
+}
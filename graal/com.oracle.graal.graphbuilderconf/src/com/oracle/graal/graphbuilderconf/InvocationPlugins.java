@@ -192,6 +192,22 @@ public class InvocationPlugins {
             MethodSubstitutionPlugin plugin = new MethodSubstitutionPlugin(substituteDeclaringClass, name, argumentTypes);
             plugins.register(plugin, declaringClass, name, argumentTypes);
         }
+
+        /**
+         * Registers a plugin that implements an optional method based on the bytecode of a
+         * substitute method.
+         *
+         * @param substituteDeclaringClass the class declaring the substitute method
+         * @param name the name of both the original and substitute method
+         * @param argumentTypes the argument types of the method. Element 0 of this array must be
+         *            the {@link Class} value for {@link InvocationPlugin.Receiver} iff the method
+         *            is non-static. Upon returning, element 0 will have been rewritten to
+         *            {@code declaringClass}
+         */
+        public void registerOptionalMethodSubstitution(Class<?> substituteDeclaringClass, String name, Class<?>... argumentTypes) {
+            MethodSubstitutionPlugin plugin = new MethodSubstitutionPlugin(substituteDeclaringClass, name, argumentTypes);
+            plugins.registerOptional(plugin, declaringClass, name, argumentTypes);
+        }
     }
 
     protected final MethodIdMap<InvocationPlugin> plugins;
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.hotspot.test;
+
+import java.io.*;
+import java.lang.management.*;
+import java.nio.file.*;
+import java.util.*;
+
+import jdk.internal.jvmci.meta.*;
+
+import org.junit.*;
+
+import com.oracle.graal.hotspot.*;
+import com.oracle.graal.replacements.*;
+
+/**
+ * Runs two VMs with the same {@link HotSpotReplacementsImpl.Options#SnippetGraphFile} and checks
+ * that the graphs written by the first VM are loaded and used by the second one, even if VM
+ * addresses differ between the two runs.
+ */
+public class SnippetGraphFileTest {
+
+    private static final String LOADED = "snippet graphs loaded: ";
+    private static final String VALID = "snippet graphs valid: ";
+
+    /**
+     * Entry point of the launched VMs. Prints the number of graphs loaded from the snippet graph
+     * file and the number of them that are valid in this VM.
+     */
+    public static void main(String[] args) {
+        HotSpotReplacementsImpl replacements = (HotSpotReplacementsImpl) HotSpotGraalRuntime.runtime().getHostProviders().getReplacements();
+        SnippetGraphStore store = replacements.getGraphStore();
+        System.out.println(LOADED + store.size());
+        int valid = 0;
+        for (ResolvedJavaMethod method : replacements.getAllReplacements()) {
+            if (store.lookup(method) != null) {
+                valid++;
+            }
+        }
+        System.out.println(VALID + valid);
+    }
+
+    @Test
+    public void testSecondRunLoadsGraphs() throws IOException, InterruptedException {
+        Path file = Files.createTempFile(getClass().getSimpleName(), ".bin");
+        try {
+            Files.delete(file);
+            run(file, "-G:+BootstrapReplacements");
+            Assert.assertTrue("snippet graph file not written", Files.exists(file));
+
+            Map<String, Integer> counts = run(file);
+            Assert.assertTrue(counts.toString(), counts.get(LOADED) > 0);
+            Assert.assertTrue(counts.toString(), counts.get(VALID) > 0);
+        } finally {
+            Files.deleteIfExists(file);
+        }
+    }
+
+    private static Map<String, Integer> run(Path file, String... extraArgs) throws IOException, InterruptedException {
+        List<String> command = new ArrayList<>();
+        command.add(Paths.get(System.getProperty("java.home"), "bin", "java").toString());
+        for (String arg : ManagementFactory.getRuntimeMXBean().getInputArguments()) {
+            // Do not inherit debugger connections or a snippet graph file of this VM
+            if (!arg.startsWith("-agentlib:") && !arg.startsWith("-Xrunjdwp") && !arg.startsWith("-G:SnippetGraphFile=")) {
+                command.add(arg);
+            }
+        }
+        command.add("-G:SnippetGraphFile=" + file);
+        command.addAll(Arrays.asList(extraArgs));
+        command.add("-cp");
+        command.add(System.getProperty("java.class.path"));
+        command.add(SnippetGraphFileTest.class.getName());
+
+        Process process = new ProcessBuilder(command).redirectErrorStream(true).start();
+        Map<String, Integer> counts = new HashMap<>();
+        StringBuilder output = new StringBuilder();
+        try (BufferedReader reader = new BufferedReader(new InputStreamReader(process.getInputStream()))) {
+            String line;
+            while ((line = reader.readLine()) != null) {
+                output.append(line).append('\n');
+                for (String key : new String[]{LOADED, VALID}) {
+                    if (line.startsWith(key)) {
+                        counts.put(key, Integer.parseInt(line.substring(key.length()).trim()));
+                    }
+                }
+            }
+        }
+        Assert.assertEquals(output.toString(), 0, process.waitFor());
+        Assert.assertEquals(output.toString(), 2, counts.size());
+        return counts;
+    }
+}
@@ -419,6 +419,7 @@ public final class HotSpotGraalRuntime implements HotSpotGraalRuntimeProvider, H
     }
 
     void shutdown() {
+        ((HotSpotReplacementsImpl) hostBackend.getProviders().getReplacements()).closeGraphStore();
         if (debugValuesPrinter != null) {
             debugValuesPrinter.printDebugValues();
         }
@@ -87,6 +87,9 @@ public abstract class HotSpotHostBackend extends HotSpotBackend {
                         replacementsProvider.registerReplacements(providers.getMetaAccess(), lowerer, providers.getSnippetReflection(), replacements, providers.getCodeCache().getTarget());
                     }
                 }
+                try (InitTimer st = timer("replacements.openGraphStore")) {
+                    replacements.openGraphStore();
+                }
                 if (BootstrapReplacements.getValue()) {
                     for (ResolvedJavaMethod method : replacements.getAllReplacements()) {
                         replacements.getSubstitution(method, -1);
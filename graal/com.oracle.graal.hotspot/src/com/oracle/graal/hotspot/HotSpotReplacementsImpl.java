@@ -22,14 +22,28 @@
  */
 package com.oracle.graal.hotspot;
 
+import java.io.*;
 import java.lang.reflect.*;
+import java.nio.file.*;
+import java.security.*;
+import java.util.*;
 
 import jdk.internal.jvmci.code.*;
+import jdk.internal.jvmci.common.*;
+import jdk.internal.jvmci.debug.*;
 import jdk.internal.jvmci.hotspot.*;
+import jdk.internal.jvmci.hotspot.HotSpotVMConfig.CompressEncoding;
+import jdk.internal.jvmci.hotspotvmconfig.*;
 import jdk.internal.jvmci.meta.*;
+import jdk.internal.jvmci.options.*;
 
 import com.oracle.graal.api.replacements.*;
+import com.oracle.graal.compiler.common.*;
+import com.oracle.graal.hotspot.meta.*;
+import com.oracle.graal.hotspot.replacements.*;
+import com.oracle.graal.hotspot.stubs.*;
 import com.oracle.graal.hotspot.word.*;
+import com.oracle.graal.nodes.java.*;
 import com.oracle.graal.phases.util.*;
 import com.oracle.graal.replacements.*;
 
@@ -39,6 +53,14 @@ import com.oracle.graal.replacements.*;
  */
 public class HotSpotReplacementsImpl extends ReplacementsImpl {
 
+    public static class Options {
+        // @formatter:off
+        @Option(help = "File in which prepared snippet and substitution graphs are persisted across VM runs. " +
+                       "The file is ignored and rewritten at VM shutdown if it was created for a different VM configuration.", type = OptionType.Debug)
+        public static final OptionValue<String> SnippetGraphFile = new OptionValue<>(null);
+        // @formatter:on
+    }
+
     private final HotSpotVMConfig config;
 
     public HotSpotReplacementsImpl(Providers providers, SnippetReflectionProvider snippetReflection, HotSpotVMConfig config, TargetDescription target) {
@@ -67,4 +89,112 @@ public class HotSpotReplacementsImpl extends ReplacementsImpl {
         }
         return super.registerMethodSubstitution(cr, originalMethod, substituteMethod);
     }
+
+    /**
+     * Opens the {@linkplain Options#SnippetGraphFile snippet graph file} if one is specified so
+     * that snippets and substitutions persisted by a previous VM run do not need to be prepared
+     * again.
+     */
+    public void openGraphStore() {
+        String fileName = Options.SnippetGraphFile.getValue();
+        if (fileName == null) {
+            return;
+        }
+        SnippetObjectCodec codec = new SnippetObjectCodec(providers.getMetaAccess());
+        codec.registerValueClass(CompressEncoding.class);
+        for (Class<?> holder : new Class<?>[]{HotSpotReplacementsUtil.class, HotSpotBackend.class, HotSpotHostBackend.class, HotSpotForeignCallsProviderImpl.class,
+                        HotSpotHostForeignCallsProvider.class, ForeignCallDescriptors.class, StubUtil.class, Log.class, SnippetCounterNode.class}) {
+            codec.registerHolder(holder);
+        }
+        SnippetGraphStore store = new SnippetGraphStore(Paths.get(fileName), target.arch, codec, computeFingerprint());
+        int loaded = store.load();
+        Debug.metric("SnippetGraphStore[loaded]").add(loaded);
+        setGraphStore(store);
+    }
+
+    /**
+     * Writes the graphs prepared during this VM run to the snippet graph file.
+     */
+    public void closeGraphStore() {
+        SnippetGraphStore store = getGraphStore();
+        if (store != null) {
+            try {
+                store.write();
+            } catch (IOException e) {
+                TTY.println("Warning: could not write snippet graph file %s: %s", store.getFile(), e);
+            }
+        }
+    }
+
+    /**
+     * Computes a hash of the values that are stable across VM runs and can influence the
+     * preparation of snippet graphs: the {@link HotSpotVMConfig} values other than addresses, the
+     * option values and the compiler build. Addresses change between runs, for example with address
+     * space layout randomization. The addresses folded into a graph are checked by the
+     * {@link SnippetGraphStore} when the graph is loaded. The bases of the compressed oop and klass
+     * encodings are addresses too, but the {@link CompressEncoding}s are persisted by value, so
+     * they are always part of the fingerprint.
+     */
+    private long computeFingerprint() {
+        try {
+            MessageDigest digest = MessageDigest.getInstance("SHA-1");
+            StringBuilder sb = new StringBuilder();
+            sb.append(target.arch.getName()).append('\n').append(System.getProperty("java.vm.version")).append('\n');
+            appendEncoding(sb, "oopEncoding", config.getOopEncoding());
+            appendEncoding(sb, "klassEncoding", config.getKlassEncoding());
+            for (Field f : HotSpotVMConfig.class.getDeclaredFields()) {
+                if (!Modifier.isStatic(f.getModifiers()) && !isAddress(f)) {
+                    f.setAccessible(true);
+                    sb.append(f.getName()).append('=').append(Arrays.deepToString(new Object[]{f.get(config)})).append('\n');
+                }
+            }
+            for (Map.Entry<String, OptionDescriptor> e : OptionsLoader.options.entrySet()) {
+                OptionValue<?> option = e.getValue().getOptionValue();
+                // These options only control when graphs are prepared and where they are stored
+                if (option != Options.SnippetGraphFile && option != GraalOptions.BootstrapReplacements) {
+                    sb.append(e.getKey()).append('=').append(option.getValue()).append('\n');
+                }
+            }
+            for (Class<?> c : new Class<?>[]{ReplacementsImpl.class, HotSpotReplacementsImpl.class}) {
+                CodeSource cs = c.getProtectionDomain().getCodeSource();
+                if (cs != null && cs.getLocation() != null && cs.getLocation().getProtocol().equals("file")) {
+                    File f = new File(cs.getLocation().getPath());
+                    sb.append(f).append(':').append(f.length()).append(':').append(f.lastModified()).append('\n');
+                }
+            }
+            byte[] hash = digest.digest(sb.toString().getBytes());
+            long fingerprint = 0;
+            for (int i = 0; i < 8; i++) {
+                fingerprint = (fingerprint << 8) | (hash[i] & 0xff);
+            }
+            return fingerprint;
+        } catch (NoSuchAlgorithmException | IllegalAccessException e) {
+            throw new JVMCIError(e);
+        }
+    }
+
+    private static void appendEncoding(StringBuilder sb, String name, CompressEncoding encoding) {
+        sb.append(name).append(".base=").append(encoding.base).append(" shift=").append(encoding.shift).append(" alignment=").append(encoding.alignment).append('\n');
+    }
+
+    /**
+     * Determines if {@code field} of {@link HotSpotVMConfig} holds an address. The configuration
+     * fields that are not read from the VM but computed from other values are only of type
+     * {@code long} if they hold an address.
+     */
+    private static boolean isAddress(Field field) {
+        HotSpotVMField vmField = field.getAnnotation(HotSpotVMField.class);
+        if (vmField != null) {
+            return vmField.get() == HotSpotVMField.Type.ADDRESS ||
+                            (vmField.get() == HotSpotVMField.Type.VALUE && (vmField.type().equals("address") || vmField.type().endsWith("*")));
+        }
+        HotSpotVMValue vmValue = field.getAnnotation(HotSpotVMValue.class);
+        if (vmValue != null) {
+            return vmValue.get() == HotSpotVMValue.Type.ADDRESS;
+        }
+        if (field.getAnnotation(HotSpotVMFlag.class) != null || field.getAnnotation(HotSpotVMConstant.class) != null || field.getAnnotation(HotSpotVMType.class) != null) {
+            return false;
+        }
+        return field.getType() == long.class;
+    }
 }
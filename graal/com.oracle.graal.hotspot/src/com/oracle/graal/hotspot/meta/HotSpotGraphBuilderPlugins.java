@@ -33,6 +33,7 @@ import jdk.internal.jvmci.code.*;
 import jdk.internal.jvmci.hotspot.*;
 import jdk.internal.jvmci.meta.*;
 import jdk.internal.jvmci.options.*;
+import sun.misc.*;
 import sun.reflect.*;
 
 import com.oracle.graal.api.replacements.*;
@@ -93,6 +94,7 @@ public class HotSpotGraphBuilderPlugins {
         registerStableOptionPlugins(invocationPlugins, snippetReflection);
         registerAESPlugins(invocationPlugins, config);
         registerCRC32Plugins(invocationPlugins, config);
+        registerUnsafeCopySwapPlugins(invocationPlugins, config);
         StandardGraphBuilderPlugins.registerInvocationPlugins(metaAccess, invocationPlugins, !config.useHeapProfiler);
 
         return plugins;
@@ -268,4 +270,12 @@ public class HotSpotGraphBuilderPlugins {
             r.registerMethodSubstitution(CRC32Substitutions.class, "updateByteBuffer", int.class, long.class, int.class, int.class);
         }
     }
+
+    private static void registerUnsafeCopySwapPlugins(InvocationPlugins plugins, HotSpotVMConfig config) {
+        if (config.jshortSwapcopy != 0L && config.jintSwapcopy != 0L && config.jlongSwapcopy != 0L) {
+            // Only class libraries that declare Unsafe.copySwapMemory have the method
+            Registration r = new Registration(plugins, Unsafe.class);
+            r.registerOptionalMethodSubstitution(UnsafeCopySwapSubstitutions.class, "copySwapMemory", Receiver.class, Object.class, long.class, Object.class, long.class, long.class, long.class);
+        }
+    }
 }
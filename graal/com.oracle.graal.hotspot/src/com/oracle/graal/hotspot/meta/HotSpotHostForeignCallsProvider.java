@@ -35,6 +35,7 @@ import static com.oracle.graal.hotspot.replacements.MonitorSnippets.*;
 import static com.oracle.graal.hotspot.replacements.NewObjectSnippets.*;
 import static com.oracle.graal.hotspot.replacements.SystemSubstitutions.*;
 import static com.oracle.graal.hotspot.replacements.ThreadSubstitutions.*;
+import static com.oracle.graal.hotspot.replacements.UnsafeCopySwapSubstitutions.*;
 import static com.oracle.graal.hotspot.replacements.WriteBarrierSnippets.*;
 import static com.oracle.graal.hotspot.stubs.ExceptionHandlerStub.*;
 import static com.oracle.graal.hotspot.stubs.NewArrayStub.*;
@@ -247,6 +248,13 @@ public abstract class HotSpotHostForeignCallsProvider extends HotSpotForeignCall
         registerCheckcastArraycopyDescriptor(true, c.checkcastArraycopyUninit);
         registerCheckcastArraycopyDescriptor(false, c.checkcastArraycopy);
 
+        if (c.jshortSwapcopy != 0L && c.jintSwapcopy != 0L && c.jlongSwapcopy != 0L) {
+            // Unsafe.copySwapMemory may write to any primitive array or to off-heap memory
+            registerForeignCall(JSHORT_SWAPCOPY, c.jshortSwapcopy, NativeCall, DESTROYS_REGISTERS, LEAF_NOFP, NOT_REEXECUTABLE, any());
+            registerForeignCall(JINT_SWAPCOPY, c.jintSwapcopy, NativeCall, DESTROYS_REGISTERS, LEAF_NOFP, NOT_REEXECUTABLE, any());
+            registerForeignCall(JLONG_SWAPCOPY, c.jlongSwapcopy, NativeCall, DESTROYS_REGISTERS, LEAF_NOFP, NOT_REEXECUTABLE, any());
+        }
+
         if (c.useAESIntrinsics) {
             /*
              * When the java.ext.dirs property is modified then the crypto classes might not be
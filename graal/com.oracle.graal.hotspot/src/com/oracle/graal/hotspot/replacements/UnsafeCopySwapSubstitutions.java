@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.hotspot.replacements;
+
+import static com.oracle.graal.nodes.extended.BranchProbabilityNode.*;
+
+import jdk.internal.jvmci.meta.*;
+
+import com.oracle.graal.graph.Node.ConstantNodeParameter;
+import com.oracle.graal.graph.Node.NodeIntrinsic;
+import com.oracle.graal.hotspot.nodes.*;
+import com.oracle.graal.nodes.*;
+import com.oracle.graal.nodes.extended.*;
+import com.oracle.graal.word.*;
+
+// JaCoCo Exclude
+
+/**
+ * Substitutions for {@code sun.misc.Unsafe.copySwapMemory}, which copies 2, 4 or 8 byte elements
+ * while reversing the byte order of each. The method is only present in class libraries that
+ * declare it. The copy is done by the {@code StubRoutines::_j*_swapcopy} stubs, which take an
+ * element count and allow the ranges to overlap.
+ */
+public class UnsafeCopySwapSubstitutions {
+
+    public static final ForeignCallDescriptor JSHORT_SWAPCOPY = new ForeignCallDescriptor("jshort_swapcopy", void.class, Word.class, Word.class, Word.class);
+    public static final ForeignCallDescriptor JINT_SWAPCOPY = new ForeignCallDescriptor("jint_swapcopy", void.class, Word.class, Word.class, Word.class);
+    public static final ForeignCallDescriptor JLONG_SWAPCOPY = new ForeignCallDescriptor("jlong_swapcopy", void.class, Word.class, Word.class, Word.class);
+
+    static void copySwapMemory(Object rcvr, Object srcBase, long srcOffset, Object destBase, long destOffset, long bytes, long elemSize) {
+        /*
+         * The native method throws for an unsupported element size or a byte count that is
+         * negative or not a whole number of elements; let the interpreter do that.
+         */
+        if (probability(VERY_SLOW_PATH_PROBABILITY, (elemSize != 2 && elemSize != 4 && elemSize != 8) || (bytes & (Long.MIN_VALUE | (elemSize - 1))) != 0)) {
+            DeoptimizeNode.deopt(DeoptimizationAction.None, DeoptimizationReason.RuntimeConstraint);
+        }
+        Word src = address(srcBase, srcOffset);
+        Word dest = address(destBase, destOffset);
+        if (elemSize == 2) {
+            swapcopy(JSHORT_SWAPCOPY, src, dest, Word.unsigned(bytes >>> 1));
+        } else if (elemSize == 4) {
+            swapcopy(JINT_SWAPCOPY, src, dest, Word.unsigned(bytes >>> 2));
+        } else {
+            swapcopy(JLONG_SWAPCOPY, src, dest, Word.unsigned(bytes >>> 3));
+        }
+    }
+
+    /**
+     * Computes the address denoted by an Unsafe base and offset, where a null base means the offset
+     * is an absolute (off-heap) address.
+     */
+    private static Word address(Object base, long offset) {
+        if (base == null) {
+            return Word.unsigned(offset);
+        }
+        return Word.unsigned(ComputeObjectAddressNode.get(base, offset));
+    }
+
+    @NodeIntrinsic(ForeignCallNode.class)
+    public static native void swapcopy(@ConstantNodeParameter ForeignCallDescriptor descriptor, Word src, Word dest, Word count);
+}
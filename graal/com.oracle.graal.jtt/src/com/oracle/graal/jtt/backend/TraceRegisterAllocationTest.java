@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.jtt.backend;
+
+import static com.oracle.graal.api.directives.GraalDirectives.*;
+import jdk.internal.jvmci.options.*;
+import jdk.internal.jvmci.options.OptionValue.OverrideScope;
+
+import org.junit.*;
+
+import com.oracle.graal.jtt.*;
+import com.oracle.graal.lir.alloc.lsra.*;
+
+/**
+ * Compiles methods with several traces, i.e., with values that are live across infrequently
+ * executed paths, using the {@link TraceRegisterAllocationPhase}.
+ */
+public class TraceRegisterAllocationTest extends JTTTest {
+
+    private static int call(int a) {
+        return String.valueOf(a).hashCode();
+    }
+
+    public static int loopWithSlowPath(int n) {
+        int a = 1;
+        int b = 2;
+        int c = 3;
+        for (int i = 0; i < n; i++) {
+            if (injectBranchProbability(SLOWPATH_PROBABILITY, i % 7 == 6)) {
+                // swap values on the slow path to force moves between traces
+                int t = a;
+                a = c;
+                c = b;
+                b = t + call(i);
+            } else {
+                a += b;
+                c ^= a;
+            }
+        }
+        return a + 3 * b + 7 * c;
+    }
+
+    public static long switchMerge(int x, long y) {
+        long a = y;
+        long b = y * 3;
+        long c = y - 11;
+        switch (x) {
+            case 0:
+                a = b + call(x);
+                break;
+            case 1:
+                b = c;
+                break;
+            case 2:
+                c = a * 5;
+                a = call(x);
+                break;
+            default:
+                a = c;
+                c = b;
+                b = a;
+        }
+        return a * 31 + b * 17 + c;
+    }
+
+    public static double manyLiveValues(double x, int n) {
+        double d0 = x;
+        double d1 = x + 1;
+        double d2 = x * 2;
+        double d3 = x - 3;
+        double d4 = x / 4;
+        double d5 = x * x;
+        double d6 = d5 - x;
+        double d7 = d6 + d1;
+        if (injectBranchProbability(UNLIKELY_PROBABILITY, n > 10)) {
+            call(n);
+            d0 = d7;
+            d7 = d3;
+        }
+        for (int i = 0; i < n; i++) {
+            d0 += d1;
+            d2 = d2 * 0.5 + d3;
+            if (injectBranchProbability(SLOWPATH_PROBABILITY, i == 3)) {
+                d4 = d5 + call(i);
+            }
+            d6 -= d7;
+        }
+        return d0 + d1 + d2 + d3 + d4 + d5 + d6 + d7;
+    }
+
+    /**
+     * Keeps more constants live across the trace boundaries than there are registers, so some of
+     * them are spilled as rematerializable intervals when they enter a trace.
+     */
+    public static long constantsAcrossTraces(long x, int n) {
+        long sum = x;
+        for (int i = 0; i < n; i++) {
+            if (injectBranchProbability(SLOWPATH_PROBABILITY, i % 5 == 4)) {
+                sum += call(i);
+            }
+            sum = sum * 0x123456789ABCL + 0x23456789ABCDL;
+            sum ^= 0x3456789ABCDEL;
+            sum += 0x456789ABCDEFL;
+            sum -= 0x56789ABCDEF0L;
+            sum ^= 0x6789ABCDEF01L;
+            sum += 0x789ABCDEF012L;
+            sum -= 0x89ABCDEF0123L;
+            sum ^= 0x9ABCDEF01234L;
+            sum += 0xABCDEF012345L;
+            sum -= 0xBCDEF0123456L;
+            sum ^= 0xCDEF01234567L;
+            sum += 0xDEF012345678L;
+            sum -= 0xEF0123456789L;
+            sum ^= 0xF0123456789AL;
+            sum += 0x0123456789ABL;
+            sum -= 0x13579BDF0246L;
+            sum ^= 0x2468ACE01357L;
+        }
+        return sum;
+    }
+
+    @Test
+    public void run0() throws Throwable {
+        try (OverrideScope s = OptionValue.override(TraceRegisterAllocationPhase.Options.TraceRA, true)) {
+            runTest("loopWithSlowPath", 0);
+            runTest("loopWithSlowPath", 5);
+            runTest("loopWithSlowPath", 100);
+        }
+    }
+
+    @Test
+    public void run1() throws Throwable {
+        try (OverrideScope s = OptionValue.override(TraceRegisterAllocationPhase.Options.TraceRA, true)) {
+            for (int i = -1; i < 4; i++) {
+                runTest("switchMerge", i, 42L);
+            }
+        }
+    }
+
+    @Test
+    public void run2() throws Throwable {
+        try (OverrideScope s = OptionValue.override(TraceRegisterAllocationPhase.Options.TraceRA, true)) {
+            runTest("manyLiveValues", 1.5, 2);
+            runTest("manyLiveValues", 1.5, 20);
+        }
+    }
+
+    @Test
+    public void run3() throws Throwable {
+        try (OverrideScope s = OptionValue.override(TraceRegisterAllocationPhase.Options.TraceRA, true)) {
+            runTest("constantsAcrossTraces", 7L, 0);
+            runTest("constantsAcrossTraces", 7L, 3);
+            runTest("constantsAcrossTraces", 7L, 50);
+        }
+    }
+}
@@ -153,11 +153,19 @@ class LinearScan {
     private final int firstVariableNumber;
 
     LinearScan(TargetDescription target, LIRGenerationResult res, SpillMoveFactory spillMoveFactory, RegisterAllocationConfig regAllocConfig) {
+        this(target, res, spillMoveFactory, regAllocConfig, res.getLIR().linearScanOrder());
+    }
+
+    /**
+     * Creates an allocator that only processes {@code sortedBlocks}, a subset of the blocks of the
+     * LIR in the order in which they are numbered.
+     */
+    LinearScan(TargetDescription target, LIRGenerationResult res, SpillMoveFactory spillMoveFactory, RegisterAllocationConfig regAllocConfig, List<? extends AbstractBlockBase<?>> sortedBlocks) {
         this.res = res;
         this.ir = res.getLIR();
         this.moveFactory = spillMoveFactory;
         this.frameMapBuilder = res.getFrameMapBuilder();
-        this.sortedBlocks = ir.linearScanOrder();
+        this.sortedBlocks = sortedBlocks;
         this.registerAttributes = regAllocConfig.getRegisterConfig().getAttributesMap();
         this.regAllocConfig = regAllocConfig;
 
@@ -211,14 +219,28 @@ class LinearScan {
             return number;
         }
         assert isVariable(operand) : operand;
-        return firstVariableNumber + ((Variable) operand).index;
+        return firstVariableNumber + variableNumber((Variable) operand);
     }
 
     /**
      * Gets the number of operands. This value will increase by 1 for new variable.
      */
     int operandSize() {
-        return firstVariableNumber + ir.numVariables();
+        return firstVariableNumber + numVariables();
+    }
+
+    /**
+     * Converts a variable to an index in {@code [0, numVariables())}.
+     */
+    int variableNumber(Variable variable) {
+        return variable.index;
+    }
+
+    /**
+     * Gets the number of variables processed by this allocator.
+     */
+    int numVariables() {
+        return ir.numVariables();
     }
 
     /**
@@ -236,6 +258,14 @@ class LinearScan {
         blockData.put(block, new BlockData());
     }
 
+    /**
+     * Determines if {@code block} is processed by this allocator. Only valid after the
+     * instructions have been numbered.
+     */
+    boolean isAllocated(AbstractBlockBase<?> block) {
+        return blockData.get(block) != null;
+    }
+
     static final IntervalPredicate IS_PRECOLORED_INTERVAL = new IntervalPredicate() {
 
         @Override
@@ -342,6 +372,13 @@ class LinearScan {
         return sortedBlocks.get(index);
     }
 
+    /**
+     * Gets the index of {@code block} in {@link #sortedBlocks}.
+     */
+    int blockIndex(AbstractBlockBase<?> block) {
+        return block.getLinearScanNumber();
+    }
+
     /**
      * Gets the size of the {@link BlockData#liveIn} and {@link BlockData#liveOut} sets for a basic
      * block. These sets do not include any operands allocated as a result of creating
@@ -638,7 +675,7 @@ class LinearScan {
 
                 createRegisterAllocationPhase().apply(target, lirGenRes, codeEmittingOrder, linearScanOrder, context, false);
 
-                if (LinearScan.Options.LSRAOptimizeSpillPosition.getValue()) {
+                if (optimizeSpillPosition()) {
                     createOptimizeSpillPositionPhase().apply(target, lirGenRes, codeEmittingOrder, linearScanOrder, context, false);
                 }
                 createResolveDataFlowPhase().apply(target, lirGenRes, codeEmittingOrder, linearScanOrder, context);
@@ -664,6 +701,13 @@ class LinearScan {
     protected void beforeSpillMoveElimination() {
     }
 
+    /**
+     * Determines if spill moves may be moved to a dominator of the spill positions.
+     */
+    protected boolean optimizeSpillPosition() {
+        return LinearScan.Options.LSRAOptimizeSpillPosition.getValue();
+    }
+
     protected LinearScanLifetimeAnalysisPhase createLifetimeAnalysisPhase() {
         return new LinearScanLifetimeAnalysisPhase(this);
     }
@@ -130,8 +130,9 @@ final class LinearScanAssignLocationsPhase extends AllocationPhase {
              */
             final LIRInstruction instr = allocator.ir.getLIRforBlock(block).get(allocator.ir.getLIRforBlock(block).size() - 1);
             if (instr instanceof StandardOp.JumpOp) {
-                if (allocator.getBlockData(block).liveOut.get(allocator.operandNumber(operand))) {
-                    tempOpId = allocator.getFirstLirInstructionId(block.getSuccessors().iterator().next());
+                AbstractBlockBase<?> successor = block.getSuccessors().iterator().next();
+                if (allocator.isAllocated(successor) && allocator.getBlockData(block).liveOut.get(allocator.operandNumber(operand))) {
+                    tempOpId = allocator.getFirstLirInstructionId(successor);
                     mode = OperandMode.DEF;
                 }
             }
@@ -144,7 +144,7 @@ class LinearScanResolveDataFlowPhase extends AllocationPhase {
                         AbstractBlockBase<?> sux = block.getSuccessors().iterator().next();
 
                         // prevent optimization of two consecutive blocks
-                        if (!blockCompleted.get(pred.getLinearScanNumber()) && !blockCompleted.get(sux.getLinearScanNumber())) {
+                        if (allocator.isAllocated(pred) && allocator.isAllocated(sux) && !blockCompleted.get(pred.getLinearScanNumber()) && !blockCompleted.get(sux.getLinearScanNumber())) {
                             if (Debug.isLogEnabled()) {
                                 Debug.log(" optimizing empty block B%d (pred: B%d, sux: B%d)", block.getId(), pred.getId(), sux.getId());
                             }
@@ -174,9 +174,9 @@ class LinearScanResolveDataFlowPhase extends AllocationPhase {
 
                         /*
                          * Check for duplicate edges between the same blocks (can happen with switch
-                         * blocks).
+                         * blocks). Edges leaving the allocated blocks are resolved by the caller.
                          */
-                        if (!alreadyResolved.get(toBlock.getLinearScanNumber())) {
+                        if (allocator.isAllocated(toBlock) && !alreadyResolved.get(toBlock.getLinearScanNumber())) {
                             if (Debug.isLogEnabled()) {
                                 Debug.log("processing edge between B%d and B%d", fromBlock.getId(), toBlock.getId());
                             }
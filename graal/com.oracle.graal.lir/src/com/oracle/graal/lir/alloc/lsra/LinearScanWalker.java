@@ -285,8 +285,8 @@ class LinearScanWalker extends IntervalWalker {
     }
 
     int findOptimalSplitPos(AbstractBlockBase<?> minBlock, AbstractBlockBase<?> maxBlock, int maxSplitPos) {
-        int fromBlockNr = minBlock.getLinearScanNumber();
-        int toBlockNr = maxBlock.getLinearScanNumber();
+        int fromBlockNr = allocator.blockIndex(minBlock);
+        int toBlockNr = allocator.blockIndex(maxBlock);
 
         assert 0 <= fromBlockNr && fromBlockNr < blockCount() : "out of range";
         assert 0 <= toBlockNr && toBlockNr < blockCount() : "out of range";
@@ -339,7 +339,7 @@ class LinearScanWalker extends IntervalWalker {
             // block at this opId)
             AbstractBlockBase<?> maxBlock = allocator.blockForId(maxSplitPos - 1);
 
-            assert minBlock.getLinearScanNumber() <= maxBlock.getLinearScanNumber() : "invalid order";
+            assert allocator.blockIndex(minBlock) <= allocator.blockIndex(maxBlock) : "invalid order";
             if (minBlock == maxBlock) {
                 // split position cannot be moved to block boundary : so split as late as possible
                 if (Debug.isLogEnabled()) {
@@ -584,7 +584,7 @@ class LinearScanWalker extends IntervalWalker {
                      * The loop depth of the spilling position is higher then the loop depth at the
                      * definition of the interval. Move write to memory out of loop.
                      */
-                    if (LinearScan.Options.LSRAOptimizeSpillPosition.getValue()) {
+                    if (allocator.optimizeSpillPosition()) {
                         // find best spill position in dominator the tree
                         interval.setSpillState(SpillState.SpillInDominator);
                     } else {
@@ -602,7 +602,7 @@ class LinearScanWalker extends IntervalWalker {
             }
 
             case OneSpillStore: {
-                if (LinearScan.Options.LSRAOptimizeSpillPosition.getValue()) {
+                if (allocator.optimizeSpillPosition()) {
                     // the interval is spilled more then once
                     interval.setSpillState(SpillState.SpillInDominator);
                 } else {
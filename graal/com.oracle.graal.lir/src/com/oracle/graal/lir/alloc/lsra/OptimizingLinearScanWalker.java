@@ -81,7 +81,7 @@ public class OptimizingLinearScanWalker extends LinearScanWalker {
     }
 
     private void optimizeBlock(AbstractBlockBase<?> block) {
-        if (block.getPredecessorCount() == 1) {
+        if (block.getPredecessorCount() == 1 && allocator.isAllocated(block.getPredecessors().get(0))) {
             int nextBlock = allocator.getFirstLirInstructionId(block);
             try (Scope s1 = Debug.scope("LSRAOptimization")) {
                 Debug.log("next block: %s (%d)", block, nextBlock);
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.lir.alloc.lsra;
+
+import static jdk.internal.jvmci.code.ValueUtil.*;
+
+import java.util.*;
+
+import jdk.internal.jvmci.code.*;
+import jdk.internal.jvmci.debug.*;
+import jdk.internal.jvmci.meta.*;
+
+import com.oracle.graal.lir.*;
+import com.oracle.graal.lir.framemap.*;
+import com.oracle.graal.lir.gen.LIRGeneratorTool.SpillMoveFactory;
+
+/**
+ * Resolves the data flow at an edge between two traces. Unlike the {@link MoveResolver}, which
+ * works on the intervals of a single allocator, the mappings are between the locations assigned by
+ * the allocators of the two traces.
+ */
+final class TraceGlobalMoveResolver {
+
+    private final SpillMoveFactory spillMoveFactory;
+    private final FrameMapBuilder frameMapBuilder;
+    private final LIRInsertionBuffer insertionBuffer;
+    private final List<Value> mappingFrom;
+    private final List<AllocatableValue> mappingTo;
+
+    TraceGlobalMoveResolver(SpillMoveFactory spillMoveFactory, FrameMapBuilder frameMapBuilder) {
+        this.spillMoveFactory = spillMoveFactory;
+        this.frameMapBuilder = frameMapBuilder;
+        this.insertionBuffer = new LIRInsertionBuffer();
+        this.mappingFrom = new ArrayList<>(8);
+        this.mappingTo = new ArrayList<>(8);
+    }
+
+    boolean hasMappings() {
+        return mappingFrom.size() > 0;
+    }
+
+    /**
+     * Adds a move from {@code from}, which is a location or a constant, to the location
+     * {@code to}.
+     */
+    void addMapping(Value from, AllocatableValue to) {
+        assert isRegister(to) || isStackSlotValue(to) : "destination must be a location: " + to;
+        if (!isSameLocation(from, to)) {
+            mappingFrom.add(from);
+            mappingTo.add(to);
+        }
+    }
+
+    /**
+     * Inserts the moves for the collected mappings before the instruction at {@code index} of
+     * {@code instructions}.
+     */
+    void resolveAndAppendMoves(List<LIRInstruction> instructions, int index) {
+        insertionBuffer.init(instructions);
+        while (hasMappings()) {
+            boolean processed = false;
+            for (int i = mappingFrom.size() - 1; i >= 0; i--) {
+                if (!isRead(mappingTo.get(i), i)) {
+                    insertMove(index, mappingFrom.get(i), mappingTo.get(i));
+                    mappingFrom.remove(i);
+                    mappingTo.remove(i);
+                    processed = true;
+                }
+            }
+            if (!processed) {
+                breakCycle(index);
+            }
+        }
+        insertionBuffer.finish();
+    }
+
+    private boolean isRead(AllocatableValue location, int skip) {
+        for (int i = 0; i < mappingFrom.size(); i++) {
+            if (i != skip && isSameLocation(mappingFrom.get(i), location)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * All remaining mappings form cycles. Saves the source of the last mapping to a new stack slot
+     * so that its destination can be overwritten.
+     */
+    private void breakCycle(int index) {
+        Value from = mappingFrom.get(mappingFrom.size() - 1);
+        assert isRegister(from) || isStackSlotValue(from) : "constants cannot be part of a cycle: " + from;
+        StackSlotValue spillSlot = frameMapBuilder.allocateSpillSlot(from.getLIRKind());
+        if (Debug.isLogEnabled()) {
+            Debug.log("breaking cycle at %s with %s", from, spillSlot);
+        }
+        insertMove(index, from, spillSlot);
+        for (int i = 0; i < mappingFrom.size(); i++) {
+            if (isSameLocation(mappingFrom.get(i), from)) {
+                mappingFrom.set(i, spillSlot);
+            }
+        }
+    }
+
+    private void insertMove(int index, Value from, AllocatableValue to) {
+        LIRInstruction move;
+        if (isStackSlotValue(from) && isStackSlotValue(to)) {
+            move = spillMoveFactory.createStackMove(to, from);
+        } else {
+            move = spillMoveFactory.createMove(to, from);
+        }
+        insertionBuffer.append(index, move);
+        if (Debug.isLogEnabled()) {
+            Debug.log("insert move from %s to %s at %d", from, to, index);
+        }
+    }
+
+    private static boolean isSameLocation(Value a, Value b) {
+        if (isRegister(a) && isRegister(b)) {
+            return asRegister(a).equals(asRegister(b));
+        }
+        return a.equals(b);
+    }
+}
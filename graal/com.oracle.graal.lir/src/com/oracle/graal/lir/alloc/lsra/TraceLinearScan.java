@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.lir.alloc.lsra;
+
+import static com.oracle.graal.lir.LIRValueUtil.*;
+
+import java.util.*;
+
+import jdk.internal.jvmci.code.*;
+import jdk.internal.jvmci.debug.*;
+import jdk.internal.jvmci.meta.*;
+
+import com.oracle.graal.compiler.common.alloc.*;
+import com.oracle.graal.compiler.common.cfg.*;
+import com.oracle.graal.lir.*;
+import com.oracle.graal.lir.LIRInstruction.OperandFlag;
+import com.oracle.graal.lir.LIRInstruction.OperandMode;
+import com.oracle.graal.lir.gen.*;
+import com.oracle.graal.lir.gen.LIRGeneratorTool.SpillMoveFactory;
+
+/**
+ * A linear scan allocator for a single trace computed by the {@link TraceRegisterAllocationPhase}.
+ * The live sets at the block boundaries are taken from a liveness analysis of the whole method.
+ * Values flowing into or out of the trace are resolved by the {@link TraceRegisterAllocationPhase}
+ * once all traces are allocated.
+ *
+ * Only the variables used in the trace or live at its blocks get an operand number, so the
+ * interval table and the live sets are sized by the trace and not by the whole method.
+ */
+final class TraceLinearScan extends LinearScan {
+
+    private final LinearScan liveness;
+    private final int[] blockIndices;
+
+    /**
+     * Map from {@link Variable#index} to the variable number in this trace, or -1. The array is
+     * shared by all traces of a method, only the entries of {@link #traceVariables} are set.
+     */
+    private final int[] variableNumbers;
+
+    /**
+     * The {@link Variable#index indices} of the variables of this trace, in the order of their
+     * variable numbers.
+     */
+    private final int[] traceVariables;
+
+    /**
+     * The index of the first variable created for a derived interval of this trace.
+     */
+    private final int firstDerivedVariable;
+
+    TraceLinearScan(TargetDescription target, LIRGenerationResult res, SpillMoveFactory spillMoveFactory, RegisterAllocationConfig regAllocConfig, List<? extends AbstractBlockBase<?>> trace,
+                    LinearScan liveness, int[] variableNumbers) {
+        super(target, res, spillMoveFactory, regAllocConfig, trace);
+        this.liveness = liveness;
+        this.variableNumbers = variableNumbers;
+        this.traceVariables = numberVariables(trace);
+        this.firstDerivedVariable = ir.numVariables();
+        int maxId = -1;
+        for (AbstractBlockBase<?> block : trace) {
+            maxId = Math.max(maxId, block.getId());
+        }
+        this.blockIndices = new int[maxId + 1];
+        for (int i = 0; i < trace.size(); i++) {
+            blockIndices[trace.get(i).getId()] = i;
+        }
+    }
+
+    LinearScan getLiveness() {
+        return liveness;
+    }
+
+    private int[] numberVariables(List<? extends AbstractBlockBase<?>> trace) {
+        VariableCollector collector = new VariableCollector();
+        for (AbstractBlockBase<?> block : trace) {
+            for (LIRInstruction op : ir.getLIRforBlock(block)) {
+                op.visitEachInput(collector);
+                op.visitEachAlive(collector);
+                op.visitEachTemp(collector);
+                op.visitEachOutput(collector);
+                op.visitEachState(collector);
+            }
+            BlockData global = liveness.getBlockData(block);
+            collector.addLive(global.liveIn);
+            collector.addLive(global.liveOut);
+        }
+        return Arrays.copyOf(collector.variables, collector.count);
+    }
+
+    private final class VariableCollector implements ValueConsumer {
+        int[] variables = new int[16];
+        int count;
+
+        @Override
+        public void visitValue(Value value, OperandMode mode, EnumSet<OperandFlag> flags) {
+            if (isVariable(value)) {
+                add(((Variable) value).index);
+            }
+        }
+
+        void addLive(BitSet live) {
+            int firstVariable = liveness.maxRegisterNumber() + 1;
+            for (int operandNum = live.nextSetBit(firstVariable); operandNum >= 0; operandNum = live.nextSetBit(operandNum + 1)) {
+                add(operandNum - firstVariable);
+            }
+        }
+
+        private void add(int index) {
+            if (variableNumbers[index] == -1) {
+                if (count == variables.length) {
+                    variables = Arrays.copyOf(variables, count * 2);
+                }
+                variableNumbers[index] = count;
+                variables[count++] = index;
+            }
+        }
+    }
+
+    /**
+     * Resets the entries of the shared variable number map set for this trace.
+     */
+    void releaseVariableNumbers() {
+        for (int index : traceVariables) {
+            variableNumbers[index] = -1;
+        }
+    }
+
+    /**
+     * Variables created for derived intervals of this trace are numbered after the variables of
+     * the trace, in the order in which they are created.
+     */
+    @Override
+    int variableNumber(Variable variable) {
+        if (variable.index >= firstDerivedVariable) {
+            return traceVariables.length + variable.index - firstDerivedVariable;
+        }
+        int number = variableNumbers[variable.index];
+        assert number >= 0 : "variable not part of the trace: " + variable;
+        return number;
+    }
+
+    @Override
+    int numVariables() {
+        return traceVariables.length + ir.numVariables() - firstDerivedVariable;
+    }
+
+    /**
+     * Converts an operand number of the {@linkplain #getLiveness() global liveness} to an operand
+     * number of this allocator.
+     */
+    int traceOperandNumber(int livenessOperandNumber) {
+        int firstVariable = maxRegisterNumber() + 1;
+        if (livenessOperandNumber < firstVariable) {
+            return livenessOperandNumber;
+        }
+        int number = variableNumbers[livenessOperandNumber - firstVariable];
+        assert number >= 0 : "operand not part of the trace: " + livenessOperandNumber;
+        return firstVariable + number;
+    }
+
+    /**
+     * Converts a live set of the {@linkplain #getLiveness() global liveness} to a live set of this
+     * allocator.
+     */
+    BitSet traceLiveSet(BitSet livenessSet) {
+        BitSet result = new BitSet(liveSetSize());
+        for (int operandNum = livenessSet.nextSetBit(0); operandNum >= 0; operandNum = livenessSet.nextSetBit(operandNum + 1)) {
+            result.set(traceOperandNumber(operandNum));
+        }
+        return result;
+    }
+
+    @Override
+    int blockIndex(AbstractBlockBase<?> block) {
+        assert isAllocated(block) : "block not part of the trace: " + block;
+        return blockIndices[block.getId()];
+    }
+
+    /**
+     * The dominator of the spill positions might not be part of the trace.
+     */
+    @Override
+    protected boolean optimizeSpillPosition() {
+        return false;
+    }
+
+    @Override
+    protected LinearScanLifetimeAnalysisPhase createLifetimeAnalysisPhase() {
+        return new TraceLinearScanLifetimeAnalysisPhase(this);
+    }
+
+    /**
+     * The {@link RegisterVerifier} follows control flow from the first block and therefore cannot
+     * be used for a trace.
+     */
+    @Override
+    boolean verify() {
+        verifyIntervals();
+        Debug.log("no errors found");
+        return true;
+    }
+}
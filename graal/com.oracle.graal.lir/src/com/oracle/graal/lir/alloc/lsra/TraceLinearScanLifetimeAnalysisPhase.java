@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.lir.alloc.lsra;
+
+import java.util.*;
+
+import jdk.internal.jvmci.debug.*;
+
+import com.oracle.graal.compiler.common.cfg.*;
+import com.oracle.graal.lir.alloc.lsra.Interval.SpillState;
+import com.oracle.graal.lir.alloc.lsra.LinearScan.BlockData;
+
+/**
+ * Lifetime analysis for a {@link TraceLinearScan}. The global live sets are translated from the
+ * liveness analysis of the whole method instead of being computed from the blocks of the trace.
+ */
+final class TraceLinearScanLifetimeAnalysisPhase extends LinearScanLifetimeAnalysisPhase {
+
+    TraceLinearScanLifetimeAnalysisPhase(TraceLinearScan linearScan) {
+        super(linearScan);
+    }
+
+    @Override
+    void computeGlobalLiveSets() {
+        TraceLinearScan traceAllocator = (TraceLinearScan) allocator;
+        try (Indent indent = Debug.logAndIndent("translate global live sets")) {
+            for (AbstractBlockBase<?> block : allocator.sortedBlocks) {
+                BlockData global = traceAllocator.getLiveness().getBlockData(block);
+                BlockData blockSets = allocator.getBlockData(block);
+                blockSets.liveIn = traceAllocator.traceLiveSet(global.liveIn);
+                blockSets.liveOut = traceAllocator.traceLiveSet(global.liveOut);
+            }
+        }
+    }
+
+    @Override
+    void buildIntervals() {
+        super.buildIntervals();
+
+        /*
+         * Values that are live on entry of a trace are also defined outside of the trace. The
+         * stack slot of such an interval is therefore not guaranteed to be up to date at its
+         * definitions in this trace, and it cannot be rematerialized from a definition in this
+         * trace.
+         */
+        for (AbstractBlockBase<?> block : allocator.sortedBlocks) {
+            if (hasPredecessorOutsideTrace(block)) {
+                BitSet liveIn = allocator.getBlockData(block).liveIn;
+                for (int operandNum = liveIn.nextSetBit(0); operandNum >= 0; operandNum = liveIn.nextSetBit(operandNum + 1)) {
+                    Interval interval = allocator.intervalFor(operandNum);
+                    if (interval.spillState() == SpillState.NoDefinitionFound || interval.spillState() == SpillState.NoSpillStore) {
+                        interval.setSpillState(SpillState.NoOptimization);
+                    }
+                    interval.addMaterializationValue(null);
+                }
+            }
+        }
+    }
+
+    private boolean hasPredecessorOutsideTrace(AbstractBlockBase<?> block) {
+        for (AbstractBlockBase<?> predecessor : block.getPredecessors()) {
+            if (!allocator.isAllocated(predecessor)) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
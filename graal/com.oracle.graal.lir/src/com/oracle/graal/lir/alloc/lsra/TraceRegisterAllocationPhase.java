@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.lir.alloc.lsra;
+
+import static jdk.internal.jvmci.code.ValueUtil.*;
+
+import java.util.*;
+
+import jdk.internal.jvmci.code.*;
+import jdk.internal.jvmci.debug.*;
+import jdk.internal.jvmci.meta.*;
+import jdk.internal.jvmci.options.*;
+
+import com.oracle.graal.compiler.common.alloc.*;
+import com.oracle.graal.compiler.common.alloc.TraceBuilder.TraceBuilderResult;
+import com.oracle.graal.compiler.common.cfg.*;
+import com.oracle.graal.lir.*;
+import com.oracle.graal.lir.LIRInstruction.OperandMode;
+import com.oracle.graal.lir.gen.*;
+import com.oracle.graal.lir.gen.LIRGeneratorTool.SpillMoveFactory;
+import com.oracle.graal.lir.phases.*;
+
+/**
+ * A register allocator that splits the LIR into {@linkplain TraceBuilder traces} along the most
+ * frequently executed paths and allocates each trace separately with a {@link TraceLinearScan}.
+ * Intervals therefore only cover the blocks of a single trace, which keeps lifetime analysis and
+ * data flow resolution cheap for methods with many blocks. The data flow between traces is resolved
+ * afterwards by inserting moves at the edges that cross a trace boundary. Since the hot traces are
+ * allocated as a whole, these moves are mostly placed on infrequently executed edges.
+ *
+ * The allocator works on LIR that is not in SSA form.
+ */
+public final class TraceRegisterAllocationPhase extends AllocationPhase {
+
+    public static class Options {
+        // @formatter:off
+        @Option(help = "Use the trace-based register allocator instead of linear scan over the whole method", type = OptionType.Debug)
+        public static final OptionValue<Boolean> TraceRA = new OptionValue<>(false);
+        // @formatter:on
+    }
+
+    private static final DebugMetric traces = Debug.metric("TraceRA[traces]");
+    private static final DebugMetric interTraceEdges = Debug.metric("TraceRA[interTraceEdges]");
+    private static final DebugMetric globalResolutionMoves = Debug.metric("TraceRA[globalResolutionMoves]");
+
+    @Override
+    protected <B extends AbstractBlockBase<B>> void run(TargetDescription target, LIRGenerationResult lirGenRes, List<B> codeEmittingOrder, List<B> linearScanOrder, SpillMoveFactory spillMoveFactory,
+                    RegisterAllocationConfig registerAllocationConfig) {
+        LIR lir = lirGenRes.getLIR();
+        LinearScan liveness = computeLiveness(target, lirGenRes, spillMoveFactory, registerAllocationConfig);
+        TraceBuilderResult<B> traceBuilderResult = TraceBuilder.computeTraces(linearScanOrder);
+        traces.add(traceBuilderResult.getTraces().size());
+
+        /*
+         * The locations of the values live at the trace boundaries, in the order of the operand
+         * numbers in the global live sets.
+         */
+        BlockMap<Value[]> entryLocations = new BlockMap<>(lir.getControlFlowGraph());
+        BlockMap<Value[]> exitLocations = new BlockMap<>(lir.getControlFlowGraph());
+
+        /*
+         * Maps the variables of the trace being allocated to trace-local numbers. Allocated once for
+         * all traces, each trace resets the entries it used.
+         */
+        int[] variableNumbers = new int[lir.numVariables()];
+        Arrays.fill(variableNumbers, -1);
+
+        for (List<B> trace : traceBuilderResult.getTraces()) {
+            try (Indent indent = Debug.logAndIndent("Allocating trace %s", trace)) {
+                TraceLinearScan allocator = new TraceLinearScan(target, lirGenRes, spillMoveFactory, registerAllocationConfig, trace, liveness, variableNumbers);
+                allocator.allocate(target, lirGenRes, codeEmittingOrder, linearScanOrder, spillMoveFactory, registerAllocationConfig);
+
+                for (B block : trace) {
+                    for (B predecessor : block.getPredecessors()) {
+                        if (!allocator.isAllocated(predecessor)) {
+                            entryLocations.put(block, locationsAt(allocator, liveness.getBlockData(block).liveIn, allocator.getFirstLirInstructionId(block)));
+                            break;
+                        }
+                    }
+                    for (B successor : block.getSuccessors()) {
+                        if (!allocator.isAllocated(successor)) {
+                            exitLocations.put(block, locationsAt(allocator, liveness.getBlockData(block).liveOut, allocator.getLastLirInstructionId(block) + 1));
+                            break;
+                        }
+                    }
+                }
+                allocator.releaseVariableNumbers();
+            }
+        }
+
+        resolveGlobalDataFlow(lir, linearScanOrder, traceBuilderResult, liveness, entryLocations, exitLocations, new TraceGlobalMoveResolver(spillMoveFactory, lirGenRes.getFrameMapBuilder()));
+    }
+
+    /**
+     * Computes the live sets of all blocks of the method. The intervals of this allocator are not
+     * built.
+     */
+    private static LinearScan computeLiveness(TargetDescription target, LIRGenerationResult lirGenRes, SpillMoveFactory spillMoveFactory, RegisterAllocationConfig registerAllocationConfig) {
+        try (Indent indent = Debug.logAndIndent("compute global liveness")) {
+            LinearScan liveness = new LinearScan(target, lirGenRes, spillMoveFactory, registerAllocationConfig);
+            LinearScanLifetimeAnalysisPhase lifetimeAnalysis = new LinearScanLifetimeAnalysisPhase(liveness);
+            lifetimeAnalysis.numberInstructions();
+            lifetimeAnalysis.computeLocalLiveSets();
+            lifetimeAnalysis.computeGlobalLiveSets();
+            return liveness;
+        }
+    }
+
+    /**
+     * Gets the locations at {@code opId} of the operands in {@code live}, a live set of the global
+     * liveness.
+     */
+    private static Value[] locationsAt(TraceLinearScan allocator, BitSet live, int opId) {
+        Value[] locations = new Value[live.cardinality()];
+        int i = 0;
+        for (int operandNum = live.nextSetBit(0); operandNum >= 0; operandNum = live.nextSetBit(operandNum + 1)) {
+            Interval interval = allocator.splitChildAtOpId(allocator.intervalFor(allocator.traceOperandNumber(operandNum)), opId, OperandMode.DEF);
+            if (isIllegal(interval.location())) {
+                assert interval.canMaterialize() : "no location for " + interval;
+                locations[i++] = interval.getMaterializedValue();
+            } else {
+                locations[i++] = interval.location();
+            }
+        }
+        return locations;
+    }
+
+    /**
+     * Inserts moves at all edges between different traces for values whose locations differ.
+     */
+    private static <B extends AbstractBlockBase<B>> void resolveGlobalDataFlow(LIR lir, List<B> blocks, TraceBuilderResult<B> traceBuilderResult, LinearScan liveness,
+                    BlockMap<Value[]> entryLocations, BlockMap<Value[]> exitLocations, TraceGlobalMoveResolver moveResolver) {
+        try (Indent indent = Debug.logAndIndent("resolve global data flow")) {
+            for (B fromBlock : blocks) {
+                int fromTrace = traceBuilderResult.getTraceForBlock(fromBlock);
+                Set<B> resolved = null;
+                for (B toBlock : fromBlock.getSuccessors()) {
+                    if (fromTrace == traceBuilderResult.getTraceForBlock(toBlock)) {
+                        continue;
+                    }
+                    if (resolved == null) {
+                        resolved = new HashSet<>(4);
+                    }
+                    // duplicate edges can occur for switches
+                    if (resolved.add(toBlock)) {
+                        interTraceEdges.increment();
+                        if (Debug.isLogEnabled()) {
+                            Debug.log("processing edge between B%d and B%d", fromBlock.getId(), toBlock.getId());
+                        }
+                        BitSet liveOut = liveness.getBlockData(fromBlock).liveOut;
+                        BitSet liveIn = liveness.getBlockData(toBlock).liveIn;
+                        Value[] from = exitLocations.get(fromBlock);
+                        Value[] to = entryLocations.get(toBlock);
+                        int i = 0;
+                        int j = 0;
+                        for (int operandNum = liveOut.nextSetBit(0); operandNum >= 0; operandNum = liveOut.nextSetBit(operandNum + 1), i++) {
+                            if (liveIn.get(operandNum)) {
+                                Value dest = to[j++];
+                                if (isConstant(dest)) {
+                                    // the successor trace re-materializes the value
+                                    if (Debug.isLogEnabled()) {
+                                        Debug.log("no store to rematerializable value %s needed", dest);
+                                    }
+                                    continue;
+                                }
+                                moveResolver.addMapping(from[i], (AllocatableValue) dest);
+                            }
+                        }
+                        assert j == to.length : "value live on entry of B" + toBlock.getId() + " but not on exit of B" + fromBlock.getId();
+
+                        if (moveResolver.hasMappings()) {
+                            List<LIRInstruction> instructions;
+                            int insertIdx;
+                            if (fromBlock.getSuccessorCount() <= 1) {
+                                instructions = lir.getLIRforBlock(fromBlock);
+                                insertIdx = instructions.get(instructions.size() - 1) instanceof StandardOp.JumpOp ? instructions.size() - 1 : instructions.size();
+                            } else {
+                                assert isOnlyPredecessor(fromBlock, toBlock) : "all critical edges must be broken";
+                                instructions = lir.getLIRforBlock(toBlock);
+                                insertIdx = 1;
+                            }
+                            int numInstructions = instructions.size();
+                            moveResolver.resolveAndAppendMoves(instructions, insertIdx);
+                            globalResolutionMoves.add(instructions.size() - numInstructions);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    private static boolean isOnlyPredecessor(AbstractBlockBase<?> fromBlock, AbstractBlockBase<?> toBlock) {
+        for (AbstractBlockBase<?> predecessor : toBlock.getPredecessors()) {
+            if (predecessor != fromBlock) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -24,13 +24,15 @@ package com.oracle.graal.lir.phases;
 
 import static com.oracle.graal.compiler.common.GraalOptions.*;
 
+import com.oracle.graal.lir.alloc.lsra.*;
 import com.oracle.graal.lir.constopt.*;
 import com.oracle.graal.lir.phases.PreAllocationOptimizationPhase.PreAllocationOptimizationContext;
 import com.oracle.graal.lir.ssa.*;
 
 public class PreAllocationOptimizationStage extends LIRPhaseSuite<PreAllocationOptimizationContext> {
     public PreAllocationOptimizationStage() {
-        if (SSA_LIR.getValue() && SSADestructionPhase.Options.LIREagerSSADestruction.getValue()) {
+        // the trace register allocator expects LIR that is not in SSA form
+        if (SSA_LIR.getValue() && (SSADestructionPhase.Options.LIREagerSSADestruction.getValue() || TraceRegisterAllocationPhase.Options.TraceRA.getValue())) {
             appendPhase(new SSADestructionPhase());
         }
         if (ConstantLoadOptimization.Options.LIROptConstantLoadOptimization.getValue()) {
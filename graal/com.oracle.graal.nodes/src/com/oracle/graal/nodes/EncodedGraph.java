@@ -44,9 +44,10 @@ public class EncodedGraph {
 
     /**
      * The "table of contents" of the encoded graph, i.e., the mapping from orderId numbers to the
-     * offset in the encoded byte[] array. Used as a cache during decoding.
+     * offset in the encoded byte[] array. Used as a cache during decoding. Volatile because an
+     * encoded graph can be shared by decoders running on different compiler threads.
      */
-    protected long[] nodeStartOffsets;
+    protected volatile long[] nodeStartOffsets;
 
     public EncodedGraph(byte[] encoding, long startOffset, Object[] objects, NodeClass<?>[] types, Assumptions assumptions, Set<ResolvedJavaMethod> inlinedMethods) {
         this.encoding = encoding;
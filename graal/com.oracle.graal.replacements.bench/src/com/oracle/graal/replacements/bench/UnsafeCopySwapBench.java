@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.replacements.bench;
+
+import java.lang.invoke.*;
+import java.lang.reflect.*;
+
+import org.openjdk.jmh.annotations.*;
+
+import sun.misc.*;
+
+/**
+ * Measures the throughput of {@code Unsafe.copySwapMemory} against the element by element loop
+ * that byte swapping views of heap and direct buffers otherwise use. The method only exists in
+ * class libraries that declare it; on others the {@code copySwap} benchmarks fail in setup.
+ */
+@State(Scope.Thread)
+public class UnsafeCopySwapBench {
+
+    private static final Unsafe UNSAFE;
+    private static final MethodHandle COPY_SWAP_MEMORY;
+
+    static {
+        try {
+            Field theUnsafe = Unsafe.class.getDeclaredField("theUnsafe");
+            theUnsafe.setAccessible(true);
+            UNSAFE = (Unsafe) theUnsafe.get(null);
+        } catch (Exception e) {
+            throw new Error(e);
+        }
+        MethodHandle copySwapMemory;
+        try {
+            MethodType type = MethodType.methodType(void.class, Object.class, long.class, Object.class, long.class, long.class, long.class);
+            copySwapMemory = MethodHandles.lookup().findVirtual(Unsafe.class, "copySwapMemory", type);
+        } catch (NoSuchMethodException | IllegalAccessException e) {
+            copySwapMemory = null;
+        }
+        COPY_SWAP_MEMORY = copySwapMemory;
+    }
+
+    private static final long BYTE_BASE = Unsafe.ARRAY_BYTE_BASE_OFFSET;
+
+    @Param({"2", "4", "8"}) int elemSize;
+
+    @Param({"64", "4096", "1048576"}) int bytes;
+
+    private byte[] heapSrc;
+    private byte[] heapDst;
+    private long offHeapSrc;
+    private long offHeapDst;
+
+    @Setup
+    public void setup() {
+        heapSrc = new byte[bytes];
+        heapDst = new byte[bytes];
+        for (int i = 0; i < bytes; i++) {
+            heapSrc[i] = (byte) i;
+        }
+        offHeapSrc = UNSAFE.allocateMemory(bytes);
+        offHeapDst = UNSAFE.allocateMemory(bytes);
+        UNSAFE.copyMemory(heapSrc, BYTE_BASE, null, offHeapSrc, bytes);
+    }
+
+    @TearDown
+    public void tearDown() {
+        UNSAFE.freeMemory(offHeapSrc);
+        UNSAFE.freeMemory(offHeapDst);
+    }
+
+    @Benchmark
+    public void heapLoop() {
+        loop(heapSrc, BYTE_BASE, heapDst, BYTE_BASE);
+    }
+
+    @Benchmark
+    public void heapCopySwap() throws Throwable {
+        copySwap(heapSrc, BYTE_BASE, heapDst, BYTE_BASE);
+    }
+
+    @Benchmark
+    public void offHeapLoop() {
+        loop(null, offHeapSrc, null, offHeapDst);
+    }
+
+    @Benchmark
+    public void offHeapCopySwap() throws Throwable {
+        copySwap(null, offHeapSrc, null, offHeapDst);
+    }
+
+    @Benchmark
+    public void heapToOffHeapCopySwap() throws Throwable {
+        copySwap(heapSrc, BYTE_BASE, null, offHeapDst);
+    }
+
+    private void copySwap(Object src, long srcOffset, Object dst, long dstOffset) throws Throwable {
+        if (COPY_SWAP_MEMORY == null) {
+            throw new UnsupportedOperationException("Unsafe.copySwapMemory is not available in this class library");
+        }
+        COPY_SWAP_MEMORY.invokeExact(UNSAFE, src, srcOffset, dst, dstOffset, (long) bytes, (long) elemSize);
+    }
+
+    private void loop(Object src, long srcOffset, Object dst, long dstOffset) {
+        switch (elemSize) {
+            case 2:
+                for (int i = 0; i < bytes; i += 2) {
+                    UNSAFE.putShort(dst, dstOffset + i, Short.reverseBytes(UNSAFE.getShort(src, srcOffset + i)));
+                }
+                break;
+            case 4:
+                for (int i = 0; i < bytes; i += 4) {
+                    UNSAFE.putInt(dst, dstOffset + i, Integer.reverseBytes(UNSAFE.getInt(src, srcOffset + i)));
+                }
+                break;
+            default:
+                for (int i = 0; i < bytes; i += 8) {
+                    UNSAFE.putLong(dst, dstOffset + i, Long.reverseBytes(UNSAFE.getLong(src, srcOffset + i)));
+                }
+                break;
+        }
+    }
+}
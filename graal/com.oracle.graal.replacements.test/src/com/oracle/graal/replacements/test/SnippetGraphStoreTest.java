@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.replacements.test;
+
+import java.io.*;
+import java.nio.file.*;
+import java.util.*;
+
+import jdk.internal.jvmci.meta.*;
+
+import org.junit.*;
+
+import com.oracle.graal.compiler.test.*;
+import com.oracle.graal.nodes.*;
+import com.oracle.graal.replacements.*;
+
+/**
+ * Tests that substitution graphs persisted by a {@link SnippetGraphStore} are reproduced exactly
+ * when loaded with the same fingerprint and fold results, and ignored otherwise.
+ */
+public class SnippetGraphStoreTest extends GraalCompilerTest {
+
+    private SnippetGraphStore createStore(Path file, long fingerprint) {
+        return new SnippetGraphStore(file, getTarget().arch, new SnippetObjectCodec(getMetaAccess()), fingerprint);
+    }
+
+    @Test
+    public void testRoundTrip() throws IOException {
+        ResolvedJavaMethod[] originals = {getResolvedJavaMethod(String.class, "equals", Object.class), getResolvedJavaMethod(Arrays.class, "equals", int[].class, int[].class)};
+        Path file = Files.createTempFile(getClass().getSimpleName(), ".bin");
+        try {
+            SnippetGraphStore store = createStore(file, 42);
+            Assert.assertEquals(0, store.load());
+            List<StructuredGraph> graphs = new ArrayList<>();
+            for (ResolvedJavaMethod original : originals) {
+                StructuredGraph graph = getReplacements().getSubstitution(original, -1);
+                if (graph != null) {
+                    store.record(graph.method(), graph, new SnippetGraphStore.FoldLog(null));
+                    graphs.add(graph);
+                }
+            }
+            store.write();
+
+            SnippetGraphStore loaded = createStore(file, 42);
+            Assert.assertEquals(graphs.size(), loaded.load());
+            for (StructuredGraph graph : graphs) {
+                StructuredGraph loadedGraph = loaded.lookup(graph.method());
+                Assert.assertNotNull(graph.method().toString(), loadedGraph);
+                Assert.assertTrue(GraphEncoder.verifyEncoding(graph, GraphEncoder.encodeSingleGraph(loadedGraph, getTarget().arch), getTarget().arch));
+            }
+
+            SnippetGraphStore stale = createStore(file, 43);
+            Assert.assertEquals(0, stale.load());
+            for (StructuredGraph graph : graphs) {
+                Assert.assertNull(stale.lookup(graph.method()));
+            }
+        } finally {
+            Files.deleteIfExists(file);
+        }
+    }
+
+    public static long foldedAddress() {
+        return 0x1000;
+    }
+
+    @Test
+    public void testStaleFold() throws IOException {
+        ResolvedJavaMethod original = getResolvedJavaMethod(String.class, "equals", Object.class);
+        StructuredGraph graph = getReplacements().getSubstitution(original, -1);
+        Assume.assumeNotNull(graph);
+        ResolvedJavaMethod fold = getResolvedJavaMethod(SnippetGraphStoreTest.class, "foldedAddress");
+        Path file = Files.createTempFile(getClass().getSimpleName(), ".bin");
+        try {
+            // Pretend a previous VM run folded a different address
+            SnippetGraphStore.FoldLog folds = new SnippetGraphStore.FoldLog(null);
+            folds.recordFold(fold, new JavaConstant[0], JavaConstant.forLong(0x2000));
+            SnippetGraphStore store = createStore(file, 42);
+            store.record(graph.method(), graph, folds);
+            store.write();
+
+            SnippetGraphStore loaded = createStore(file, 42);
+            Assert.assertEquals(1, loaded.load());
+            Assert.assertNull(loaded.lookup(graph.method()));
+            Assert.assertEquals(0, loaded.size());
+        } finally {
+            Files.deleteIfExists(file);
+        }
+    }
+
+    @Test
+    public void testCorruptLength() throws IOException {
+        ResolvedJavaMethod original = getResolvedJavaMethod(String.class, "equals", Object.class);
+        StructuredGraph graph = getReplacements().getSubstitution(original, -1);
+        Assume.assumeNotNull(graph);
+        Path file = Files.createTempFile(getClass().getSimpleName(), ".bin");
+        try {
+            SnippetGraphStore store = createStore(file, 42);
+            store.record(graph.method(), graph, new SnippetGraphStore.FoldLog(null));
+            store.write();
+            byte[] bytes = Files.readAllBytes(file);
+
+            // magic, version and fingerprint precede the entry count
+            int countOffset = 16;
+            int keyLength = ((bytes[countOffset + 4] & 0xff) << 8) | (bytes[countOffset + 5] & 0xff);
+            int entryLengthOffset = countOffset + 4 + 2 + keyLength;
+            for (int offset : new int[]{countOffset, entryLengthOffset}) {
+                for (int length : new int[]{-1, Integer.MAX_VALUE}) {
+                    byte[] corrupt = bytes.clone();
+                    corrupt[offset] = (byte) (length >>> 24);
+                    corrupt[offset + 1] = (byte) (length >>> 16);
+                    corrupt[offset + 2] = (byte) (length >>> 8);
+                    corrupt[offset + 3] = (byte) length;
+                    Files.write(file, corrupt);
+                    SnippetGraphStore loaded = createStore(file, 42);
+                    Assert.assertEquals(0, loaded.load());
+                    Assert.assertEquals(0, loaded.size());
+                }
+            }
+        } finally {
+            Files.deleteIfExists(file);
+        }
+    }
+}
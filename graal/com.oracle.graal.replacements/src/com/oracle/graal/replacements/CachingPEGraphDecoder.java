@@ -65,14 +65,16 @@ public class CachingPEGraphDecoder extends PEGraphDecoder {
         StructuredGraph graph = new StructuredGraph(method, allowAssumptions);
         try (Debug.Scope scope = Debug.scope("createGraph", graph)) {
 
+            Providers parsingProviders = getParsingProviders();
             IntrinsicContext initialIntrinsicContext = isIntrinsic ? new IntrinsicContext(method, method, INLINE_AFTER_PARSING) : null;
-            new GraphBuilderPhase.Instance(providers.getMetaAccess(), providers.getStampProvider(), providers.getConstantReflection(), graphBuilderConfig, optimisticOpts, initialIntrinsicContext).apply(graph);
+            new GraphBuilderPhase.Instance(parsingProviders.getMetaAccess(), parsingProviders.getStampProvider(), parsingProviders.getConstantReflection(), graphBuilderConfig, optimisticOpts,
+                            initialIntrinsicContext).apply(graph);
 
-            PhaseContext context = new PhaseContext(providers);
+            PhaseContext context = new PhaseContext(parsingProviders);
             new CanonicalizerPhase().apply(graph, context);
 
             EncodedGraph encodedGraph = GraphEncoder.encodeSingleGraph(graph, architecture);
-            graphCache.put(method, encodedGraph);
+            cacheGraph(method, encodedGraph);
             return encodedGraph;
 
         } catch (Throwable ex) {
@@ -80,9 +82,30 @@ public class CachingPEGraphDecoder extends PEGraphDecoder {
         }
     }
 
+    /**
+     * Returns the providers used to parse and canonicalize the graphs before they are encoded. The
+     * providers passed to the constructor are still used when decoding.
+     */
+    protected Providers getParsingProviders() {
+        return providers;
+    }
+
+    /**
+     * Returns the previously encoded graph for {@code method}, or null if the method has not been
+     * parsed yet. Subclasses can override this and {@link #cacheGraph} to share encoded graphs
+     * beyond the lifetime of this decoder.
+     */
+    protected EncodedGraph lookupCachedGraph(ResolvedJavaMethod method) {
+        return graphCache.get(method);
+    }
+
+    protected void cacheGraph(ResolvedJavaMethod method, EncodedGraph encodedGraph) {
+        graphCache.put(method, encodedGraph);
+    }
+
     @Override
     protected EncodedGraph lookupEncodedGraph(ResolvedJavaMethod method, boolean isIntrinsic) {
-        EncodedGraph result = graphCache.get(method);
+        EncodedGraph result = lookupCachedGraph(method);
         if (result == null && method.hasBytecodes()) {
             result = createGraph(method, isIntrinsic);
         }
@@ -59,6 +59,31 @@ public class NodeIntrinsificationPhase extends Phase {
     private final ForeignCallsProvider foreignCalls;
     private final StampProvider stampProvider;
 
+    /**
+     * Receives the results of the {@link Fold} and foldable {@link NodeIntrinsic} invocations
+     * performed by the current thread.
+     */
+    public interface FoldRecorder {
+        void recordFold(ResolvedJavaMethod method, JavaConstant[] args, JavaConstant result);
+    }
+
+    private static final ThreadLocal<FoldRecorder> foldRecorder = new ThreadLocal<>();
+
+    public static FoldRecorder getFoldRecorder() {
+        return foldRecorder.get();
+    }
+
+    /**
+     * Sets the recorder for the folds performed by the current thread.
+     *
+     * @return the previous recorder of the current thread
+     */
+    public static FoldRecorder setFoldRecorder(FoldRecorder recorder) {
+        FoldRecorder previous = foldRecorder.get();
+        foldRecorder.set(recorder);
+        return previous;
+    }
+
     public NodeIntrinsificationPhase(MetaAccessProvider metaAccess, ConstantReflectionProvider constantReflection, SnippetReflectionProvider snippetReflection, ForeignCallsProvider foreignCalls,
                     StampProvider stampProvider) {
         this.metaAccess = metaAccess;
@@ -140,7 +165,12 @@ public class NodeIntrinsificationPhase extends Phase {
         }
 
         // Call the method
-        return target.invoke(receiver, reflectArgs);
+        JavaConstant result = target.invoke(receiver, reflectArgs);
+        FoldRecorder recorder = foldRecorder.get();
+        if (recorder != null) {
+            recorder.recordFold(target, reflectArgs, result);
+        }
+        return result;
     }
 
     private static boolean areAllConstant(List<ValueNode> arguments) {
@@ -307,13 +307,31 @@ public abstract class PEGraphDecoder extends SimplifyingGraphDecoder {
 
     public void decode(StructuredGraph targetGraph, ResolvedJavaMethod method, LoopExplosionPlugin loopExplosionPlugin, InvocationPlugins invocationPlugins, InlineInvokePlugin[] inlineInvokePlugins,
                     ParameterPlugin parameterPlugin) {
-        PEMethodScope methodScope = new PEMethodScope(targetGraph, null, null, lookupEncodedGraph(method, false), method, null, 0, loopExplosionPlugin, invocationPlugins, inlineInvokePlugins,
-                        parameterPlugin, null);
+        EncodedGraph encodedGraph = lookupEncodedGraph(method, false);
+        recordGraphDependencies(targetGraph, encodedGraph);
+        PEMethodScope methodScope = new PEMethodScope(targetGraph, null, null, encodedGraph, method, null, 0, loopExplosionPlugin, invocationPlugins, inlineInvokePlugins, parameterPlugin, null);
         decode(methodScope, null);
         cleanupGraph(methodScope, null);
         methodScope.graph.verify();
     }
 
+    /**
+     * Transfers the assumptions and inlined methods an encoded graph was parsed under to the graph
+     * it is decoded into. Without this, speculations made while parsing (e.g., a devirtualization
+     * based on a leaf type) would not be registered with the resulting code.
+     */
+    protected static void recordGraphDependencies(StructuredGraph targetGraph, EncodedGraph encodedGraph) {
+        if (encodedGraph.getAssumptions() != null && !encodedGraph.getAssumptions().isEmpty()) {
+            assert targetGraph.getAssumptions() != null : "encoded graph with assumptions decoded into a graph that does not allow assumptions";
+            targetGraph.getAssumptions().record(encodedGraph.getAssumptions());
+        }
+        if (encodedGraph.getInlinedMethods() != null) {
+            for (ResolvedJavaMethod inlinedMethod : encodedGraph.getInlinedMethods()) {
+                targetGraph.recordInlinedMethod(inlinedMethod);
+            }
+        }
+    }
+
     @Override
     protected void checkLoopExplosionIteration(MethodScope s, LoopScope loopScope) {
         PEMethodScope methodScope = (PEMethodScope) s;
@@ -454,6 +472,9 @@ public abstract class PEGraphDecoder extends SimplifyingGraphDecoder {
             plugin.notifyBeforeInline(inlineMethod);
         }
 
+        methodScope.graph.recordInlinedMethod(inlineMethod);
+        recordGraphDependencies(methodScope.graph, graphToInline);
+
         Invoke invoke = invokeData.invoke;
         FixedNode invokeNode = invoke.asNode();
         FixedWithNextNode predecessor = (FixedWithNextNode) invokeNode.predecessor();
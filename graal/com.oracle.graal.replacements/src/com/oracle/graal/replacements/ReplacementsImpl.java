@@ -73,6 +73,19 @@ public class ReplacementsImpl implements Replacements, InlineInvokePlugin {
      */
     protected final ConcurrentMap<ResolvedJavaMethod, StructuredGraph> graphs;
 
+    /**
+     * Prepared replacement graphs persisted by a previous VM run (may be null).
+     */
+    private SnippetGraphStore graphStore;
+
+    public void setGraphStore(SnippetGraphStore graphStore) {
+        this.graphStore = graphStore;
+    }
+
+    public SnippetGraphStore getGraphStore() {
+        return graphStore;
+    }
+
     public void setGraphBuilderPlugins(GraphBuilderConfiguration.Plugins plugins) {
         assert this.graphBuilderPlugins == null;
         this.graphBuilderPlugins = plugins;
@@ -302,7 +315,7 @@ public class ReplacementsImpl implements Replacements, InlineInvokePlugin {
         StructuredGraph graph = UseSnippetGraphCache ? graphs.get(method) : null;
         if (graph == null) {
             try (DebugCloseable a = SnippetPreparationTime.start()) {
-                StructuredGraph newGraph = makeGraph(method, args, recursiveEntry);
+                StructuredGraph newGraph = args == null ? makeStoredGraph(method, recursiveEntry) : makeGraph(method, args, recursiveEntry);
                 Debug.metric("SnippetNodeCount[%#s]", method).add(newGraph.getNodeCount());
                 if (!UseSnippetGraphCache || args != null) {
                     return newGraph;
@@ -347,7 +360,7 @@ public class ReplacementsImpl implements Replacements, InlineInvokePlugin {
         }
         StructuredGraph graph = graphs.get(substitute);
         if (graph == null) {
-            graph = makeGraph(substitute, null, original);
+            graph = makeStoredGraph(substitute, original);
             graph.freeze();
             graphs.putIfAbsent(substitute, graph);
             graph = graphs.get(substitute);
@@ -357,6 +370,32 @@ public class ReplacementsImpl implements Replacements, InlineInvokePlugin {
 
     }
 
+    /**
+     * Gets the graph for {@code method} from the {@link #graphStore} or prepares it and adds it to
+     * the store. The folds evaluated while preparing the graph are recorded with it. If this is
+     * nested in the preparation of another graph, the graph is always prepared so that its folds
+     * are also recorded for the enclosing graph.
+     */
+    private StructuredGraph makeStoredGraph(ResolvedJavaMethod method, ResolvedJavaMethod original) {
+        SnippetGraphStore store = graphStore;
+        if (store == null) {
+            return makeGraph(method, null, original);
+        }
+        NodeIntrinsificationPhase.FoldRecorder outer = NodeIntrinsificationPhase.getFoldRecorder();
+        StructuredGraph graph = outer == null ? store.lookup(method) : null;
+        if (graph == null) {
+            SnippetGraphStore.FoldLog folds = new SnippetGraphStore.FoldLog(outer);
+            NodeIntrinsificationPhase.setFoldRecorder(folds);
+            try {
+                graph = makeGraph(method, null, original);
+            } finally {
+                NodeIntrinsificationPhase.setFoldRecorder(outer);
+            }
+            store.record(method, graph, folds);
+        }
+        return graph;
+    }
+
     private SubstitutionGuard getGuard(Class<? extends SubstitutionGuard> guardClass) {
         if (guardClass != SubstitutionGuard.class) {
             Constructor<?>[] constructors = guardClass.getConstructors();
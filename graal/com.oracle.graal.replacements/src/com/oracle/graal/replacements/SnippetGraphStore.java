@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.replacements;
+
+import java.io.*;
+import java.nio.file.*;
+import java.util.*;
+import java.util.concurrent.*;
+
+import jdk.internal.jvmci.code.*;
+import jdk.internal.jvmci.common.*;
+import jdk.internal.jvmci.debug.*;
+import jdk.internal.jvmci.meta.*;
+
+import com.oracle.graal.api.replacements.*;
+import com.oracle.graal.graph.*;
+import com.oracle.graal.nodes.*;
+import com.oracle.graal.nodes.StructuredGraph.AllowAssumptions;
+
+/**
+ * A file backed store of prepared snippet and substitution graphs. Graphs are kept in the
+ * {@link GraphEncoder} format with their object tables written by a {@link SnippetObjectCodec}.
+ * The file is only used if its fingerprint matches the fingerprint of the running VM, which is
+ * expected to cover the values that are stable across VM runs and can influence snippet
+ * preparation (VM configuration, options and the compiler build).
+ *
+ * Values that change between runs, such as the addresses of VM data structures, are not part of
+ * the fingerprint. They are folded into the graphs by {@link Fold} methods without arguments.
+ * Each entry records the results of these folds, and a graph is only used if re-evaluating them in
+ * the running VM yields the same results.
+ */
+public class SnippetGraphStore {
+
+    private static final int MAGIC = 0x534e4750;
+    private static final int VERSION = 2;
+
+    private static final DebugMetric Hits = Debug.metric("SnippetGraphStore[hits]");
+    private static final DebugMetric Misses = Debug.metric("SnippetGraphStore[misses]");
+    private static final DebugMetric Recorded = Debug.metric("SnippetGraphStore[recorded]");
+    private static final DebugMetric Unsupported = Debug.metric("SnippetGraphStore[unsupported]");
+    private static final DebugMetric Invalid = Debug.metric("SnippetGraphStore[invalid]");
+    private static final DebugMetric Stale = Debug.metric("SnippetGraphStore[stale]");
+    private static final DebugTimer LoadTime = Debug.timer("SnippetGraphStore[load]");
+
+    private final Path file;
+    private final Architecture architecture;
+    private final SnippetObjectCodec codec;
+    private final long fingerprint;
+
+    /**
+     * Encoded entries read from or to be written to {@link #file}, keyed by {@link #key}.
+     */
+    private final ConcurrentMap<String, byte[]> entries = new ConcurrentHashMap<>();
+    private volatile boolean dirty;
+
+    public SnippetGraphStore(Path file, Architecture architecture, SnippetObjectCodec codec, long fingerprint) {
+        this.file = file;
+        this.architecture = architecture;
+        this.codec = codec;
+        this.fingerprint = fingerprint;
+    }
+
+    public Path getFile() {
+        return file;
+    }
+
+    /**
+     * Gets the number of graphs in this store.
+     */
+    public int size() {
+        return entries.size();
+    }
+
+    /**
+     * The results of the {@link Fold} methods without arguments evaluated while preparing a graph.
+     * Folds with arguments only depend on their (constant) arguments and on values covered by the
+     * fingerprint, so they are not recorded.
+     */
+    public static final class FoldLog implements NodeIntrinsificationPhase.FoldRecorder {
+        private final NodeIntrinsificationPhase.FoldRecorder outer;
+        private final Map<ResolvedJavaMethod, JavaConstant> folds = new LinkedHashMap<>();
+
+        /**
+         * @param outer the recorder of an enclosing graph preparation on the same thread (may be
+         *            null), which also receives the folds recorded by this log
+         */
+        public FoldLog(NodeIntrinsificationPhase.FoldRecorder outer) {
+            this.outer = outer;
+        }
+
+        @Override
+        public void recordFold(ResolvedJavaMethod method, JavaConstant[] args, JavaConstant result) {
+            if (method.isStatic() && args.length == 0 && result.getKind().isPrimitive()) {
+                folds.put(method, result);
+            }
+            if (outer != null) {
+                outer.recordFold(method, args, result);
+            }
+        }
+    }
+
+    private static String key(ResolvedJavaMethod method) {
+        return method.getDeclaringClass().getName() + "." + method.getName() + method.getSignature().toMethodDescriptor();
+    }
+
+    /**
+     * Reads the entries of {@link #file} if it exists and was written for the same fingerprint.
+     *
+     * @return the number of entries read
+     */
+    public int load() {
+        if (!Files.isReadable(file)) {
+            return 0;
+        }
+        try (DebugCloseable a = LoadTime.start(); DataInputStream in = new DataInputStream(new BufferedInputStream(Files.newInputStream(file)))) {
+            if (in.readInt() != MAGIC || in.readInt() != VERSION || in.readLong() != fingerprint) {
+                // Written by a different VM configuration. It will be overwritten.
+                dirty = true;
+                return 0;
+            }
+            // lengths are checked so that a corrupt file cannot cause huge allocations
+            long size = Files.size(file);
+            int count = readLength(in, size);
+            for (int i = 0; i < count; i++) {
+                String key = in.readUTF();
+                byte[] entry = new byte[readLength(in, size)];
+                in.readFully(entry);
+                entries.put(key, entry);
+            }
+            return count;
+        } catch (IOException e) {
+            entries.clear();
+            dirty = true;
+            return 0;
+        }
+    }
+
+    /**
+     * Gets a copy of the prepared graph for {@code method} from this store.
+     *
+     * @return null if there is no (valid) graph for {@code method} in this store
+     */
+    public StructuredGraph lookup(ResolvedJavaMethod method) {
+        byte[] entry = entries.get(key(method));
+        if (entry == null) {
+            Misses.increment();
+            return null;
+        }
+        try (Debug.Scope s = Debug.scope("SnippetGraphStore", method)) {
+            EncodedGraph encodedGraph = readEntry(entry, true);
+            if (encodedGraph == null) {
+                // Folded a value that differs in this VM run
+                Stale.increment();
+                entries.remove(key(method));
+                dirty = true;
+                return null;
+            }
+            StructuredGraph graph = new StructuredGraph(method, AllowAssumptions.NO);
+            graph.disableInlinedMethodRecording();
+            graph.disableUnsafeAccessTracking();
+            new GraphDecoder(architecture).decode(graph, encodedGraph);
+            Hits.increment();
+            Debug.dump(graph, "%s: Loaded", method.getName());
+            return graph;
+        } catch (Throwable e) {
+            // Fall back to preparing the graph and replace the stale entry
+            Invalid.increment();
+            entries.remove(key(method));
+            dirty = true;
+            return null;
+        }
+    }
+
+    /**
+     * Adds the prepared graph for {@code method} to this store. Graphs that reference objects that
+     * cannot be persisted by {@link SnippetObjectCodec} are ignored.
+     *
+     * @param folds the folds evaluated while preparing {@code graph}
+     */
+    public void record(ResolvedJavaMethod method, StructuredGraph graph, FoldLog folds) {
+        codec.registerHolder(method.getDeclaringClass());
+        EncodedGraph encodedGraph = GraphEncoder.encodeSingleGraph(graph, architecture);
+        byte[] entry;
+        try {
+            entry = writeEntry(encodedGraph, folds);
+        } catch (SnippetObjectCodec.UnsupportedObjectException e) {
+            Unsupported.increment();
+            return;
+        } catch (IOException e) {
+            throw new JVMCIError(e);
+        }
+        assert verifyEntry(graph, entry);
+        if (entries.putIfAbsent(key(method), entry) == null) {
+            Recorded.increment();
+            dirty = true;
+        }
+    }
+
+    private boolean verifyEntry(StructuredGraph graph, byte[] entry) {
+        try {
+            return GraphEncoder.verifyEncoding(graph, readEntry(entry, false), architecture);
+        } catch (IOException e) {
+            throw new JVMCIError(e);
+        }
+    }
+
+    /**
+     * Writes the entries of this store to {@link #file} if they changed since they were loaded.
+     */
+    public void write() throws IOException {
+        if (!dirty) {
+            return;
+        }
+        Path dir = file.toAbsolutePath().getParent();
+        Path tmp = Files.createTempFile(dir, file.getFileName().toString(), ".tmp");
+        try (DataOutputStream out = new DataOutputStream(new BufferedOutputStream(Files.newOutputStream(tmp)))) {
+            out.writeInt(MAGIC);
+            out.writeInt(VERSION);
+            out.writeLong(fingerprint);
+            Map<String, byte[]> snapshot = new TreeMap<>(entries);
+            out.writeInt(snapshot.size());
+            for (Map.Entry<String, byte[]> e : snapshot.entrySet()) {
+                out.writeUTF(e.getKey());
+                out.writeInt(e.getValue().length);
+                out.write(e.getValue());
+            }
+        }
+        Files.move(tmp, file, StandardCopyOption.REPLACE_EXISTING, StandardCopyOption.ATOMIC_MOVE);
+        dirty = false;
+    }
+
+    private byte[] writeEntry(EncodedGraph encodedGraph, FoldLog folds) throws IOException {
+        ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+        try (DataOutputStream out = new DataOutputStream(bytes)) {
+            out.writeInt(folds.folds.size());
+            for (Map.Entry<ResolvedJavaMethod, JavaConstant> e : folds.folds.entrySet()) {
+                codec.write(out, e.getKey());
+                codec.write(out, e.getValue());
+            }
+            out.writeLong(encodedGraph.getStartOffset());
+            out.writeInt(encodedGraph.getEncoding().length);
+            out.write(encodedGraph.getEncoding());
+            NodeClass<?>[] types = encodedGraph.getNodeClasses();
+            out.writeInt(types.length);
+            for (NodeClass<?> type : types) {
+                out.writeUTF(type.getJavaClass().getName());
+            }
+            Object[] objects = encodedGraph.getObjects();
+            out.writeInt(objects.length);
+            for (Object object : objects) {
+                codec.write(out, object);
+            }
+        }
+        return bytes.toByteArray();
+    }
+
+    /**
+     * Decodes an entry.
+     *
+     * @param checkFolds specifies if the recorded folds are re-evaluated
+     * @return null if a recorded fold has a different result in this VM run
+     */
+    private EncodedGraph readEntry(byte[] entry, boolean checkFolds) throws IOException {
+        try (DataInputStream in = new DataInputStream(new ByteArrayInputStream(entry))) {
+            int foldCount = readLength(in, entry.length);
+            for (int i = 0; i < foldCount; i++) {
+                ResolvedJavaMethod method = (ResolvedJavaMethod) codec.read(in);
+                JavaConstant result = (JavaConstant) codec.read(in);
+                if (checkFolds && !result.equals(method.invoke(null, new JavaConstant[0]))) {
+                    return null;
+                }
+            }
+            long startOffset = in.readLong();
+            byte[] encoding = new byte[readLength(in, entry.length)];
+            in.readFully(encoding);
+            NodeClass<?>[] types = new NodeClass<?>[readLength(in, entry.length)];
+            for (int i = 0; i < types.length; i++) {
+                Class<?> nodeClass = ReplacementsImpl.resolveClass(in.readUTF(), true);
+                if (nodeClass == null) {
+                    throw new IOException("cannot resolve node class");
+                }
+                types[i] = NodeClass.get(nodeClass);
+            }
+            Object[] objects = new Object[readLength(in, entry.length)];
+            for (int i = 0; i < objects.length; i++) {
+                objects[i] = codec.read(in);
+            }
+            return new EncodedGraph(encoding, startOffset, objects, types, null, null);
+        }
+    }
+
+    /**
+     * Reads a length or count from {@code in} that is valid only if it does not exceed
+     * {@code limit}, the size of the input it is read from.
+     */
+    private static int readLength(DataInputStream in, long limit) throws IOException {
+        int length = in.readInt();
+        if (length < 0 || length > limit) {
+            throw new IOException("invalid length " + length);
+        }
+        return length;
+    }
+}
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.replacements;
+
+import java.io.*;
+import java.lang.reflect.*;
+import java.util.*;
+
+import jdk.internal.jvmci.common.*;
+import jdk.internal.jvmci.meta.*;
+
+import com.oracle.graal.compiler.common.type.*;
+import com.oracle.graal.nodes.*;
+
+/**
+ * Writes and reads the objects referenced by an {@link EncodedGraph} in a form that is independent
+ * of the VM instance, e.g., {@link ResolvedJavaMethod}s by name and signature. Objects that are
+ * compared by identity are written as references to the static final field that holds them.
+ * Objects of {@linkplain #registerValueClass value classes} are written field by field.
+ *
+ * @see SnippetGraphStore
+ */
+public class SnippetObjectCodec {
+
+    /**
+     * Thrown if an object cannot be written in a VM independent form.
+     */
+    public static class UnsupportedObjectException extends IOException {
+
+        private static final long serialVersionUID = -3471258924531934425L;
+
+        public UnsupportedObjectException(Object object) {
+            super("cannot persist " + object + " of " + object.getClass());
+        }
+    }
+
+    private static final byte NULL = 0;
+    private static final byte STRING = 1;
+    private static final byte BOXED = 2;
+    private static final byte ENUM = 3;
+    private static final byte CLASS = 4;
+    private static final byte TYPE = 5;
+    private static final byte METHOD = 6;
+    private static final byte FIELD = 7;
+    private static final byte NULL_CONSTANT = 8;
+    private static final byte PRIMITIVE_CONSTANT = 9;
+    private static final byte ARRAY_LOCATION = 10;
+    private static final byte STATIC_FIELD = 11;
+    private static final byte ARRAY = 12;
+    private static final byte VALUE = 13;
+
+    private final MetaAccessProvider metaAccess;
+    private final Set<Class<?>> holders = new HashSet<>();
+    private final List<Class<?>> valueClasses = new ArrayList<>();
+    private final Map<Object, Field> staticFieldValues = new IdentityHashMap<>();
+
+    public SnippetObjectCodec(MetaAccessProvider metaAccess) {
+        this.metaAccess = metaAccess;
+        registerHolder(LocationIdentity.class);
+        registerValueClass(Stamp.class);
+    }
+
+    /**
+     * Registers a class whose static final fields hold objects referenced by snippet graphs, e.g.,
+     * {@link LocationIdentity}s or {@link ForeignCallDescriptor}s.
+     */
+    public synchronized void registerHolder(Class<?> holder) {
+        if (holders.add(holder)) {
+            for (Field field : holder.getDeclaredFields()) {
+                if (Modifier.isStatic(field.getModifiers()) && Modifier.isFinal(field.getModifiers()) && !field.getType().isPrimitive()) {
+                    try {
+                        field.setAccessible(true);
+                        Object value = field.get(null);
+                        if (value != null && !staticFieldValues.containsKey(value)) {
+                            staticFieldValues.put(value, field);
+                        }
+                    } catch (IllegalAccessException e) {
+                        throw new JVMCIError(e);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Registers the class represented by {@code holder} as a holder of objects referenced by snippet
+     * graphs.
+     *
+     * @see #registerHolder(Class)
+     */
+    public void registerHolder(ResolvedJavaType holder) {
+        try {
+            registerHolder(toClass(holder.getName()));
+        } catch (IOException e) {
+            // Not visible to the launcher class loader
+        }
+    }
+
+    /**
+     * Registers a class (and its subclasses) whose instances are immutable values that can be
+     * written field by field.
+     */
+    public synchronized void registerValueClass(Class<?> valueClass) {
+        valueClasses.add(valueClass);
+    }
+
+    private boolean isValueClass(Class<?> c) {
+        for (Class<?> valueClass : valueClasses) {
+            if (valueClass.isAssignableFrom(c)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    public synchronized void write(DataOutputStream out, Object object) throws IOException {
+        if (object == null) {
+            out.writeByte(NULL);
+        } else if (object instanceof String) {
+            out.writeByte(STRING);
+            out.writeUTF((String) object);
+        } else if (object instanceof Enum) {
+            out.writeByte(ENUM);
+            out.writeUTF(((Enum<?>) object).getDeclaringClass().getName());
+            out.writeUTF(((Enum<?>) object).name());
+        } else if (object instanceof Class) {
+            out.writeByte(CLASS);
+            out.writeUTF(((Class<?>) object).getName());
+        } else if (object instanceof ResolvedJavaType) {
+            out.writeByte(TYPE);
+            out.writeUTF(((ResolvedJavaType) object).getName());
+        } else if (object instanceof ResolvedJavaMethod) {
+            ResolvedJavaMethod method = (ResolvedJavaMethod) object;
+            out.writeByte(METHOD);
+            out.writeUTF(method.getDeclaringClass().getName());
+            out.writeUTF(method.getName());
+            out.writeUTF(method.getSignature().toMethodDescriptor());
+        } else if (object instanceof ResolvedJavaField) {
+            ResolvedJavaField field = (ResolvedJavaField) object;
+            out.writeByte(FIELD);
+            out.writeUTF(field.getDeclaringClass().getName());
+            out.writeUTF(field.getName());
+            out.writeBoolean(field.isStatic());
+        } else if (object instanceof JavaConstant) {
+            writeConstant(out, (JavaConstant) object);
+        } else if (JavaConstant.forBoxedPrimitive(object) != null) {
+            out.writeByte(BOXED);
+            writeConstant(out, JavaConstant.forBoxedPrimitive(object));
+        } else {
+            registerHolders(object.getClass());
+            Field field = staticFieldValues.get(object);
+            if (field != null) {
+                out.writeByte(STATIC_FIELD);
+                out.writeUTF(field.getDeclaringClass().getName());
+                out.writeUTF(field.getName());
+            } else if (object instanceof LocationIdentity && arrayLocationKind((LocationIdentity) object) != null) {
+                out.writeByte(ARRAY_LOCATION);
+                out.writeUTF(arrayLocationKind((LocationIdentity) object).name());
+            } else if (object.getClass().isArray()) {
+                out.writeByte(ARRAY);
+                out.writeUTF(object.getClass().getComponentType().getName());
+                int length = Array.getLength(object);
+                out.writeInt(length);
+                for (int i = 0; i < length; i++) {
+                    write(out, Array.get(object, i));
+                }
+            } else if (isValueClass(object.getClass())) {
+                out.writeByte(VALUE);
+                out.writeUTF(object.getClass().getName());
+                for (Field f : instanceFields(object.getClass())) {
+                    try {
+                        write(out, f.get(object));
+                    } catch (IllegalAccessException e) {
+                        throw new JVMCIError(e);
+                    }
+                }
+            } else {
+                throw new UnsupportedObjectException(object);
+            }
+        }
+    }
+
+    private void registerHolders(Class<?> c) {
+        for (Class<?> holder = c; holder != null && holder != Object.class; holder = holder.getSuperclass()) {
+            registerHolder(holder);
+        }
+    }
+
+    private static Kind arrayLocationKind(LocationIdentity location) {
+        for (Kind kind : Kind.values()) {
+            if (NamedLocationIdentity.getArrayLocation(kind) == location) {
+                return kind;
+            }
+        }
+        return null;
+    }
+
+    private static void writeConstant(DataOutputStream out, JavaConstant constant) throws IOException {
+        if (constant == JavaConstant.NULL_POINTER) {
+            out.writeByte(NULL_CONSTANT);
+        } else if (constant instanceof PrimitiveConstant) {
+            out.writeByte(PRIMITIVE_CONSTANT);
+            out.writeUTF(constant.getKind().name());
+            switch (constant.getKind()) {
+                case Float:
+                    out.writeInt(Float.floatToRawIntBits(constant.asFloat()));
+                    break;
+                case Double:
+                    out.writeLong(Double.doubleToRawLongBits(constant.asDouble()));
+                    break;
+                case Illegal:
+                    break;
+                case Boolean:
+                    out.writeBoolean(constant.asBoolean());
+                    break;
+                default:
+                    out.writeLong(constant.asLong());
+                    break;
+            }
+        } else {
+            throw new UnsupportedObjectException(constant);
+        }
+    }
+
+    public Object read(DataInputStream in) throws IOException {
+        byte tag = in.readByte();
+        switch (tag) {
+            case NULL:
+                return null;
+            case STRING:
+                return in.readUTF();
+            case ENUM:
+                return readEnum(resolveClass(in.readUTF()), in.readUTF());
+            case CLASS:
+                return resolveClass(in.readUTF());
+            case TYPE:
+                return lookupType(in.readUTF());
+            case METHOD:
+                return lookupMethod(lookupType(in.readUTF()), in.readUTF(), in.readUTF());
+            case FIELD:
+                return lookupField(lookupType(in.readUTF()), in.readUTF(), in.readBoolean());
+            case BOXED:
+                return ((PrimitiveConstant) readConstant(in, in.readByte())).asBoxedPrimitive();
+            case NULL_CONSTANT:
+            case PRIMITIVE_CONSTANT:
+                return readConstant(in, tag);
+            case STATIC_FIELD:
+                return readStaticField(resolveClass(in.readUTF()), in.readUTF());
+            case ARRAY_LOCATION:
+                return NamedLocationIdentity.getArrayLocation(Kind.valueOf(in.readUTF()));
+            case ARRAY: {
+                Class<?> componentType = resolveClass(in.readUTF());
+                int length = in.readInt();
+                // every element takes at least one byte
+                if (length < 0 || length > in.available()) {
+                    throw new IOException("invalid array length " + length);
+                }
+                Object array = Array.newInstance(componentType, length);
+                for (int i = 0; i < length; i++) {
+                    Array.set(array, i, read(in));
+                }
+                return array;
+            }
+            case VALUE:
+                return readValue(in, resolveClass(in.readUTF()));
+            default:
+                throw new IOException("invalid tag " + tag);
+        }
+    }
+
+    @SuppressWarnings({"unchecked", "rawtypes"})
+    private static Object readEnum(Class<?> enumClass, String name) {
+        return Enum.valueOf((Class) enumClass, name);
+    }
+
+    private static JavaConstant readConstant(DataInputStream in, byte tag) throws IOException {
+        if (tag == NULL_CONSTANT) {
+            return JavaConstant.NULL_POINTER;
+        }
+        if (tag != PRIMITIVE_CONSTANT) {
+            throw new IOException("invalid constant tag " + tag);
+        }
+        Kind kind = Kind.valueOf(in.readUTF());
+        switch (kind) {
+            case Float:
+                return JavaConstant.forFloat(Float.intBitsToFloat(in.readInt()));
+            case Double:
+                return JavaConstant.forDouble(Double.longBitsToDouble(in.readLong()));
+            case Illegal:
+                return JavaConstant.forIllegal();
+            case Boolean:
+                return JavaConstant.forBoolean(in.readBoolean());
+            default:
+                return JavaConstant.forIntegerKind(kind, in.readLong());
+        }
+    }
+
+    private static Object readStaticField(Class<?> holder, String name) throws IOException {
+        try {
+            Field field = holder.getDeclaredField(name);
+            field.setAccessible(true);
+            return field.get(null);
+        } catch (NoSuchFieldException | IllegalAccessException e) {
+            throw new IOException(e);
+        }
+    }
+
+    private Object readValue(DataInputStream in, Class<?> c) throws IOException {
+        if (!isValueClass(c)) {
+            throw new IOException("not a value class: " + c);
+        }
+        try {
+            Object object = UnsafeAccess.unsafe.allocateInstance(c);
+            for (Field f : instanceFields(c)) {
+                Object value = read(in);
+                if (f.getType().isPrimitive() && value == null) {
+                    throw new IOException("missing value for " + f);
+                }
+                f.set(object, value);
+            }
+            return object;
+        } catch (InstantiationException | IllegalAccessException | IllegalArgumentException e) {
+            throw new IOException(e);
+        }
+    }
+
+    /**
+     * Gets the instance fields of {@code c} and its superclasses in a stable order.
+     */
+    private static List<Field> instanceFields(Class<?> c) {
+        List<Field> result = new ArrayList<>();
+        for (Class<?> current = c; current != Object.class; current = current.getSuperclass()) {
+            Field[] declared = current.getDeclaredFields();
+            Arrays.sort(declared, (a, b) -> a.getName().compareTo(b.getName()));
+            for (Field f : declared) {
+                if (!Modifier.isStatic(f.getModifiers())) {
+                    f.setAccessible(true);
+                    result.add(f);
+                }
+            }
+        }
+        return result;
+    }
+
+    private static Class<?> resolveClass(String name) throws IOException {
+        for (Kind kind : Kind.values()) {
+            if ((kind.isPrimitive() || kind == Kind.Void) && kind.getJavaName().equals(name)) {
+                return kind.toJavaClass();
+            }
+        }
+        Class<?> c = ReplacementsImpl.resolveClass(name, true);
+        if (c == null) {
+            throw new IOException("cannot resolve class " + name);
+        }
+        return c;
+    }
+
+    private ResolvedJavaType lookupType(String descriptor) throws IOException {
+        return metaAccess.lookupJavaType(toClass(descriptor));
+    }
+
+    private static Class<?> toClass(String descriptor) throws IOException {
+        Class<?> c;
+        if (descriptor.length() == 1) {
+            c = Kind.fromPrimitiveOrVoidTypeChar(descriptor.charAt(0)).toJavaClass();
+        } else if (descriptor.charAt(0) == '[') {
+            c = resolveClass(descriptor.replace('/', '.'));
+        } else {
+            c = resolveClass(descriptor.substring(1, descriptor.length() - 1).replace('/', '.'));
+        }
+        return c;
+    }
+
+    private static ResolvedJavaMethod lookupMethod(ResolvedJavaType holder, String name, String descriptor) throws IOException {
+        if (name.equals("<clinit>")) {
+            return holder.getClassInitializer();
+        }
+        ResolvedJavaMethod[] candidates = name.equals("<init>") ? holder.getDeclaredConstructors() : holder.getDeclaredMethods();
+        for (ResolvedJavaMethod method : candidates) {
+            if (method.getName().equals(name) && method.getSignature().toMethodDescriptor().equals(descriptor)) {
+                return method;
+            }
+        }
+        throw new IOException("cannot find method " + holder.toJavaName() + "." + name + descriptor);
+    }
+
+    private static ResolvedJavaField lookupField(ResolvedJavaType holder, String name, boolean isStatic) throws IOException {
+        for (ResolvedJavaField field : isStatic ? holder.getStaticFields() : holder.getInstanceFields(false)) {
+            if (field.getName().equals(name)) {
+                return field;
+            }
+        }
+        throw new IOException("cannot find field " + holder.toJavaName() + "." + name);
+    }
+}
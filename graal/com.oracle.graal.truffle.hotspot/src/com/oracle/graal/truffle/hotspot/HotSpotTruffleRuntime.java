@@ -111,7 +111,13 @@ public final class HotSpotTruffleRuntime extends GraalTruffleRuntime {
             }
         }
         selectedProcessors = Math.max(1, selectedProcessors);
-        compileQueue = new ThreadPoolExecutor(selectedProcessors, selectedProcessors, 0L, TimeUnit.MILLISECONDS, new LinkedBlockingQueue<Runnable>(), factory);
+        BlockingQueue<Runnable> queue;
+        if (TrufflePrioritizedCompilationQueue.getValue()) {
+            queue = new PrioritizedCompilationQueue(this::dropStaleCompilation);
+        } else {
+            queue = new LinkedBlockingQueue<>();
+        }
+        compileQueue = new ThreadPoolExecutor(selectedProcessors, selectedProcessors, 0L, TimeUnit.MILLISECONDS, queue, factory);
 
     }
 
@@ -230,7 +236,14 @@ public final class HotSpotTruffleRuntime extends GraalTruffleRuntime {
                 doCompile(optimizedCallTarget);
             }
         };
-        Future<?> future = compileQueue.submit(r);
+        Future<?> future;
+        if (compileQueue.getQueue() instanceof PrioritizedCompilationQueue) {
+            PrioritizedCompilationQueue.CompilationTask task = new PrioritizedCompilationQueue.CompilationTask(optimizedCallTarget, !mayBeAsynchronous, r);
+            compileQueue.execute(task);
+            future = task;
+        } else {
+            future = compileQueue.submit(r);
+        }
         this.compilations.put(optimizedCallTarget, future);
         getCompilationNotify().notifyCompilationQueued(optimizedCallTarget);
 
@@ -249,6 +262,19 @@ public final class HotSpotTruffleRuntime extends GraalTruffleRuntime {
         }
     }
 
+    /**
+     * Dequeues a compilation whose target has not been called since it was queued. The target is
+     * queued again once its counts reach the (raised) thresholds.
+     */
+    private void dropStaleCompilation(PrioritizedCompilationQueue.CompilationTask task) {
+        OptimizedCallTarget optimizedCallTarget = task.getTarget();
+        if (compilations.get(optimizedCallTarget) == task && cancelInstalledTask(optimizedCallTarget, compileQueue.getQueue(), "Not called while queued.")) {
+            optimizedCallTarget.getCompilationProfile().deferCompilation();
+        } else {
+            task.cancel(false);
+        }
+    }
+
     @Override
     public boolean cancelInstalledTask(OptimizedCallTarget optimizedCallTarget, Object source, CharSequence reason) {
         Future<?> codeTask = this.compilations.get(optimizedCallTarget);
@@ -300,6 +326,14 @@ public final class HotSpotTruffleRuntime extends GraalTruffleRuntime {
         getCompilationNotify().notifyCompilationInvalidated(optimizedCallTarget, source, reason);
     }
 
+    @Override
+    public void invalidateInstalledCode(OptimizedCallTarget[] optimizedCallTargets, Object source, CharSequence reason) {
+        HotSpotGraalRuntime.runtime().getCompilerToVM().invalidateInstalledCodes(optimizedCallTargets);
+        for (OptimizedCallTarget optimizedCallTarget : optimizedCallTargets) {
+            getCompilationNotify().notifyCompilationInvalidated(optimizedCallTarget, source, reason);
+        }
+    }
+
     @Override
     public void reinstallStubs() {
         installOptimizedCallTargetCallMethod();
@@ -59,6 +59,26 @@ public class AssumptionPartialEvaluationTest extends PartialEvaluationTest {
         assertDeepEquals(43, callTarget.call());
     }
 
+    /**
+     * Invalidating an Assumption invalidates all call targets that depend on it in one batch.
+     */
+    @Test
+    public void invalidateMultipleCallTargets() {
+        Assumption assumption = Truffle.getRuntime().createAssumption();
+        OptimizedCallTarget[] callTargets = new OptimizedCallTarget[8];
+        for (int i = 0; i < callTargets.length; i++) {
+            AbstractTestNode result = new ConstantWithAssumptionTestNode(assumption, 42);
+            RootTestNode rootNode = new RootTestNode(new FrameDescriptor(), "constantValue" + i, result);
+            callTargets[i] = assertPartialEvalEquals("constant42", rootNode);
+            Assert.assertTrue(callTargets[i].isValid());
+        }
+        assumption.invalidate();
+        for (OptimizedCallTarget callTarget : callTargets) {
+            Assert.assertFalse(callTarget.isValid());
+            assertDeepEquals(43, callTarget.call());
+        }
+    }
+
     /**
      * This tests whether a valid Assumption does successfully cut of the branch that is not
      * executed.
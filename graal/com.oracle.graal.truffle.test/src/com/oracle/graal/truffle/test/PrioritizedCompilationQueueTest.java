@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.truffle.test;
+
+import static org.junit.Assert.*;
+
+import java.util.*;
+
+import jdk.internal.jvmci.options.*;
+import jdk.internal.jvmci.options.OptionValue.OverrideScope;
+
+import org.junit.*;
+
+import com.oracle.graal.truffle.*;
+import com.oracle.graal.truffle.PrioritizedCompilationQueue.CompilationTask;
+import com.oracle.graal.truffle.test.nodes.*;
+import com.oracle.truffle.api.*;
+import com.oracle.truffle.api.frame.*;
+
+public class PrioritizedCompilationQueueTest {
+
+    private final List<CompilationTask> dropped = new ArrayList<>();
+    private final PrioritizedCompilationQueue queue = new PrioritizedCompilationQueue(dropped::add);
+
+    private static OptimizedCallTarget createTarget(String name, int calls) {
+        RootTestNode rootNode = new RootTestNode(new FrameDescriptor(), name, new ConstantTestNode(42));
+        OptimizedCallTarget target = (OptimizedCallTarget) Truffle.getRuntime().createCallTarget(rootNode);
+        reportCalls(target, calls);
+        return target;
+    }
+
+    private static void reportCalls(OptimizedCallTarget target, int calls) {
+        for (int i = 0; i < calls; i++) {
+            target.getCompilationProfile().reportInterpreterCall();
+        }
+    }
+
+    private CompilationTask enqueue(OptimizedCallTarget target, boolean synchronous) {
+        CompilationTask task = new CompilationTask(target, synchronous, () -> {
+        });
+        assertTrue(queue.offer(task));
+        return task;
+    }
+
+    @Test
+    public void hottestFirst() {
+        CompilationTask cold = enqueue(createTarget("cold", 10), false);
+        CompilationTask hot = enqueue(createTarget("hot", 100), false);
+        CompilationTask warm = enqueue(createTarget("warm", 50), false);
+        assertSame(hot, queue.peek());
+        assertSame(hot, queue.poll());
+        assertSame(warm, queue.poll());
+        assertSame(cold, queue.poll());
+        assertNull(queue.poll());
+    }
+
+    @Test
+    public void callsWhileQueuedCountTwice() {
+        CompilationTask idle = enqueue(createTarget("idle", 100), false);
+        OptimizedCallTarget running = createTarget("running", 60);
+        CompilationTask runningTask = enqueue(running, false);
+        reportCalls(running, 30);
+        assertSame(runningTask, queue.poll());
+        assertSame(idle, queue.poll());
+    }
+
+    @Test
+    public void synchronousFirst() {
+        CompilationTask hot = enqueue(createTarget("hot", 1000), false);
+        CompilationTask synchronous = enqueue(createTarget("synchronous", 0), true);
+        assertSame(synchronous, queue.poll());
+        assertSame(hot, queue.poll());
+    }
+
+    @Test
+    public void tiesByAge() {
+        CompilationTask first = enqueue(createTarget("first", 20), false);
+        CompilationTask second = enqueue(createTarget("second", 20), false);
+        CompilationTask third = enqueue(createTarget("third", 20), false);
+        assertSame(first, queue.poll());
+        assertSame(second, queue.poll());
+        assertSame(third, queue.poll());
+    }
+
+    @Test
+    public void staleDropped() throws InterruptedException {
+        try (OverrideScope s = OptionValue.override(TruffleCompilerOptions.TruffleTimeThreshold, 0)) {
+            CompilationTask stale = enqueue(createTarget("stale", 100), false);
+            OptimizedCallTarget called = createTarget("called", 10);
+            CompilationTask calledTask = enqueue(called, false);
+            CompilationTask synchronous = enqueue(createTarget("synchronous", 0), true);
+            reportCalls(called, 1);
+            Thread.sleep(2);
+
+            assertSame(synchronous, queue.poll());
+            assertEquals(Collections.singletonList(stale), dropped);
+            assertSame(calledTask, queue.poll());
+            assertNull(queue.poll());
+            assertEquals(1, dropped.size());
+        }
+    }
+
+    @Test
+    public void cancelledRemoved() {
+        CompilationTask hot = enqueue(createTarget("hot", 100), false);
+        CompilationTask cold = enqueue(createTarget("cold", 10), false);
+        hot.cancel(false);
+        assertEquals(2, queue.size());
+        assertSame(cold, queue.poll());
+        assertNull(queue.poll());
+        assertEquals(0, queue.size());
+        assertTrue(dropped.isEmpty());
+    }
+}
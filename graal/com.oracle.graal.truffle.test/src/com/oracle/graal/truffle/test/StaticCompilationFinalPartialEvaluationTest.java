@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.truffle.test;
+
+import org.junit.*;
+
+import com.oracle.graal.truffle.*;
+import com.oracle.graal.truffle.test.nodes.*;
+import com.oracle.truffle.api.frame.*;
+
+public class StaticCompilationFinalPartialEvaluationTest extends PartialEvaluationTest {
+    public static Object constant42() {
+        return 42;
+    }
+
+    public static Object constant43() {
+        return 43;
+    }
+
+    /**
+     * The graph of {@link StaticCompilationFinalTestNode#execute} is shared between partial
+     * evaluations, so it must not capture the value of the static field it reads.
+     */
+    @Test
+    public void changedStaticField() {
+        try {
+            StaticCompilationFinalTestNode.setValue(42);
+            RootTestNode rootNode = new RootTestNode(new FrameDescriptor(), "staticField", new StaticCompilationFinalTestNode());
+            OptimizedCallTarget callTarget = assertPartialEvalEquals("constant42", rootNode);
+            assertDeepEquals(42, callTarget.call());
+
+            StaticCompilationFinalTestNode.setValue(43);
+            rootNode = new RootTestNode(new FrameDescriptor(), "staticFieldChanged", new StaticCompilationFinalTestNode());
+            callTarget = assertPartialEvalEquals("constant43", rootNode);
+            assertDeepEquals(43, callTarget.call());
+        } finally {
+            StaticCompilationFinalTestNode.setValue(0);
+        }
+    }
+
+    /**
+     * The receiver of the {@code @CompilationFinal} field is a constant when the graph of
+     * {@link StaticHolderTestNode#execute} is parsed, but the field must still be read when the
+     * shared graph is decoded.
+     */
+    @Test
+    public void changedFieldOfStaticFinalObject() {
+        try {
+            StaticHolderTestNode.setValue(42);
+            RootTestNode rootNode = new RootTestNode(new FrameDescriptor(), "holderField", new StaticHolderTestNode());
+            OptimizedCallTarget callTarget = assertPartialEvalEquals("constant42", rootNode);
+            assertDeepEquals(42, callTarget.call());
+
+            StaticHolderTestNode.setValue(43);
+            rootNode = new RootTestNode(new FrameDescriptor(), "holderFieldChanged", new StaticHolderTestNode());
+            callTarget = assertPartialEvalEquals("constant43", rootNode);
+            assertDeepEquals(43, callTarget.call());
+        } finally {
+            StaticHolderTestNode.setValue(0);
+        }
+    }
+}
@@ -305,6 +305,16 @@ public abstract class GraalTruffleRuntime implements TruffleRuntime {
 
     public abstract void invalidateInstalledCode(OptimizedCallTarget optimizedCallTarget, Object source, CharSequence reason);
 
+    /**
+     * Invalidates the installed code of several call targets at once. Runtimes that can deoptimize
+     * a batch of installed code in a single operation override this method.
+     */
+    public void invalidateInstalledCode(OptimizedCallTarget[] optimizedCallTargets, Object source, CharSequence reason) {
+        for (OptimizedCallTarget optimizedCallTarget : optimizedCallTargets) {
+            invalidateInstalledCode(optimizedCallTarget, source, reason);
+        }
+    }
+
     public abstract void reinstallStubs();
 
     public final boolean enableInfopoints() {
@@ -68,11 +68,17 @@ public final class OptimizedAssumption extends AbstractAssumption {
     @TruffleBoundary
     private void invalidateImpl() {
         boolean invalidatedInstalledCode = false;
+        // Call targets are invalidated together so that they are deoptimized in one safepoint.
+        List<OptimizedCallTarget> callTargets = new ArrayList<>();
         Entry e = first;
         while (e != null) {
             InstalledCode installedCode = e.installedCode.get();
             if (installedCode != null && installedCode.getVersion() == e.version) {
-                invalidateWithReason(installedCode, "assumption invalidated");
+                if (installedCode instanceof OptimizedCallTarget) {
+                    callTargets.add((OptimizedCallTarget) installedCode);
+                } else {
+                    installedCode.invalidate();
+                }
                 invalidatedInstalledCode = true;
                 if (TraceTruffleAssumptions.getValue()) {
                     logInvalidatedInstalledCode(installedCode);
@@ -80,6 +86,9 @@ public final class OptimizedAssumption extends AbstractAssumption {
             }
             e = e.next;
         }
+        if (!callTargets.isEmpty()) {
+            OptimizedCallTarget.invalidate(callTargets, this, "assumption invalidated");
+        }
         first = null;
         isValid = false;
 
@@ -313,6 +313,23 @@ public class OptimizedCallTarget extends InstalledCode implements RootCallTarget
         cachedNonTrivialNodeCount = -1;
     }
 
+    /**
+     * Invalidates several call targets with a single deoptimization, see
+     * {@link GraalTruffleRuntime#invalidateInstalledCode(OptimizedCallTarget[], Object, CharSequence)}.
+     */
+    static void invalidate(List<OptimizedCallTarget> callTargets, Object source, CharSequence reason) {
+        List<OptimizedCallTarget> valid = new ArrayList<>(callTargets.size());
+        for (OptimizedCallTarget callTarget : callTargets) {
+            if (callTarget.isValid()) {
+                valid.add(callTarget);
+            }
+            callTarget.cachedNonTrivialNodeCount = -1;
+        }
+        if (!valid.isEmpty()) {
+            valid.get(0).runtime.invalidateInstalledCode(valid.toArray(new OptimizedCallTarget[valid.size()]), source, reason);
+        }
+    }
+
     public TruffleInlining getInlining() {
         return inlining;
     }
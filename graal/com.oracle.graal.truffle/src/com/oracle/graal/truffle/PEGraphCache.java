@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.truffle;
+
+import java.util.*;
+import java.util.concurrent.*;
+
+import jdk.internal.jvmci.common.*;
+import jdk.internal.jvmci.debug.*;
+import jdk.internal.jvmci.meta.*;
+import jdk.internal.jvmci.meta.Assumptions.Assumption;
+import jdk.internal.jvmci.meta.Assumptions.AssumptionResult;
+import jdk.internal.jvmci.meta.Assumptions.CallSiteTargetValue;
+import jdk.internal.jvmci.meta.Assumptions.ConcreteMethod;
+import jdk.internal.jvmci.meta.Assumptions.ConcreteSubtype;
+import jdk.internal.jvmci.meta.Assumptions.LeafType;
+
+import com.oracle.graal.nodes.*;
+
+/**
+ * Encoded, canonicalized parser graphs of Truffle node methods and intrinsics that are shared by
+ * all partial evaluations of a {@link PartialEvaluator}. The graphs only depend on the bytecode
+ * and on the class hierarchy, so they are reused across call targets instead of being re-parsed
+ * for each compilation. They must not fold values that can change at run time, such as static
+ * {@code @CompilationFinal} fields.
+ *
+ * An entry is discarded when the class of its method or of any method inlined during parsing has
+ * been redefined, or when one of the assumptions the graph was parsed under no longer holds. Graphs
+ * whose assumptions cannot be re-validated are not shared.
+ */
+public final class PEGraphCache {
+
+    private static final DebugMetric PEGraphCacheHits = Debug.metric("PEGraphCacheHits");
+    private static final DebugMetric PEGraphCacheMisses = Debug.metric("PEGraphCacheMisses");
+    private static final DebugMetric PEGraphCacheInvalidations = Debug.metric("PEGraphCacheInvalidations");
+
+    private final ConstantReflectionProvider constantReflection;
+    private final ResolvedJavaField classRedefinedCountField;
+    private final ConcurrentMap<ResolvedJavaMethod, Entry> entries = new ConcurrentHashMap<>();
+
+    /**
+     * A cached graph together with the redefinition counts of the classes declaring the methods it
+     * was parsed from.
+     */
+    private static final class Entry {
+        final EncodedGraph graph;
+        final ResolvedJavaType[] holders;
+        final int[] redefinedCounts;
+
+        Entry(EncodedGraph graph, ResolvedJavaType[] holders, int[] redefinedCounts) {
+            this.graph = graph;
+            this.holders = holders;
+            this.redefinedCounts = redefinedCounts;
+        }
+    }
+
+    public PEGraphCache(MetaAccessProvider metaAccess, ConstantReflectionProvider constantReflection) {
+        this.constantReflection = constantReflection;
+        try {
+            this.classRedefinedCountField = metaAccess.lookupJavaField(Class.class.getDeclaredField("classRedefinedCount"));
+        } catch (NoSuchFieldException ex) {
+            throw new JVMCIError(ex);
+        }
+    }
+
+    /**
+     * Returns the cached graph for {@code method}, or null if there is none or the cached graph is
+     * no longer valid.
+     */
+    public EncodedGraph get(ResolvedJavaMethod method) {
+        Entry entry = entries.get(method);
+        if (entry == null) {
+            PEGraphCacheMisses.increment();
+            return null;
+        }
+        if (!isCodeCurrent(entry) || !areAssumptionsValid(entry.graph.getAssumptions())) {
+            PEGraphCacheInvalidations.increment();
+            entries.remove(method, entry);
+            return null;
+        }
+        PEGraphCacheHits.increment();
+        return entry.graph;
+    }
+
+    public void put(ResolvedJavaMethod method, EncodedGraph graph) {
+        if (!areAssumptionsValid(graph.getAssumptions())) {
+            return;
+        }
+        Set<ResolvedJavaType> holderSet = new LinkedHashSet<>();
+        holderSet.add(method.getDeclaringClass());
+        if (graph.getInlinedMethods() != null) {
+            for (ResolvedJavaMethod inlinedMethod : graph.getInlinedMethods()) {
+                holderSet.add(inlinedMethod.getDeclaringClass());
+            }
+        }
+        ResolvedJavaType[] holders = holderSet.toArray(new ResolvedJavaType[holderSet.size()]);
+        int[] redefinedCounts = new int[holders.length];
+        for (int i = 0; i < holders.length; i++) {
+            redefinedCounts[i] = redefinedCount(holders[i]);
+        }
+        /*
+         * The counts are read before checking the methods, so a class redefined while the graph was
+         * parsed is either detected here or by a changed count on the next lookup.
+         */
+        if (!isCurrent(method)) {
+            return;
+        }
+        if (graph.getInlinedMethods() != null) {
+            for (ResolvedJavaMethod inlinedMethod : graph.getInlinedMethods()) {
+                if (!isCurrent(inlinedMethod)) {
+                    return;
+                }
+            }
+        }
+        entries.put(method, new Entry(graph, holders, redefinedCounts));
+    }
+
+    private boolean isCodeCurrent(Entry entry) {
+        for (int i = 0; i < entry.holders.length; i++) {
+            if (redefinedCount(entry.holders[i]) != entry.redefinedCounts[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Reads {@code Class.classRedefinedCount} of {@code type}, which the VM increments each time
+     * the class is redefined.
+     */
+    private int redefinedCount(ResolvedJavaType type) {
+        return constantReflection.readFieldValue(classRedefinedCountField, type.getJavaClass()).asInt();
+    }
+
+    /**
+     * Determines if {@code method} is still a method of its declaring class. Class redefinition
+     * replaces all methods of the redefined class, so the methods a graph was parsed from are no
+     * longer found once the class has been redefined. This is only checked when a graph is added,
+     * lookups compare the redefinition counts instead.
+     */
+    private static boolean isCurrent(ResolvedJavaMethod method) {
+        ResolvedJavaType holder = method.getDeclaringClass();
+        if (method.isClassInitializer()) {
+            return method.equals(holder.getClassInitializer());
+        }
+        for (ResolvedJavaMethod current : method.isConstructor() ? holder.getDeclaredConstructors() : holder.getDeclaredMethods()) {
+            if (current.equals(method)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    private static boolean areAssumptionsValid(Assumptions assumptions) {
+        if (assumptions == null) {
+            return true;
+        }
+        for (Assumption assumption : assumptions) {
+            if (!isValid(assumption)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Re-evaluates the query that produced {@code assumption} against the current class hierarchy.
+     * Assumption kinds that cannot be re-evaluated are treated as invalid.
+     */
+    private static boolean isValid(Assumption assumption) {
+        if (assumption instanceof LeafType) {
+            LeafType leafType = (LeafType) assumption;
+            return hasResult(leafType.context.findLeafConcreteSubtype(), leafType.context);
+        } else if (assumption instanceof ConcreteSubtype) {
+            ConcreteSubtype concreteSubtype = (ConcreteSubtype) assumption;
+            return hasResult(concreteSubtype.context.findLeafConcreteSubtype(), concreteSubtype.subtype);
+        } else if (assumption instanceof ConcreteMethod) {
+            ConcreteMethod concreteMethod = (ConcreteMethod) assumption;
+            return hasResult(concreteMethod.context.findUniqueConcreteMethod(concreteMethod.method), concreteMethod.impl);
+        } else if (assumption instanceof CallSiteTargetValue) {
+            CallSiteTargetValue callSiteTargetValue = (CallSiteTargetValue) assumption;
+            return callSiteTargetValue.callSite.getTarget() == callSiteTargetValue.methodHandle;
+        }
+        return false;
+    }
+
+    private static boolean hasResult(AssumptionResult<?> result, Object expected) {
+        return result != null && expected.equals(result.getResult());
+    }
+}
@@ -79,6 +79,8 @@ public class PartialEvaluator {
     private final ResolvedJavaMethod callSiteProxyMethod;
     private final ResolvedJavaMethod callRootMethod;
     private final GraphBuilderConfiguration configForRoot;
+    private final PEGraphCache graphCache;
+    private final Providers graphCacheProviders;
 
     public PartialEvaluator(Providers providers, GraphBuilderConfiguration configForRoot, SnippetReflectionProvider snippetReflection, Architecture architecture) {
         this.providers = providers;
@@ -89,6 +91,14 @@ public class PartialEvaluator {
         this.callInlinedMethod = providers.getMetaAccess().lookupJavaMethod(OptimizedCallTarget.getCallInlinedMethod());
         this.callSiteProxyMethod = providers.getMetaAccess().lookupJavaMethod(GraalFrameInstance.CallNodeFrame.METHOD);
         this.configForRoot = configForRoot;
+        if (TrufflePEGraphCache.getValue() && providers.getConstantReflection() instanceof TruffleConstantReflectionProvider) {
+            TruffleConstantReflectionProvider constantReflection = (TruffleConstantReflectionProvider) providers.getConstantReflection();
+            this.graphCache = new PEGraphCache(providers.getMetaAccess(), constantReflection);
+            this.graphCacheProviders = providers.copyWith(constantReflection.withoutTruffleFieldFolding());
+        } else {
+            this.graphCache = null;
+            this.graphCacheProviders = null;
+        }
 
         try {
             callRootMethod = providers.getMetaAccess().lookupJavaMethod(OptimizedCallTarget.class.getDeclaredMethod("callRoot", Object[].class));
@@ -331,7 +341,49 @@ public class PartialEvaluator {
             plugins.appendInlineInvokePlugin(new InlineDuringParsingPlugin());
         }
 
-        return new CachingPEGraphDecoder(providers, newConfig, TruffleCompiler.Optimizations, AllowAssumptions.from(graph.getAssumptions() != null), architecture);
+        AllowAssumptions allowAssumptions = AllowAssumptions.from(graph.getAssumptions() != null);
+        if (graphCache != null && allowAssumptions == AllowAssumptions.YES) {
+            return new SharedCachingPEGraphDecoder(providers, newConfig, allowAssumptions);
+        }
+        return new CachingPEGraphDecoder(providers, newConfig, TruffleCompiler.Optimizations, allowAssumptions, architecture);
+    }
+
+    /**
+     * Looks up graphs in the {@link PEGraphCache} shared by all partial evaluations before parsing
+     * them. The per-decoder cache is still filled so that one compilation sees a consistent graph
+     * for each method even if the shared entry is invalidated concurrently.
+     * {@code @CompilationFinal}, {@code @Child} and {@code @Children} fields and assumptions are
+     * not folded while parsing but when decoding, so that the shared graphs do not capture their
+     * current values.
+     */
+    private final class SharedCachingPEGraphDecoder extends CachingPEGraphDecoder {
+
+        public SharedCachingPEGraphDecoder(Providers providers, GraphBuilderConfiguration graphBuilderConfig, AllowAssumptions allowAssumptions) {
+            super(providers, graphBuilderConfig, TruffleCompiler.Optimizations, allowAssumptions, architecture);
+        }
+
+        @Override
+        protected EncodedGraph lookupCachedGraph(ResolvedJavaMethod method) {
+            EncodedGraph result = super.lookupCachedGraph(method);
+            if (result == null) {
+                result = graphCache.get(method);
+                if (result != null) {
+                    super.cacheGraph(method, result);
+                }
+            }
+            return result;
+        }
+
+        @Override
+        protected Providers getParsingProviders() {
+            return graphCacheProviders;
+        }
+
+        @Override
+        protected void cacheGraph(ResolvedJavaMethod method, EncodedGraph encodedGraph) {
+            super.cacheGraph(method, encodedGraph);
+            graphCache.put(method, encodedGraph);
+        }
     }
 
     protected void doGraphPE(OptimizedCallTarget callTarget, StructuredGraph graph) {
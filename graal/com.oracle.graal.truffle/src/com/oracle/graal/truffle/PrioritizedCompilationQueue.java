@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.graal.truffle;
+
+import static com.oracle.graal.truffle.TruffleCompilerOptions.*;
+
+import java.util.*;
+import java.util.concurrent.*;
+import java.util.concurrent.locks.*;
+import java.util.function.*;
+
+/**
+ * Work queue for the Truffle compiler threads that hands out the hottest queued call target first
+ * instead of the oldest one.
+ *
+ * Hotness is read from a target's {@link CompilationProfile} when a compiler thread asks for work,
+ * so targets whose counts keep rising while they wait move ahead of targets that went quiet after
+ * being queued. Entries whose compilation was cancelled are discarded, and entries that saw no
+ * interpreter calls for {@link TruffleCompilerOptions#TruffleTimeThreshold} milliseconds are handed
+ * to a stale handler instead of being compiled.
+ */
+public final class PrioritizedCompilationQueue extends AbstractQueue<Runnable> implements BlockingQueue<Runnable> {
+
+    /**
+     * A queued compilation of a single call target.
+     */
+    public static final class CompilationTask extends FutureTask<Void> {
+
+        private final OptimizedCallTarget target;
+
+        /**
+         * A caller is blocked waiting for this compilation, so it is neither delayed nor dropped.
+         */
+        private final boolean synchronous;
+        private final int queuedCallAndLoopCount;
+        private final long queuedTime;
+
+        public CompilationTask(OptimizedCallTarget target, boolean synchronous, Runnable compilation) {
+            super(compilation, null);
+            this.target = target;
+            this.synchronous = synchronous;
+            this.queuedCallAndLoopCount = target.getCompilationProfile().getInterpreterCallAndLoopCount();
+            this.queuedTime = System.nanoTime();
+        }
+
+        public OptimizedCallTarget getTarget() {
+            return target;
+        }
+
+        /**
+         * Counts accumulated while waiting in the queue are weighted twice so that targets still
+         * running in the interpreter overtake equally counted targets that are no longer called.
+         */
+        long hotness() {
+            if (synchronous) {
+                return Long.MAX_VALUE;
+            }
+            long count = target.getCompilationProfile().getInterpreterCallAndLoopCount();
+            return count + (count - queuedCallAndLoopCount);
+        }
+
+        boolean isStale(long now) {
+            if (synchronous || target.getCompilationProfile().getInterpreterCallAndLoopCount() != queuedCallAndLoopCount) {
+                return false;
+            }
+            return now - queuedTime > TimeUnit.MILLISECONDS.toNanos(TruffleTimeThreshold.getValue());
+        }
+    }
+
+    private final ArrayList<Runnable> tasks = new ArrayList<>();
+    private final ReentrantLock lock = new ReentrantLock();
+    private final Condition notEmpty = lock.newCondition();
+    private final Consumer<CompilationTask> staleHandler;
+
+    /**
+     * @param staleHandler called, without the queue lock held, for each task removed because its
+     *            target is no longer being called
+     */
+    public PrioritizedCompilationQueue(Consumer<CompilationTask> staleHandler) {
+        this.staleHandler = staleHandler;
+    }
+
+    private static long hotness(Runnable task) {
+        if (task instanceof CompilationTask) {
+            return ((CompilationTask) task).hotness();
+        }
+        return Long.MAX_VALUE;
+    }
+
+    /**
+     * Gets the index of the hottest task, or -1 if the queue is empty. Ties go to the older task.
+     */
+    private int hottest() {
+        int best = -1;
+        long bestHotness = 0;
+        for (int i = 0; i < tasks.size(); i++) {
+            long hotness = hotness(tasks.get(i));
+            if (best == -1 || hotness > bestHotness) {
+                best = i;
+                bestHotness = hotness;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Removes cancelled and stale tasks, adding the latter to {@code stale}, and then removes and
+     * returns the hottest remaining task.
+     */
+    private Runnable select(List<CompilationTask> stale) {
+        long now = System.nanoTime();
+        Iterator<Runnable> iter = tasks.iterator();
+        while (iter.hasNext()) {
+            Runnable r = iter.next();
+            if (r instanceof CompilationTask) {
+                CompilationTask task = (CompilationTask) r;
+                if (task.isDone()) {
+                    iter.remove();
+                } else if (task.isStale(now)) {
+                    iter.remove();
+                    stale.add(task);
+                }
+            }
+        }
+        int best = hottest();
+        return best == -1 ? null : tasks.remove(best);
+    }
+
+    private void dropStale(List<CompilationTask> stale) {
+        for (CompilationTask task : stale) {
+            staleHandler.accept(task);
+        }
+    }
+
+    @Override
+    public boolean offer(Runnable task) {
+        Objects.requireNonNull(task);
+        lock.lock();
+        try {
+            tasks.add(task);
+            notEmpty.signal();
+        } finally {
+            lock.unlock();
+        }
+        return true;
+    }
+
+    @Override
+    public void put(Runnable task) {
+        offer(task);
+    }
+
+    @Override
+    public boolean offer(Runnable task, long timeout, TimeUnit unit) {
+        return offer(task);
+    }
+
+    @Override
+    public Runnable take() throws InterruptedException {
+        while (true) {
+            List<CompilationTask> stale = new ArrayList<>();
+            Runnable task;
+            lock.lockInterruptibly();
+            try {
+                task = select(stale);
+                if (task == null && stale.isEmpty()) {
+                    notEmpty.await();
+                    continue;
+                }
+            } finally {
+                lock.unlock();
+            }
+            dropStale(stale);
+            if (task != null) {
+                return task;
+            }
+        }
+    }
+
+    @Override
+    public Runnable poll(long timeout, TimeUnit unit) throws InterruptedException {
+        long nanos = unit.toNanos(timeout);
+        while (true) {
+            List<CompilationTask> stale = new ArrayList<>();
+            Runnable task;
+            lock.lockInterruptibly();
+            try {
+                task = select(stale);
+                if (task == null && stale.isEmpty()) {
+                    if (nanos <= 0) {
+                        return null;
+                    }
+                    nanos = notEmpty.awaitNanos(nanos);
+                    continue;
+                }
+            } finally {
+                lock.unlock();
+            }
+            dropStale(stale);
+            if (task != null) {
+                return task;
+            }
+        }
+    }
+
+    @Override
+    public Runnable poll() {
+        List<CompilationTask> stale = new ArrayList<>();
+        Runnable task;
+        lock.lock();
+        try {
+            task = select(stale);
+        } finally {
+            lock.unlock();
+        }
+        dropStale(stale);
+        return task;
+    }
+
+    @Override
+    public Runnable peek() {
+        lock.lock();
+        try {
+            int best = hottest();
+            return best == -1 ? null : tasks.get(best);
+        } finally {
+            lock.unlock();
+        }
+    }
+
+    @Override
+    public boolean remove(Object o) {
+        lock.lock();
+        try {
+            for (int i = 0; i < tasks.size(); i++) {
+                if (tasks.get(i) == o) {
+                    tasks.remove(i);
+                    return true;
+                }
+            }
+            return false;
+        } finally {
+            lock.unlock();
+        }
+    }
+
+    @Override
+    public int size() {
+        lock.lock();
+        try {
+            return tasks.size();
+        } finally {
+            lock.unlock();
+        }
+    }
+
+    @Override
+    public int remainingCapacity() {
+        return Integer.MAX_VALUE;
+    }
+
+    @Override
+    public int drainTo(Collection<? super Runnable> c) {
+        return drainTo(c, Integer.MAX_VALUE);
+    }
+
+    @Override
+    public int drainTo(Collection<? super Runnable> c, int maxElements) {
+        if (c == this) {
+            throw new IllegalArgumentException();
+        }
+        lock.lock();
+        try {
+            int n = Math.min(tasks.size(), maxElements);
+            List<Runnable> drained = tasks.subList(0, n);
+            c.addAll(drained);
+            drained.clear();
+            return n;
+        } finally {
+            lock.unlock();
+        }
+    }
+
+    /**
+     * Returns an iterator over a snapshot of the queue, in no particular order.
+     */
+    @Override
+    public Iterator<Runnable> iterator() {
+        Runnable[] snapshot;
+        lock.lock();
+        try {
+            snapshot = tasks.toArray(new Runnable[tasks.size()]);
+        } finally {
+            lock.unlock();
+        }
+        return new Iterator<Runnable>() {
+            private int next;
+            private Runnable last;
+
+            @Override
+            public boolean hasNext() {
+                return next < snapshot.length;
+            }
+
+            @Override
+            public Runnable next() {
+                if (next >= snapshot.length) {
+                    throw new NoSuchElementException();
+                }
+                last = snapshot[next++];
+                return last;
+            }
+
+            @Override
+            public void remove() {
+                if (last == null) {
+                    throw new IllegalStateException();
+                }
+                PrioritizedCompilationQueue.this.remove(last);
+                last = null;
+            }
+        };
+    }
+}
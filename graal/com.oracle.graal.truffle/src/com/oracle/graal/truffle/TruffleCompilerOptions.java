@@ -104,6 +104,12 @@ public class TruffleCompilerOptions {
     @Option(help = "Manually set the number of compiler threads", type = OptionType.Expert)
     public static final OptionValue<Integer> TruffleCompilerThreads = new StableOptionValue<>(0);
 
+    @Option(help = "Compile the hottest queued call target first instead of the oldest. Disable to compare time to peak with a FIFO queue.", type = OptionType.Expert)
+    public static final OptionValue<Boolean> TrufflePrioritizedCompilationQueue = new StableOptionValue<>(true);
+
+    @Option(help = "Share parsed graphs of Truffle node methods between partial evaluations. Disable to compare partial evaluation time without the cache.", type = OptionType.Expert)
+    public static final OptionValue<Boolean> TrufflePEGraphCache = new StableOptionValue<>(true);
+
     @Option(help = "Enable inlining across Truffle boundary", type = OptionType.Expert)
     public static final OptionValue<Boolean> TruffleInlineAcrossTruffleBoundary = new OptionValue<>(false);
 
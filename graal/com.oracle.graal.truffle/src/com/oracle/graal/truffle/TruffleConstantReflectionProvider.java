@@ -31,10 +31,30 @@ import com.oracle.truffle.api.nodes.Node.Children;
 public class TruffleConstantReflectionProvider implements ConstantReflectionProvider {
     private final ConstantReflectionProvider graalConstantReflection;
     private final MetaAccessProvider metaAccess;
+    private final boolean foldTruffleFields;
 
     public TruffleConstantReflectionProvider(ConstantReflectionProvider graalConstantReflection, MetaAccessProvider metaAccess) {
+        this(graalConstantReflection, metaAccess, true);
+    }
+
+    private TruffleConstantReflectionProvider(ConstantReflectionProvider graalConstantReflection, MetaAccessProvider metaAccess, boolean foldTruffleFields) {
         this.graalConstantReflection = graalConstantReflection;
         this.metaAccess = metaAccess;
+        this.foldTruffleFields = foldTruffleFields;
+    }
+
+    /**
+     * Returns a provider that folds fields only like the underlying provider does. The values of
+     * {@code @CompilationFinal}, {@code @Child} and {@code @Children} fields can change after
+     * {@code transferToInterpreterAndInvalidate}, so graphs that outlive a single compilation must
+     * leave the loads in place and have them folded when the graph is decoded.
+     */
+    public TruffleConstantReflectionProvider withoutTruffleFieldFolding() {
+        return new TruffleConstantReflectionProvider(graalConstantReflection, metaAccess, false);
+    }
+
+    public boolean foldsTruffleFields() {
+        return foldTruffleFields;
     }
 
     public Boolean constantEquals(Constant x, Constant y) {
@@ -59,6 +79,9 @@ public class TruffleConstantReflectionProvider implements ConstantReflectionProv
 
     public JavaConstant readConstantFieldValue(JavaField field0, JavaConstant receiver) {
         ResolvedJavaField field = (ResolvedJavaField) field0;
+        if (!foldTruffleFields) {
+            return graalConstantReflection.readConstantFieldValue(field, receiver);
+        }
         if (!field.isStatic() && receiver.isNonNull()) {
             JavaType fieldType = field.getType();
             if (field.isFinal() || field.getAnnotation(CompilationFinal.class) != null ||
@@ -52,6 +52,8 @@ public final class CompilationStatisticsListener extends AbstractDebugCompilatio
     private final IntSummaryStatistics deferCompilations = new IntSummaryStatistics();
     private final LongSummaryStatistics timeToQueue = new LongSummaryStatistics();
     private final LongSummaryStatistics timeToCompilation = new LongSummaryStatistics();
+    private final LongSummaryStatistics timeInQueue = new LongSummaryStatistics();
+    private final Map<OptimizedCallTarget, Long> queuedTimes = Collections.synchronizedMap(new IdentityHashMap<>());
 
     private final IntSummaryStatistics nodeCount = new IntSummaryStatistics();
     private final IntSummaryStatistics nodeCountTrivial = new IntSummaryStatistics();
@@ -108,12 +110,15 @@ public final class CompilationStatisticsListener extends AbstractDebugCompilatio
         if (firstCompilation == 0) {
             firstCompilation = System.nanoTime();
         }
-        timeToQueue.accept(System.nanoTime() - target.getCompilationProfile().getTimestamp());
+        long queued = System.nanoTime();
+        timeToQueue.accept(queued - target.getCompilationProfile().getTimestamp());
+        queuedTimes.put(target, queued);
     }
 
     @Override
     public void notifyCompilationDequeued(OptimizedCallTarget target, Object source, CharSequence reason) {
         dequeues++;
+        queuedTimes.remove(target);
     }
 
     @Override
@@ -137,6 +142,10 @@ public final class CompilationStatisticsListener extends AbstractDebugCompilatio
 
         deferCompilations.accept(target.getCompilationProfile().getDeferedCount());
         timeToCompilation.accept(local.compilationStarted - target.getCompilationProfile().getTimestamp());
+        Long queued = queuedTimes.remove(target);
+        if (queued != null) {
+            timeInQueue.accept(local.compilationStarted - queued);
+        }
     }
 
     @Override
@@ -227,6 +236,7 @@ public final class CompilationStatisticsListener extends AbstractDebugCompilatio
 
         printStatisticTime(rt, "Time to queue", timeToQueue);
         printStatisticTime(rt, "Time to compilation", timeToCompilation);
+        printStatisticTime(rt, "Time in queue", timeInQueue);
 
         printStatisticTime(rt, "Compilation time", compilationTime);
         printStatisticTime(rt, "  Truffle Tier", compilationTimeTruffleTier);
@@ -72,7 +72,7 @@ public class TruffleGraphBuilderPlugins {
         Registration r = new Registration(plugins, OptimizedAssumption.class);
         InvocationPlugin plugin = new InvocationPlugin() {
             public boolean apply(GraphBuilderContext b, ResolvedJavaMethod targetMethod, Receiver receiver) {
-                if (receiver.isConstant()) {
+                if (receiver.isConstant() && foldsTruffleState(b)) {
                     Constant constant = receiver.get().asConstant();
                     OptimizedAssumption assumption = snippetReflection.asObject(OptimizedAssumption.class, (JavaConstant) constant);
                     if (assumption.isValid()) {
@@ -100,6 +100,15 @@ public class TruffleGraphBuilderPlugins {
         r.register1("check", Receiver.class, plugin);
     }
 
+    /**
+     * Graphs parsed for the {@link PEGraphCache} must not capture the validity of an assumption,
+     * so the invoke is left for the decoding plugins.
+     */
+    private static boolean foldsTruffleState(GraphBuilderContext b) {
+        ConstantReflectionProvider constantReflection = b.getConstantReflection();
+        return !(constantReflection instanceof TruffleConstantReflectionProvider) || ((TruffleConstantReflectionProvider) constantReflection).foldsTruffleFields();
+    }
+
     public static void registerExactMathPlugins(InvocationPlugins plugins) {
         Registration r = new Registration(plugins, ExactMath.class);
         for (Kind kind : new Kind[]{Kind.Int, Kind.Long}) {
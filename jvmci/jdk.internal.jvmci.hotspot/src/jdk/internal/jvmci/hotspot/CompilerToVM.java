@@ -267,6 +267,14 @@ public interface CompilerToVM {
 
     void invalidateInstalledCode(InstalledCode hotspotInstalledCode);
 
+    /**
+     * Invalidates a batch of installed code. All of the code is marked for deoptimization first and
+     * then deoptimized in a single safepoint, instead of one safepoint per installed code.
+     *
+     * @param installedCodes the installed code to invalidate, {@code null} elements are ignored
+     */
+    void invalidateInstalledCodes(InstalledCode[] installedCodes);
+
     /**
      * Collects the current values of all JVMCI benchmark counters, summed up over all threads.
      */
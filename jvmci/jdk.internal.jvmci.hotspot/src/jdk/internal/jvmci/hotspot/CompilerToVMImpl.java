@@ -178,6 +178,9 @@ public class CompilerToVMImpl implements CompilerToVM {
     @Override
     public native void invalidateInstalledCode(InstalledCode hotspotInstalledCode);
 
+    @Override
+    public native void invalidateInstalledCodes(InstalledCode[] installedCodes);
+
     @Override
     public native Class<?> getJavaMirror(long metaspaceKlass);
 
@@ -1403,6 +1403,9 @@ public class HotSpotVMConfig {
     @HotSpotVMField(name = "StubRoutines::_checkcast_arraycopy_uninit", type = "address", get = HotSpotVMField.Type.VALUE) @Stable public long checkcastArraycopyUninit;
     @HotSpotVMField(name = "StubRoutines::_unsafe_arraycopy", type = "address", get = HotSpotVMField.Type.VALUE) @Stable public long unsafeArraycopy;
     @HotSpotVMField(name = "StubRoutines::_generic_arraycopy", type = "address", get = HotSpotVMField.Type.VALUE) @Stable public long genericArraycopy;
+    @HotSpotVMField(name = "StubRoutines::_jshort_swapcopy", type = "address", get = HotSpotVMField.Type.VALUE) @Stable public long jshortSwapcopy;
+    @HotSpotVMField(name = "StubRoutines::_jint_swapcopy", type = "address", get = HotSpotVMField.Type.VALUE) @Stable public long jintSwapcopy;
+    @HotSpotVMField(name = "StubRoutines::_jlong_swapcopy", type = "address", get = HotSpotVMField.Type.VALUE) @Stable public long jlongSwapcopy;
 
     @HotSpotVMValue(expression = "JVMCIRuntime::new_instance", get = HotSpotVMValue.Type.ADDRESS) @Stable public long newInstanceAddress;
     @HotSpotVMValue(expression = "JVMCIRuntime::new_array", get = HotSpotVMValue.Type.ADDRESS) @Stable public long newArrayAddress;
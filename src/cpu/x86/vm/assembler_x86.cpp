@@ -1843,6 +1843,15 @@ void Assembler::movl(Address dst, Register src) {
   emit_operand(src, dst);
 }
 
+void Assembler::movnti(Address dst, Register src) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), "unsupported");)
+  InstructionMark im(this);
+  prefix(dst, src);
+  emit_int8(0x0F);
+  emit_int8((unsigned char)0xC3);
+  emit_operand(src, dst);
+}
+
 // New cpus require to use movsd and movss to avoid partial register stall
 // when loading from memory. But for old Opteron use movlpd instead of movsd.
 // The selection is done in MacroAssembler::movdbl() and movflt().
@@ -2536,6 +2545,13 @@ void Assembler::pshufb(XMMRegister dst, Address src) {
   emit_operand(dst, src);
 }
 
+void Assembler::vpshufb(XMMRegister dst, XMMRegister nds, XMMRegister src, bool vector256) {
+  assert(VM_Version::supports_avx() && !vector256 || VM_Version::supports_avx2(), "256 bit integer vectors requires AVX2");
+  int encode = vex_prefix_and_encode(dst, nds, src, VEX_SIMD_66, vector256, VEX_OPCODE_0F_38);
+  emit_int8(0x00);
+  emit_int8((unsigned char)(0xC0 | encode));
+}
+
 void Assembler::pshufd(XMMRegister dst, XMMRegister src, int mode) {
   assert(isByte(mode), "invalid value");
   NOT_LP64(assert(VM_Version::supports_sse2(), ""));
@@ -2801,6 +2817,13 @@ void Assembler::setb(Condition cc, Register dst) {
   emit_int8((unsigned char)(0xC0 | encode));
 }
 
+void Assembler::sfence() {
+  NOT_LP64(assert(VM_Version::supports_sse(), "unsupported");)
+  emit_int8(0x0F);
+  emit_int8((unsigned char)0xAE);
+  emit_int8((unsigned char)0xF8);
+}
+
 void Assembler::shll(Register dst, int imm8) {
   assert(isShiftCount(imm8), "illegal shift count");
   int encode = prefix_and_encode(dst->encoding());
@@ -5385,6 +5408,14 @@ void Assembler::movq(Address dst, Register src) {
   emit_operand(src, dst);
 }
 
+void Assembler::movntiq(Address dst, Register src) {
+  InstructionMark im(this);
+  prefixq(dst, src);
+  emit_int8(0x0F);
+  emit_int8((unsigned char)0xC3);
+  emit_operand(src, dst);
+}
+
 void Assembler::movsbq(Register dst, Address src) {
   InstructionMark im(this);
   prefixq(src, dst);
@@ -1356,6 +1356,12 @@ private:
   void movl(Address  dst, void* junk);
   void movl(Register dst, void* junk);
 
+  // Non-temporal (streaming) store of a general register
+  void movnti(Address dst, Register src);
+#ifdef _LP64
+  void movntiq(Address dst, Register src);
+#endif
+
 #ifdef _LP64
   void movq(Register dst, Register src);
   void movq(Register dst, Address src);
@@ -1517,6 +1523,7 @@ private:
   // Shuffle Bytes
   void pshufb(XMMRegister dst, XMMRegister src);
   void pshufb(XMMRegister dst, Address src);
+  void vpshufb(XMMRegister dst, XMMRegister nds, XMMRegister src, bool vector256);
 
   // Shuffle Packed Doublewords
   void pshufd(XMMRegister dst, XMMRegister src, int mode);
@@ -1586,6 +1593,9 @@ private:
 
   void setb(Condition cc, Register dst);
 
+  // Orders preceding stores, including non-temporal ones
+  void sfence();
+
   void shldl(Register dst, Register src);
 
   void shll(Register dst, int imm8);
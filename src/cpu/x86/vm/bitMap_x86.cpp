@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/vm_version.hpp"
+#include "utilities/bitMap.hpp"
+
+// x86_64 kernels of the BitMap bulk operations: popcnt for counting, and
+// 256 bit AVX2 vectors for comparing and combining bitmaps.  They are
+// compiled with per-function target attributes, so the rest of the VM keeps
+// its baseline instruction set, and are only installed if the CPU supports
+// them.  Large ranges are cleared through Copy, which switches to streaming
+// stores above NonTemporalStoreThreshold.
+
+#if defined(AMD64) && defined(TARGET_COMPILER_gcc) && \
+    (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+#define BITMAP_X86_KERNELS
+#endif
+
+#ifdef BITMAP_X86_KERNELS
+
+typedef BitMap::idx_t     idx_t;
+typedef BitMap::bm_word_t bm_word_t;
+
+// Four bitmap words in a ymm register.
+typedef bm_word_t v4w __attribute__((vector_size(32)));
+
+enum {
+  op_union,
+  op_intersection,
+  op_difference
+};
+
+template <int op>
+__attribute__((target("avx2")))
+static bool avx2_combine(bm_word_t* dst, const bm_word_t* src, idx_t words) {
+  v4w changed = { 0, 0, 0, 0 };
+  idx_t i = 0;
+  for (; i + 4 <= words; i += 4) {
+    v4w d, s, r;
+    // Bitmaps are only word aligned, memcpy becomes an unaligned load/store.
+    __builtin_memcpy(&d, dst + i, sizeof(v4w));
+    __builtin_memcpy(&s, src + i, sizeof(v4w));
+    switch (op) {
+      case op_union:        r = d | s;  break;
+      case op_intersection: r = d & s;  break;
+      default:              r = d & ~s; break;
+    }
+    changed |= r ^ d;
+    __builtin_memcpy(dst + i, &r, sizeof(v4w));
+  }
+  bm_word_t changed_word = changed[0] | changed[1] | changed[2] | changed[3];
+  for (; i < words; i++) {
+    bm_word_t d = dst[i];
+    bm_word_t r;
+    switch (op) {
+      case op_union:        r = d | src[i];  break;
+      case op_intersection: r = d & src[i];  break;
+      default:              r = d & ~src[i]; break;
+    }
+    changed_word |= r ^ d;
+    dst[i] = r;
+  }
+  return changed_word != 0;
+}
+
+__attribute__((target("avx2")))
+static bool avx2_is_same(const bm_word_t* a, const bm_word_t* b, idx_t words) {
+  idx_t i = 0;
+  // Test two vectors at a time to halve the horizontal reductions.
+  for (; i + 8 <= words; i += 8) {
+    v4w a0, a1, b0, b1;
+    __builtin_memcpy(&a0, a + i,     sizeof(v4w));
+    __builtin_memcpy(&a1, a + i + 4, sizeof(v4w));
+    __builtin_memcpy(&b0, b + i,     sizeof(v4w));
+    __builtin_memcpy(&b1, b + i + 4, sizeof(v4w));
+    v4w diff = (a0 ^ b0) | (a1 ^ b1);
+    if ((diff[0] | diff[1] | diff[2] | diff[3]) != 0) return false;
+  }
+  for (; i < words; i++) {
+    if (a[i] != b[i]) return false;
+  }
+  return true;
+}
+
+__attribute__((target("popcnt")))
+static idx_t popcnt_count_one_bits(const bm_word_t* map, idx_t words) {
+  idx_t sum = 0;
+  for (idx_t i = 0; i < words; i++) {
+    sum += __builtin_popcountl(map[i]);
+  }
+  return sum;
+}
+
+#endif // BITMAP_X86_KERNELS
+
+void BitMap::pd_initialize_kernels(Kernels* kernels) {
+#ifdef BITMAP_X86_KERNELS
+  if (UsePopCountInstruction) {
+    kernels->count_one_bits = popcnt_count_one_bits;
+  }
+  if (UseAVX >= 2) {
+    kernels->set_union        = avx2_combine<op_union>;
+    kernels->set_intersection = avx2_combine<op_intersection>;
+    kernels->set_difference   = avx2_combine<op_difference>;
+    kernels->is_same          = avx2_is_same;
+  }
+#endif // BITMAP_X86_KERNELS
+}
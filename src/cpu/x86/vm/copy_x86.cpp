@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "utilities/copy.hpp"
+
+#ifdef AMD64
+
+#include <emmintrin.h>
+
+void Copy::pd_fill_to_words_nontemporal(julong* to, size_t count, julong value) {
+  // movnti only needs natural alignment, which heap words always have.
+  long long v = (long long) value;
+  for (size_t i = 0; i < count; i++) {
+    _mm_stream_si64((long long*) (to + i), v);
+  }
+  // Streaming stores are weakly ordered with respect to ordinary stores.
+  _mm_sfence();
+}
+
+void Copy::pd_fill_to_bytes_nontemporal(void* to, size_t count, jubyte value) {
+  jubyte* dst  = (jubyte*) to;
+  jubyte* head = (jubyte*) align_size_up((intptr_t) dst, BytesPerLong);
+  size_t  lead = MIN2((size_t) pointer_delta(head, dst, sizeof(jubyte)), count);
+  (void) memset(dst, value, lead);
+  dst   += lead;
+  count -= lead;
+
+  size_t words = count / BytesPerLong;
+  pd_fill_to_words_nontemporal((julong*) dst, words, (julong) value * CONST64(0x0101010101010101));
+  (void) memset(dst + words * BytesPerLong, value, count - words * BytesPerLong);
+}
+
+#endif // AMD64
@@ -41,11 +41,28 @@
 # include "copy_bsd_x86.inline.hpp"
 #endif
 
+#ifdef AMD64
+// Fills of at least NonTemporalStoreThreshold bytes use non-temporal stores,
+// so that zeroing a large array or clearing a card table or bitmap does not
+// evict the working set from the caches.  Both functions issue an sfence
+// before returning, so the fill is ordered before any later store that
+// publishes the memory.  See copy_x86.cpp.
+static void pd_fill_to_words_nontemporal(julong* to, size_t count, julong value);
+static void pd_fill_to_bytes_nontemporal(void* to, size_t count, jubyte value);
+
+static bool pd_use_nontemporal_stores(size_t byte_count) {
+  return NonTemporalStoreThreshold != 0 && byte_count >= NonTemporalStoreThreshold;
+}
+#endif // AMD64
 
 static void pd_fill_to_words(HeapWord* tohw, size_t count, juint value) {
 #ifdef AMD64
   julong* to = (julong*) tohw;
   julong  v  = ((julong) value << 32) | value;
+  if (pd_use_nontemporal_stores(count * HeapWordSize)) {
+    pd_fill_to_words_nontemporal(to, count, v);
+    return;
+  }
   while (count-- > 0) {
     *to++ = v;
   }
@@ -63,6 +80,12 @@ static void pd_fill_to_aligned_words(HeapWord* tohw, size_t count, juint value)
 }
 
 static void pd_fill_to_bytes(void* to, size_t count, jubyte value) {
+#ifdef AMD64
+  if (pd_use_nontemporal_stores(count)) {
+    pd_fill_to_bytes_nontemporal(to, count, value);
+    return;
+  }
+#endif // AMD64
   (void)memset(to, value, count);
 }
 
@@ -71,7 +94,7 @@ static void pd_zero_to_words(HeapWord* tohw, size_t count) {
 }
 
 static void pd_zero_to_bytes(void* to, size_t count) {
-  (void)memset(to, 0, count);
+  pd_fill_to_bytes(to, count, 0);
 }
 
 #endif // CPU_X86_VM_COPY_X86_HPP
@@ -130,6 +130,10 @@ define_pd_global(uintx, TypeProfileLevel, JVMCI_ONLY(0) NOT_JVMCI(111));
   product(bool, UseFastStosb, false,                                        \
           "Use fast-string operation for zeroing: rep stosb")               \
                                                                             \
+  product(uintx, NonTemporalStoreThreshold, 4*M,                            \
+          "Use non-temporal stores for bulk zeroing and copying of at "     \
+          "least this many bytes on x64 (0 disables)")                      \
+                                                                            \
   /* Use Restricted Transactional Memory for lock eliding */                \
   product(bool, UseRTMLocking, false,                                       \
           "Enable RTM lock eliding for inflated locks in compiled code")    \
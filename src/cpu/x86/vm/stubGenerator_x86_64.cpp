@@ -1274,6 +1274,13 @@ class StubGenerator: public StubCodeGenerator {
   }
 
 
+  // Number of qwords from which copy_bytes_forward/backward switch to
+  // non-temporal stores, clipped so it fits an immediate operand.
+  int32_t nontemporal_qword_threshold() {
+    assert(NonTemporalStoreThreshold > 0, "streaming copies are disabled");
+    return (int32_t)MIN2(NonTemporalStoreThreshold / BytesPerLong, (uintx)max_jint);
+  }
+
   // Copy big chunks forward
   //
   // Inputs:
@@ -1288,7 +1295,33 @@ class StubGenerator: public StubCodeGenerator {
                              Register qword_count, Register to,
                              Label& L_copy_bytes, Label& L_copy_8_bytes) {
     DEBUG_ONLY(__ stop("enter at entry label, not here"));
-    Label L_loop;
+    Label L_loop, L_regular;
+    Label& L_entry = (NonTemporalStoreThreshold > 0) ? L_regular : L_copy_bytes;
+    if (NonTemporalStoreThreshold > 0) {
+      // Stream copies of at least NonTemporalStoreThreshold bytes past the
+      // caches, then let the regular code below copy the remaining qwords.
+      Label L_nt_loop, L_nt_entry;
+      __ BIND(L_copy_bytes);
+      __ cmpptr(qword_count, -nontemporal_qword_threshold());
+      __ jcc(Assembler::greater, L_entry);
+      __ jmpb(L_nt_entry);
+      __ align(OptoLoopAlignment);
+      __ BIND(L_nt_loop);
+      __ movq(to, Address(end_from, qword_count, Address::times_8, -24));
+      __ movntiq(Address(end_to, qword_count, Address::times_8, -24), to);
+      __ movq(to, Address(end_from, qword_count, Address::times_8, -16));
+      __ movntiq(Address(end_to, qword_count, Address::times_8, -16), to);
+      __ movq(to, Address(end_from, qword_count, Address::times_8, - 8));
+      __ movntiq(Address(end_to, qword_count, Address::times_8, - 8), to);
+      __ movq(to, Address(end_from, qword_count, Address::times_8, - 0));
+      __ movntiq(Address(end_to, qword_count, Address::times_8, - 0), to);
+      __ BIND(L_nt_entry);
+      __ addptr(qword_count, 4);
+      __ jcc(Assembler::lessEqual, L_nt_loop);
+      __ subptr(qword_count, 4);
+      __ sfence();
+      __ jmp(L_entry);
+    }
     __ align(OptoLoopAlignment);
     if (UseUnalignedLoadStores) {
       Label L_end;
@@ -1309,7 +1342,7 @@ class StubGenerator: public StubCodeGenerator {
         __ movdqu(xmm3, Address(end_from, qword_count, Address::times_8, - 8));
         __ movdqu(Address(end_to, qword_count, Address::times_8, - 8), xmm3);
       }
-      __ BIND(L_copy_bytes);
+      __ BIND(L_entry);
       __ addptr(qword_count, 8);
       __ jcc(Assembler::lessEqual, L_loop);
       __ subptr(qword_count, 4);  // sub(8) and add(4)
@@ -1342,7 +1375,7 @@ class StubGenerator: public StubCodeGenerator {
       __ movq(to, Address(end_from, qword_count, Address::times_8, - 0));
       __ movq(Address(end_to, qword_count, Address::times_8, - 0), to);
 
-      __ BIND(L_copy_bytes);
+      __ BIND(L_entry);
       __ addptr(qword_count, 4);
       __ jcc(Assembler::lessEqual, L_loop);
     }
@@ -1364,7 +1397,33 @@ class StubGenerator: public StubCodeGenerator {
                               Register qword_count, Register to,
                               Label& L_copy_bytes, Label& L_copy_8_bytes) {
     DEBUG_ONLY(__ stop("enter at entry label, not here"));
-    Label L_loop;
+    Label L_loop, L_regular;
+    Label& L_entry = (NonTemporalStoreThreshold > 0) ? L_regular : L_copy_bytes;
+    if (NonTemporalStoreThreshold > 0) {
+      // Stream copies of at least NonTemporalStoreThreshold bytes past the
+      // caches, then let the regular code below copy the remaining qwords.
+      Label L_nt_loop, L_nt_entry;
+      __ BIND(L_copy_bytes);
+      __ cmpptr(qword_count, nontemporal_qword_threshold());
+      __ jcc(Assembler::less, L_entry);
+      __ jmpb(L_nt_entry);
+      __ align(OptoLoopAlignment);
+      __ BIND(L_nt_loop);
+      __ movq(to, Address(from, qword_count, Address::times_8, 24));
+      __ movntiq(Address(dest, qword_count, Address::times_8, 24), to);
+      __ movq(to, Address(from, qword_count, Address::times_8, 16));
+      __ movntiq(Address(dest, qword_count, Address::times_8, 16), to);
+      __ movq(to, Address(from, qword_count, Address::times_8,  8));
+      __ movntiq(Address(dest, qword_count, Address::times_8,  8), to);
+      __ movq(to, Address(from, qword_count, Address::times_8,  0));
+      __ movntiq(Address(dest, qword_count, Address::times_8,  0), to);
+      __ BIND(L_nt_entry);
+      __ subptr(qword_count, 4);
+      __ jcc(Assembler::greaterEqual, L_nt_loop);
+      __ addptr(qword_count, 4);
+      __ sfence();
+      __ jmp(L_entry);
+    }
     __ align(OptoLoopAlignment);
     if (UseUnalignedLoadStores) {
       Label L_end;
@@ -1385,7 +1444,7 @@ class StubGenerator: public StubCodeGenerator {
         __ movdqu(xmm3, Address(from, qword_count, Address::times_8,  0));
         __ movdqu(Address(dest, qword_count, Address::times_8,  0), xmm3);
       }
-      __ BIND(L_copy_bytes);
+      __ BIND(L_entry);
       __ subptr(qword_count, 8);
       __ jcc(Assembler::greaterEqual, L_loop);
 
@@ -1419,7 +1478,7 @@ class StubGenerator: public StubCodeGenerator {
       __ movq(to, Address(from, qword_count, Address::times_8,  0));
       __ movq(Address(dest, qword_count, Address::times_8,  0), to);
 
-      __ BIND(L_copy_bytes);
+      __ BIND(L_entry);
       __ subptr(qword_count, 4);
       __ jcc(Assembler::greaterEqual, L_loop);
     }
@@ -2460,6 +2519,162 @@ class StubGenerator: public StubCodeGenerator {
     return start;
   }
 
+  // Shuffle masks reversing the bytes of each 2, 4 or 8 byte element in
+  // a 16 byte lane.  The mask is emitted twice so that it can be loaded
+  // as a 256 bit vector for vpshufb, which shuffles within 128 bit lanes.
+  address generate_swap_shuffle_mask(int elem_size, const char *name) {
+    __ align(32);
+    StubCodeMark mark(this, "StubRoutines", name);
+    address start = __ pc();
+    for (int lane = 0; lane < 2; lane++) {
+      switch (elem_size) {
+      case 2:
+        __ emit_data64( 0x0607040502030001, relocInfo::none );
+        __ emit_data64( 0x0e0f0c0d0a0b0809, relocInfo::none );
+        break;
+      case 4:
+        __ emit_data64( 0x0405060700010203, relocInfo::none );
+        __ emit_data64( 0x0c0d0e0f08090a0b, relocInfo::none );
+        break;
+      case 8:
+        __ emit_data64( 0x0001020304050607, relocInfo::none );
+        __ emit_data64( 0x08090a0b0c0d0e0f, relocInfo::none );
+        break;
+      default:
+        ShouldNotReachHere();
+      }
+    }
+    return start;
+  }
+
+  // Copy one element from src to dst, reversing its bytes. Kills tmp and flags.
+  void swap_element(Address src, Address dst, Register tmp, int elem_size) {
+    switch (elem_size) {
+    case 2:
+      __ movzwl(tmp, src);
+      __ bswapl(tmp);
+      __ shrl(tmp, 16);
+      __ movw(dst, tmp);
+      break;
+    case 4:
+      __ movl(tmp, src);
+      __ bswapl(tmp);
+      __ movl(dst, tmp);
+      break;
+    case 8:
+      __ movq(tmp, src);
+      __ bswapq(tmp);
+      __ movq(dst, tmp);
+      break;
+    default:
+      ShouldNotReachHere();
+    }
+  }
+
+  //
+  //  Generate a byte swapping copy of 2, 4 or 8 byte elements,
+  //  used by Unsafe.copySwapMemory.  Neither address needs to be
+  //  aligned and the ranges may overlap.
+  //
+  //  Input:
+  //    c_rarg0   - source address
+  //    c_rarg1   - destination address
+  //    c_rarg2   - element count, treated as ssize_t, can be zero
+  //
+  //  The bulk of the copy is done with pshufb (SSSE3) or vpshufb (AVX2)
+  //  against a per element size shuffle mask, the remainder with bswap.
+  //  When the destination starts inside the source range the copy is
+  //  done backwards, one element at a time.
+  //
+  address generate_swapcopy(int elem_size, const char *name, const char *mask_name) {
+    Label L_backward, L_backward_loop, L_loop32, L_loop16, L_tail, L_tail_loop, L_exit;
+
+    const Register from        = c_rarg0;  // source address
+    const Register to          = c_rarg1;  // destination address
+    const Register count       = c_rarg2;  // element count, then remaining bytes
+    const Register tmp         = rax;
+    const XMMRegister xmm_data = xmm0;
+    const XMMRegister xmm_mask = xmm1;
+
+    const bool use_avx2  = UseAVX >= 2;
+    const bool use_ssse3 = use_avx2 || (UseSSE >= 3 && VM_Version::supports_ssse3());
+
+    address mask = use_ssse3 ? generate_swap_shuffle_mask(elem_size, mask_name) : NULL;
+
+    __ align(CodeEntryAlignment);
+    StubCodeMark mark(this, "StubRoutines", name);
+    address start = __ pc();
+
+    __ enter(); // required for proper stackwalking of RuntimeStub frame
+
+    __ shlptr(count, exact_log2(elem_size)); // count => byte_count
+
+    // Destination starting inside [from, from + byte_count): copy backwards.
+    __ mov(tmp, to);
+    __ subptr(tmp, from);
+    __ cmpptr(tmp, count);
+    __ jcc(Assembler::below, L_backward);
+
+    if (use_ssse3) {
+      if (use_avx2) {
+        __ lea(tmp, ExternalAddress(mask));
+        __ vmovdqu(xmm_mask, Address(tmp, 0));
+        __ BIND(L_loop32);
+        __ cmpptr(count, 32);
+        __ jccb(Assembler::below, L_loop16);
+        __ vmovdqu(xmm_data, Address(from, 0));
+        __ vpshufb(xmm_data, xmm_data, xmm_mask, true);
+        __ vmovdqu(Address(to, 0), xmm_data);
+        __ addptr(from, 32);
+        __ addptr(to, 32);
+        __ subptr(count, 32);
+        __ jmpb(L_loop32);
+      } else {
+        __ movdqu(xmm_mask, ExternalAddress(mask));
+      }
+      __ BIND(L_loop16);
+      __ cmpptr(count, 16);
+      __ jccb(Assembler::below, L_tail);
+      __ movdqu(xmm_data, Address(from, 0));
+      __ pshufb(xmm_data, xmm_mask);
+      __ movdqu(Address(to, 0), xmm_data);
+      __ addptr(from, 16);
+      __ addptr(to, 16);
+      __ subptr(count, 16);
+      __ jmpb(L_loop16);
+    }
+
+    __ BIND(L_tail);
+    __ testptr(count, count);
+    __ jccb(Assembler::zero, L_exit);
+    __ BIND(L_tail_loop);
+    swap_element(Address(from, 0), Address(to, 0), tmp, elem_size);
+    __ addptr(from, elem_size);
+    __ addptr(to, elem_size);
+    __ subptr(count, elem_size);
+    __ jccb(Assembler::notZero, L_tail_loop);
+    __ jmpb(L_exit);
+
+    __ BIND(L_backward);
+    __ testptr(count, count);
+    __ jccb(Assembler::zero, L_exit);
+    __ BIND(L_backward_loop);
+    __ subptr(count, elem_size);
+    swap_element(Address(from, count, Address::times_1), Address(to, count, Address::times_1), tmp, elem_size);
+    __ testptr(count, count);
+    __ jccb(Assembler::notZero, L_backward_loop);
+
+    __ BIND(L_exit);
+    if (use_avx2) {
+      // Avoid the AVX/SSE transition penalty in the caller.
+      __ vzeroupper();
+    }
+    __ leave(); // required for proper stackwalking of RuntimeStub frame
+    __ ret(0);
+
+    return start;
+  }
+
   // Perform range checks on the proposed arraycopy.
   // Kills temp, but nothing else.
   // Also, clean the sign bits of src_pos and dst_pos.
@@ -2879,6 +3094,10 @@ class StubGenerator: public StubCodeGenerator {
     StubRoutines::_arrayof_jshort_fill = generate_fill(T_SHORT, true, "arrayof_jshort_fill");
     StubRoutines::_arrayof_jint_fill = generate_fill(T_INT, true, "arrayof_jint_fill");
 
+    StubRoutines::_jshort_swapcopy = generate_swapcopy(BytesPerShort, "jshort_swapcopy", "jshort_swapcopy_mask");
+    StubRoutines::_jint_swapcopy   = generate_swapcopy(BytesPerInt,   "jint_swapcopy",   "jint_swapcopy_mask");
+    StubRoutines::_jlong_swapcopy  = generate_swapcopy(BytesPerLong,  "jlong_swapcopy",  "jlong_swapcopy_mask");
+
     // We don't generate specialized code for HeapWord-aligned source
     // arrays, so just use the code we've already generated
     StubRoutines::_arrayof_jbyte_disjoint_arraycopy  = StubRoutines::_jbyte_disjoint_arraycopy;
@@ -929,6 +929,22 @@ void VM_Version::get_processor_features() {
     FLAG_SET_DEFAULT(UseFastStosb, false);
   }
 
+  // Streaming stores bypass the caches and only pay off for blocks much
+  // larger than the last level cache can usefully hold.
+#ifdef _LP64
+  if (NonTemporalStoreThreshold != 0 && NonTemporalStoreThreshold < 64*K) {
+    warning("NonTemporalStoreThreshold is too small, using 64K");
+    FLAG_SET_DEFAULT(NonTemporalStoreThreshold, 64*K);
+  }
+#else
+  if (NonTemporalStoreThreshold != 0) {
+    if (!FLAG_IS_DEFAULT(NonTemporalStoreThreshold)) {
+      warning("NonTemporalStoreThreshold is only supported on x64");
+    }
+    FLAG_SET_DEFAULT(NonTemporalStoreThreshold, 0);
+  }
+#endif
+
 #ifdef COMPILER2
   if (FLAG_IS_DEFAULT(AlignVector)) {
     // Modern processors allow misaligned memory operations for vectors.
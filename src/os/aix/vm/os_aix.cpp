@@ -2689,6 +2689,10 @@ bool os::unguard_memory(char* addr, size_t size) {
 static size_t _large_page_size = 0;
 
 // Enable large page support if OS allows that.
+void os::pd_init_before_ergo() {
+  // nothing to do
+}
+
 void os::large_page_init() {
 
   // Note: os::Aix::query_multipage_support must run first.
@@ -2759,6 +2763,14 @@ bool os::can_execute_large_page_memory() {
   return true;
 }
 
+size_t os::code_huge_page_size() {
+  return 0;
+}
+
+void os::advise_huge_pages_for_code(char* addr, size_t bytes) {
+  // not supported
+}
+
 // Reserve memory at an arbitrary address, only if that area is
 // available (and not reserved for something else).
 char* os::pd_attempt_reserve_memory_at(size_t bytes, char* requested_addr) {
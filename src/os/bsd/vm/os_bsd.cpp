@@ -2373,6 +2373,10 @@ bool os::Bsd::hugetlbfs_sanity_check(bool warn, size_t page_size) {
 
 static size_t _large_page_size = 0;
 
+void os::pd_init_before_ergo() {
+  // nothing to do
+}
+
 void os::large_page_init() {
 }
 
@@ -2470,6 +2474,14 @@ bool os::can_execute_large_page_memory() {
   return UseHugeTLBFS;
 }
 
+size_t os::code_huge_page_size() {
+  return 0;
+}
+
+void os::advise_huge_pages_for_code(char* addr, size_t bytes) {
+  // not supported
+}
+
 // Reserve memory at an arbitrary address, only if that area is
 // available (and not reserved for something else).
 
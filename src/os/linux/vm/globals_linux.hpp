@@ -43,11 +43,35 @@
   product(bool, UseTransparentHugePages, false,                         \
           "Use MADV_HUGEPAGE for large pages")                          \
                                                                         \
+  product(bool, UseTransparentHugePagesForCode, false,                  \
+          "Use MADV_HUGEPAGE for the code cache and the compressed "    \
+          "class space, independently of UseLargePages")                \
+                                                                        \
   product(bool, LoadExecStackDllInVMThread, true,                       \
           "Load DLLs with executable-stack attribute in the VM Thread") \
                                                                         \
   product(bool, UseSHM, false,                                          \
-          "Use SYSV shared memory for large pages")
+          "Use SYSV shared memory for large pages")                     \
+                                                                        \
+  product(bool, PerfDataUseShmBacking, false,                           \
+          "Back the shared PerfData memory with a POSIX shared memory " \
+          "object in /dev/shm, which is never written back to disk, "   \
+          "and publish it in the hsperfdata directory via a symlink")    \
+                                                                        \
+  product(bool, UseContainerSupport, true,                              \
+          "Size the ergonomics for the CPU and memory limits of the "   \
+          "cgroup the VM runs in")                                      \
+                                                                        \
+  product(intx, ActiveProcessorCount, -1,                               \
+          "Override the number of CPUs the VM uses to size its thread " \
+          "pools, -1 uses the number the OS and cgroup allow")          \
+                                                                        \
+  diagnostic(bool, PrintContainerInfo, false,                           \
+          "Print the cgroup CPU and memory limits at startup")          \
+                                                                        \
+  diagnostic(ccstr, CgroupFileSystemRoot, NULL,                         \
+          "Directory prefixed to the /proc and cgroup file system "     \
+          "paths read for UseContainerSupport, for testing")
 
 //
 // Defines Linux-specific default values. The flags are available on all
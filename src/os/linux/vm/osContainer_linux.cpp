@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "osContainer_linux.hpp"
+#include "prims/jvm.h"
+#include "runtime/globals.hpp"
+#include "runtime/os.hpp"
+
+# include <stdio.h>
+# include <string.h>
+
+bool  OSContainer::_is_containerized = false;
+int   OSContainer::_cgroup_version = 0;
+jlong OSContainer::_memory_limit = -1;
+int   OSContainer::_cpu_limit = -1;
+
+char  OSContainer::_memory_dir[JVM_MAXPATHLEN] = "";
+char  OSContainer::_cpu_dir[JVM_MAXPATHLEN] = "";
+char  OSContainer::_cpuset_dir[JVM_MAXPATHLEN] = "";
+
+// All paths are prefixed with CgroupFileSystemRoot, which lets tests supply
+// a mocked /proc and cgroup file system.
+static const char* fs_root() {
+  return CgroupFileSystemRoot != NULL ? CgroupFileSystemRoot : "";
+}
+
+// read the first line of <dir>/<name> into buf, without the newline.
+// returns false if the file cannot be read.
+//
+static bool read_first_line(const char* dir, const char* name, char* buf, int buflen) {
+  char path[JVM_MAXPATHLEN];
+  int len = jio_snprintf(path, sizeof(path), "%s/%s", dir, name);
+  if (len < 0 || len >= (int)sizeof(path)) {
+    return false;
+  }
+  FILE* fp = fopen(path, "r");
+  if (fp == NULL) {
+    return false;
+  }
+  char* line = fgets(buf, buflen, fp);
+  fclose(fp);
+  if (line == NULL) {
+    return false;
+  }
+  char* nl = strchr(buf, '\n');
+  if (nl != NULL) {
+    *nl = '\0';
+  }
+  return true;
+}
+
+// read a single number from <dir>/<name>. returns -1 if the file cannot
+// be read or holds "max", the cgroup v2 spelling of unlimited.
+//
+static jlong read_number(const char* dir, const char* name) {
+  char buf[64];
+  jlong value;
+  if (dir[0] == '\0' ||
+      !read_first_line(dir, name, buf, sizeof(buf)) ||
+      sscanf(buf, JLONG_FORMAT, &value) != 1) {
+    return -1;
+  }
+  return value;
+}
+
+// count the CPUs in a cpuset list such as "0-3,8,10-11"
+//
+static int count_cpus(const char* list) {
+  int count = 0;
+  const char* p = list;
+  while (*p != '\0') {
+    int lo, hi, n;
+    if (sscanf(p, "%d-%d%n", &lo, &hi, &n) == 2) {
+      count += hi - lo + 1;
+    } else if (sscanf(p, "%d%n", &lo, &n) == 1) {
+      count++;
+    } else {
+      return -1;
+    }
+    p += n;
+    if (*p == ',') {
+      p++;
+    } else if (*p != '\0') {
+      return -1;
+    }
+  }
+  return count;
+}
+
+// does the comma separated option list contain the given option?
+//
+static bool has_option(const char* options, const char* option) {
+  size_t len = strlen(option);
+  const char* p = options;
+  while ((p = strstr(p, option)) != NULL) {
+    if ((p == options || p[-1] == ',') && (p[len] == ',' || p[len] == '\0')) {
+      return true;
+    }
+    p += len;
+  }
+  return false;
+}
+
+// The directory of a controller is the mount point plus the part of the
+// process' cgroup path below the root of the mount. Inside a cgroup
+// namespace the mount root is the process' cgroup itself.
+//
+static void set_controller_dir(char* dir, const char* mount_root,
+                               const char* mount_point, const char* cgroup_path) {
+  const char* rest = "";
+  size_t root_len = strlen(mount_root);
+  if (strcmp(mount_root, "/") == 0) {
+    rest = strcmp(cgroup_path, "/") == 0 ? "" : cgroup_path;
+  } else if (strncmp(cgroup_path, mount_root, root_len) == 0) {
+    rest = cgroup_path + root_len;
+  }
+  jio_snprintf(dir, JVM_MAXPATHLEN, "%s%s%s", fs_root(), mount_point, rest);
+}
+
+bool OSContainer::find_controllers() {
+  char path[JVM_MAXPATHLEN];
+  char line[JVM_MAXPATHLEN + 256];
+
+  // /proc/self/cgroup: "<hierarchy>:<controllers>:<path>", the single
+  // cgroup v2 entry is "0::<path>"
+  char memory_path[JVM_MAXPATHLEN] = "";
+  char cpu_path[JVM_MAXPATHLEN] = "";
+  char cpuset_path[JVM_MAXPATHLEN] = "";
+  char unified_path[JVM_MAXPATHLEN] = "";
+
+  jio_snprintf(path, sizeof(path), "%s/proc/self/cgroup", fs_root());
+  FILE* fp = fopen(path, "r");
+  if (fp == NULL) {
+    return false;
+  }
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    char* nl = strchr(line, '\n');
+    if (nl != NULL) *nl = '\0';
+    char* controllers = strchr(line, ':');
+    char* cgroup_path = controllers == NULL ? NULL : strchr(controllers + 1, ':');
+    if (cgroup_path == NULL) {
+      continue;
+    }
+    *controllers++ = '\0';
+    *cgroup_path++ = '\0';
+    if (strcmp(line, "0") == 0 && *controllers == '\0') {
+      strncpy(unified_path, cgroup_path, sizeof(unified_path) - 1);
+    } else {
+      if (has_option(controllers, "memory")) strncpy(memory_path, cgroup_path, sizeof(memory_path) - 1);
+      if (has_option(controllers, "cpu"))    strncpy(cpu_path, cgroup_path, sizeof(cpu_path) - 1);
+      if (has_option(controllers, "cpuset")) strncpy(cpuset_path, cgroup_path, sizeof(cpuset_path) - 1);
+    }
+  }
+  fclose(fp);
+
+  // /proc/self/mountinfo: "<id> <parent> <major:minor> <root> <mount point>
+  // <options> [<optional fields>] - <fs type> <source> <super options>"
+  jio_snprintf(path, sizeof(path), "%s/proc/self/mountinfo", fs_root());
+  fp = fopen(path, "r");
+  if (fp == NULL) {
+    return false;
+  }
+  bool v1 = false;
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    char fs_type[64];
+    char super_options[256];
+    char* separator = strstr(line, " - ");
+    if (separator == NULL ||
+        sscanf(separator + 3, "%63s %*s %255s", fs_type, super_options) != 2) {
+      continue;
+    }
+    // The root and the mount point are the 4th and 5th fields. They are
+    // used in place, but must still fit a path buffer.
+    char* saveptr;
+    char* root = strtok_r(line, " ", &saveptr);
+    for (int i = 0; i < 3 && root != NULL; i++) {
+      root = strtok_r(NULL, " ", &saveptr);
+    }
+    char* mount_point = root == NULL ? NULL : strtok_r(NULL, " ", &saveptr);
+    if (mount_point == NULL || mount_point >= separator ||
+        strlen(root) >= JVM_MAXPATHLEN || strlen(mount_point) >= JVM_MAXPATHLEN) {
+      continue;
+    }
+    if (strcmp(fs_type, "cgroup") == 0) {
+      if (has_option(super_options, "memory") && memory_path[0] != '\0') {
+        set_controller_dir(_memory_dir, root, mount_point, memory_path);
+        v1 = true;
+      }
+      if (has_option(super_options, "cpu") && cpu_path[0] != '\0') {
+        set_controller_dir(_cpu_dir, root, mount_point, cpu_path);
+        v1 = true;
+      }
+      if (has_option(super_options, "cpuset") && cpuset_path[0] != '\0') {
+        set_controller_dir(_cpuset_dir, root, mount_point, cpuset_path);
+      }
+    } else if (strcmp(fs_type, "cgroup2") == 0 && unified_path[0] != '\0' && !v1) {
+      set_controller_dir(_memory_dir, root, mount_point, unified_path);
+      strcpy(_cpu_dir, _memory_dir);
+      strcpy(_cpuset_dir, _memory_dir);
+      _cgroup_version = 2;
+    }
+  }
+  fclose(fp);
+
+  if (v1) {
+    // on a hybrid hierarchy the v1 controllers are the ones in effect
+    _cgroup_version = 1;
+  }
+  return _cgroup_version != 0;
+}
+
+jlong OSContainer::read_memory_limit() {
+  jlong limit = read_number(_memory_dir, _cgroup_version == 1 ? "memory.limit_in_bytes" : "memory.max");
+  // cgroup v1 reports an unlimited cgroup as a huge number
+  if (limit <= 0 || (julong)limit >= os::physical_memory()) {
+    return -1;
+  }
+  return limit;
+}
+
+int OSContainer::read_cpu_quota_limit() {
+  jlong quota;
+  jlong period;
+  if (_cgroup_version == 1) {
+    quota = read_number(_cpu_dir, "cpu.cfs_quota_us");
+    period = read_number(_cpu_dir, "cpu.cfs_period_us");
+  } else {
+    // "<quota> <period>" where the quota may be "max"
+    char buf[64];
+    if (_cpu_dir[0] == '\0' || !read_first_line(_cpu_dir, "cpu.max", buf, sizeof(buf)) ||
+        sscanf(buf, JLONG_FORMAT " " JLONG_FORMAT, &quota, &period) != 2) {
+      return -1;
+    }
+  }
+  if (quota <= 0 || period <= 0) {
+    return -1;
+  }
+  // round up, a quota of half a CPU still needs one thread
+  return (int)((quota + period - 1) / period);
+}
+
+int OSContainer::read_cpuset_limit() {
+  char buf[1024];
+  if (_cpuset_dir[0] == '\0' ||
+      !read_first_line(_cpuset_dir, _cgroup_version == 1 ? "cpuset.cpus" : "cpuset.cpus.effective",
+                       buf, sizeof(buf))) {
+    return -1;
+  }
+  int count = count_cpus(buf);
+  return count > 0 ? count : -1;
+}
+
+void OSContainer::init() {
+  assert(!_is_containerized, "initializing twice");
+  if (!find_controllers()) {
+    if (PrintContainerInfo) {
+      tty->print_cr("container: no cgroup controllers found");
+    }
+    return;
+  }
+  _is_containerized = true;
+  _memory_limit = read_memory_limit();
+
+  int quota_cpus = read_cpu_quota_limit();
+  int cpuset_cpus = read_cpuset_limit();
+  if (quota_cpus > 0 && cpuset_cpus > 0) {
+    _cpu_limit = MIN2(quota_cpus, cpuset_cpus);
+  } else {
+    _cpu_limit = MAX2(quota_cpus, cpuset_cpus);
+  }
+
+  if (PrintContainerInfo) {
+    print_container_info(tty);
+  }
+}
+
+jlong OSContainer::memory_usage_in_bytes() {
+  if (!_is_containerized) {
+    return -1;
+  }
+  return read_number(_memory_dir, _cgroup_version == 1 ? "memory.usage_in_bytes" : "memory.current");
+}
+
+void OSContainer::print_container_info(outputStream* st) {
+  if (!_is_containerized) {
+    return;
+  }
+  st->print_cr("container (cgroup v%d) information:", _cgroup_version);
+  if (_memory_limit > 0) {
+    st->print_cr("  memory limit: " JLONG_FORMAT "k", _memory_limit / K);
+  } else {
+    st->print_cr("  memory limit: unlimited");
+  }
+  if (_cpu_limit > 0) {
+    st->print_cr("  cpu limit: %d", _cpu_limit);
+  } else {
+    st->print_cr("  cpu limit: unlimited");
+  }
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#ifndef OS_LINUX_VM_OSCONTAINER_LINUX_HPP
+#define OS_LINUX_VM_OSCONTAINER_LINUX_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/ostream.hpp"
+
+// OSContainer reads the CPU and memory limits that the cgroup (v1 or v2)
+// of the VM imposes on it, so that the ergonomics size the heap, the GC
+// and the compiler thread counts for the container instead of the host.
+//
+// The limits are read once, after the command line flags have been parsed
+// and before the ergonomics run.
+
+class OSContainer: AllStatic {
+ private:
+  static bool  _is_containerized;
+  static int   _cgroup_version;
+  static jlong _memory_limit;
+  static int   _cpu_limit;
+
+  static char  _memory_dir[];
+  static char  _cpu_dir[];
+  static char  _cpuset_dir[];
+
+  static bool  find_controllers();
+  static jlong read_memory_limit();
+  static int   read_cpu_quota_limit();
+  static int   read_cpuset_limit();
+
+ public:
+  static void  init();
+
+  static bool  is_containerized()  { return _is_containerized; }
+
+  // The memory limit in bytes, or -1 if the memory is not limited
+  static jlong memory_limit_in_bytes()  { return _memory_limit; }
+
+  // The memory currently charged to the cgroup, or -1 if unknown
+  static jlong memory_usage_in_bytes();
+
+  // The number of CPUs the quota and cpuset allow, or -1 if not limited
+  static int   cpu_limit()  { return _cpu_limit; }
+
+  static void  print_container_info(outputStream* st);
+};
+
+#endif // OS_LINUX_VM_OSCONTAINER_LINUX_HPP
@@ -36,6 +36,7 @@
 #include "memory/filemap.hpp"
 #include "mutex_linux.inline.hpp"
 #include "oops/oop.inline.hpp"
+#include "osContainer_linux.hpp"
 #include "os_share_linux.hpp"
 #include "prims/jniFastGetField.hpp"
 #include "prims/jvm.h"
@@ -198,6 +199,14 @@ julong os::available_memory() {
 }
 
 julong os::Linux::available_memory() {
+  jlong limit = OSContainer::memory_limit_in_bytes();
+  if (limit > 0) {
+    jlong usage = OSContainer::memory_usage_in_bytes();
+    if (usage >= 0) {
+      return limit > usage ? (julong)(limit - usage) : 0;
+    }
+  }
+
   // values in struct sysinfo are "unsigned long"
   struct sysinfo si;
   sysinfo(&si);
@@ -321,6 +330,18 @@ void os::Linux::initialize_system_info() {
   assert(processor_count() > 0, "linux error");
 }
 
+void os::Linux::init_container_support() {
+  if (!UseContainerSupport) {
+    return;
+  }
+  OSContainer::init();
+
+  jlong limit = OSContainer::memory_limit_in_bytes();
+  if (limit > 0 && (julong)limit < _physical_memory) {
+    _physical_memory = (julong)limit;
+  }
+}
+
 void os::init_system_properties_values() {
   // The next steps are taken in the product version:
   //
@@ -2147,6 +2168,8 @@ void os::print_os_info(outputStream* st) {
   os::Posix::print_load_average(st);
 
   os::Linux::print_full_memory_info(st);
+
+  OSContainer::print_container_info(st);
 }
 
 // Try to identify popular distros.
@@ -3349,6 +3372,63 @@ bool os::Linux::setup_large_page_type(size_t page_size) {
   return UseSHM;
 }
 
+// Transparent huge pages for the code cache and the compressed class space
+
+static size_t _code_huge_page_size = 0;
+
+void os::Linux::init_transparent_huge_pages_for_code() {
+  if (!UseTransparentHugePagesForCode) {
+    return;
+  }
+
+  // madvise(MADV_HUGEPAGE) succeeds even if the system administrator has
+  // turned transparent huge pages off, so check the global mode first.
+  bool enabled = true;
+  FILE* fp = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+  if (fp != NULL) {
+    char buf[64];
+    if (fgets(buf, sizeof(buf), fp) != NULL && strstr(buf, "[never]") != NULL) {
+      enabled = false;
+    }
+    fclose(fp);
+  }
+
+  size_t page_size = _large_page_size != 0 ? _large_page_size : find_large_page_size();
+  if (!enabled || page_size <= (size_t)Linux::page_size() ||
+      !transparent_huge_pages_sanity_check(false, page_size)) {
+    if (!FLAG_IS_DEFAULT(UseTransparentHugePagesForCode)) {
+      warning("UseTransparentHugePagesForCode is disabled: transparent huge pages "
+              "are not supported or not enabled by the operating system.");
+    }
+    UseTransparentHugePagesForCode = false;
+    return;
+  }
+  _code_huge_page_size = page_size;
+}
+
+size_t os::code_huge_page_size() {
+  return _code_huge_page_size;
+}
+
+void os::advise_huge_pages_for_code(char* addr, size_t bytes) {
+  if (!UseTransparentHugePagesForCode) {
+    return;
+  }
+  // Only the huge pages that lie completely inside the range are advised:
+  // the commit and uncommit granularity of the caller stays unchanged.
+  char* start = (char*)align_ptr_up(addr, _code_huge_page_size);
+  char* end = (char*)align_ptr_down(addr + bytes, _code_huge_page_size);
+  if (start < end) {
+    // We don't check the return value, see os::pd_realign_memory().
+    ::madvise(start, end - start, MADV_HUGEPAGE);
+  }
+}
+
+void os::pd_init_before_ergo() {
+  Linux::init_transparent_huge_pages_for_code();
+  Linux::init_container_support();
+}
+
 void os::large_page_init() {
   if (!UseLargePages &&
       !UseTransparentHugePages &&
@@ -4961,10 +5041,20 @@ void os::make_polling_page_readable(void) {
 };
 
 int os::active_processor_count() {
+  if (ActiveProcessorCount > 0) {
+    // the user has overridden the number of processors
+    return ActiveProcessorCount;
+  }
+
   // Linux doesn't yet have a (official) notion of processor sets,
-  // so just return the number of online processors.
+  // so start from the number of online processors and honor the
+  // CPU quota and cpuset of the cgroup.
   int online_cpus = ::sysconf(_SC_NPROCESSORS_ONLN);
   assert(online_cpus > 0 && online_cpus <= processor_count(), "sanity check");
+  int container_cpus = OSContainer::cpu_limit();
+  if (container_cpus > 0 && container_cpus < online_cpus) {
+    return container_cpus;
+  }
   return online_cpus;
 }
 
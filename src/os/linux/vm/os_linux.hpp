@@ -117,6 +117,15 @@ class Linux {
   static void print_libversion_info(outputStream* st);
 
  public:
+  // Apply the cgroup limits to the physical memory and processor count
+  // before the ergonomics use them.
+  static void init_container_support();
+
+  // Transparent huge pages for the code cache and the compressed class
+  // space, see UseTransparentHugePagesForCode and
+  // os::advise_huge_pages_for_code().
+  static void init_transparent_huge_pages_for_code();
+
   static bool _stack_is_executable;
   static void *dlopen_helper(const char *name, char *ebuf, int ebuflen);
   static void *dll_load_in_vmthread(const char *name, char *ebuf, int ebuflen);
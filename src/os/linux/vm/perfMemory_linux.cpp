@@ -45,6 +45,16 @@
 
 static char* backing_store_file_name = NULL;  // name of the backing store
                                               // file, if successfully created.
+static char* backing_store_shm_name = NULL;   // name of the shared memory
+                                              // object the backing store file
+                                              // links to, if PerfDataUseShmBacking.
+
+// POSIX shared memory objects live in this tmpfs mount. Its pages are never
+// written back to a block device, so a busy host cannot stall the threads
+// updating the PerfData memory in file system writeback, as can happen with
+// a mapping of a file in the temporary directory.
+#define SHM_DIR         "/dev/shm"
+#define SHM_FILE_PREFIX SHM_DIR "/hsperfdata_"
 
 // Standard Memory Implementation Details
 
@@ -578,8 +588,9 @@ static char* get_user_name_slow(int vmid, TRAPS) {
            continue;
         }
 
-        // skip over files that are not regular files.
-        if (!S_ISREG(statbuf.st_mode)) {
+        // skip over files that are not regular files or the symbolic
+        // links published for PerfDataUseShmBacking.
+        if (!S_ISREG(statbuf.st_mode) && !S_ISLNK(statbuf.st_mode)) {
           FREE_C_HEAP_ARRAY(char, filename, mtInternal);
           continue;
         }
@@ -633,6 +644,60 @@ static char* get_sharedmem_filename(const char* dirname, int vmid) {
   return name;
 }
 
+// return the file name of the shared memory object that backs the
+// PerfData memory of the given user name and vmid when PerfDataUseShmBacking
+// is set.
+//
+// the caller is expected to free the allocated memory.
+//
+static char* get_shm_filename(const char* user, int vmid) {
+
+  // add 2 for the '_' separator and a null terminator.
+  size_t nbytes = strlen(SHM_FILE_PREFIX) + strlen(user) + UINT_CHARS + 2;
+
+  char* name = NEW_C_HEAP_ARRAY(char, nbytes, mtInternal);
+  snprintf(name, nbytes, "%s%s_%d", SHM_FILE_PREFIX, user, vmid);
+
+  return name;
+}
+
+// return true if the given path names a shared memory object created by
+// get_shm_filename(), i.e., a file directly within SHM_DIR.
+//
+static bool is_shm_filename(const char* path) {
+  size_t len = strlen(SHM_FILE_PREFIX);
+  return strncmp(path, SHM_FILE_PREFIX, len) == 0 && strchr(path + len, '/') == NULL;
+}
+
+// return the target of the symbolic link at the given path if it names a
+// shared memory object, or NULL otherwise. The owner of the link is
+// returned in ownerp.
+//
+static char* get_shm_link_target(const char* path, uid_t* ownerp) {
+
+  struct stat statbuf;
+  int result;
+
+  RESTARTABLE(::lstat(path, &statbuf), result);
+  if (result == OS_ERR || !S_ISLNK(statbuf.st_mode)) {
+    return NULL;
+  }
+
+  char* target = NEW_RESOURCE_ARRAY(char, PATH_MAX);
+  ssize_t len;
+  RESTARTABLE(::readlink(path, target, PATH_MAX - 1), len);
+  if (len <= 0) {
+    return NULL;
+  }
+  target[len] = '\0';
+
+  if (!is_shm_filename(target)) {
+    return NULL;
+  }
+  *ownerp = statbuf.st_uid;
+  return target;
+}
+
 
 // remove file
 //
@@ -657,6 +722,25 @@ static void remove_file(const char* path) {
 }
 
 
+// remove a stale entry of the user temporary directory, which is the
+// current working directory. If the entry is the symbolic link published
+// for PerfDataUseShmBacking, the shared memory object is removed as well.
+//
+static void remove_stale_entry(const char* name) {
+
+  char target[PATH_MAX];
+  ssize_t len;
+
+  RESTARTABLE(::readlink(name, target, sizeof(target) - 1), len);
+  if (len > 0) {
+    target[len] = '\0';
+    if (is_shm_filename(target)) {
+      remove_file(target);
+    }
+  }
+  unlink(name);
+}
+
 // cleanup stale shared memory resources
 //
 // This method attempts to remove all stale shared memory files in
@@ -718,7 +802,7 @@ static void cleanup_sharedmem_resources(const char* dirname) {
     //
     if ((pid == os::current_process_id()) ||
         (kill(pid, 0) == OS_ERR && (errno == ESRCH || errno == EPERM))) {
-        unlink(entry->d_name);
+        remove_stale_entry(entry->d_name);
     }
     errno = 0;
   }
@@ -767,6 +851,30 @@ static bool make_user_tmp_dir(const char* dirname) {
   return true;
 }
 
+// Verify that we have enough space for the file by writing to each of
+// its pages. We'll get random SIGBUS crashes on memory accesses if we
+// don't.
+//
+static bool reserve_file_space(int fd, const char* filename, size_t size) {
+
+  int result = 0;
+
+  for (size_t seekpos = 0; seekpos < size; seekpos += os::vm_page_size()) {
+    int zero_int = 0;
+    result = (int)os::seek_to_file_offset(fd, (jlong)(seekpos));
+    if (result == -1 ) break;
+    RESTARTABLE(::write(fd, &zero_int, 1), result);
+    if (result != 1) {
+      if (errno == ENOSPC) {
+        warning("Insufficient space for shared memory file:\n   %s\nTry using the -Djava.io.tmpdir= option to select an alternate temp location.\n", filename);
+      }
+      break;
+    }
+  }
+
+  return result != -1;
+}
+
 // create the shared memory file resources
 //
 // This method creates the shared memory file with the given size
@@ -840,29 +948,83 @@ static int create_sharedmem_resources(const char* dirname, const char* filename,
     return -1;
   }
 
-  // Verify that we have enough disk space for this file.
-  // We'll get random SIGBUS crashes on memory accesses if
-  // we don't.
+  if (reserve_file_space(fd, filename, size)) {
+    return fd;
+  } else {
+    ::close(fd);
+    return -1;
+  }
+}
+
+// create the shared memory object resources for PerfDataUseShmBacking
+//
+// This method creates the shared memory object with the given size and
+// publishes it in the user specific temporary directory with a symbolic
+// link named like the backing store file, so that tools discovering JVMs
+// by scanning that directory still find this one. It also creates the
+// user specific temporary directory, if it does not yet exist.
+//
+static int create_shm_resources(const char* dirname, const char* filename,
+                                const char* shm_name, size_t size) {
 
-  for (size_t seekpos = 0; seekpos < size; seekpos += os::vm_page_size()) {
-    int zero_int = 0;
-    result = (int)os::seek_to_file_offset(fd, (jlong)(seekpos));
-    if (result == -1 ) break;
-    RESTARTABLE(::write(fd, &zero_int, 1), result);
-    if (result != 1) {
-      if (errno == ENOSPC) {
-        warning("Insufficient space for shared memory file:\n   %s\nTry using the -Djava.io.tmpdir= option to select an alternate temp location.\n", filename);
-      }
-      break;
+  // make the user temporary directory
+  if (!make_user_tmp_dir(dirname)) {
+    return -1;
+  }
+
+  // The object name is derived from our pid, so an existing object of
+  // ours was left behind by a process that had the same pid.
+  struct stat statbuf;
+  int result;
+  RESTARTABLE(::lstat(shm_name, &statbuf), result);
+  if (result != OS_ERR && S_ISREG(statbuf.st_mode) && statbuf.st_uid == geteuid()) {
+    remove_file(shm_name);
+  }
+
+  // SHM_DIR is world writable; O_EXCL makes sure we never use an object
+  // planted by another user.
+  RESTARTABLE(::open(shm_name, O_RDWR|O_CREAT|O_EXCL|O_NOFOLLOW, S_IREAD|S_IWRITE), result);
+  if (result == OS_ERR) {
+    if (PrintMiscellaneous && Verbose) {
+      warning("could not create shared memory object %s: %s\n", shm_name, strerror(errno));
     }
+    return -1;
   }
+  int fd = result;
 
-  if (result != -1) {
-    return fd;
-  } else {
+  RESTARTABLE(::ftruncate(fd, (off_t)size), result);
+  if (result == OS_ERR || !reserve_file_space(fd, shm_name, size)) {
+    if (PrintMiscellaneous && Verbose) {
+      warning("could not set shared memory object size: %s\n", strerror(errno));
+    }
     ::close(fd);
+    remove_file(shm_name);
     return -1;
   }
+
+  int saved_cwd_fd;
+  // open the directory and set the current working directory to it
+  DIR* dirp = open_directory_secure_cwd(dirname, &saved_cwd_fd);
+  if (dirp == NULL) {
+    ::close(fd);
+    remove_file(shm_name);
+    return -1;
+  }
+
+  RESTARTABLE(::symlink(shm_name, filename), result);
+  if (result == OS_ERR && PrintMiscellaneous && Verbose) {
+    warning("could not create symbolic link %s: %s\n", filename, strerror(errno));
+  }
+
+  // close the directory and reset the current working directory
+  close_directory_secure_cwd(dirp, saved_cwd_fd);
+
+  if (result == OS_ERR) {
+    ::close(fd);
+    remove_file(shm_name);
+    return -1;
+  }
+  return fd;
 }
 
 // open the shared memory file for the given user and vmid. returns
@@ -940,7 +1102,22 @@ static char* mmap_create_shared(size_t size) {
   assert(((size > 0) && (size % os::vm_page_size() == 0)),
          "unexpected PerfMemory region size");
 
-  fd = create_sharedmem_resources(dirname, short_filename, size);
+  fd = -1;
+  char* shm_name = NULL;
+  if (PerfDataUseShmBacking) {
+    shm_name = get_shm_filename(user_name, vmid);
+    fd = create_shm_resources(dirname, short_filename, shm_name, size);
+    if (fd == -1) {
+      if (PrintMiscellaneous && Verbose) {
+        warning("Reverting to a file backing the shared PerfMemory region.\n");
+      }
+      FREE_C_HEAP_ARRAY(char, shm_name, mtInternal);
+      shm_name = NULL;
+    }
+  }
+  if (fd == -1) {
+    fd = create_sharedmem_resources(dirname, short_filename, size);
+  }
 
   FREE_C_HEAP_ARRAY(char, user_name, mtInternal);
   FREE_C_HEAP_ARRAY(char, dirname, mtInternal);
@@ -961,11 +1138,16 @@ static char* mmap_create_shared(size_t size) {
     }
     remove_file(filename);
     FREE_C_HEAP_ARRAY(char, filename, mtInternal);
+    if (shm_name != NULL) {
+      remove_file(shm_name);
+      FREE_C_HEAP_ARRAY(char, shm_name, mtInternal);
+    }
     return NULL;
   }
 
-  // save the file name for use in delete_shared_memory()
+  // save the file names for use in delete_shared_memory()
   backing_store_file_name = filename;
+  backing_store_shm_name = shm_name;
 
   // clear the shared memory region
   (void)::memset((void*) mapAddress, 0, size);
@@ -1008,6 +1190,10 @@ static void delete_shared_memory(char* addr, size_t size) {
     // FREE_C_HEAP_ARRAY(char, backing_store_file_name);
     backing_store_file_name = NULL;
   }
+  if (backing_store_shm_name != NULL) {
+    remove_file(backing_store_shm_name);
+    backing_store_shm_name = NULL;
+  }
 }
 
 // return the size of the file for the given file descriptor
@@ -1108,6 +1294,15 @@ static void mmap_attach_shared(const char* user, int vmid, PerfMemory::PerfMemor
   FREE_C_HEAP_ARRAY(char, dirname, mtInternal);
   FREE_C_HEAP_ARRAY(char, filename, mtInternal);
 
+  // A JVM running with PerfDataUseShmBacking publishes a symbolic link to
+  // its shared memory object instead of a file. Follow only links of that
+  // form, and only to an object owned by the owner of the link.
+  uid_t shm_owner = 0;
+  char* shm_name = get_shm_link_target(rfilename, &shm_owner);
+  if (shm_name != NULL) {
+    rfilename = shm_name;
+  }
+
   // open the shared memory file for the give vmid
   fd = open_sharedmem_file(rfilename, file_flags, THREAD);
 
@@ -1120,6 +1315,16 @@ static void mmap_attach_shared(const char* user, int vmid, PerfMemory::PerfMemor
     return;
   }
 
+  if (shm_name != NULL) {
+    struct stat statbuf;
+    RESTARTABLE(::fstat(fd, &statbuf), result);
+    if (result == OS_ERR || statbuf.st_uid != shm_owner) {
+      ::close(fd);
+      THROW_MSG(vmSymbols::java_lang_IllegalArgumentException(),
+                "Process not found");
+    }
+  }
+
   if (*sizep == 0) {
     size = sharedmem_filesize(fd, CHECK);
   } else {
@@ -3241,6 +3241,10 @@ bool os::Solaris::mpss_sanity_check(bool warn, size_t* page_size) {
   return true;
 }
 
+void os::pd_init_before_ergo() {
+  // nothing to do
+}
+
 void os::large_page_init() {
   if (UseLargePages) {
     // print a warning if any large page related flag is specified on command line
@@ -3290,6 +3294,14 @@ bool os::can_execute_large_page_memory() {
   return true;
 }
 
+size_t os::code_huge_page_size() {
+  return 0;
+}
+
+void os::advise_huge_pages_for_code(char* addr, size_t bytes) {
+  // not supported
+}
+
 static int os_sleep(jlong millis, bool interruptible) {
   const jlong limit = INT_MAX;
   jlong prevtime;
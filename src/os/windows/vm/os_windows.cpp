@@ -3048,6 +3048,10 @@ static char* allocate_pages_individually(size_t bytes, char* addr, DWORD flags,
 
 
 
+void os::pd_init_before_ergo() {
+  // nothing to do
+}
+
 void os::large_page_init() {
   if (!UseLargePages) return;
 
@@ -3197,6 +3201,14 @@ bool os::can_execute_large_page_memory() {
   return true;
 }
 
+size_t os::code_huge_page_size() {
+  return 0;
+}
+
+void os::advise_huge_pages_for_code(char* addr, size_t bytes) {
+  // not supported
+}
+
 char* os::reserve_memory_special(size_t bytes, size_t alignment, char* addr, bool exec) {
   assert(UseLargePages, "only for large pages");
 
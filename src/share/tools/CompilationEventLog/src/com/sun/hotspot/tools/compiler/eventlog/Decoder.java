@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/**
+ * Decoder for the binary compilation event log written by
+ * jcmd Compiler.event_log.  The layout mirrors CompilationEventLog::Header
+ * and CompilationEventLog::Record in compilationEventLog.hpp.
+ */
+
+package com.sun.hotspot.tools.compiler.eventlog;
+
+import java.io.DataInputStream;
+import java.io.FileInputStream;
+import java.io.IOException;
+import java.io.PrintStream;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+public class Decoder {
+
+    static final int HEADER_SIZE = 32;
+    static final int FORMAT_VERSION = 1;
+    static final int NAME_LENGTH = 80;
+
+    static final int IS_OSR = 1 << 0;
+    static final int IS_BLOCKING = 1 << 1;
+
+    static final String[] TYPE_NAMES = {
+        "unknown", "enqueue", "start", "inlining", "install",
+        "failure", "not_entrant", "zombie", "unloaded", "flush"
+    };
+
+    static final int ENQUEUE = 1;
+    static final int START = 2;
+    static final int INLINING = 3;
+    static final int INSTALL = 4;
+    static final int NOT_ENTRANT = 6;
+    static final int FLUSH = 9;
+
+    public static void usage() {
+        System.out.println("Usage: Decoder [-id <compile id>] <file>");
+        System.exit(1);
+    }
+
+    public static void main(String[] args) throws IOException {
+        int selectedId = -1;
+        String file = null;
+        int index = 0;
+        while (index < args.length) {
+            if (args[index].equals("-id") && index + 1 < args.length) {
+                selectedId = Integer.parseInt(args[index + 1]);
+                index += 2;
+            } else if (args[index].startsWith("-")) {
+                usage();
+            } else {
+                file = args[index++];
+            }
+        }
+        if (file == null) {
+            usage();
+        }
+        decode(file, selectedId, System.out);
+    }
+
+    static void decode(String file, int selectedId, PrintStream out) throws IOException {
+        DataInputStream in = new DataInputStream(new FileInputStream(file));
+        try {
+            byte[] headerBytes = new byte[HEADER_SIZE];
+            in.readFully(headerBytes);
+            ByteBuffer header = ByteBuffer.wrap(headerBytes);
+            if (headerBytes[0] != 'H' || headerBytes[1] != 'S' || headerBytes[2] != 'C' || headerBytes[3] != 'E') {
+                throw new IOException(file + " is not a compilation event log");
+            }
+            // The VM writes in native byte order; the version tells us which one that was.
+            header.order(ByteOrder.LITTLE_ENDIAN);
+            if (header.getInt(4) != FORMAT_VERSION) {
+                header.order(ByteOrder.BIG_ENDIAN);
+                if (header.getInt(4) != FORMAT_VERSION) {
+                    throw new IOException("unsupported compilation event log version");
+                }
+            }
+            ByteOrder order = header.order();
+            int recordSize = header.getInt(8);
+            int count = header.getInt(12);
+            long ticksPerSecond = header.getLong(16);
+
+            out.println("Compilation event log (" + count + " events):");
+            byte[] recordBytes = new byte[recordSize];
+            for (int i = 0; i < count; i++) {
+                in.readFully(recordBytes);
+                ByteBuffer r = ByteBuffer.wrap(recordBytes).order(order);
+                int compileId = r.getInt(24);
+                if (selectedId >= 0 && compileId != selectedId) {
+                    continue;
+                }
+                printRecord(out, r, ticksPerSecond);
+            }
+        } finally {
+            in.close();
+        }
+    }
+
+    static void printRecord(PrintStream out, ByteBuffer r, long ticksPerSecond) {
+        long timestamp = r.getLong(8);
+        long address = r.getLong(16);
+        int compileId = r.getInt(24);
+        int osrBci = r.getInt(28);
+        int value1 = r.getInt(32);
+        int value2 = r.getInt(36);
+        int type = r.get(40) & 0xff;
+        int level = r.get(41) & 0xff;
+        int flags = r.getShort(42) & 0xffff;
+
+        StringBuilder sb = new StringBuilder();
+        sb.append(String.format("Event: %.3f %4d %-11s level=%d",
+                                (double) timestamp / ticksPerSecond, compileId,
+                                type < TYPE_NAMES.length ? TYPE_NAMES[type] : TYPE_NAMES[0], level));
+        if ((flags & IS_OSR) != 0) {
+            sb.append(" osr_bci=").append(osrBci);
+        }
+        if ((flags & IS_BLOCKING) != 0) {
+            sb.append(" blocking");
+        }
+        switch (type) {
+            case ENQUEUE:     sb.append(" hot_count=").append(value1).append(" bytes=").append(value2); break;
+            case START:       sb.append(" queued_us=").append(value1); break;
+            case INLINING:    sb.append(" inlined_bytes=").append(value1).append(" bytes=").append(value2); break;
+            case INSTALL:     sb.append(" insts=").append(value1).append(" total=").append(value2); break;
+            case NOT_ENTRANT: sb.append(" decompiles=").append(value1); break;
+            case FLUSH:       sb.append(" total=").append(value1); break;
+            default:          break;
+        }
+        if (address != 0) {
+            sb.append(String.format(" nmethod=0x%016x", address));
+        }
+        String name = readName(r, 48);
+        if (name.length() > 0) {
+            sb.append(' ').append(name);
+        }
+        out.println(sb.toString());
+    }
+
+    static String readName(ByteBuffer r, int offset) {
+        StringBuilder sb = new StringBuilder();
+        for (int i = 0; i < NAME_LENGTH; i++) {
+            byte b = r.get(offset + i);
+            if (b == 0) {
+                break;
+            }
+            sb.append((char) (b & 0xff));
+        }
+        return sb.toString();
+    }
+}
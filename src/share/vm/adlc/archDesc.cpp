@@ -193,6 +193,7 @@ ArchDesc::ArchDesc()
       _disable_warnings  = 0;
       _dfa_debug         = 0;
       _dfa_small         = 0;
+      _dfa_table         = 0;
       _adl_debug         = 0;
       _adlocation_debug  = 0;
       _internalOpCounter = 0;
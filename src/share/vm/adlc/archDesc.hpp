@@ -34,6 +34,7 @@
 // Minimal declarations for include files
 class  OutputMap;
 class  ProductionState;
+class  DFATable;
 class  Expr;
 
 // STRUCTURE FOR HANDLING INPUT AND OUTPUT FILES
@@ -129,11 +130,14 @@ private:
 
   // Methods for outputting the DFA
   void gen_match(FILE *fp, MatchList &mlist, ProductionState &status, Dict &operands_chained_from);
+  void gen_match_table(FILE *fp, DFATable &table, MatchList &mlist, ProductionState &status, Dict &operands_chained_from);
   void chain_rule(FILE *fp, const char *indent, const char *ideal,
                   const Expr *icost, const char *irule,
-                  Dict &operands_chained_from, ProductionState &status);
+                  Dict &operands_chained_from, ProductionState &status,
+                  DFATable *table = NULL);
   void expand_opclass(FILE *fp, const char *indent, const Expr *cost,
-                      const char *result_type, ProductionState &status);
+                      const char *result_type, ProductionState &status,
+                      DFATable *table = NULL);
   Expr *calc_cost(FILE *fp, const char *spaces, MatchList &mList, ProductionState &status);
   void prune_matchlist(Dict &minimize, MatchList &mlist);
 
@@ -151,6 +155,7 @@ public:
   int   _disable_warnings;              // Do not output warning messages
   int   _dfa_debug;                     // Debug Flag for generated DFA
   int   _dfa_small;                     // Debug Flag for generated DFA
+  int   _dfa_table;                     // Generate a table driven DFA
   int   _adl_debug;                     // Debug Flag for ADLC
   int   _adlocation_debug;              // Debug Flag to use ad file locations
   bool  _cisc_spill_debug;              // Debug Flag to see cisc-spill-instructions
@@ -239,6 +244,7 @@ public:
   void inspectInstructions();        // Build MatchLists for all operands
   void buildDFA(FILE *fp);           // Driver for constructing the DFA
   void gen_dfa_state_body(FILE *fp, Dict &minmize, ProductionState &status, Dict &chained, int i);    // Driver for constructing the DFA state bodies
+  void buildDFATable(FILE *fp, Dict &minimize, ProductionState &status, Dict &chained); // Driver for the table driven DFA
 
   // Helper utilities to generate reduction maps for internal operands
   const char *reduceLeft (char *internalName);
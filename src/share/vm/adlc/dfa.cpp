@@ -108,14 +108,47 @@ private:
 };
 
 
+//------------------------------DFATable---------------------------------------
+// Collect the rows of the table driven DFA (adlc -B) for one ideal opcode.
+// Each match rule refers to a contiguous run of productions which already
+// contains the closure of the rule under chain rules and operand classes,
+// with costs relative to the cost of the match.
+class DFATable {
+private:
+  NameList _matches;        // Rows of the DFATableMatch array
+  NameList _productions;    // Rows of the DFATableProduction array
+  NameList _predicates;     // Predicate source, in order of predicate numbers
+  Dict     _predicate_ids;  // Map predicate source, char*, to its number
+
+public:
+  int      _total_matches;
+  int      _total_productions;
+
+  DFATable(Arena *arena) : _predicate_ids(cmpstr, hashstr, arena),
+                           _total_matches(0), _total_productions(0) { }
+
+  int  productions() const { return _productions.count(); }
+
+  void add_production(const char *result, const char *rule, const Expr *cost, bool always);
+  void add_match(MatchList &mList, const char *cost, int first);
+
+  // Emit the rows for 'opcode' and start over, returns its DFATableOpcode row
+  const char *output_opcode(FILE *fp, const char *opcode, int chain_first);
+  void output_predicates(FILE *fp);
+};
+
+
 //---------------------------Helper Functions----------------------------------
 // cost_check template:
 // 1)      if (STATE__NOT_YET_VALID(EBXREGI) || _cost[EBXREGI] > c) {
 // 2)        DFA_PRODUCTION__SET_VALID(EBXREGI, cmovI_memu_rule, c)
 // 3)      }
 //
+// When building a table driven DFA the production is recorded in 'table',
+// marked unconditional where the generated code would not test it.
 static void cost_check(FILE *fp, const char *spaces,
-                       const char *arrayIdx, const Expr *cost, const char *rule, ProductionState &status) {
+                       const char *arrayIdx, const Expr *cost, const char *rule, ProductionState &status,
+                       DFATable *table = NULL) {
   bool state_check               = false;  // true if this production needs to check validity
   bool cost_check                = false;  // true if this production needs to check cost
   bool cost_is_above_upper_bound = false;  // true if this production is unnecessary due to high cost
@@ -142,7 +175,9 @@ static void cost_check(FILE *fp, const char *spaces,
   // Check for validity and compare to other match costs
   const char *validity_check = status.valid(arrayIdx);
   if( validity_check == unknownValid ) {
-    fprintf(fp, "%sif (STATE__NOT_YET_VALID(%s) || _cost[%s] > %s) {\n",  spaces, arrayIdx, arrayIdx, cost->as_string());
+    if( table == NULL ) {
+      fprintf(fp, "%sif (STATE__NOT_YET_VALID(%s) || _cost[%s] > %s) {\n",  spaces, arrayIdx, arrayIdx, cost->as_string());
+    }
     state_check = true;
     cost_check  = true;
   }
@@ -156,23 +191,29 @@ static void cost_check(FILE *fp, const char *spaces,
     } else if( cost_is_below_lower_bound ) {
       // production will unconditionally overwrite a previous production that had higher cost
     } else {
-      fprintf(fp, "%sif ( /* %s KNOWN_VALID || */ _cost[%s] > %s) {\n",  spaces, arrayIdx, arrayIdx, cost->as_string());
+      if( table == NULL ) {
+        fprintf(fp, "%sif ( /* %s KNOWN_VALID || */ _cost[%s] > %s) {\n",  spaces, arrayIdx, arrayIdx, cost->as_string());
+      }
       cost_check  = true;
     }
   }
 
-  // line 2)
-  // no need to set State vector if our state is knownValid
-  const char *production = (validity_check == knownValid) ? dfa_production : dfa_production_set_valid;
-  fprintf(fp, "%s  %s(%s, %s_rule, %s)", spaces, production, arrayIdx, rule, cost->as_string() );
-  if( validity_check == knownValid ) {
-    if( cost_is_below_lower_bound ) { fprintf(fp, "\t  // overwrites higher cost rule"); }
-   }
-   fprintf(fp, "\n");
-
-  // line 3)
-  if( cost_check || state_check ) {
-    fprintf(fp, "%s}\n", spaces);
+  if( table != NULL ) {
+    table->add_production(arrayIdx, rule, cost, !(state_check || cost_check));
+  } else {
+    // line 2)
+    // no need to set State vector if our state is knownValid
+    const char *production = (validity_check == knownValid) ? dfa_production : dfa_production_set_valid;
+    fprintf(fp, "%s  %s(%s, %s_rule, %s)", spaces, production, arrayIdx, rule, cost->as_string() );
+    if( validity_check == knownValid ) {
+      if( cost_is_below_lower_bound ) { fprintf(fp, "\t  // overwrites higher cost rule"); }
+     }
+     fprintf(fp, "\n");
+
+    // line 3)
+    if( cost_check || state_check ) {
+      fprintf(fp, "%s}\n", spaces);
+    }
   }
 
   status.set_cost_bounds(arrayIdx, cost, state_check, cost_check);
@@ -210,8 +251,8 @@ static void child_test(FILE *fp, MatchList &mList) {
 // Example:
 //           unsigned int c = _kids[0]->_cost[FOO] + _kids[1]->_cost[BAR] + 5;
 //
+// Nothing is printed if 'fp' is NULL.
 Expr *ArchDesc::calc_cost(FILE *fp, const char *spaces, MatchList &mList, ProductionState &status) {
-  fprintf(fp, "%sunsigned int c = ", spaces);
   Expr *c = new Expr("0");
   if (mList._lchild) { // If left child, add it in
     const char* lchild_to_upper = ArchDesc::getMachOperEnum(mList._lchild);
@@ -229,7 +270,9 @@ Expr *ArchDesc::calc_cost(FILE *fp, const char *spaces, MatchList &mList, Produc
   const char *mList_cost = mList.get_cost();
   c->add(mList_cost, *this);
 
-  fprintf(fp, "%s;\n", c->as_string());
+  if (fp != NULL) {
+    fprintf(fp, "%sunsigned int c = %s;\n", spaces, c->as_string());
+  }
   c->set_external_name("c");
   return c;
 }
@@ -287,11 +330,38 @@ void ArchDesc::gen_match(FILE *fp, MatchList &mList, ProductionState &status, Di
 
 }
 
+//---------------------------gen_match_table-----------------------------------
+// Record the match rule and the productions it enables in 'table' instead of
+// generating code for them.  Mirrors gen_match, so both DFA flavors select
+// the same rules.
+void ArchDesc::gen_match_table(FILE *fp, DFATable &table, MatchList &mList, ProductionState &status, Dict &operands_chained_from) {
+  bool has_child_constraints = mList._lchild || mList._rchild;
+  if (has_child_constraints || mList.get_pred()) {
+    status.set_constraint(hasConstraint);
+  } else {
+    status.set_constraint(noConstraint);
+  }
+
+  int first = table.productions();
+  const Expr *cost = calc_cost(NULL, NULL, mList, status);
+  cost_check(fp, "", ArchDesc::getMachOperEnum(mList._resultStr), cost, mList._opcode, status, &table);
+  expand_opclass(fp, "", cost, mList._resultStr, status, &table);
+  const char *rule = /* set rule to "Invalid" for internal operands */
+    strcmp(mList._opcode,mList._resultStr) ? mList._opcode : "Invalid";
+  chain_rule(fp, "", mList._resultStr, cost, rule, operands_chained_from, status, &table);
+
+  // The rule's own cost, the children's costs are added at match time
+  Expr *rule_cost = new Expr("0");
+  rule_cost->add(mList.get_cost(), *this);
+  table.add_match(mList, rule_cost->as_string(), first);
+}
+
 
 //---------------------------expand_opclass------------------------------------
 // Chain from one result_type to all other members of its operand class
 void ArchDesc::expand_opclass(FILE *fp, const char *indent, const Expr *cost,
-                              const char *result_type, ProductionState &status) {
+                              const char *result_type, ProductionState &status,
+                              DFATable *table) {
   const Form *form = _globalNames[result_type];
   OperandForm *op = form ? form->is_operand() : NULL;
   if( op && op->_classes.count() > 0 ) {
@@ -302,14 +372,15 @@ void ArchDesc::expand_opclass(FILE *fp, const char *indent, const Expr *cost,
     // Expr *cCost = new Expr(cost);
     while( (oclass = op->_classes.iter()) != NULL )
       // Check against other match costs, and update cost & rule vectors
-      cost_check(fp, indent, ArchDesc::getMachOperEnum(oclass), cost, result_type, status);
+      cost_check(fp, indent, ArchDesc::getMachOperEnum(oclass), cost, result_type, status, table);
   }
 }
 
 //---------------------------chain_rule----------------------------------------
 // Starting at 'operand', check if we know how to automatically generate other results
 void ArchDesc::chain_rule(FILE *fp, const char *indent, const char *operand,
-     const Expr *icost, const char *irule, Dict &operands_chained_from,  ProductionState &status) {
+     const Expr *icost, const char *irule, Dict &operands_chained_from,  ProductionState &status,
+     DFATable *table) {
 
   // Check if we have already generated chains from this starting point
   if( operands_chained_from[operand] != NULL ) {
@@ -339,17 +410,17 @@ void ArchDesc::chain_rule(FILE *fp, const char *indent, const char *operand,
           // printf("   result=%s cost=%s rule=%s\n", result, total_cost, rule);
           // Check against other match costs, and update cost & rule vectors
           const char *reduce_rule = strcmp(irule,"Invalid") ? irule : rule;
-          cost_check(fp, indent, ArchDesc::getMachOperEnum(result), total_cost, reduce_rule, status);
-          chain_rule(fp, indent, result, total_cost, irule, operands_chained_from, status);
+          cost_check(fp, indent, ArchDesc::getMachOperEnum(result), total_cost, reduce_rule, status, table);
+          chain_rule(fp, indent, result, total_cost, irule, operands_chained_from, status, table);
         } else {
           // printf("   result=%s cost=%s rule=%s\n", result, total_cost, rule);
           // Check against other match costs, and update cost & rule vectors
-          cost_check(fp, indent, ArchDesc::getMachOperEnum(result), total_cost, rule, status);
-          chain_rule(fp, indent, result, total_cost, rule, operands_chained_from, status);
+          cost_check(fp, indent, ArchDesc::getMachOperEnum(result), total_cost, rule, status, table);
+          chain_rule(fp, indent, result, total_cost, rule, operands_chained_from, status, table);
         }
 
         // If this is a member of an operand class, update class cost & rule
-        expand_opclass( fp, indent, total_cost, result, status );
+        expand_opclass( fp, indent, total_cost, result, status, table );
       }
     }
   }
@@ -408,6 +479,12 @@ void ArchDesc::buildDFA(FILE* fp) {
   fprintf(fp, "  %s( (result), (rule), (cost) ); STATE__SET_VALID( (result) );\n", dfa_production);
   fprintf(fp, "\n");
 
+  if (_dfa_table) {
+    buildDFATable(fp, minimize, status, operands_chained_from);
+    Expr::check_buffers();
+    return;
+  }
+
   fprintf(fp, "//------------------------- DFA --------------------------------------------\n");
 
   fprintf(fp,
@@ -470,6 +547,194 @@ void ArchDesc::buildDFA(FILE* fp) {
 }
 
 
+//---------------------------DFATable------------------------------------------
+void DFATable::add_production(const char *result, const char *rule, const Expr *cost, bool always) {
+  // Costs are relative to the cost 'c' of the match rule, see calc_cost
+  const char *delta = cost->as_string();
+  if (delta[0] == 'c' && delta[1] == '\0') {
+    delta = "0";
+  } else if (delta[0] == 'c' && delta[1] == '+') {
+    delta += 2;
+  }
+  sprintf(Expr::buffer(), "  { %s, %s, %s_rule, %s },\n", result, always ? "true " : "false", rule, delta);
+  _productions.addName(strdup(Expr::buffer()));
+}
+
+void DFATable::add_match(MatchList &mList, const char *cost, int first) {
+  // Number the predicates, sharing the number among identical ones
+  int pred = 0;
+  const char *pred_source = mList.get_pred();
+  if (pred_source != NULL) {
+    pred = (int)(intptr_t)_predicate_ids[pred_source];
+    if (pred == 0) {
+      _predicates.addName(pred_source);
+      pred = _predicates.count();
+      _predicate_ids.Insert(pred_source, (void *)(intptr_t)pred);
+    }
+  }
+  const char *left  = mList._lchild ? ArchDesc::getMachOperEnum(mList._lchild) : "-1";
+  const char *right = mList._rchild ? ArchDesc::getMachOperEnum(mList._rchild) : "-1";
+  sprintf(Expr::buffer(), "  { %s, %s, %d, %d, %s, %d },\t// %s\n",
+          left, right, pred, productions() - first, cost, first, mList._opcode);
+  _matches.addName(strdup(Expr::buffer()));
+}
+
+const char *DFATable::output_opcode(FILE *fp, const char *opcode, int chain_first) {
+  const char *row;
+  int productions = this->productions();
+  if (productions > 0) {
+    fprintf(fp, "static const DFATableProduction _dfa_productions_%s[] = {\n", opcode);
+    for (_productions.reset(); (row = _productions.iter()) != NULL; ) {
+      fprintf(fp, "%s", row);
+    }
+    fprintf(fp, "};\n");
+  }
+  fprintf(fp, "static const DFATableMatch _dfa_matches_%s[] = {\n", opcode);
+  for (_matches.reset(); (row = _matches.iter()) != NULL; ) {
+    fprintf(fp, "%s", row);
+  }
+  fprintf(fp, "};\n\n");
+
+  sprintf(Expr::buffer(), "  { _dfa_matches_%s, %s%s, %d, %d, %d },\t// Op_%s\n",
+          opcode, productions > 0 ? "_dfa_productions_" : "NULL", productions > 0 ? opcode : "",
+          _matches.count(), chain_first, productions - chain_first, opcode);
+
+  _total_matches     += _matches.count();
+  _total_productions += productions;
+  _matches.clear();
+  _productions.clear();
+  return strdup(Expr::buffer());
+}
+
+void DFATable::output_predicates(FILE *fp) {
+  fprintf(fp, "bool State::_dfa_predicate(int pred, const Node *n) {\n");
+  fprintf(fp, "  switch (pred) {\n");
+  const char *pred;
+  int i = 1;
+  for (_predicates.reset(); (pred = _predicates.iter()) != NULL; i++) {
+    fprintf(fp, "  case %d:\n", i);
+    fprintf(fp, "    return ( %s );\n", pred);
+  }
+  fprintf(fp, "  default:\n");
+  fprintf(fp, "    ShouldNotReachHere();\n");
+  fprintf(fp, "    return false;\n");
+  fprintf(fp, "  }\n");
+  fprintf(fp, "}\n\n");
+}
+
+
+//---------------------------buildDFATable-------------------------------------
+// The table driven DFA, selected with adlc -B, replaces the straight-line
+// code of each case of the DFA switch by tables.  For every ideal opcode
+// there is a table of match rules, holding the operands required of the
+// children, a predicate number and the rule cost, and a table of the
+// productions they enable.  Chain rules and operand classes are closed over
+// here exactly as for the generated code, so State::DFA only has to test
+// children and predicates and apply the productions with a dynamic cost
+// check.  The DFA becomes much smaller, at the price of an indirection per
+// production in the Matcher.
+void ArchDesc::buildDFATable(FILE *fp, Dict &minimize, ProductionState &status, Dict &operands_chained_from) {
+  DFATable table(Form::arena);
+  const char **opcode_rows = new const char *[_last_opcode];
+  int i;
+
+  fprintf(fp, "//------------------------- DFA tables -------------------------------------\n");
+  fprintf(fp, "// Production of an operand or operand class by a match or chain rule\n");
+  fprintf(fp, "struct DFATableProduction {\n");
+  fprintf(fp, "  unsigned short _result;   // Operand or operand class produced\n");
+  fprintf(fp, "  bool           _always;   // Statically known to be valid and cheaper\n");
+  fprintf(fp, "  unsigned int   _rule;     // Rule to reduce with\n");
+  fprintf(fp, "  unsigned int   _cost;     // Added to the cost of the match\n");
+  fprintf(fp, "};\n");
+  fprintf(fp, "\n");
+  fprintf(fp, "// Match rule for an ideal opcode\n");
+  fprintf(fp, "struct DFATableMatch {\n");
+  fprintf(fp, "  short          _left;     // Operand required of _kids[0], or -1\n");
+  fprintf(fp, "  short          _right;    // Operand required of _kids[1], or -1\n");
+  fprintf(fp, "  unsigned short _pred;     // Predicate number, or 0\n");
+  fprintf(fp, "  unsigned short _count;    // Number of productions\n");
+  fprintf(fp, "  unsigned int   _cost;     // Cost of the rule, without the children\n");
+  fprintf(fp, "  unsigned int   _first;    // Index of the first production\n");
+  fprintf(fp, "};\n");
+  fprintf(fp, "\n");
+  fprintf(fp, "// Match rules and productions of an ideal opcode\n");
+  fprintf(fp, "struct DFATableOpcode {\n");
+  fprintf(fp, "  const DFATableMatch      *_matches;\n");
+  fprintf(fp, "  const DFATableProduction *_productions;\n");
+  fprintf(fp, "  unsigned int              _match_count;\n");
+  fprintf(fp, "  unsigned int              _chain_first;  // Top level chain rules\n");
+  fprintf(fp, "  unsigned int              _chain_count;\n");
+  fprintf(fp, "};\n");
+  fprintf(fp, "\n");
+
+  // Iterate over the table of MatchLists, start at first valid opcode of 1
+  for (i = 0; i < _last_opcode; i++) {
+    opcode_rows[i] = NULL;
+    if (i == 0 || _mlistab[i] == NULL) continue;
+    // Start the tables of each Op_XXX with a clean state.
+    status.initialize();
+    MatchList *mList;
+    for (mList = _mlistab[i]; mList != NULL; mList = mList->get_next()) {
+      prune_matchlist(minimize, *mList);
+    }
+    for (mList = _mlistab[i]; mList != NULL; mList = mList->get_next()) {
+      // Each match can generate its own chains
+      operands_chained_from.Clear();
+      gen_match_table(fp, table, *mList, status, operands_chained_from);
+    }
+    // Fill in any chain rules which add instructions
+    operands_chained_from.Clear();
+    int chain_first = table.productions();
+    chain_rule(fp, "", (char *)NodeClassNames[i], new Expr("0"), "Invalid",
+               operands_chained_from, status, &table);
+    opcode_rows[i] = table.output_opcode(fp, NodeClassNames[i], chain_first);
+  }
+
+  fprintf(fp, "// %d match rules, %d productions\n", table._total_matches, table._total_productions);
+  fprintf(fp, "static const DFATableOpcode _dfa_opcodes[_last_opcode] = {\n");
+  for (i = 0; i < _last_opcode; i++) {
+    fprintf(fp, "%s", opcode_rows[i] != NULL ? opcode_rows[i] : "  { NULL, NULL, 0, 0, 0 },\n");
+  }
+  fprintf(fp, "};\n");
+  fprintf(fp, "\n");
+  delete[] opcode_rows;
+
+  fprintf(fp, "//------------------------- DFA --------------------------------------------\n");
+  table.output_predicates(fp);
+
+  fprintf(fp, "void State::_dfa_produce(const DFATableProduction *p, uint count, unsigned int c) {\n");
+  fprintf(fp, "  for (uint i = 0; i < count; i++, p++) {\n");
+  fprintf(fp, "    unsigned int cost = c + p->_cost;\n");
+  fprintf(fp, "    if (p->_always || STATE__NOT_YET_VALID(p->_result) || _cost[p->_result] > cost) {\n");
+  fprintf(fp, "      %s(p->_result, p->_rule, cost)\n", dfa_production_set_valid);
+  fprintf(fp, "    }\n");
+  fprintf(fp, "  }\n");
+  fprintf(fp, "}\n");
+  fprintf(fp, "\n");
+
+  fprintf(fp, "bool State::DFA(int opcode, const Node *n) {\n");
+  fprintf(fp, "  assert(0 <= opcode && opcode < _last_opcode, \"invalid opcode\");\n");
+  fprintf(fp, "  const DFATableOpcode *op = &_dfa_opcodes[opcode];\n");
+  fprintf(fp, "  if (op->_match_count == 0) {\n");
+  fprintf(fp, "    tty->print(\"Default case invoked for: \\n\");\n");
+  fprintf(fp, "    tty->print(\"   opcode  = %cd, \\\"%cs\\\"\\n\", opcode, NodeClassNames[opcode]);\n", '%', '%');
+  fprintf(fp, "    return false;\n");
+  fprintf(fp, "  }\n");
+  fprintf(fp, "  const DFATableMatch *m = op->_matches;\n");
+  fprintf(fp, "  for (uint i = 0; i < op->_match_count; i++, m++) {\n");
+  fprintf(fp, "    if (m->_left  >= 0 && !STATE__VALID_CHILD(_kids[0], m->_left))  continue;\n");
+  fprintf(fp, "    if (m->_right >= 0 && !STATE__VALID_CHILD(_kids[1], m->_right)) continue;\n");
+  fprintf(fp, "    if (m->_pred != 0 && !_dfa_predicate(m->_pred, n)) continue;\n");
+  fprintf(fp, "    unsigned int c = m->_cost;\n");
+  fprintf(fp, "    if (m->_left  >= 0) c += _kids[0]->_cost[m->_left];\n");
+  fprintf(fp, "    if (m->_right >= 0) c += _kids[1]->_cost[m->_right];\n");
+  fprintf(fp, "    _dfa_produce(op->_productions + m->_first, m->_count, c);\n");
+  fprintf(fp, "  }\n");
+  fprintf(fp, "  _dfa_produce(op->_productions + op->_chain_first, op->_chain_count, 0);\n");
+  fprintf(fp, "  return true;\n");
+  fprintf(fp, "}\n");
+}
+
 class dfa_shared_preds {
   enum { count = 4 };
 
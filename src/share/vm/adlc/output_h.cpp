@@ -2058,6 +2058,10 @@ void ArchDesc::defineStateClass(FILE *fp) {
   fprintf(fp,"// indexed by machine operand opcodes, pointers to the children in the label\n");
   fprintf(fp,"// tree generated by the Label routines in ideal nodes (currently limited to\n");
   fprintf(fp,"// two for convenience, but this could change).\n");
+  if (_dfa_table) {
+    fprintf(fp,"struct DFATableProduction;\n");
+    fprintf(fp,"\n");
+  }
   fprintf(fp,"class State : public ResourceObj {\n");
   fprintf(fp,"public:\n");
   fprintf(fp,"  int    _id;         // State identifier\n");
@@ -2091,7 +2095,11 @@ void ArchDesc::defineStateClass(FILE *fp) {
   fprintf(fp,"  void dump();                // Debugging prints\n");
   fprintf(fp,"  void dump(int depth);\n");
   fprintf(fp,"#endif\n");
-  if (_dfa_small) {
+  if (_dfa_table) {
+    // Helpers of the table driven DFA
+    fprintf(fp, "  bool  _dfa_predicate(int pred, const Node *n);\n");
+    fprintf(fp, "  void  _dfa_produce(const DFATableProduction *p, uint count, unsigned int c);\n");
+  } else if (_dfa_small) {
     // Generate the routine name we'll need
     for (int i = 1; i < _last_opcode; i++) {
       if (_mlistab[i] == NULL) continue;
@@ -913,6 +913,9 @@
   do_intrinsic(_copyMemory,               sun_misc_Unsafe,        copyMemory_name, copyMemory_signature,         F_RN)  \
    do_name(     copyMemory_name,                                 "copyMemory")                                          \
    do_signature(copyMemory_signature,         "(Ljava/lang/Object;JLjava/lang/Object;JJ)V")                             \
+  do_intrinsic(_copySwapMemory,           sun_misc_Unsafe,        copySwapMemory_name, copySwapMemory_signature, F_RN)  \
+   do_name(     copySwapMemory_name,                             "copySwapMemory")                                      \
+   do_signature(copySwapMemory_signature,     "(Ljava/lang/Object;JLjava/lang/Object;JJJ)V")                            \
   do_intrinsic(_park,                     sun_misc_Unsafe,        park_name, park_signature,                     F_RN)  \
    do_name(     park_name,                                       "park")                                                \
    do_signature(park_signature,                                  "(ZJ)V")                                               \
@@ -27,8 +27,10 @@
 #include "code/compiledIC.hpp"
 #include "code/dependencies.hpp"
 #include "code/nmethod.hpp"
+#include "code/perfMap.hpp"
 #include "code/scopeDesc.hpp"
 #include "compiler/abstractCompiler.hpp"
+#include "compiler/compilationEventLog.hpp"
 #include "compiler/compileBroker.hpp"
 #include "compiler/compileLog.hpp"
 #include "compiler/compilerOracle.hpp"
@@ -616,6 +618,7 @@ nmethod* nmethod::new_native_nmethod(methodHandle method,
 
   if (nm != NULL) {
     nm->log_new_nmethod();
+    PerfMap::register_nmethod(nm);
   }
 
   return nm;
@@ -734,6 +737,7 @@ nmethod* nmethod::new_nmethod(methodHandle method,
     // Safepoints in nmethod::verify aren't allowed because nm hasn't been installed yet.
     DEBUG_ONLY(nm->verify();)
     nm->log_new_nmethod();
+    PerfMap::register_nmethod(nm);
   }
   return nm;
 }
@@ -1525,6 +1529,10 @@ void nmethod::invalidate_osr_method() {
 }
 
 void nmethod::log_state_change() const {
+  CompilationEventLog::log_state_change(this,
+                                        _state == unloaded ? CompilationEventLog::Unloaded :
+                                        _state == zombie   ? CompilationEventLog::Zombie :
+                                                             CompilationEventLog::NotEntrant);
   if (LogCompilation) {
     if (xtty != NULL) {
       ttyLocker ttyl;  // keep the following output all in one block
@@ -1693,6 +1701,7 @@ void nmethod::flush() {
 
   // completely deallocate this method
   Events::log(JavaThread::current(), "flushing nmethod " INTPTR_FORMAT, this);
+  CompilationEventLog::log_flush(this);
   if (PrintMethodFlushing) {
     tty->print_cr("*flushing nmethod %3d/" INTPTR_FORMAT ". Live blobs:" UINT32_FORMAT "/Free CodeCache:" SIZE_FORMAT "Kb",
         _compile_id, this, CodeCache::nof_blobs(), CodeCache::unallocated_capacity()/1024);
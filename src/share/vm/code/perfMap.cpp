@@ -0,0 +1,447 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "code/debugInfoRec.hpp"
+#include "code/nmethod.hpp"
+#include "code/pcDesc.hpp"
+#include "code/perfMap.hpp"
+#include "code/scopeDesc.hpp"
+#include "memory/allocation.inline.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/instanceKlass.hpp"
+#include "oops/method.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/interfaceSupport.hpp"
+#include "runtime/os.hpp"
+#include "utilities/ostream.hpp"
+
+#ifdef LINUX
+# include <elf.h>
+# include <sys/mman.h>
+#endif
+
+// Record layouts of the jitdump format, as described in
+// tools/perf/Documentation/jitdump-specification.txt of the Linux sources.
+struct JitDumpFileHeader {
+  u4 magic;
+  u4 version;
+  u4 total_size;
+  u4 elf_mach;
+  u4 pad1;
+  u4 pid;
+  u8 timestamp;
+  u8 flags;
+};
+
+struct JitDumpRecordHeader {
+  u4 id;
+  u4 total_size;
+  u8 timestamp;
+};
+
+struct JitDumpCodeLoad {
+  JitDumpRecordHeader header;
+  u4 pid;
+  u4 tid;
+  u8 vma;
+  u8 code_addr;
+  u8 code_size;
+  u8 code_index;
+  // followed by the nul-terminated name and the code bytes
+};
+
+struct JitDumpDebugInfo {
+  JitDumpRecordHeader header;
+  u8 code_addr;
+  u8 nr_entry;
+  // followed by nr_entry JitDumpDebugEntry records
+};
+
+struct JitDumpDebugEntry {
+  u8 addr;
+  u4 lineno;
+  u4 discrim;
+  // followed by the nul-terminated file name
+};
+
+enum {
+  jitdump_magic         = 0x4A695444,   // "JiTD"
+  jitdump_version       = 1,
+  jitdump_code_load     = 0,
+  jitdump_code_debug    = 2
+};
+
+// A fully formatted piece of output for one code blob.
+class PerfMap::Entry : public CHeapObj<mtInternal> {
+ public:
+  Entry* _next;
+  char*  _map_line;
+  size_t _map_line_length;
+  char*  _jitdump;
+  size_t _jitdump_length;
+
+  Entry(bufferedStream* map_line, bufferedStream* jitdump) : _next(NULL) {
+    _map_line_length = map_line->size();
+    _map_line = NEW_C_HEAP_ARRAY(char, _map_line_length, mtInternal);
+    memcpy(_map_line, map_line->base(), _map_line_length);
+    _jitdump_length = jitdump->size();
+    _jitdump = NULL;
+    if (_jitdump_length > 0) {
+      _jitdump = NEW_C_HEAP_ARRAY(char, _jitdump_length, mtInternal);
+      memcpy(_jitdump, jitdump->base(), _jitdump_length);
+    }
+  }
+
+  ~Entry() {
+    FREE_C_HEAP_ARRAY(char, _map_line, mtInternal);
+    if (_jitdump != NULL) {
+      FREE_C_HEAP_ARRAY(char, _jitdump, mtInternal);
+    }
+  }
+};
+
+bool                    PerfMap::_enabled        = false;
+PerfMap::Entry* volatile PerfMap::_pending       = NULL;
+volatile jint           PerfMap::_writing        = 0;
+int                     PerfMap::_map_fd         = -1;
+int                     PerfMap::_jitdump_fd     = -1;
+void*                   PerfMap::_jitdump_marker = NULL;
+jlong                   PerfMap::_code_index     = 0;
+
+static bool write_fully(int fd, const char* buf, size_t len) {
+  while (len > 0) {
+    size_t n = os::write(fd, buf, (unsigned int)MIN2(len, (size_t)max_jint));
+    if (n == 0 || n == (size_t)-1) {
+      return false;
+    }
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+// Both files are created in world-writable directories. A file of the
+// same name may be a link planted by another user, so it is removed and
+// the new file is created exclusively; if someone else's file cannot be
+// removed, the open fails.
+static int create_file(const char* path, int flags) {
+  remove(path);
+  return os::open(path, flags | O_CREAT | O_EXCL, 0644);
+}
+
+bool PerfMap::open_perf_map() {
+  char path[JVM_MAXPATHLEN];
+  // perf only looks for the map in /tmp.
+  jio_snprintf(path, sizeof(path), "/tmp/perf-%d.map", os::current_process_id());
+  _map_fd = create_file(path, O_WRONLY);
+  if (_map_fd < 0) {
+    warning("Could not create %s, disabling -XX:+WritePerfMap", path);
+    return false;
+  }
+  return true;
+}
+
+bool PerfMap::open_jitdump() {
+#ifdef LINUX
+  char path[JVM_MAXPATHLEN];
+  jio_snprintf(path, sizeof(path), "%s/jit-%d.dump", os::get_temp_directory(), os::current_process_id());
+  _jitdump_fd = create_file(path, O_RDWR);
+  if (_jitdump_fd < 0) {
+    warning("Could not create %s, disabling -XX:+WriteJitDump", path);
+    return false;
+  }
+
+  JitDumpFileHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic      = jitdump_magic;
+  header.version    = jitdump_version;
+  header.total_size = sizeof(header);
+#if defined(AMD64)
+  header.elf_mach   = EM_X86_64;
+#elif defined(IA32)
+  header.elf_mach   = EM_386;
+#elif defined(SPARC)
+  header.elf_mach   = EM_SPARCV9;
+#elif defined(PPC64)
+  header.elf_mach   = EM_PPC64;
+#elif defined(AARCH64)
+  header.elf_mach   = EM_AARCH64;
+#else
+  header.elf_mach   = EM_NONE;
+#endif
+  header.pid        = os::current_process_id();
+  header.timestamp  = os::javaTimeNanos();
+  if (!write_fully(_jitdump_fd, (const char*)&header, sizeof(header))) {
+    warning("Could not write %s, disabling -XX:+WriteJitDump", path);
+    os::close(_jitdump_fd);
+    _jitdump_fd = -1;
+    return false;
+  }
+
+  // perf record notices the dump file through this executable mapping
+  // of it; the mapping is never accessed.
+  _jitdump_marker = ::mmap(NULL, os::vm_page_size(), PROT_READ | PROT_EXEC, MAP_PRIVATE, _jitdump_fd, 0);
+  if (_jitdump_marker == MAP_FAILED) {
+    _jitdump_marker = NULL;
+    warning("Could not map %s, perf will not find the jitdump file", path);
+  }
+  return true;
+#else
+  warning("-XX:+WriteJitDump is only supported on Linux");
+  return false;
+#endif
+}
+
+void PerfMap::initialize() {
+  if (!WritePerfMap && !WriteJitDump) {
+    return;
+  }
+  if (WritePerfMap && !open_perf_map()) {
+    FLAG_SET_DEFAULT(WritePerfMap, false);
+  }
+  if (WriteJitDump && !open_jitdump()) {
+    FLAG_SET_DEFAULT(WriteJitDump, false);
+  }
+  _enabled = WritePerfMap || WriteJitDump;
+}
+
+void PerfMap::enqueue(Entry* e) {
+  Entry* head;
+  do {
+    head = _pending;
+    e->_next = head;
+  } while (Atomic::cmpxchg_ptr(e, &_pending, head) != head);
+}
+
+// Detach the pending list and return it oldest first.
+PerfMap::Entry* PerfMap::take_pending() {
+  Entry* list = (Entry*)Atomic::xchg_ptr(NULL, &_pending);
+  Entry* reversed = NULL;
+  while (list != NULL) {
+    Entry* next = list->_next;
+    list->_next = reversed;
+    reversed = list;
+    list = next;
+  }
+  return reversed;
+}
+
+static void write_code_load(bufferedStream* st, const char* name, address begin, address end, jlong index) {
+  size_t name_length = strlen(name) + 1;
+  size_t code_size = end - begin;
+  JitDumpCodeLoad rec;
+  rec.header.id         = jitdump_code_load;
+  rec.header.total_size = (u4)(sizeof(rec) + name_length + code_size);
+  rec.header.timestamp  = os::javaTimeNanos();
+  rec.pid               = os::current_process_id();
+  rec.tid               = (u4)os::current_thread_id();
+  rec.vma               = (u8)(uintptr_t)begin;
+  rec.code_addr         = (u8)(uintptr_t)begin;
+  rec.code_size         = code_size;
+  rec.code_index        = index;
+  st->write((const char*)&rec, sizeof(rec));
+  st->write(name, name_length);
+  st->write((const char*)begin, code_size);
+}
+
+// The file name perf should look up for a method: the holder's
+// package directory followed by its SourceFile attribute.
+static const char* source_path(Method* m) {
+  InstanceKlass* holder = m->method_holder();
+  Symbol* source = holder->source_file_name();
+  if (source == NULL) {
+    return holder->name()->as_C_string();
+  }
+  const char* klass = holder->name()->as_C_string();
+  const char* slash = strrchr(klass, '/');
+  if (slash == NULL) {
+    return source->as_C_string();
+  }
+  size_t package_length = slash - klass + 1;
+  const char* file = source->as_C_string();
+  char* path = NEW_RESOURCE_ARRAY(char, package_length + strlen(file) + 1);
+  memcpy(path, klass, package_length);
+  strcpy(path + package_length, file);
+  return path;
+}
+
+static void write_debug_info(bufferedStream* st, nmethod* nm) {
+  bufferedStream entries(4 * K);
+  u8 count = 0;
+  Method* last_method = NULL;
+  int last_line = -1;
+  const char* last_path = NULL;
+  for (PcDesc* p = nm->scopes_pcs_begin(); p < nm->scopes_pcs_end(); p++) {
+    if (p->scope_decode_offset() == DebugInformationRecorder::serialized_null) {
+      continue;
+    }
+    ScopeDesc sd(nm, p->scope_decode_offset(), p->obj_decode_offset(),
+                 p->should_reexecute(), p->rethrow_exception(), p->return_oop());
+    Method* m = sd.method();
+    int line = m->line_number_from_bci(MAX2(sd.bci(), 0));
+    if (line < 0 || (m == last_method && line == last_line)) {
+      continue;
+    }
+    if (m != last_method) {
+      last_path = source_path(m);
+    }
+    last_method = m;
+    last_line = line;
+
+    JitDumpDebugEntry entry;
+    entry.addr    = (u8)(uintptr_t)p->real_pc(nm);
+    entry.lineno  = line;
+    entry.discrim = 0;
+    entries.write((const char*)&entry, sizeof(entry));
+    entries.write(last_path, strlen(last_path) + 1);
+    count++;
+  }
+  if (count == 0) {
+    return;
+  }
+
+  JitDumpDebugInfo rec;
+  rec.header.id         = jitdump_code_debug;
+  rec.header.total_size = (u4)(sizeof(rec) + entries.size());
+  rec.header.timestamp  = os::javaTimeNanos();
+  rec.code_addr         = (u8)(uintptr_t)nm->code_begin();
+  rec.nr_entry          = count;
+  st->write((const char*)&rec, sizeof(rec));
+  st->write(entries.base(), entries.size());
+}
+
+void PerfMap::register_nmethod(nmethod* nm) {
+  if (!_enabled || nm == NULL) {
+    return;
+  }
+  ResourceMark rm;
+  char name[512];
+  Method* m = nm->method();
+  if (m == NULL) {
+    jio_snprintf(name, sizeof(name), "nmethod %d", nm->compile_id());
+  } else {
+    char method_name[400];
+    m->name_and_sig_as_C_string(method_name, sizeof(method_name));
+    if (nm->is_native_method()) {
+      jio_snprintf(name, sizeof(name), "%s [native]", method_name);
+    } else if (nm->is_osr_method()) {
+      jio_snprintf(name, sizeof(name), "%s [tier %d, osr @%d]", method_name, nm->comp_level(), nm->osr_entry_bci());
+    } else {
+      jio_snprintf(name, sizeof(name), "%s [tier %d]", method_name, nm->comp_level());
+    }
+  }
+
+  bufferedStream map_line(256);
+  if (WritePerfMap) {
+    map_line.print_cr("%" PRIxPTR " %x %s", (uintptr_t)nm->code_begin(), nm->code_size(), name);
+  }
+  bufferedStream jitdump(WriteJitDump ? nm->code_size() + 4 * K : 16);
+  if (WriteJitDump) {
+    if (!nm->is_native_method()) {
+      write_debug_info(&jitdump, nm);
+    }
+    write_code_load(&jitdump, name, nm->code_begin(), nm->code_end(), Atomic::add((jlong)1, &_code_index));
+  }
+  enqueue(new Entry(&map_line, &jitdump));
+}
+
+void PerfMap::register_stub(const char* name, address begin, address end) {
+  if (!_enabled || begin == NULL || end <= begin) {
+    return;
+  }
+  bufferedStream map_line(256);
+  if (WritePerfMap) {
+    map_line.print_cr("%" PRIxPTR " %x %s", (uintptr_t)begin, (int)(end - begin), name);
+  }
+  bufferedStream jitdump(WriteJitDump ? (end - begin) + 256 : 16);
+  if (WriteJitDump) {
+    write_code_load(&jitdump, name, begin, end, Atomic::add((jlong)1, &_code_index));
+  }
+  enqueue(new Entry(&map_line, &jitdump));
+}
+
+void PerfMap::write_entries(Entry* list) {
+  // Batch everything into one write per file.
+  bufferedStream map_buf(16 * K, max_jint);
+  bufferedStream jitdump_buf(WriteJitDump ? 64 * K : 16, max_jint);
+  while (list != NULL) {
+    Entry* next = list->_next;
+    map_buf.write(list->_map_line, list->_map_line_length);
+    if (list->_jitdump != NULL) {
+      jitdump_buf.write(list->_jitdump, list->_jitdump_length);
+    }
+    delete list;
+    list = next;
+  }
+  if (_map_fd >= 0 && map_buf.size() > 0) {
+    write_fully(_map_fd, map_buf.base(), map_buf.size());
+  }
+  if (_jitdump_fd >= 0 && jitdump_buf.size() > 0) {
+    write_fully(_jitdump_fd, jitdump_buf.base(), jitdump_buf.size());
+  }
+}
+
+void PerfMap::write_pending(JavaThread* thread) {
+  if (Atomic::cmpxchg(1, &_writing, 0) != 0) {
+    return;
+  }
+  Entry* list = take_pending();
+  if (list != NULL) {
+    // Do the I/O in native so that slow disks do not hold up safepoints.
+    ThreadToNativeFromVM ttn(thread);
+    write_entries(list);
+  }
+  OrderAccess::release_store(&_writing, 0);
+}
+
+void PerfMap::shutdown() {
+  if (!_enabled) {
+    return;
+  }
+  // Wait for the ServiceThread to finish its batch.
+  while (Atomic::cmpxchg(1, &_writing, 0) != 0) {
+    os::naked_short_sleep(1);
+  }
+  _enabled = false;
+  write_entries(take_pending());
+  if (_map_fd >= 0) {
+    os::close(_map_fd);
+    _map_fd = -1;
+  }
+#ifdef LINUX
+  if (_jitdump_marker != NULL) {
+    ::munmap(_jitdump_marker, os::vm_page_size());
+    _jitdump_marker = NULL;
+  }
+#endif
+  if (_jitdump_fd >= 0) {
+    os::close(_jitdump_fd);
+    _jitdump_fd = -1;
+  }
+}
+
+void perfMap_init() {
+  PerfMap::initialize();
+}
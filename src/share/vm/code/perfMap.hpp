@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#ifndef SHARE_VM_CODE_PERFMAP_HPP
+#define SHARE_VM_CODE_PERFMAP_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class JavaThread;
+class nmethod;
+
+// Native support for the Linux perf profiler, replacing the JVMTI
+// agents that rebuild symbol maps from CompiledMethodLoad events.
+//
+// With -XX:+WritePerfMap every nmethod, stub and adapter is described
+// by a line in /tmp/perf-<pid>.map.  With -XX:+WriteJitDump the same
+// code is also written as records of a jit-<pid>.dump file, including
+// a copy of the code bytes and the line table derived from the PcDescs
+// and ScopeDescs of nmethods, so that `perf inject --jit` can annotate
+// JIT-compiled code.
+//
+// The thread creating the code only formats the records and pushes
+// them onto a lock-free list; the ServiceThread picks them up every
+// PerfMapFlushInterval milliseconds and writes each batch with a single
+// write() per file.  Neither format has an unload record: perf orders
+// reused addresses by the jitdump timestamps, so flushed code needs no
+// record of its own.
+
+class PerfMap : AllStatic {
+ private:
+  class Entry;
+
+  static bool            _enabled;
+  static Entry* volatile _pending;
+  static volatile jint   _writing;
+  static int             _map_fd;
+  static int             _jitdump_fd;
+  static void*           _jitdump_marker;
+  static jlong           _code_index;
+
+  static void enqueue(Entry* e);
+  static Entry* take_pending();
+  static void write_entries(Entry* list);
+
+  static bool open_perf_map();
+  static bool open_jitdump();
+
+ public:
+  static bool is_enabled()          { return _enabled; }
+  static bool has_pending_entries() { return _pending != NULL; }
+
+  static void initialize();
+
+  // Called after the code has been installed in the CodeCache and the
+  // CodeCache_lock has been released.
+  static void register_nmethod(nmethod* nm);
+  static void register_stub(const char* name, address begin, address end);
+
+  // Called by the ServiceThread to write out what has been queued.
+  static void write_pending(JavaThread* thread);
+
+  // Write out whatever is still queued and close the files.
+  static void shutdown();
+};
+
+#endif // SHARE_VM_CODE_PERFMAP_HPP
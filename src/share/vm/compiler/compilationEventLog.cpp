@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "code/nmethod.hpp"
+#include "compiler/compilationEventLog.hpp"
+#include "compiler/compileBroker.hpp"
+#include "memory/allocation.inline.hpp"
+#include "oops/method.hpp"
+#include "oops/methodData.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "runtime/os.hpp"
+#include "utilities/events.hpp"
+#include "utilities/ostream.hpp"
+#include "utilities/vmError.hpp"
+
+CompilationEventLog::Record*    CompilationEventLog::_records = NULL;
+jlong                           CompilationEventLog::_length  = 0;
+volatile jlong                  CompilationEventLog::_cursor  = 0;
+
+// Registered with the other event logs so that the tail of the ring is
+// printed in hs_err files.
+class CompilationEventLogPrinter : public EventLog {
+ public:
+  enum { crash_records = 64 };
+
+  virtual void print_log_on(outputStream* out) {
+    CompilationEventLog::print_on(out, crash_records);
+    out->cr();
+  }
+};
+
+void CompilationEventLog::initialize() {
+  // The decoder hard-codes the record layout.
+  STATIC_ASSERT(sizeof(Record) == 128);
+  STATIC_ASSERT(sizeof(Header) == 32);
+  if (LogCompilationEvents && CompilationEventLogSize > 0) {
+    _length = (jlong)CompilationEventLogSize;
+    _records = NEW_C_HEAP_ARRAY(Record, CompilationEventLogSize, mtCompiler);
+    memset(_records, 0, sizeof(Record) * CompilationEventLogSize);
+    new CompilationEventLogPrinter();
+  }
+}
+
+const char* CompilationEventLog::type_name(int type) {
+  switch (type) {
+    case Enqueue:    return "enqueue";
+    case Start:      return "start";
+    case Inlining:   return "inlining";
+    case Install:    return "install";
+    case Failure:    return "failure";
+    case NotEntrant: return "not_entrant";
+    case Zombie:     return "zombie";
+    case Unloaded:   return "unloaded";
+    case Flush:      return "flush";
+    default:         return "unknown";
+  }
+}
+
+CompilationEventLog::Record* CompilationEventLog::claim(EventType type, int compile_id, int comp_level,
+                                                       jlong* seq_addr) {
+  if (_records == NULL || VMError::fatal_error_in_progress()) {
+    return NULL;
+  }
+  jlong seq = Atomic::add((jlong)1, &_cursor);
+  Record* r = &_records[(seq - 1) % _length];
+  OrderAccess::release_store(&r->_seq, (jlong)0);
+  r->_timestamp  = os::elapsed_counter();
+  r->_address    = 0;
+  r->_compile_id = compile_id;
+  r->_osr_bci    = InvocationEntryBci;
+  r->_value1     = 0;
+  r->_value2     = 0;
+  r->_type       = (u1)type;
+  r->_comp_level = (u1)comp_level;
+  r->_flags      = 0;
+  r->_thread_id  = (u4)os::current_thread_id();
+  r->_name[0]    = '\0';
+  *seq_addr = seq;
+  return r;
+}
+
+void CompilationEventLog::publish(Record* r, jlong seq) {
+  OrderAccess::release_store(&r->_seq, seq);
+}
+
+static void set_method_name(CompilationEventLog::Record* r, Method* m) {
+  if (m != NULL) {
+    m->name_and_sig_as_C_string(r->_name, CompilationEventLog::name_length);
+  }
+}
+
+static void set_task_fields(CompilationEventLog::Record* r, CompileTask* task) {
+  if (task->osr_bci() != InvocationEntryBci) {
+    r->_osr_bci = task->osr_bci();
+    r->_flags |= CompilationEventLog::is_osr;
+  }
+  if (task->is_blocking()) {
+    r->_flags |= CompilationEventLog::is_blocking;
+  }
+}
+
+void CompilationEventLog::log_enqueue(CompileTask* task, Method* method, int hot_count) {
+  jlong seq;
+  Record* r = claim(Enqueue, task->compile_id(), task->comp_level(), &seq);
+  if (r == NULL) return;
+  set_task_fields(r, task);
+  set_method_name(r, method);
+  r->_value1 = hot_count;
+  r->_value2 = method->code_size();
+  publish(r, seq);
+}
+
+void CompilationEventLog::log_start(CompileTask* task, jlong time_queued) {
+  jlong seq;
+  Record* r = claim(Start, task->compile_id(), task->comp_level(), &seq);
+  if (r == NULL) return;
+  set_task_fields(r, task);
+  if (time_queued != 0) {
+    r->_value1 = (jint)((r->_timestamp - time_queued) * 1000000 / os::elapsed_frequency());
+  } else {
+    r->_value1 = -1;
+  }
+  publish(r, seq);
+}
+
+void CompilationEventLog::log_inlining(CompileTask* task, Method* method) {
+  jlong seq;
+  Record* r = claim(Inlining, task->compile_id(), task->comp_level(), &seq);
+  if (r == NULL) return;
+  set_task_fields(r, task);
+  r->_value1 = task->num_inlined_bytecodes();
+  r->_value2 = method->code_size();
+  publish(r, seq);
+}
+
+void CompilationEventLog::log_install(CompileTask* task, nmethod* nm) {
+  jlong seq;
+  Record* r = claim(Install, task->compile_id(), task->comp_level(), &seq);
+  if (r == NULL) return;
+  set_task_fields(r, task);
+  set_method_name(r, nm->method());
+  r->_value1 = nm->insts_size();
+  r->_value2 = nm->total_size();
+  r->_address = (jlong)(intptr_t)nm;
+  publish(r, seq);
+}
+
+void CompilationEventLog::log_failure(CompileTask* task, const char* reason) {
+  jlong seq;
+  Record* r = claim(Failure, task->compile_id(), task->comp_level(), &seq);
+  if (r == NULL) return;
+  set_task_fields(r, task);
+  if (reason != NULL) {
+    strncpy(r->_name, reason, name_length - 1);
+    r->_name[name_length - 1] = '\0';
+  }
+  publish(r, seq);
+}
+
+void CompilationEventLog::log_state_change(const nmethod* nm, EventType type) {
+  jlong seq;
+  Record* r = claim(type, nm->compile_id(), nm->comp_level(), &seq);
+  if (r == NULL) return;
+  if (nm->is_osr_method()) {
+    r->_osr_bci = nm->osr_entry_bci();
+    r->_flags |= is_osr;
+  }
+  set_method_name(r, nm->method());
+  if (type == NotEntrant && nm->method() != NULL && nm->method()->method_data() != NULL) {
+    r->_value1 = nm->method()->method_data()->decompile_count();
+  }
+  r->_address = (jlong)(intptr_t)nm;
+  publish(r, seq);
+}
+
+void CompilationEventLog::log_flush(const nmethod* nm) {
+  jlong seq;
+  Record* r = claim(Flush, nm->compile_id(), nm->comp_level(), &seq);
+  if (r == NULL) return;
+  r->_value1 = nm->total_size();
+  r->_address = (jlong)(intptr_t)nm;
+  publish(r, seq);
+}
+
+bool CompilationEventLog::read(jlong seq, Record* result) {
+  const Record* r = &_records[(seq - 1) % _length];
+  if (OrderAccess::load_acquire((volatile jlong*)&r->_seq) != seq) {
+    return false;
+  }
+  memcpy(result, r, sizeof(Record));
+  OrderAccess::loadload();
+  return OrderAccess::load_acquire((volatile jlong*)&r->_seq) == seq;
+}
+
+void CompilationEventLog::print_record(outputStream* st, const Record* r) {
+  double secs = (double)r->_timestamp / os::elapsed_frequency();
+  st->print("Event: %.3f %4d %-11s level=%d", secs, r->_compile_id, type_name(r->_type), r->_comp_level);
+  if ((r->_flags & is_osr) != 0) {
+    st->print(" osr_bci=%d", r->_osr_bci);
+  }
+  if ((r->_flags & is_blocking) != 0) {
+    st->print(" blocking");
+  }
+  switch (r->_type) {
+    case Enqueue:    st->print(" hot_count=%d bytes=%d", r->_value1, r->_value2); break;
+    case Start:      st->print(" queued_us=%d", r->_value1); break;
+    case Inlining:   st->print(" inlined_bytes=%d bytes=%d", r->_value1, r->_value2); break;
+    case Install:    st->print(" insts=%d total=%d", r->_value1, r->_value2); break;
+    case NotEntrant: st->print(" decompiles=%d", r->_value1); break;
+    case Flush:      st->print(" total=%d", r->_value1); break;
+    default:         break;
+  }
+  if (r->_address != 0) {
+    st->print(" nmethod=" INTPTR_FORMAT, (intptr_t)r->_address);
+  }
+  if (r->_name[0] != '\0') {
+    st->print(" %s", r->_name);
+  }
+  st->cr();
+}
+
+void CompilationEventLog::print_on(outputStream* st, int max_records) {
+  if (_records == NULL) {
+    st->print_cr("Compilation event log is disabled, use -XX:+LogCompilationEvents");
+    return;
+  }
+  jlong end = _cursor;
+  jlong start = MAX2((jlong)0, end - _length);
+  if (max_records >= 0) {
+    start = MAX2(start, end - max_records);
+  }
+  st->print_cr("Compilation event log (" JLONG_FORMAT " of " JLONG_FORMAT " events):", end - start, end);
+  for (jlong seq = start + 1; seq <= end; seq++) {
+    Record r;
+    if (read(seq, &r)) {
+      print_record(st, &r);
+    }
+  }
+}
+
+bool CompilationEventLog::dump(const char* path, outputStream* st) {
+  if (_records == NULL) {
+    st->print_cr("Compilation event log is disabled, use -XX:+LogCompilationEvents");
+    return false;
+  }
+  int fd = os::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    st->print_cr("Could not open %s: %s", path, strerror(errno));
+    return false;
+  }
+
+  jlong end = _cursor;
+  jlong start = MAX2((jlong)0, end - _length);
+
+  // Snapshot first so that the header carries the exact record count.
+  Record* copy = NEW_C_HEAP_ARRAY_RETURN_NULL(Record, (size_t)(end - start), mtCompiler);
+  if (copy == NULL) {
+    os::close(fd);
+    st->print_cr("Could not allocate %d bytes for the dump", (int)((end - start) * sizeof(Record)));
+    return false;
+  }
+  u4 count = 0;
+  for (jlong seq = start + 1; seq <= end; seq++) {
+    if (read(seq, &copy[count])) {
+      count++;
+    }
+  }
+
+  Header h;
+  memcpy(h._magic, "HSCE", 4);
+  h._version = format_version;
+  h._record_size = sizeof(Record);
+  h._record_count = count;
+  h._ticks_per_second = os::elapsed_frequency();
+  h._dump_timestamp = os::elapsed_counter();
+
+  bool ok = os::write(fd, &h, sizeof(h)) == sizeof(h) &&
+            (count == 0 || os::write(fd, copy, (unsigned int)(count * sizeof(Record))) == count * sizeof(Record));
+  FREE_C_HEAP_ARRAY(Record, copy, mtCompiler);
+  os::close(fd);
+  if (!ok) {
+    st->print_cr("Could not write %s", path);
+    return false;
+  }
+  st->print_cr("Wrote %u compilation events to %s", count, path);
+  return true;
+}
+
+void compilationEventLog_init() {
+  CompilationEventLog::initialize();
+}
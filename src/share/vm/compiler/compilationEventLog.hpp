@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#ifndef SHARE_VM_COMPILER_COMPILATIONEVENTLOG_HPP
+#define SHARE_VM_COMPILER_COMPILATIONEVENTLOG_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class CompileTask;
+class Method;
+class nmethod;
+class outputStream;
+
+// CompilationEventLog is a compact, always-on alternative to
+// -XX:+LogCompilation.  Every compilation event is written as one
+// fixed-size binary record into a ring buffer; slots are claimed with
+// an atomic increment so no lock is taken on the compiler threads or
+// in the nmethod state transitions.
+//
+// The ring can be printed or dumped in binary form with
+// jcmd Compiler.event_log, and its tail is printed in hs_err files.
+// A decoder for the binary dump lives in src/share/tools/CompilationEventLog;
+// keep the layout of Header and Record in sync with it.
+
+class CompilationEventLog : AllStatic {
+ public:
+  enum EventType {
+    Enqueue      = 1,   // value1 = hot count, value2 = bytecode size
+    Start        = 2,   // value1 = compile queue wait in microseconds, or -1
+    Inlining     = 3,   // value1 = inlined bytecodes, value2 = bytecode size
+    Install      = 4,   // address = nmethod, value1 = insts size, value2 = total size, name = method
+    Failure      = 5,   // name = failure reason
+    NotEntrant   = 6,   // address = nmethod, value1 = decompile count
+    Zombie       = 7,   // address = nmethod
+    Unloaded     = 8,   // address = nmethod
+    Flush        = 9,   // address = nmethod, value1 = total size
+    EventTypeLimit
+  };
+
+  enum Flags {
+    is_osr      = 1 << 0,
+    is_blocking = 1 << 1
+  };
+
+  enum {
+    name_length    = 80,
+    format_version = 1
+  };
+
+  // One ring slot; also the on-disk record.  128 bytes, naturally aligned.
+  struct Record {
+    volatile jlong _seq;         // 0 while being written
+    jlong          _timestamp;   // os::elapsed_counter() ticks
+    jlong          _address;
+    jint           _compile_id;
+    jint           _osr_bci;
+    jint           _value1;
+    jint           _value2;
+    u1             _type;
+    u1             _comp_level;
+    u2             _flags;
+    u4             _thread_id;
+    char           _name[name_length];
+  };
+
+  // Dump file header, in native byte order.  The decoder uses
+  // _version to detect a byte-swapped file.
+  struct Header {
+    char           _magic[4];    // "HSCE"
+    u4             _version;
+    u4             _record_size;
+    u4             _record_count;
+    jlong          _ticks_per_second;
+    jlong          _dump_timestamp;
+  };
+
+ private:
+  static Record*        _records;
+  static jlong          _length;
+  static volatile jlong _cursor;
+
+  // Claim the next ring slot and reset it; the record is invisible to
+  // readers until publish() stores its sequence number.
+  static Record* claim(EventType type, int compile_id, int comp_level, jlong* seq);
+  static void    publish(Record* r, jlong seq);
+  static bool    read(jlong seq, Record* result);
+  static void    print_record(outputStream* st, const Record* r);
+
+ public:
+  static void initialize();
+  static bool is_enabled()  { return _records != NULL; }
+
+  static void log_enqueue(CompileTask* task, Method* method, int hot_count);
+  static void log_start(CompileTask* task, jlong time_queued);
+  static void log_inlining(CompileTask* task, Method* method);
+  static void log_install(CompileTask* task, nmethod* nm);
+  static void log_failure(CompileTask* task, const char* reason);
+  static void log_state_change(const nmethod* nm, EventType type);
+  static void log_flush(const nmethod* nm);
+
+  // Print the newest max_records records (all of them if max_records < 0).
+  static void print_on(outputStream* st, int max_records);
+
+  // Write all valid records to path.  Returns false and prints a
+  // message on st if the file could not be written.
+  static bool dump(const char* path, outputStream* st);
+
+  static const char* type_name(int type);
+};
+
+#endif // SHARE_VM_COMPILER_COMPILATIONEVENTLOG_HPP
@@ -26,6 +26,7 @@
 #include "classfile/systemDictionary.hpp"
 #include "classfile/vmSymbols.hpp"
 #include "code/codeCache.hpp"
+#include "compiler/compilationEventLog.hpp"
 #include "compiler/compileBroker.hpp"
 #include "compiler/compileLog.hpp"
 #include "compiler/compilerOracle.hpp"
@@ -338,8 +339,11 @@ void CompileTask::initialize(int compile_id,
   _comment = comment;
   _failure_reason = NULL;
 
-  if (LogCompilation) {
+  if (LogCompilation || LogCompilationEvents) {
     _time_queued = os::elapsed_counter();
+  }
+
+  if (LogCompilation) {
     if (hot_method.not_null()) {
       if (hot_method == method) {
         _hot_method = _method;
@@ -1683,6 +1687,7 @@ CompileTask* CompileBroker::create_compile_task(CompileQueue* queue,
                        hot_method, hot_count, comment,
                        blocking);
   queue->add(new_task);
+  CompilationEventLog::log_enqueue(new_task, method(), hot_count);
   return new_task;
 }
 
@@ -2010,6 +2015,15 @@ void CompileBroker::post_compile(CompilerThread* thread, CompileTask* task, Even
         _compilation_log->log_nmethod(thread, code);
       }
     }
+    if (CompilationEventLog::is_enabled()) {
+      CompilationEventLog::log_inlining(task, task->method());
+      nmethod* code = task->code();
+      if (code != NULL) {
+        CompilationEventLog::log_install(task, code);
+      }
+    }
+  } else {
+    CompilationEventLog::log_failure(task, task->failure_reason());
   }
 
   // simulate crash during compilation
@@ -2044,6 +2058,7 @@ void CompileBroker::invoke_compiler_on_method(CompileTask* task) {
   if (LogEvents) {
     _compilation_log->log_compile(thread, task);
   }
+  CompilationEventLog::log_start(task, task->time_queued());
 
   // Common flags.
   uint compile_id = task->compile_id();
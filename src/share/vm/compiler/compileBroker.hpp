@@ -99,6 +99,8 @@ class CompileTask : public CHeapObj<mtCompiler> {
   int          comp_level()                      { return _comp_level;}
   void         set_comp_level(int comp_level)    { _comp_level = comp_level;}
 
+  jlong        time_queued() const               { return _time_queued; }
+
   int          num_inlined_bytecodes() const     { return _num_inlined_bytecodes; }
   void         set_num_inlined_bytecodes(int n)  { _num_inlined_bytecodes = n; }
 
@@ -142,6 +144,7 @@ public:
   void         log_task_start(CompileLog* log);
   void         log_task_done(CompileLog* log);
 
+  const char*  failure_reason() const            { return _failure_reason; }
   void         set_failure_reason(const char* reason) {
     _failure_reason = reason;
   }
@@ -2853,7 +2853,7 @@ void G1CollectedHeap::collection_set_iterate_from(HeapRegion* r,
 
 HeapRegion* G1CollectedHeap::next_compaction_region(const HeapRegion* from) const {
   HeapRegion* result = _hrm.next_region_in_heap(from);
-  while (result != NULL && result->isHumongous()) {
+  while (result != NULL && (result->isHumongous() || result->has_pinned_objects())) {
     result = _hrm.next_region_in_heap(result);
   }
   return result;
@@ -2878,6 +2878,18 @@ bool G1CollectedHeap::block_is_obj(const HeapWord* addr) const {
   return sp->block_is_obj(addr);
 }
 
+// Pin counts only change outside of safepoints, so a collection sees a
+// stable set of pinned regions.
+void G1CollectedHeap::pin_object(JavaThread* thread, oop obj) {
+  assert(!SafepointSynchronize::is_at_safepoint(), "should not be at a safepoint");
+  heap_region_containing(obj)->increment_pinned_object_count();
+}
+
+void G1CollectedHeap::unpin_object(JavaThread* thread, oop obj) {
+  assert(!SafepointSynchronize::is_at_safepoint(), "should not be at a safepoint");
+  heap_region_containing(obj)->decrement_pinned_object_count();
+}
+
 bool G1CollectedHeap::supports_tlab_allocation() const {
   return true;
 }
@@ -3674,7 +3686,8 @@ size_t G1CollectedHeap::cards_scanned() {
 bool G1CollectedHeap::humongous_region_is_always_live(uint index) {
   HeapRegion* region = region_at(index);
   assert(region->startsHumongous(), "Must start a humongous object");
-  return oop(region->bottom())->is_objArray() || !region->rem_set()->is_empty();
+  return oop(region->bottom())->is_objArray() || !region->rem_set()->is_empty() ||
+         region->has_pinned_objects();
 }
 
 class RegisterHumongousWithInCSetFastTestClosure : public HeapRegionClosure {
@@ -4333,7 +4346,8 @@ void G1CollectedHeap::drain_evac_failure_scan_stack() {
 
 oop
 G1CollectedHeap::handle_evacuation_failure_par(G1ParScanThreadState* _par_scan_state,
-                                               oop old) {
+                                               oop old,
+                                               bool pinned) {
   assert(obj_in_cs(old),
          err_msg("obj: "PTR_FORMAT" should still be in the CSet",
                  (HeapWord*) old));
@@ -4345,8 +4359,12 @@ G1CollectedHeap::handle_evacuation_failure_par(G1ParScanThreadState* _par_scan_s
     OopsInHeapRegionClosure* cl = _par_scan_state->evac_failure_closure();
     uint queue_num = _par_scan_state->queue_num();
 
-    _evacuation_failed = true;
-    _evacuation_failed_info_array[queue_num].register_copy_failure(old->size());
+    if (pinned) {
+      _evacuation_pinned = true;
+    } else {
+      _evacuation_failed = true;
+      _evacuation_failed_info_array[queue_num].register_copy_failure(old->size());
+    }
     if (_evac_failure_closure != cl) {
       MutexLockerEx x(EvacFailureStack_lock, Mutex::_no_safepoint_check_flag);
       assert(!_drain_in_progress,
@@ -4396,7 +4414,7 @@ void G1CollectedHeap::handle_evacuation_failure_common(oop old, markOop m) {
 }
 
 void G1CollectedHeap::preserve_mark_if_necessary(oop obj, markOop m) {
-  assert(evacuation_failed(), "Oversaving!");
+  assert(evacuation_failed() || evacuation_pinned(), "Oversaving!");
   // We want to call the "for_promotion_failure" version only in the
   // case of a promotion failure.
   if (m->must_be_preserved_for_promotion_failure(obj)) {
@@ -5860,6 +5878,7 @@ void G1CollectedHeap::enqueue_discovered_references(uint no_of_gc_workers) {
 void G1CollectedHeap::evacuate_collection_set(EvacuationInfo& evacuation_info) {
   _expand_heap_after_alloc_failure = true;
   _evacuation_failed = false;
+  _evacuation_pinned = false;
 
   // Should G1EvacuationFailureALot be in effect for this GC?
   NOT_PRODUCT(set_evacuation_failure_alot_for_current_gc();)
@@ -5970,9 +5989,11 @@ void G1CollectedHeap::evacuate_collection_set(EvacuationInfo& evacuation_info) {
 
   finalize_for_evac_failure();
 
-  if (evacuation_failed()) {
+  if (evacuation_failed() || evacuation_pinned()) {
     remove_self_forwarding_pointers();
+  }
 
+  if (evacuation_failed()) {
     // Reset the G1EvacuationFailureALot counters and flags
     // Note: the values are reset only when an actual
     // evacuation failure occurs.
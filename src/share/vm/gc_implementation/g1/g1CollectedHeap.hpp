@@ -842,6 +842,11 @@ protected:
   // True iff a evacuation has failed in the current collection.
   bool _evacuation_failed;
 
+  // True iff objects in pinned regions were left in place in the current
+  // collection. They are handled like failed evacuations, but do not mean
+  // that the collection ran out of space.
+  bool _evacuation_pinned;
+
   EvacuationFailedInfo* _evacuation_failed_info_array;
 
   // Failed evacuations cause some logical from-space objects to have
@@ -883,8 +888,10 @@ protected:
   // structures.
   void finalize_for_evac_failure();
 
-  // An attempt to evacuate "obj" has failed; take necessary steps.
-  oop handle_evacuation_failure_par(G1ParScanThreadState* _par_scan_state, oop obj);
+  // An attempt to evacuate "obj" has failed, or "obj" is in a pinned
+  // region and must stay in place; take necessary steps.
+  oop handle_evacuation_failure_par(G1ParScanThreadState* _par_scan_state, oop obj,
+                                    bool pinned = false);
   void handle_evacuation_failure_common(oop obj, markOop m);
 
 #ifndef PRODUCT
@@ -1257,6 +1264,9 @@ public:
   // True iff an evacuation has failed in the most-recent collection.
   bool evacuation_failed() { return _evacuation_failed; }
 
+  // True iff pinned regions were kept in place in the most-recent collection.
+  bool evacuation_pinned() { return _evacuation_pinned; }
+
   void remove_from_old_sets(const HeapRegionSetCount& old_regions_removed, const HeapRegionSetCount& humongous_regions_removed);
   void prepend_to_freelist(FreeRegionList* list);
   void decrement_summary_bytes(size_t bytes);
@@ -1465,6 +1475,12 @@ public:
   // Does this heap support heap inspection? (+PrintClassHistogram)
   virtual bool supports_heap_inspection() const { return true; }
 
+  // Pinning keeps the region containing the object out of evacuation
+  // and full GC compaction.
+  virtual bool supports_object_pinning() const { return G1RegionPinning; }
+  virtual void pin_object(JavaThread* thread, oop obj);
+  virtual void unpin_object(JavaThread* thread, oop obj);
+
   // Section on thread-local allocation buffers (TLABs)
   // See CollectedHeap for semantics.
 
@@ -2045,6 +2045,14 @@ void G1CollectorPolicy::finalize_cset(double target_pause_time_ms, EvacuationInf
 
     HeapRegion* hr = cset_chooser->peek();
     while (hr != NULL) {
+      if (hr->has_pinned_objects()) {
+        // Evacuating a pinned region would only retain it in place, so
+        // drop it from the candidates of this mixed cycle.
+        cset_chooser->remove_and_move_to_next(hr);
+        hr = cset_chooser->peek();
+        continue;
+      }
+
       if (old_cset_region_length() >= max_old_cset_length) {
         // Added maximum number of old regions to the CSet.
         ergo_verbose2(ErgoCSetConstruction,
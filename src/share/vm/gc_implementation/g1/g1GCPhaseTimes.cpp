@@ -202,6 +202,9 @@ void G1GCPhaseTimes::note_gc_start(uint active_gc_threads) {
   _last_redirty_logged_cards_time_ms.reset();
   _last_redirty_logged_cards_processed_cards.reset();
 
+  _cur_evac_fail_recalc_used = 0.0;
+  _cur_evac_fail_remove_self_forwards = 0.0;
+  _cur_evac_fail_restore_remsets = 0.0;
 }
 
 void G1GCPhaseTimes::note_gc_end() {
@@ -334,7 +337,8 @@ void G1GCPhaseTimes::print(double pause_time_sec) {
   if (_cur_verify_before_time_ms > 0.0) {
     print_stats(2, "Verify Before", _cur_verify_before_time_ms);
   }
-  if (G1CollectedHeap::heap()->evacuation_failed()) {
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  if (g1h->evacuation_failed() || g1h->evacuation_pinned()) {
     double evac_fail_handling = _cur_evac_fail_recalc_used + _cur_evac_fail_remove_self_forwards +
       _cur_evac_fail_restore_remsets;
     print_stats(2, "Evacuation Failure", evac_fail_handling);
@@ -218,6 +218,13 @@ class G1AdjustPointersClosure: public HeapRegionClosure {
         // point all the oops to the new location
         obj->adjust_pointers();
       }
+    } else if (r->has_pinned_objects()) {
+      // Pinned regions are not compacted; adjust their live objects in place.
+      HeapWord* p = r->bottom();
+      while (p < r->top()) {
+        oop obj = oop(p);
+        p += obj->is_gc_marked() ? obj->adjust_pointers() : obj->size();
+      }
     } else {
       // This really ought to be "as_CompactibleSpace"...
       r->adjust_pointers();
@@ -277,6 +284,16 @@ public:
         }
         hr->reset_during_compaction();
       }
+    } else if (hr->has_pinned_objects()) {
+      HeapWord* p = hr->bottom();
+      while (p < hr->top()) {
+        oop obj = oop(p);
+        if (obj->is_gc_marked()) {
+          obj->init_mark();
+        }
+        p += obj->size();
+      }
+      hr->reset_during_compaction();
     } else {
       hr->compact();
     }
@@ -322,6 +339,24 @@ void G1PrepareCompactClosure::free_humongous_region(HeapRegion* hr) {
   dummy_free_list.remove_all();
 }
 
+void G1PrepareCompactClosure::prepare_pinned_region(HeapRegion* hr) {
+  // Live objects of a pinned region keep their place.  Dead ones are
+  // replaced by fillers of the same size, so the region stays parsable
+  // after their classes are unloaded, and its block offset table stays
+  // valid.
+  HeapWord* p = hr->bottom();
+  while (p < hr->top()) {
+    oop obj = oop(p);
+    size_t size = obj->size();
+    if (obj->is_gc_marked()) {
+      obj->forward_to(obj);
+    } else {
+      CollectedHeap::fill_with_object(p, size);
+    }
+    p += size;
+  }
+}
+
 void G1PrepareCompactClosure::prepare_for_compaction(HeapRegion* hr, HeapWord* end) {
   // If this is the first live region that we came across which we can compact,
   // initialize the CompactPoint.
@@ -360,6 +395,8 @@ bool G1PrepareCompactClosure::doHeapRegion(HeapRegion* hr) {
     } else {
       assert(hr->continuesHumongous(), "Invalid humongous.");
     }
+  } else if (hr->has_pinned_objects()) {
+    prepare_pinned_region(hr);
   } else {
     prepare_for_compaction(hr, hr->end());
   }
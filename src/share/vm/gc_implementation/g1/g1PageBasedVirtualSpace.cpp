@@ -24,6 +24,7 @@
 
 #include "precompiled.hpp"
 #include "gc_implementation/g1/g1PageBasedVirtualSpace.hpp"
+#include "gc_implementation/shared/pretouchTask.hpp"
 #include "oops/markOop.hpp"
 #include "oops/oop.inline.hpp"
 #include "services/memTracker.hpp"
@@ -144,6 +145,10 @@ bool G1PageBasedVirtualSpace::commit(uintptr_t start, size_t size_in_pages) {
   }
   _committed.set_range(start, end);
 
+  if (AlwaysPreTouch) {
+    PretouchTask::pretouch(page_start(start), page_start(end), _page_size);
+  }
+
   return zero_filled;
 }
 
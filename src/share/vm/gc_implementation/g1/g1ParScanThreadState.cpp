@@ -153,6 +153,11 @@ void G1ParScanThreadState::trim_queue() {
 oop G1ParScanThreadState::copy_to_survivor_space(oop const old) {
   size_t word_sz = old->size();
   HeapRegion* from_region = _g1h->heap_region_containing_raw(old);
+  if (from_region->has_pinned_objects()) {
+    // Objects in pinned regions stay where they are, and the region is
+    // retained like one whose evacuation failed.
+    return _g1h->handle_evacuation_failure_par(this, old, true /* pinned */);
+  }
   // +1 to make the -1 indexes valid...
   int       young_index = from_region->young_index_in_cset()+1;
   assert( (from_region->is_young() && young_index >  0) ||
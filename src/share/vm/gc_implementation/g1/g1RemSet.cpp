@@ -396,7 +396,7 @@ void G1RemSet::cleanup_after_oops_into_collection_set_do() {
   DirtyCardQueueSet& into_cset_dcqs = _g1->into_cset_dirty_card_queue_set();
   int into_cset_n_buffers = into_cset_dcqs.completed_buffers_num();
 
-  if (_g1->evacuation_failed()) {
+  if (_g1->evacuation_failed() || _g1->evacuation_pinned()) {
     double restore_remembered_set_start = os::elapsedTime();
 
     // Restore remembered sets for the regions pointing into the collection set.
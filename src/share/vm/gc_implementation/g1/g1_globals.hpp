@@ -289,6 +289,10 @@
           "Print some information about large object liveness "             \
           "at every young GC.")                                             \
                                                                             \
+  experimental(bool, G1RegionPinning, true,                                 \
+          "Pin the regions holding arrays of JNI critical sections "        \
+          "instead of locking out garbage collection")                      \
+                                                                            \
   experimental(uintx, G1OldCSetRegionThresholdPercent, 10,                  \
           "An upper bound for the number of old CSet regions expressed "    \
           "as a percentage of the heap size.")                              \
@@ -238,6 +238,9 @@ class HeapRegion: public G1OffsetTableContigSpace {
   // True iff an attempt to evacuate an object in the region failed.
   bool _evacuation_failed;
 
+  // Number of objects in the region held by JNI critical sections.
+  volatile jint _pinned_object_count;
+
   // A heap region may be a member one of a number of special subsets, each
   // represented as linked lists through the field below.  Currently, there
   // is only one set:
@@ -349,7 +352,8 @@ class HeapRegion: public G1OffsetTableContigSpace {
     ParEvacFailureClaimValue   = 6,
     AggregateCountClaimValue   = 7,
     VerifyCountClaimValue      = 8,
-    ParMarkRootClaimValue      = 9
+    ParMarkRootClaimValue      = 9,
+    JvmtiHeapIterClaimValue    = 10
   };
 
   // All allocated blocks are occupied by objects in a HeapRegion
@@ -614,8 +618,8 @@ class HeapRegion: public G1OffsetTableContigSpace {
   bool is_marked() { return _prev_top_at_mark_start != bottom(); }
 
   void reset_during_compaction() {
-    assert(isHumongous() && startsHumongous(),
-           "should only be called for starts humongous regions");
+    assert(startsHumongous() || has_pinned_objects(),
+           "should only be called for regions that are not compacted");
 
     zero_marked_bytes();
     init_top_at_mark_start();
@@ -711,6 +715,12 @@ class HeapRegion: public G1OffsetTableContigSpace {
     }
   }
 
+  // A region with pinned objects is neither evacuated nor compacted; its
+  // live objects stay in place, as after an evacuation failure.
+  bool has_pinned_objects() const { return _pinned_object_count > 0; }
+  inline void increment_pinned_object_count();
+  inline void decrement_pinned_object_count();
+
   // Requires that "mr" be entirely within the region.
   // Apply "cl->do_object" to all objects that intersect with "mr".
   // If the iteration encounters an unparseable portion of the region,
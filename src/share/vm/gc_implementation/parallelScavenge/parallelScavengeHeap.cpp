@@ -96,6 +96,9 @@ jint ParallelScavengeHeap::initialize() {
   double max_gc_pause_sec = ((double) MaxGCPauseMillis)/1000.0;
   double max_gc_minor_pause_sec = ((double) MaxGCMinorPauseMillis)/1000.0;
 
+  // Set up the GCTaskManager; its workers pre-touch the generations
+  _gc_task_manager = GCTaskManager::create(ParallelGCThreads);
+
   _gens = new AdjoiningGenerations(heap_rs, _collector_policy, generation_alignment());
 
   _old_gen = _gens->old_gen();
@@ -123,9 +126,6 @@ jint ParallelScavengeHeap::initialize() {
     new PSGCAdaptivePolicyCounters("ParScav:MSC", 2, 3, _size_policy);
   _psh = this;
 
-  // Set up the GCTaskManager
-  _gc_task_manager = GCTaskManager::create(ParallelGCThreads);
-
   if (UseParallelOldGC && !PSParallelCompact::initialize()) {
     return JNI_ENOMEM;
   }
@@ -26,6 +26,7 @@
 #include "utilities/macros.hpp"
 #if INCLUDE_ALL_GCS
 #include "gc_implementation/shared/mutableSpace.hpp"
+#include "gc_implementation/shared/pretouchTask.hpp"
 #include "gc_implementation/shared/spaceDecorator.hpp"
 #include "oops/oop.inline.hpp"
 #include "runtime/safepoint.hpp"
@@ -62,9 +63,8 @@ void MutableSpace::numa_setup_pages(MemRegion mr, bool clear_space) {
 }
 
 void MutableSpace::pretouch_pages(MemRegion mr) {
-  for (volatile char *p = (char*)mr.start(); p < (char*)mr.end(); p += os::vm_page_size()) {
-    char t = *p; *p = t;
-  }
+  size_t page_size = UseLargePages ? os::large_page_size() : os::vm_page_size();
+  PretouchTask::pretouch((char*)mr.start(), (char*)mr.end(), page_size);
 }
 
 void MutableSpace::initialize(MemRegion mr,
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "gc_implementation/shared/pretouchTask.hpp"
+#include "gc_interface/collectedHeap.hpp"
+#include "memory/sharedHeap.hpp"
+#include "memory/universe.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/init.hpp"
+#include "runtime/os.hpp"
+#include "runtime/thread.hpp"
+#include "utilities/macros.hpp"
+#if INCLUDE_ALL_GCS
+#include "gc_implementation/parallelScavenge/gcTaskManager.hpp"
+#include "gc_implementation/parallelScavenge/parallelScavengeHeap.hpp"
+#endif // INCLUDE_ALL_GCS
+
+PretouchTask::PretouchTask(char* start, char* end, size_t chunk_size) :
+  AbstractGangTask("Pretouch"),
+  _cur(start),
+  _end(end),
+  _chunk_size(chunk_size) {
+}
+
+void PretouchTask::do_pretouch() {
+  while (true) {
+    char* chunk_start = (char*)Atomic::add_ptr((intptr_t)_chunk_size, (volatile intptr_t*)&_cur)
+                        - _chunk_size;
+    if (chunk_start >= _end) {
+      return;
+    }
+    char* chunk_end = chunk_start + MIN2(_chunk_size, pointer_delta(_end, chunk_start, 1));
+    os::pretouch_memory(chunk_start, chunk_end);
+  }
+}
+
+#if INCLUDE_ALL_GCS
+// The Parallel collector runs its workers through the GCTaskManager
+class PretouchGCTask : public GCTask {
+ private:
+  PretouchTask* _task;
+
+ public:
+  PretouchGCTask(PretouchTask* task) : _task(task) {}
+
+  virtual char* name() { return (char *)"pretouch task"; }
+  virtual void do_it(GCTaskManager* manager, uint which) { _task->do_pretouch(); }
+};
+#endif // INCLUDE_ALL_GCS
+
+void PretouchTask::pretouch(char* start, char* end, size_t page_size) {
+  size_t chunk_size = align_size_up(MAX2(PreTouchParallelChunkSize, page_size), page_size);
+  PretouchTask task(start, end, chunk_size);
+
+  // The work gang and the GCTaskManager must not be entered by two threads
+  // at once. The VM thread owns them, and before it exists the main thread
+  // is the only Java thread and cannot race with a GC.
+  Thread* thread = Thread::current();
+  bool owns_workers = thread->is_VM_thread() ||
+                      (!is_init_completed() && thread->is_Java_thread() &&
+                       Threads::number_of_threads() <= 1);
+  CollectedHeap* heap = Universe::heap();
+  bool use_workers = heap != NULL && owns_workers &&
+                     pointer_delta(end, start, 1) > chunk_size;
+  if (use_workers) {
+    if (heap->kind() == CollectedHeap::GenCollectedHeap ||
+        heap->kind() == CollectedHeap::G1CollectedHeap) {
+      FlexibleWorkGang* workers = ((SharedHeap*)heap)->workers();
+      if (workers != NULL) {
+        workers->run_task(&task);
+      }
+    }
+#if INCLUDE_ALL_GCS
+    if (heap->kind() == CollectedHeap::ParallelScavengeHeap) {
+      GCTaskManager* manager = ParallelScavengeHeap::gc_task_manager();
+      if (manager != NULL) {
+        ResourceMark rm;
+        GCTaskQueue* q = GCTaskQueue::create();
+        for (uint i = 0; i < manager->active_workers(); i++) {
+          q->enqueue(new PretouchGCTask(&task));
+        }
+        manager->execute_and_wait(q);
+      }
+    }
+#endif // INCLUDE_ALL_GCS
+  }
+
+  // Touch whatever the workers did not, which is everything if there
+  // were none.
+  task.do_pretouch();
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_SHARED_PRETOUCHTASK_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_SHARED_PRETOUCHTASK_HPP
+
+#include "utilities/workgroup.hpp"
+
+// Pre-touches (AlwaysPreTouch) the pages of a range of freshly committed
+// memory. The range is split into chunks of PreTouchParallelChunkSize,
+// aligned to the page size backing the memory, which the GC worker threads
+// claim and touch in parallel.
+//
+// The GC workers are only used by the VM thread and by the main thread
+// during initialization while it is the only Java thread, because neither
+// the work gang nor the GCTaskManager may be entered concurrently. Everyone
+// else touches the range itself.
+
+class PretouchTask : public AbstractGangTask {
+ private:
+  char* volatile _cur;
+  char* const    _end;
+  const size_t   _chunk_size;
+
+ public:
+  PretouchTask(char* start, char* end, size_t chunk_size);
+
+  // Claim chunks and touch them until the whole range is claimed.
+  void do_pretouch();
+
+  virtual void work(uint worker_id) { do_pretouch(); }
+
+  // Touch the pages of [start, end); page_size is the size of the pages
+  // backing the memory, which may be large pages.
+  static void pretouch(char* start, char* end, size_t page_size);
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_SHARED_PRETOUCHTASK_HPP
@@ -331,6 +331,14 @@ void CollectedHeap::flush_deferred_store_barrier(JavaThread* thread) {
   assert(thread->deferred_card_mark().is_empty(), "invariant");
 }
 
+void CollectedHeap::pin_object(JavaThread* thread, oop obj) {
+  ShouldNotReachHere();
+}
+
+void CollectedHeap::unpin_object(JavaThread* thread, oop obj) {
+  ShouldNotReachHere();
+}
+
 size_t CollectedHeap::max_tlab_size() const {
   // TLABs can't be bigger than we can fill with a int[Integer.MAX_VALUE].
   // This restriction could be removed by enabling filling with multiple arrays.
@@ -460,6 +460,13 @@ class CollectedHeap : public CHeapObj<mtInternal> {
   // Does this heap support heap inspection (+PrintClassHistogram?)
   virtual bool supports_heap_inspection() const = 0;
 
+  // Support for object pinning, used by the JNI Get/Release*Critical
+  // functions.  A heap that supports it must never move a pinned object,
+  // so that critical sections need not lock out GC via the GC_locker.
+  virtual bool supports_object_pinning() const { return false; }
+  virtual void pin_object(JavaThread* thread, oop obj);
+  virtual void unpin_object(JavaThread* thread, oop obj);
+
   // Perform a collection of the heap; intended for use in implementing
   // "System.gc".  This probably implies as full a collection as the
   // "CollectedHeap" supports.
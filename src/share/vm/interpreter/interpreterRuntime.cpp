@@ -768,6 +768,7 @@ IRT_ENTRY(void, InterpreterRuntime::resolve_invoke(JavaThread* thread, Bytecodes
            info.call_kind() == CallInfo::vtable_call, "");
   }
 #endif
+  JVMTI_ONLY(pool->cache()->record_method_holder(info.resolved_method()->method_holder());)
   switch (info.call_kind()) {
   case CallInfo::direct_call:
     cache_entry(thread)->set_direct_call(
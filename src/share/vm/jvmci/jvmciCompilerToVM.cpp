@@ -713,6 +713,34 @@ C2V_VMENTRY(void, invalidateInstalledCode, (JNIEnv*, jobject, jobject hotspotIns
   InstalledCode::set_address(hotspotInstalledCode, 0);
 C2V_END
 
+// Invalidates all of the given installed codes with a single deoptimization
+// safepoint instead of one safepoint per installed code.
+C2V_VMENTRY(void, invalidateInstalledCodes, (JNIEnv*, jobject, jobjectArray installedCodes))
+  objArrayHandle codes(THREAD, (objArrayOop) JNIHandles::resolve(installedCodes));
+  int marked = 0;
+  for (int i = 0; i < codes->length(); i++) {
+    oop installed_code = codes->obj_at(i);
+    if (installed_code == NULL) {
+      continue;
+    }
+    nmethod* m = (nmethod*) InstalledCode::address(installed_code);
+    if (m != NULL && !m->is_not_entrant()) {
+      m->mark_for_deoptimization();
+      marked++;
+    }
+  }
+  if (marked > 0) {
+    VM_Deoptimize op;
+    VMThread::execute(&op);
+  }
+  for (int i = 0; i < codes->length(); i++) {
+    oop installed_code = codes->obj_at(i);
+    if (installed_code != NULL) {
+      InstalledCode::set_address(installed_code, 0);
+    }
+  }
+C2V_END
+
 C2V_VMENTRY(jobject, getJavaMirror, (JNIEnv* env, jobject, jlong metaspace_klass))
   Klass* klass = asKlass(metaspace_klass);
   return JNIHandles::make_local(THREAD, klass->java_mirror());
@@ -1102,6 +1130,7 @@ JNINativeMethod CompilerToVM_methods[] = {
   {CC"getLocalVariableTableLength",                  CC"("METASPACE_METHOD")I",                                                FN_PTR(getLocalVariableTableLength)},
   {CC"reprofile",                                    CC"("METASPACE_METHOD")V",                                                FN_PTR(reprofile)},
   {CC"invalidateInstalledCode",                      CC"("INSTALLED_CODE")V",                                                  FN_PTR(invalidateInstalledCode)},
+  {CC"invalidateInstalledCodes",                     CC"(["INSTALLED_CODE")V",                                                 FN_PTR(invalidateInstalledCodes)},
   {CC"getJavaMirror",                                CC"("METASPACE_KLASS")"CLASS,                                             FN_PTR(getJavaMirror)},
   {CC"readUnsafeKlassPointer",                       CC"("OBJECT")J",                                                          FN_PTR(readUnsafeKlassPointer)},
   {CC"readUncompressedOop",                          CC"(J)"OBJECT,                                                            FN_PTR(readUncompressedOop)},
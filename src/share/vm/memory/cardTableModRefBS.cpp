@@ -34,6 +34,7 @@
 #include "runtime/mutexLocker.hpp"
 #include "runtime/virtualspace.hpp"
 #include "services/memTracker.hpp"
+#include "utilities/copy.hpp"
 #include "utilities/macros.hpp"
 #ifdef COMPILER1
 #include "c1/c1_LIR.hpp"
@@ -572,7 +573,7 @@ void CardTableModRefBS::clear_MemRegion(MemRegion mr) {
     cur = byte_after(mr.start() - 1);
   }
   jbyte* last = byte_after(mr.last());
-  memset(cur, clean_card, pointer_delta(last, cur, sizeof(jbyte)));
+  Copy::fill_to_bytes(cur, pointer_delta(last, cur, sizeof(jbyte)), clean_card);
 }
 
 void CardTableModRefBS::clear(MemRegion mr) {
@@ -102,12 +102,25 @@ bool CodeHeap::reserve(size_t reserved_size, size_t committed_size,
           os::vm_page_size();
   const size_t granularity = os::vm_allocation_granularity();
   const size_t r_align = MAX2(page_size, granularity);
-  const size_t r_size = align_size_up(reserved_size, r_align);
+  size_t r_size = align_size_up(reserved_size, r_align);
   const size_t c_size = align_size_up(committed_size, page_size);
 
-  const size_t rs_align = page_size == (size_t) os::vm_page_size() ? 0 :
+  size_t rs_align = page_size == (size_t) os::vm_page_size() ? 0 :
     MAX2(page_size, granularity);
-  ReservedCodeSpace rs(r_size, rs_align, rs_align > 0);
+  const bool large = rs_align > 0;
+  if (!large && os::code_huge_page_size() > 0) {
+    // Start the code heap at a huge page boundary so that khugepaged can
+    // collapse it from the first committed chunk on. The reservation is
+    // rounded up to its alignment, so align the size down to keep
+    // ReservedCodeCacheSize an upper bound.
+    const size_t huge_align = MAX2(os::code_huge_page_size(), granularity);
+    const size_t huge_r_size = align_size_down(r_size, huge_align);
+    if (huge_r_size >= c_size && huge_r_size > 0) {
+      rs_align = huge_align;
+      r_size = huge_r_size;
+    }
+  }
+  ReservedCodeSpace rs(r_size, rs_align, large);
   os::trace_page_sizes("code heap", committed_size, reserved_size, page_size,
                        rs.base(), rs.size());
   if (!_memory.initialize(rs, c_size)) {
@@ -115,6 +128,7 @@ bool CodeHeap::reserve(size_t reserved_size, size_t committed_size,
   }
 
   on_code_mapping(_memory.low(), _memory.committed_size());
+  os::advise_huge_pages_for_code(_memory.low(), _memory.committed_size());
   _number_of_committed_segments = size_to_segments(_memory.committed_size());
   _number_of_reserved_segments  = size_to_segments(_memory.reserved_size());
   assert(_number_of_reserved_segments >= _number_of_committed_segments, "just checking");
@@ -151,6 +165,7 @@ bool CodeHeap::expand_by(size_t size) {
     char* base = _memory.low() + _memory.committed_size();
     if (!_memory.expand_by(dm)) return false;
     on_code_mapping(base, dm);
+    os::advise_huge_pages_for_code(_memory.low(), _memory.committed_size());
     size_t i = _number_of_committed_segments;
     _number_of_committed_segments = size_to_segments(_memory.committed_size());
     assert(_number_of_reserved_segments == size_to_segments(_memory.reserved_size()), "number of reserved segments should not change");
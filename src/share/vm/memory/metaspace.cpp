@@ -1270,6 +1270,10 @@ bool VirtualSpaceList::expand_node_by(VirtualSpaceNode* node,
   assert(after >= before, "Inconsistency");
   inc_committed_words(after - before);
 
+  if (is_class() && after > before) {
+    os::advise_huge_pages_for_code((char*)node->bottom(), after * BytesPerWord);
+  }
+
   return result;
 }
 
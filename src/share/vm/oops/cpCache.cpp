@@ -293,6 +293,7 @@ void ConstantPoolCacheEntry::set_method_handle_common(constantPoolHandle cpool,
 
   const methodHandle adapter = call_info.resolved_method();
   const Handle appendix      = call_info.resolved_appendix();
+  JVMTI_ONLY(cpool->cache()->record_method_holder(adapter->method_holder());)
   const Handle method_type   = call_info.resolved_method_type();
   const bool has_appendix    = appendix.not_null();
   const bool has_method_type = method_type.not_null();
@@ -644,6 +645,30 @@ void ConstantPoolCache::adjust_method_entries(Method** old_methods, Method** new
   }
 }
 
+static inline uint method_holder_filter_bit(Klass* holder) {
+  uintptr_t addr = (uintptr_t)holder;
+  return (uint)((addr >> LogBytesPerWord) ^ (addr >> 12));
+}
+
+void ConstantPoolCache::record_method_holder(Klass* holder) {
+  uint bit = method_holder_filter_bit(holder) % (method_holder_filter_words * BitsPerWord);
+  volatile intptr_t* word = &_method_holder_filter[bit / BitsPerWord];
+  intptr_t mask = (intptr_t)1 << (bit % BitsPerWord);
+  while (true) {
+    intptr_t old_value = *word;
+    if ((old_value & mask) != 0 ||
+        Atomic::cmpxchg_ptr(old_value | mask, word, old_value) == old_value) {
+      return;
+    }
+  }
+}
+
+bool ConstantPoolCache::may_refer_to_methods_of(Klass* holder) const {
+  uint bit = method_holder_filter_bit(holder) % (method_holder_filter_words * BitsPerWord);
+  intptr_t mask = (intptr_t)1 << (bit % BitsPerWord);
+  return (_method_holder_filter[bit / BitsPerWord] & mask) != 0;
+}
+
 // the constant pool cache should never contain old or obsolete methods
 bool ConstantPoolCache::check_no_old_or_obsolete_entries() {
   for (int i = 1; i < length(); i++) {
@@ -405,6 +405,13 @@ class ConstantPoolCache: public MetaspaceObj {
  private:
   int             _length;
   ConstantPool*   _constant_pool;          // the corresponding constant pool
+#if INCLUDE_JVMTI
+  // A bloom filter of the holders of the methods the entries have been
+  // linked to. RedefineClasses skips the caches that cannot refer to
+  // methods of the redefined class.
+  enum { method_holder_filter_words = 2 };
+  volatile intptr_t _method_holder_filter[method_holder_filter_words];
+#endif // INCLUDE_JVMTI
 
   // Sizing
   debug_only(friend class ClassVerifier;)
@@ -416,6 +423,11 @@ class ConstantPoolCache: public MetaspaceObj {
                     const intStack& invokedynamic_references_map) :
                           _length(length),
                           _constant_pool(NULL) {
+#if INCLUDE_JVMTI
+    for (int i = 0; i < method_holder_filter_words; i++) {
+      _method_holder_filter[i] = 0;
+    }
+#endif // INCLUDE_JVMTI
     initialize(inverse_index_map, invokedynamic_inverse_index_map,
                invokedynamic_references_map);
     for (int i = 0; i < length; i++) {
@@ -479,6 +491,11 @@ class ConstantPoolCache: public MetaspaceObj {
   void adjust_method_entries(Method** old_methods, Method** new_methods,
                              int methods_length, bool * trace_name_printed);
   bool check_no_old_or_obsolete_entries();
+
+  // Must be called before an entry is linked to a method of holder.
+  void record_method_holder(Klass* holder);
+  // false if no entry can refer to a method of holder
+  bool may_refer_to_methods_of(Klass* holder) const;
   void dump_cache();
 #endif // INCLUDE_JVMTI
 
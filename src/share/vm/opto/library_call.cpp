@@ -234,6 +234,7 @@ class LibraryCallKit : public GraphKit {
   static bool klass_needs_init_guard(Node* kls);
   bool inline_unsafe_allocate();
   bool inline_unsafe_copyMemory();
+  bool inline_unsafe_copySwapMemory();
   bool inline_native_currentThread();
 #ifdef TRACE_HAVE_INTRINSICS
   bool inline_native_classID();
@@ -409,6 +410,10 @@ CallGenerator* Compile::make_vm_intrinsic(ciMethod* m, bool is_virtual) {
     if (StubRoutines::unsafe_arraycopy() == NULL)  return NULL;
     if (!InlineArrayCopy)  return NULL;
     break;
+  case vmIntrinsics::_copySwapMemory:
+    // The stub for the element size is checked when the call is inlined.
+    if (!InlineArrayCopy)  return NULL;
+    break;
   case vmIntrinsics::_hashCode:
     if (!InlineObjectHash)  return NULL;
     does_virtual_dispatch = true;
@@ -866,6 +871,7 @@ bool LibraryCallKit::try_to_inline(int predicate) {
   case vmIntrinsics::_nanoTime:                 return inline_native_time_funcs(CAST_FROM_FN_PTR(address, os::javaTimeNanos), "nanoTime");
   case vmIntrinsics::_allocateInstance:         return inline_unsafe_allocate();
   case vmIntrinsics::_copyMemory:               return inline_unsafe_copyMemory();
+  case vmIntrinsics::_copySwapMemory:           return inline_unsafe_copySwapMemory();
   case vmIntrinsics::_newArray:                 return inline_native_newArray();
   case vmIntrinsics::_getLength:                return inline_native_getLength();
   case vmIntrinsics::_copyOf:                   return inline_array_copyOf(false);
@@ -4398,6 +4404,65 @@ bool LibraryCallKit::inline_unsafe_copyMemory() {
   return true;
 }
 
+//----------------------inline_unsafe_copySwapMemory---------------------
+// public native void sun.misc.Unsafe.copySwapMemory(Object srcBase, long srcOffset, Object destBase, long destOffset, long bytes, long elemSize);
+bool LibraryCallKit::inline_unsafe_copySwapMemory() {
+  if (callee()->is_static())  return false;  // caller must have the capability!
+
+  // Only a constant element size selects a stub.
+  const TypeLong* elem_t = _gvn.type(argument(9))->isa_long();
+  if (elem_t == NULL || !elem_t->is_con())  return false;
+  jlong elem_size = elem_t->get_con();
+  if (elem_size != 2 && elem_size != 4 && elem_size != 8)  return false;
+  address stub = StubRoutines::swapcopy((size_t)elem_size);
+  if (stub == NULL)  return false;
+  if (too_many_traps(Deoptimization::Reason_intrinsic))  return false;
+
+  null_check_receiver();  // null-check receiver
+  if (stopped())  return true;
+
+  C->set_has_unsafe_access(true);  // Mark eventual nmethod as "unsafe".
+
+  Node* src_ptr =         argument(1);   // type: oop
+  Node* src_off = ConvL2X(argument(2));  // type: long
+  Node* dst_ptr =         argument(4);   // type: oop
+  Node* dst_off = ConvL2X(argument(5));  // type: long
+  Node* size    =         argument(7);   // type: long
+
+  // A negative size or one that is not a whole number of elements makes
+  // the native method throw; leave that to the interpreter.
+  Node* bits  = _gvn.transform(new (C) AndLNode(size, longcon(min_jlong | (elem_size - 1))));
+  Node* cmp   = _gvn.transform(new (C) CmpLNode(bits, longcon(0)));
+  Node* valid = _gvn.transform(new (C) BoolNode(cmp, BoolTest::eq));
+  { BuildCutout unless(this, valid, PROB_MAX);
+    uncommon_trap(Deoptimization::Reason_intrinsic,
+                  Deoptimization::Action_make_not_entrant);
+  }
+  if (stopped())  return true;
+
+  Node* count = ConvL2X(_gvn.transform(new (C) URShiftLNode(size, intcon(exact_log2_long(elem_size)))));
+
+  Node* src = make_unsafe_address(src_ptr, src_off);
+  Node* dst = make_unsafe_address(dst_ptr, dst_off);
+
+  // Conservatively insert a memory barrier on all memory slices.
+  // Do not let writes of the copy source or destination float below the copy.
+  insert_mem_bar(Op_MemBarCPUOrder);
+
+  // Call it.  The stub takes an element count.
+  make_runtime_call(RC_LEAF|RC_NO_FP,
+                    OptoRuntime::fast_arraycopy_Type(),
+                    stub,
+                    "swapcopy",
+                    TypeRawPtr::BOTTOM,
+                    src, dst, count XTOP);
+
+  // Do not let reads of the copy destination float above the copy.
+  insert_mem_bar(Op_MemBarCPUOrder);
+
+  return true;
+}
+
 //------------------------clone_coping-----------------------------------
 // Helper function for inline_native_clone.
 void LibraryCallKit::copy_to_clone(Node* obj, Node* alloc_obj, Node* obj_size, bool is_array, bool card_mark) {
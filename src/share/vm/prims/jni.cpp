@@ -4236,6 +4236,55 @@ JNI_ENTRY(void, jni_GetStringUTFRegion(JNIEnv *env, jstring string, jsize start,
 JNI_END
 
 
+// Enter a critical section on an array. If the heap supports pinning, only
+// the array is pinned, otherwise the GC_locker holds off GC until the
+// section is exited again.
+static oop lock_gc_or_pin_object(JavaThread* thread, jobject obj) {
+  if (Universe::heap()->supports_object_pinning()) {
+    oop o = JNIHandles::resolve_non_null(obj);
+    Universe::heap()->pin_object(thread, o);
+    return o;
+  } else {
+    GC_locker::lock_critical(thread);
+    return JNIHandles::resolve_non_null(obj);
+  }
+}
+
+static void unlock_gc_or_unpin_object(JavaThread* thread, jobject obj) {
+  if (Universe::heap()->supports_object_pinning()) {
+    Universe::heap()->unpin_object(thread, JNIHandles::resolve_non_null(obj));
+  } else {
+    GC_locker::unlock_critical(thread);
+  }
+}
+
+// Enter a critical section on the characters of a string and return its
+// value array. String deduplication may replace the value of the string
+// at any time, so the characters must be taken from the returned array,
+// which is the one that was pinned.
+static typeArrayOop lock_gc_or_pin_string_value(JavaThread* thread, jstring str) {
+  if (Universe::heap()->supports_object_pinning()) {
+    typeArrayOop value = java_lang_String::value(JNIHandles::resolve_non_null(str));
+    Universe::heap()->pin_object(thread, value);
+    return value;
+  } else {
+    GC_locker::lock_critical(thread);
+    return java_lang_String::value(JNIHandles::resolve_non_null(str));
+  }
+}
+
+// The pinned value array is recovered from the characters handed out by
+// jni_GetStringCritical rather than read from the string again.
+static void unlock_gc_or_unpin_string_value(JavaThread* thread, jstring str, const jchar* chars) {
+  if (Universe::heap()->supports_object_pinning()) {
+    int offset = java_lang_String::offset(JNIHandles::resolve_non_null(str));
+    address base = (address)(chars - offset);
+    Universe::heap()->unpin_object(thread, (oop)(base - arrayOopDesc::base_offset_in_bytes(T_CHAR)));
+  } else {
+    GC_locker::unlock_critical(thread);
+  }
+}
+
 JNI_ENTRY(void*, jni_GetPrimitiveArrayCritical(JNIEnv *env, jarray array, jboolean *isCopy))
   JNIWrapper("GetPrimitiveArrayCritical");
 #ifndef USDT2
@@ -4244,11 +4293,10 @@ JNI_ENTRY(void*, jni_GetPrimitiveArrayCritical(JNIEnv *env, jarray array, jboole
  HOTSPOT_JNI_GETPRIMITIVEARRAYCRITICAL_ENTRY(
                                              env, array, (uintptr_t *) isCopy);
 #endif /* USDT2 */
-  GC_locker::lock_critical(thread);
+  oop a = lock_gc_or_pin_object(thread, array);
   if (isCopy != NULL) {
     *isCopy = JNI_FALSE;
   }
-  oop a = JNIHandles::resolve_non_null(array);
   assert(a->is_array(), "just checking");
   BasicType type;
   if (a->is_objArray()) {
@@ -4275,8 +4323,8 @@ JNI_ENTRY(void, jni_ReleasePrimitiveArrayCritical(JNIEnv *env, jarray array, voi
   HOTSPOT_JNI_RELEASEPRIMITIVEARRAYCRITICAL_ENTRY(
                                                   env, array, carray, mode);
 #endif /* USDT2 */
-  // The array, carray and mode arguments are ignored
-  GC_locker::unlock_critical(thread);
+  // The carray and mode arguments are ignored
+  unlock_gc_or_unpin_object(thread, array);
 #ifndef USDT2
   DTRACE_PROBE(hotspot_jni, ReleasePrimitiveArrayCritical__return);
 #else /* USDT2 */
@@ -4294,20 +4342,13 @@ JNI_ENTRY(const jchar*, jni_GetStringCritical(JNIEnv *env, jstring string, jbool
   HOTSPOT_JNI_GETSTRINGCRITICAL_ENTRY(
                                       env, string, (uintptr_t *) isCopy);
 #endif /* USDT2 */
-  GC_locker::lock_critical(thread);
+  typeArrayOop s_value = lock_gc_or_pin_string_value(thread, string);
   if (isCopy != NULL) {
     *isCopy = JNI_FALSE;
   }
-  oop s = JNIHandles::resolve_non_null(string);
-  int s_len = java_lang_String::length(s);
-  typeArrayOop s_value = java_lang_String::value(s);
-  int s_offset = java_lang_String::offset(s);
-  const jchar* ret;
-  if (s_len > 0) {
-    ret = s_value->char_at_addr(s_offset);
-  } else {
-    ret = (jchar*) s_value->base(T_CHAR);
-  }
+  int s_offset = java_lang_String::offset(JNIHandles::resolve_non_null(string));
+  // Also for an empty string, ReleaseStringCritical finds the array from it
+  const jchar* ret = (jchar*) s_value->base(T_CHAR) + s_offset;
 #ifndef USDT2
   DTRACE_PROBE1(hotspot_jni, GetStringCritical__return, ret);
 #else /* USDT2 */
@@ -4326,8 +4367,7 @@ JNI_ENTRY(void, jni_ReleaseStringCritical(JNIEnv *env, jstring str, const jchar
   HOTSPOT_JNI_RELEASESTRINGCRITICAL_ENTRY(
                                           env, str, (uint16_t *) chars);
 #endif /* USDT2 */
-  // The str and chars arguments are ignored
-  GC_locker::unlock_critical(thread);
+  unlock_gc_or_unpin_string_value(thread, str, chars);
 #ifndef USDT2
   DTRACE_PROBE(hotspot_jni, ReleaseStringCritical__return);
 #else /* USDT2 */
@@ -5085,6 +5125,8 @@ void TestNewSize_test();
 void TestKlass_test();
 void Test_linked_list();
 void TestChunkedList_test();
+void TestBitMap_test();
+void TestCopySwap_test();
 #if INCLUDE_ALL_GCS
 void TestOldFreeSpaceCalculation_test();
 void TestG1BiasedArray_test();
@@ -5114,6 +5156,8 @@ void execute_internal_vm_tests() {
     run_unit_test(TestKlass_test());
     run_unit_test(Test_linked_list());
     run_unit_test(TestChunkedList_test());
+    run_unit_test(TestBitMap_test());
+    run_unit_test(TestCopySwap_test());
 #if INCLUDE_VM_STRUCTS
     run_unit_test(VMStructs::test());
 #endif
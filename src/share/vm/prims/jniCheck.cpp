@@ -1832,8 +1832,8 @@ JNI_ENTRY_CHECKED(void,
     IN_VM(
       checkString(thr, str);
     )
-    /* The Hotspot JNI code does not use the parameters, so just check the
-     * string parameter as a minor sanity check
+    /* The Hotspot JNI code only uses chars to find the pinned array, so
+     * just check the string parameter as a minor sanity check
      */
     UNCHECKED()->ReleaseStringCritical(env, str, chars);
     functionExit(env);
@@ -173,6 +173,7 @@ JvmtiEnvBase::JvmtiEnvBase(jint version) : _env_event_enable() {
   _version = version;
   _env_local_storage = NULL;
   _tag_map = NULL;
+  _heap_callbacks_thread_safe = false;
   _native_method_prefix_count = 0;
   _native_method_prefixes = NULL;
   _next = NULL;
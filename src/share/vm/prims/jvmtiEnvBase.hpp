@@ -98,6 +98,7 @@ class JvmtiEnvBase : public CHeapObj<mtInternal> {
   jvmtiEventCallbacks _event_callbacks;
   jvmtiExtEventCallbacks _ext_event_callbacks;
   JvmtiTagMap* _tag_map;
+  bool _heap_callbacks_thread_safe;   // set with an extension function
   JvmtiEnvEventEnable _env_event_enable;
   jvmtiCapabilities _current_capabilities;
   jvmtiCapabilities _prohibited_capabilities;
@@ -251,6 +252,16 @@ class JvmtiEnvBase : public CHeapObj<mtInternal> {
     return _tag_map;
   }
 
+  // true if the agent has declared that its heap iteration callbacks may be
+  // invoked by several threads at once
+  bool heap_callbacks_thread_safe() const {
+    return _heap_callbacks_thread_safe;
+  }
+
+  void set_heap_callbacks_thread_safe(bool thread_safe) {
+    _heap_callbacks_thread_safe = thread_safe;
+  }
+
 
   // return true if event is enabled globally or for any thread
   // True only if there is a callback for it.
@@ -42,9 +42,19 @@ static jvmtiError JNICALL IsClassUnloadingEnabled(const jvmtiEnv* env, jboolean*
   return JVMTI_ERROR_NONE;
 }
 
+// extension function
+static jvmtiError JNICALL SetHeapCallbacksThreadSafe(const jvmtiEnv* env, jboolean thread_safe, ...) {
+  JvmtiEnv* jvmti_env = JvmtiEnv::JvmtiEnv_from_jvmti_env((jvmtiEnv*)env);
+  jvmti_env->set_heap_callbacks_thread_safe(thread_safe == JNI_TRUE);
+  return JVMTI_ERROR_NONE;
+}
+
 // register extension functions and events. In this implementation we
-// have a single extension function (to prove the API) that tests if class
-// unloading is enabled or disabled. We also have a single extension event
+// have an extension function (to prove the API) that tests if class
+// unloading is enabled or disabled, and one with which an agent declares
+// that its heap iteration callbacks are thread safe, which allows
+// IterateThroughHeap to invoke them from the GC worker threads in parallel.
+// We also have a single extension event
 // EXT_EVENT_CLASS_UNLOAD which is used to provide the JVMDI_EVENT_CLASS_UNLOAD
 // event. The function and the event are registered here.
 //
@@ -67,6 +77,20 @@ void JvmtiExtensions::register_extensions() {
   };
   _ext_functions->append(&ext_func);
 
+  static jvmtiParamInfo thread_safe_params[] = {
+    { (char*)"ThreadSafe", JVMTI_KIND_IN, JVMTI_TYPE_JBOOLEAN, JNI_FALSE }
+  };
+  static jvmtiExtensionFunctionInfo thread_safe_func = {
+    (jvmtiExtensionFunction)SetHeapCallbacksThreadSafe,
+    (char*)"com.sun.hotspot.functions.SetHeapCallbacksThreadSafe",
+    (char*)"Declare the heap iteration callbacks as thread safe",
+    sizeof(thread_safe_params)/sizeof(thread_safe_params[0]),
+    thread_safe_params,
+    0,              // no non-universal errors
+    NULL
+  };
+  _ext_functions->append(&thread_safe_func);
+
   // register our extension event
 
   static jvmtiParamInfo event_params[] = {
@@ -39,9 +39,15 @@
 #include "prims/jvmtiImpl.hpp"
 #include "prims/jvmtiRedefineClasses.hpp"
 #include "prims/methodComparator.hpp"
+#include "runtime/atomic.inline.hpp"
 #include "runtime/deoptimization.hpp"
 #include "runtime/relocator.hpp"
 #include "utilities/bitMap.inline.hpp"
+#include "utilities/macros.hpp"
+#if INCLUDE_ALL_GCS
+#include "gc_implementation/parallelScavenge/gcTaskManager.hpp"
+#include "gc_implementation/parallelScavenge/parallelScavengeHeap.hpp"
+#endif // INCLUDE_ALL_GCS
 
 PRAGMA_FORMAT_MUTE_WARNINGS_FOR_GCC
 
@@ -3366,14 +3372,15 @@ void VM_RedefineClasses::AdjustCpoolCacheAndVtable::do_klass(Klass* k) {
     // holds the Method*s for virtual (but not final) methods.
     // Default methods, or concrete methods in interfaces are stored
     // in the vtable, so if an interface changes we need to check
-    // adjust_method_entries() for every InstanceKlass, which will also
-    // adjust the default method vtable indices.
+    // adjust_method_entries() for every InstanceKlass implementing it,
+    // which will also adjust the default method vtable indices. Every
+    // method in a vtable is declared by the class or one of its
+    // supertypes, so is_subtype_of() covers both cases.
     // We also need to adjust any default method entries that are
     // not yet in the vtable, because the vtable setup is in progress.
     // This must be done after we adjust the default_methods and
     // default_vtable_indices for methods already in the vtable.
-    if (ik->vtable_length() > 0 && (_the_class_oop->is_interface()
-        || ik->is_subtype_of(_the_class_oop))) {
+    if (ik->vtable_length() > 0 && ik->is_subtype_of(_the_class_oop)) {
       // ik->vtable() creates a wrapper object; rm cleans it up
       ResourceMark rm(_thread);
       ik->vtable()->adjust_method_entries(_matching_old_methods,
@@ -3386,14 +3393,11 @@ void VM_RedefineClasses::AdjustCpoolCacheAndVtable::do_klass(Klass* k) {
                                  &trace_name_printed);
     }
 
-    // If the current class has an itable and we are either redefining an
-    // interface or if the current class is a subclass of the_class, then
-    // we potentially have to fix the itable. If we are redefining an
-    // interface, then we have to call adjust_method_entries() for
-    // every InstanceKlass that has an itable since there isn't a
-    // subclass relationship between an interface and an InstanceKlass.
-    if (ik->itable_length() > 0 && (_the_class_oop->is_interface()
-        || ik->is_subclass_of(_the_class_oop))) {
+    // If the current class has an itable and is a subtype of the_class,
+    // either a subclass or an implementor of a redefined interface, then
+    // we potentially have to fix the itable. Like the vtable, the itable
+    // only holds methods declared by the class or its supertypes.
+    if (ik->itable_length() > 0 && ik->is_subtype_of(_the_class_oop)) {
       // ik->itable() creates a wrapper object; rm cleans it up
       ResourceMark rm(_thread);
       ik->itable()->adjust_method_entries(_matching_old_methods,
@@ -3407,7 +3411,9 @@ void VM_RedefineClasses::AdjustCpoolCacheAndVtable::do_klass(Klass* k) {
     // other_cp's cache. If other_cp has a previous version, then we
     // have to repeat the process for each previous version. The
     // constant pool cache holds the Method*s for non-virtual
-    // methods and for virtual, final methods.
+    // methods and for virtual, final methods. Each cache records the
+    // holders of the methods it has been linked to, so the caches
+    // that cannot refer to the_class are skipped without a scan.
     //
     // Special case: if the current class is the_class, then new_cp
     // has already been attached to the_class and old_cp has already
@@ -3422,7 +3428,7 @@ void VM_RedefineClasses::AdjustCpoolCacheAndVtable::do_klass(Klass* k) {
       // this klass' constant pool cache may need adjustment
       other_cp = constantPoolHandle(ik->constants());
       cp_cache = other_cp->cache();
-      if (cp_cache != NULL) {
+      if (cp_cache != NULL && cp_cache->may_refer_to_methods_of(_the_class_oop)) {
         cp_cache->adjust_method_entries(_matching_old_methods,
                                         _matching_new_methods,
                                         _matching_methods_length,
@@ -3436,7 +3442,7 @@ void VM_RedefineClasses::AdjustCpoolCacheAndVtable::do_klass(Klass* k) {
          pv_node != NULL; pv_node = pvw.next_previous_version()) {
       other_cp = pv_node->prev_constant_pool();
       cp_cache = other_cp->cache();
-      if (cp_cache != NULL) {
+      if (cp_cache != NULL && cp_cache->may_refer_to_methods_of(_the_class_oop)) {
         cp_cache->adjust_method_entries(_matching_old_methods,
                                         _matching_new_methods,
                                         _matching_methods_length,
@@ -3446,6 +3452,92 @@ void VM_RedefineClasses::AdjustCpoolCacheAndVtable::do_klass(Klass* k) {
   }
 }
 
+// Collects all loaded classes for AdjustCpoolCacheAndVtableTask
+class CollectKlassesClosure : public KlassClosure {
+ private:
+  GrowableArray<Klass*>* _klasses;
+ public:
+  CollectKlassesClosure(GrowableArray<Klass*>* klasses) : _klasses(klasses) {}
+  void do_klass(Klass* k) { _klasses->append(k); }
+};
+
+void VM_RedefineClasses::AdjustCpoolCacheAndVtableTask::do_work() {
+  AdjustCpoolCacheAndVtable adjust(Thread::current());
+  while (true) {
+    int start = Atomic::add(chunk_size, &_claimed) - chunk_size;
+    if (start >= _klasses->length()) {
+      return;
+    }
+    int end = MIN2(start + (int)chunk_size, _klasses->length());
+    for (int i = start; i < end; i++) {
+      adjust.do_klass(_klasses->at(i));
+    }
+  }
+}
+
+#if INCLUDE_ALL_GCS
+// The Parallel collector runs its workers through the GCTaskManager
+class AdjustCpoolCacheAndVtableGCTask : public GCTask {
+ private:
+  VM_RedefineClasses::AdjustCpoolCacheAndVtableTask* _task;
+
+ public:
+  AdjustCpoolCacheAndVtableGCTask(VM_RedefineClasses::AdjustCpoolCacheAndVtableTask* task) :
+    _task(task) {}
+
+  virtual char* name() { return (char *)"adjust-cpool-cache-and-vtable-task"; }
+  virtual void do_it(GCTaskManager* manager, uint which) { _task->do_work(); }
+};
+#endif // INCLUDE_ALL_GCS
+
+// Every loaded class is checked. With many classes loaded, and GC worker
+// threads available, the classes are collected first and the workers
+// check them in parallel.
+void VM_RedefineClasses::adjust_cpool_cache_and_vtable(Thread* thread) {
+  CollectedHeap* heap = Universe::heap();
+  FlexibleWorkGang* workers = NULL;
+  if (heap->kind() == CollectedHeap::GenCollectedHeap ||
+      heap->kind() == CollectedHeap::G1CollectedHeap) {
+    workers = ((SharedHeap*)heap)->workers();
+  }
+#if INCLUDE_ALL_GCS
+  GCTaskManager* manager = NULL;
+  if (heap->kind() == CollectedHeap::ParallelScavengeHeap) {
+    manager = ParallelScavengeHeap::gc_task_manager();
+  }
+  bool parallel = (workers != NULL && workers->active_workers() > 1) ||
+                  (manager != NULL && manager->active_workers() > 1);
+#else
+  bool parallel = workers != NULL && workers->active_workers() > 1;
+#endif // INCLUDE_ALL_GCS
+
+  if (parallel) {
+    ResourceMark rm(thread);
+    GrowableArray<Klass*>* klasses = new GrowableArray<Klass*>(4 * parallel_adjust_threshold);
+    CollectKlassesClosure collect(klasses);
+    ClassLoaderDataGraph::classes_do(&collect);
+    if (klasses->length() >= parallel_adjust_threshold) {
+      AdjustCpoolCacheAndVtableTask task(klasses);
+      if (workers != NULL) {
+        workers->run_task(&task);
+      }
+#if INCLUDE_ALL_GCS
+      if (manager != NULL) {
+        GCTaskQueue* q = GCTaskQueue::create();
+        for (uint i = 0; i < manager->active_workers(); i++) {
+          q->enqueue(new AdjustCpoolCacheAndVtableGCTask(&task));
+        }
+        manager->execute_and_wait(q);
+      }
+#endif // INCLUDE_ALL_GCS
+      return;
+    }
+  }
+
+  AdjustCpoolCacheAndVtable adjust_cpool_cache_and_vtable(thread);
+  ClassLoaderDataGraph::classes_do(&adjust_cpool_cache_and_vtable);
+}
+
 void VM_RedefineClasses::update_jmethod_ids() {
   for (int j = 0; j < _matching_methods_length; ++j) {
     Method* old_method = _matching_old_methods[j];
@@ -4067,8 +4159,7 @@ void VM_RedefineClasses::redefine_single_class(jclass the_jclass,
 
   // Adjust constantpool caches and vtables for all classes
   // that reference methods of the evolved class.
-  AdjustCpoolCacheAndVtable adjust_cpool_cache_and_vtable(THREAD);
-  ClassLoaderDataGraph::classes_do(&adjust_cpool_cache_and_vtable);
+  adjust_cpool_cache_and_vtable(THREAD);
 
   // JSR-292 support
   MemberNameTable* mnt = the_class->member_names();
@@ -32,6 +32,7 @@
 #include "oops/objArrayOop.hpp"
 #include "prims/jvmtiRedefineClassesTrace.hpp"
 #include "runtime/vm_operations.hpp"
+#include "utilities/workgroup.hpp"
 
 // Introduction:
 //
@@ -516,7 +517,27 @@ class VM_RedefineClasses: public VM_Operation {
     void do_klass(Klass* k);
   };
 
+  // minimum number of loaded classes to adjust them in parallel
+  enum { parallel_adjust_threshold = 4096 };
+
+  void adjust_cpool_cache_and_vtable(Thread* thread);
+
  public:
+  // Applies AdjustCpoolCacheAndVtable to a list of classes with the GC
+  // worker threads, which claim chunks of the list.
+  class AdjustCpoolCacheAndVtableTask : public AbstractGangTask {
+    enum { chunk_size = 64 };
+    GrowableArray<Klass*>* _klasses;
+    volatile jint _claimed;
+   public:
+    AdjustCpoolCacheAndVtableTask(GrowableArray<Klass*>* klasses) :
+      AbstractGangTask("Adjust cpool cache and vtable"),
+      _klasses(klasses),
+      _claimed(0) {}
+    void do_work();
+    void work(uint worker_id) { do_work(); }
+  };
+
   VM_RedefineClasses(jint class_count,
                      const jvmtiClassDefinition *class_defs,
                      JvmtiClassLoadKind class_load_kind);
@@ -46,7 +46,9 @@
 #include "runtime/vm_operations.hpp"
 #include "services/serviceUtil.hpp"
 #include "utilities/macros.hpp"
+#include "utilities/workgroup.hpp"
 #if INCLUDE_ALL_GCS
+#include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
 #include "gc_implementation/parallelScavenge/parallelScavengeHeap.hpp"
 #endif // INCLUDE_ALL_GCS
 
@@ -106,10 +108,17 @@ class JvmtiTagHashmapEntry : public CHeapObj<mtInternal> {
 // A hashmap provides functions for adding, removing, and finding
 // entries. It also provides a function to iterate over all entries
 // in the hashmap.
+//
+// While a hashmap is concurrent it may be used by several threads at
+// once, for example by the GC worker threads during a parallel heap
+// iteration. Each chain is then guarded by one of a fixed number of
+// spin locks and resizing is deferred until the hashmap is no longer
+// concurrent.
 
 class JvmtiTagHashmap : public CHeapObj<mtInternal> {
  private:
   friend class JvmtiTagMap;
+  friend class JvmtiTagHashmapRebuildTask;
 
   enum {
     small_trace_threshold  = 10000,                  // threshold for tracing
@@ -118,6 +127,10 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
     initial_trace_threshold = small_trace_threshold
   };
 
+  enum {
+    lock_stripes = 64                                // number of chain locks
+  };
+
   static int _sizes[];                  // array of possible hashmap sizes
   int _size;                            // actual size of the table
   int _size_index;                      // index into size table
@@ -132,6 +145,9 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
 
   JvmtiTagHashmapEntry** _table;        // the table of entries.
 
+  bool _concurrent;                     // used by several threads at once
+  volatile int _stripe_locks[lock_stripes];
+
   // private accessors
   int resize_threshold() const                  { return _resize_threshold; }
   int trace_threshold() const                   { return _trace_threshold; }
@@ -150,6 +166,10 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
     _load_factor = load_factor;
     _resize_threshold = (int)(_load_factor * _size);
     _resizing_enabled = true;
+    _concurrent = false;
+    for (int i = 0; i < lock_stripes; i++) {
+      _stripe_locks[i] = 0;
+    }
     size_t s = initial_size * sizeof(JvmtiTagHashmapEntry*);
     _table = (JvmtiTagHashmapEntry**)os::malloc(s, mtInternal);
     if (_table == NULL) {
@@ -178,6 +198,24 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
     return hash(key, _size);
   }
 
+  // Locks the chain at the given position if the hashmap is concurrent
+  class ChainLocker : public StackObj {
+   private:
+    volatile int* _lock;
+   public:
+    ChainLocker(JvmtiTagHashmap* hashmap, unsigned int pos) : _lock(NULL) {
+      if (hashmap->is_concurrent()) {
+        _lock = &hashmap->_stripe_locks[pos % lock_stripes];
+        Thread::SpinAcquire(_lock, "JvmtiTagHashmap chain");
+      }
+    }
+    ~ChainLocker() {
+      if (_lock != NULL) {
+        Thread::SpinRelease(_lock);
+      }
+    }
+  };
+
   // resize the hashmap - allocates a large table and re-hashes
   // all entries into the new table.
   void resize() {
@@ -244,7 +282,11 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
       prev->set_next(entry->next());
     }
     assert(_entry_count > 0, "checking");
-    _entry_count--;
+    if (is_concurrent()) {
+      Atomic::dec(&_entry_count);
+    } else {
+      _entry_count--;
+    }
   }
 
   // resizing switch
@@ -295,10 +337,28 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
   int size() const                              { return _size; }
   JvmtiTagHashmapEntry** table() const          { return _table; }
   int entry_count() const                       { return _entry_count; }
+  bool is_concurrent() const                    { return _concurrent; }
+
+  // Switch the hashmap to or from concurrent use. Must be called when no
+  // other thread uses the hashmap, and grows it if it was filled up while
+  // resizing was deferred.
+  void set_concurrent(bool concurrent) {
+    _concurrent = concurrent;
+    if (!concurrent) {
+      while (entry_count() > resize_threshold() && is_resizing_enabled()) {
+        int old_size = _size;
+        resize();
+        if (_size == old_size) {
+          break;
+        }
+      }
+    }
+  }
 
   // find an entry in the hashmap, returns NULL if not found.
   inline JvmtiTagHashmapEntry* find(oop key) {
     unsigned int h = hash(key);
+    ChainLocker cl(this, h);
     JvmtiTagHashmapEntry* entry = _table[h];
     while (entry != NULL) {
       if (entry->object() == key) {
@@ -309,19 +369,40 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
     return NULL;
   }
 
+  // returns the tag of the given key, or 0 if it is not tagged
+  inline jlong find_tag(oop key) {
+    unsigned int h = hash(key);
+    ChainLocker cl(this, h);
+    for (JvmtiTagHashmapEntry* entry = _table[h]; entry != NULL; entry = entry->next()) {
+      if (entry->object() == key) {
+        return entry->tag();
+      }
+    }
+    return 0;
+  }
+
 
   // add a new entry to hashmap
   inline void add(oop key, JvmtiTagHashmapEntry* entry) {
     assert(key != NULL, "checking");
     assert(find(key) == NULL, "duplicate detected");
     unsigned int h = hash(key);
-    JvmtiTagHashmapEntry* anchor = _table[h];
-    if (anchor == NULL) {
-      _table[h] = entry;
-      entry->set_next(NULL);
-    } else {
-      entry->set_next(anchor);
-      _table[h] = entry;
+    {
+      ChainLocker cl(this, h);
+      JvmtiTagHashmapEntry* anchor = _table[h];
+      if (anchor == NULL) {
+        _table[h] = entry;
+        entry->set_next(NULL);
+      } else {
+        entry->set_next(anchor);
+        _table[h] = entry;
+      }
+    }
+
+    if (is_concurrent()) {
+      // tracing and resizing wait until the hashmap is no longer concurrent
+      Atomic::inc(&_entry_count);
+      return;
     }
 
     _entry_count++;
@@ -340,6 +421,7 @@ class JvmtiTagHashmap : public CHeapObj<mtInternal> {
   // remove an entry with the given key.
   inline JvmtiTagHashmapEntry* remove(oop key) {
     unsigned int h = hash(key);
+    ChainLocker cl(this, h);
     JvmtiTagHashmapEntry* entry = _table[h];
     JvmtiTagHashmapEntry* prev = NULL;
     while (entry != NULL) {
@@ -468,9 +550,11 @@ JvmtiTagMap::~JvmtiTagMap() {
 // - if there's an entry on the (per-environment) free list then this
 // is returned. Otherwise an new entry is allocated.
 JvmtiTagHashmapEntry* JvmtiTagMap::create_entry(oop ref, jlong tag) {
-  assert(Thread::current()->is_VM_thread() || is_locked(), "checking");
+  assert(Thread::current()->is_VM_thread() || is_locked() ||
+         _hashmap->is_concurrent(), "checking");
   JvmtiTagHashmapEntry* entry;
-  if (_free_entries == NULL) {
+  // the free list is not used while the hashmap is concurrent
+  if (_free_entries == NULL || _hashmap->is_concurrent()) {
     entry = new JvmtiTagHashmapEntry(ref, tag);
   } else {
     assert(_free_entries_count > 0, "mismatched _free_entries_count");
@@ -486,7 +570,7 @@ JvmtiTagHashmapEntry* JvmtiTagMap::create_entry(oop ref, jlong tag) {
 void JvmtiTagMap::destroy_entry(JvmtiTagHashmapEntry* entry) {
   assert(SafepointSynchronize::is_at_safepoint() || is_locked(), "checking");
   // limit the size of the free list
-  if (_free_entries_count >= max_free_entries) {
+  if (_free_entries_count >= max_free_entries || _hashmap->is_concurrent()) {
     delete entry;
   } else {
     entry->set_next(_free_entries);
@@ -527,12 +611,7 @@ bool JvmtiTagMap::is_empty() {
 // not tagged
 //
 static inline jlong tag_for(JvmtiTagMap* tag_map, oop o) {
-  JvmtiTagHashmapEntry* entry = tag_map->hashmap()->find(o);
-  if (entry == NULL) {
-    return 0;
-  } else {
-    return entry->tag();
-  }
+  return tag_map->hashmap()->find_tag(o);
 }
 
 
@@ -568,7 +647,8 @@ class CallbackWrapper : public StackObj {
                                        JvmtiTagHashmapEntry* entry, jlong obj_tag);
  public:
   CallbackWrapper(JvmtiTagMap* tag_map, oop o) {
-    assert(Thread::current()->is_VM_thread() || tag_map->is_locked(),
+    assert(Thread::current()->is_VM_thread() || tag_map->is_locked() ||
+           tag_map->hashmap()->is_concurrent(),
            "MT unsafe or must be VM thread");
 
     // object to tag
@@ -611,7 +691,8 @@ void inline CallbackWrapper::post_callback_tag_update(oop o,
   if (entry == NULL) {
     if (obj_tag != 0) {
       // callback has tagged the object
-      assert(Thread::current()->is_VM_thread(), "must be VMThread");
+      assert(Thread::current()->is_VM_thread() || hashmap->is_concurrent(),
+             "must be VMThread");
       entry = tag_map()->create_entry(o, obj_tag);
       hashmap->add(o, entry);
     }
@@ -882,6 +963,7 @@ class JvmtiCachedClassFieldMap : public CHeapObj<mtInternal> {
   ~JvmtiCachedClassFieldMap();
 
   static GrowableArray<InstanceKlass*>* _class_list;
+  static volatile int _cache_lock;      // taken by GC workers iterating in parallel
   static void add_to_class_list(InstanceKlass* ik);
 
  public:
@@ -898,6 +980,7 @@ class JvmtiCachedClassFieldMap : public CHeapObj<mtInternal> {
 };
 
 GrowableArray<InstanceKlass*>* JvmtiCachedClassFieldMap::_class_list;
+volatile int JvmtiCachedClassFieldMap::_cache_lock = 0;
 
 JvmtiCachedClassFieldMap::JvmtiCachedClassFieldMap(ClassFieldMap* field_map) {
   _field_map = field_map;
@@ -943,24 +1026,28 @@ void JvmtiCachedClassFieldMap::add_to_class_list(InstanceKlass* ik) {
 // returns the instance field map for the given object
 // (returns field map cached by the InstanceKlass if possible)
 ClassFieldMap* JvmtiCachedClassFieldMap::get_map_of_instance_fields(oop obj) {
-  assert(Thread::current()->is_VM_thread(), "must be VMThread");
+  assert(Thread::current()->is_VM_thread() ||
+         SafepointSynchronize::is_at_safepoint(), "must be VMThread or GC worker");
   assert(ClassFieldMapCacheMark::is_active(), "ClassFieldMapCacheMark not active");
 
   Klass* k = obj->klass();
   InstanceKlass* ik = InstanceKlass::cast(k);
 
+  Thread::SpinAcquire(&_cache_lock, "JvmtiCachedClassFieldMap");
   // return cached map if possible
   JvmtiCachedClassFieldMap* cached_map = ik->jvmti_cached_class_field_map();
+  ClassFieldMap* field_map;
   if (cached_map != NULL) {
     assert(cached_map->field_map() != NULL, "missing field list");
-    return cached_map->field_map();
+    field_map = cached_map->field_map();
   } else {
-    ClassFieldMap* field_map = ClassFieldMap::create_map_of_instance_fields(obj);
+    field_map = ClassFieldMap::create_map_of_instance_fields(obj);
     cached_map = new JvmtiCachedClassFieldMap(field_map);
     ik->set_jvmti_cached_class_field_map(cached_map);
     add_to_class_list(ik);
-    return field_map;
   }
+  Thread::SpinRelease(&_cache_lock);
+  return field_map;
 }
 
 // remove the fields maps cached from all instanceKlasses
@@ -1213,13 +1300,73 @@ static jint invoke_primitive_field_callback_for_instance_fields(
 }
 
 
+#if INCLUDE_ALL_GCS
+// Applies an ObjectClosure to the objects of the G1 heap with the GC
+// worker threads, each claiming chunks of regions.
+class G1ParHeapIterateTask : public AbstractGangTask {
+ private:
+  class IterateRegionClosure : public HeapRegionClosure {
+   private:
+    ObjectClosure* _cl;
+   public:
+    IterateRegionClosure(ObjectClosure* cl) : _cl(cl) {}
+    bool doHeapRegion(HeapRegion* r) {
+      if (!r->continuesHumongous()) {
+        r->object_iterate(_cl);
+      }
+      return false;
+    }
+  };
+
+  ObjectClosure* _cl;
+
+ public:
+  G1ParHeapIterateTask(ObjectClosure* cl) :
+    AbstractGangTask("JVMTI heap iteration"), _cl(cl) {}
+
+  void work(uint worker_id) {
+    ResourceMark rm;
+    HandleMark hm;
+    G1CollectedHeap* g1h = G1CollectedHeap::heap();
+    IterateRegionClosure blk(_cl);
+    g1h->heap_region_par_iterate_chunked(&blk, worker_id,
+                                         g1h->workers()->active_workers(),
+                                         HeapRegion::JvmtiHeapIterClaimValue);
+  }
+};
+#endif // INCLUDE_ALL_GCS
+
 // VM operation to iterate over all objects in the heap (both reachable
-// and unreachable)
+// and unreachable). If the agent has declared its callbacks thread safe
+// the GC worker threads iterate over the heap in parallel, with the tag
+// map in concurrent mode. This is currently supported for G1.
 class VM_HeapIterateOperation: public VM_Operation {
  private:
   ObjectClosure* _blk;
+  JvmtiTagMap* _tag_map;
+  bool _parallel;
+
+  // returns the gang iterating over the heap in parallel, or NULL
+  FlexibleWorkGang* parallel_workers() {
+#if INCLUDE_ALL_GCS
+    if (_parallel && UseG1GC) {
+      FlexibleWorkGang* workers = G1CollectedHeap::heap()->workers();
+      if (workers != NULL && workers->active_workers() > 1) {
+        return workers;
+      }
+    }
+#endif // INCLUDE_ALL_GCS
+    return NULL;
+  }
+
  public:
-  VM_HeapIterateOperation(ObjectClosure* blk) { _blk = blk; }
+  VM_HeapIterateOperation(ObjectClosure* blk,
+                          JvmtiTagMap* tag_map = NULL,
+                          bool parallel = false) {
+    _blk = blk;
+    _tag_map = tag_map;
+    _parallel = parallel;
+  }
 
   VMOp_Type type() const { return VMOp_HeapIterateOperation; }
   void doit() {
@@ -1235,6 +1382,21 @@ class VM_HeapIterateOperation: public VM_Operation {
       Universe::verify();
     }
 
+#if INCLUDE_ALL_GCS
+    FlexibleWorkGang* workers = parallel_workers();
+    if (workers != NULL) {
+      G1CollectedHeap* g1h = G1CollectedHeap::heap();
+      assert(g1h->check_heap_region_claim_values(HeapRegion::InitialClaimValue),
+             "sanity check");
+      G1ParHeapIterateTask task(_blk);
+      _tag_map->hashmap()->set_concurrent(true);
+      workers->run_task(&task);
+      _tag_map->hashmap()->set_concurrent(false);
+      g1h->reset_heap_region_claim_values();
+      return;
+    }
+#endif // INCLUDE_ALL_GCS
+
     // do the iteration
     // If this operation encounters a bad object when using CMS,
     // consider using safe_object_iterate() which avoids perm gen
@@ -1336,7 +1498,7 @@ class IterateThroughHeapObjectClosure: public ObjectClosure {
   const void* user_data() const                    { return _user_data; }
 
   // indicates if the iteration has been aborted
-  bool _iteration_aborted;
+  volatile bool _iteration_aborted;
   bool is_iteration_aborted() const                { return _iteration_aborted; }
 
   // used to check the visit control flags. If the abort flag is set
@@ -1475,7 +1637,8 @@ void JvmtiTagMap::iterate_through_heap(jint heap_filter,
                                       heap_filter,
                                       callbacks,
                                       user_data);
-  VM_HeapIterateOperation op(&blk);
+  VM_HeapIterateOperation op(&blk, this,
+                             ((JvmtiEnvBase*)env())->heap_callbacks_thread_safe());
   VMThread::execute(&op);
 }
 
@@ -3277,11 +3440,95 @@ void JvmtiTagMap::weak_oops_do(BoolObjectClosure* is_alive, OopClosure* f) {
   }
 }
 
+// Rebuilds the hashmap after do_weak_oops_par has cleared the entries of the
+// dead objects and updated the others: the cleared entries are freed and the
+// others are rehashed at the address their object may have been moved to.
+// GC workers claim chunks of the old table and push the entries onto the
+// chains of the new table with a CAS.
+class JvmtiTagHashmapRebuildTask : public AbstractGangTask {
+ private:
+  enum {
+    chunk_size = 1024                   // table positions claimed at once
+  };
+
+  JvmtiTagHashmapEntry** _old_table;
+  JvmtiTagHashmapEntry** _new_table;
+  int _size;
+  volatile jint _claimed;
+  volatile jint _freed;
+
+ public:
+  JvmtiTagHashmapRebuildTask(JvmtiTagHashmapEntry** old_table,
+                             JvmtiTagHashmapEntry** new_table,
+                             int size) :
+    AbstractGangTask("JVMTI tag map rebuild"),
+    _old_table(old_table),
+    _new_table(new_table),
+    _size(size),
+    _claimed(0),
+    _freed(0) {}
+
+  jint freed() const { return _freed; }
+
+  void work(uint worker_id) {
+    jint freed = 0;
+    while (true) {
+      int start = Atomic::add(chunk_size, &_claimed) - chunk_size;
+      if (start >= _size) {
+        break;
+      }
+      int end = MIN2(start + (int)chunk_size, _size);
+      for (int pos = start; pos < end; pos++) {
+        JvmtiTagHashmapEntry* entry = _old_table[pos];
+        while (entry != NULL) {
+          JvmtiTagHashmapEntry* next = entry->next();
+          if (entry->object() == NULL) {
+            delete entry;
+            freed++;
+          } else {
+            unsigned int h = JvmtiTagHashmap::hash(entry->object(), _size);
+            JvmtiTagHashmapEntry* anchor;
+            do {
+              anchor = _new_table[h];
+              entry->set_next(anchor);
+            } while (Atomic::cmpxchg_ptr(entry, &_new_table[h], anchor) != anchor);
+          }
+          entry = next;
+        }
+      }
+    }
+    Atomic::add(freed, &_freed);
+  }
+};
+
+// returns the GC workers that may process the weak oops of large tag maps
+static FlexibleWorkGang* weak_oops_workers() {
+  CollectedHeap* heap = Universe::heap();
+  if (Thread::current()->is_VM_thread() &&
+      (heap->kind() == CollectedHeap::GenCollectedHeap ||
+       heap->kind() == CollectedHeap::G1CollectedHeap)) {
+    FlexibleWorkGang* workers = ((SharedHeap*)heap)->workers();
+    if (workers != NULL && workers->active_workers() > 1) {
+      return workers;
+    }
+  }
+  return NULL;
+}
+
 void JvmtiTagMap::do_weak_oops(BoolObjectClosure* is_alive, OopClosure* f) {
 
   // does this environment have the OBJECT_FREE event enabled
   bool post_object_free = env()->is_enabled(JVMTI_EVENT_OBJECT_FREE);
 
+  // large tag maps are rebuilt by the GC workers
+  if (hashmap()->entry_count() >= parallel_weak_oops_threshold) {
+    FlexibleWorkGang* workers = weak_oops_workers();
+    if (workers != NULL) {
+      do_weak_oops_par(is_alive, f, workers, post_object_free);
+      return;
+    }
+  }
+
   // counters used for trace message
   int freed = 0;
   int moved = 0;
@@ -3380,3 +3627,57 @@ void JvmtiTagMap::do_weak_oops(BoolObjectClosure* is_alive, OopClosure* f) {
         pre_total, post_total, freed, moved);
   }
 }
+
+// The GC supplied closures are not necessarily MT safe, so they are applied
+// to the entries serially; the entries of dead objects are cleared. The
+// GC workers then free the cleared entries and rehash the others in parallel.
+void JvmtiTagMap::do_weak_oops_par(BoolObjectClosure* is_alive, OopClosure* f,
+                                   FlexibleWorkGang* workers, bool post_object_free) {
+  JvmtiTagHashmap* hashmap = this->hashmap();
+  hashmap->set_resizing_enabled(true);
+
+  int moved = 0;
+  JvmtiTagHashmapEntry** table = hashmap->table();
+  int size = hashmap->size();
+  for (int pos = 0; pos < size; ++pos) {
+    for (JvmtiTagHashmapEntry* entry = table[pos]; entry != NULL; entry = entry->next()) {
+      if (!is_alive->do_object_b(entry->object())) {
+        jlong tag = entry->tag();
+        guarantee(tag != 0, "checking");
+        entry->_object = NULL;
+        if (post_object_free) {
+          JvmtiExport::post_object_free(env(), tag);
+        }
+      } else {
+        oop old_oop = entry->object();
+        f->do_oop(entry->object_addr());
+        if (entry->object() != old_oop) {
+          moved++;
+        }
+      }
+    }
+  }
+
+  size_t s = size * sizeof(JvmtiTagHashmapEntry*);
+  JvmtiTagHashmapEntry** new_table = (JvmtiTagHashmapEntry**)os::malloc(s, mtInternal);
+  if (new_table == NULL) {
+    vm_exit_out_of_memory(s, OOM_MALLOC_ERROR,
+      "unable to allocate hashtable for jvmti object tags");
+  }
+  memset(new_table, 0, s);
+
+  JvmtiTagHashmapRebuildTask task(table, new_table, size);
+  workers->run_task(&task);
+
+  os::free((void*)table);
+  hashmap->_table = new_table;
+  hashmap->_entry_count -= task.freed();
+
+  if (TraceJVMTIObjectTagging) {
+    int post_total = hashmap->_entry_count;
+    int pre_total = post_total + task.freed();
+
+    tty->print_cr("(%d->%d, %d freed, %d total moves, parallel)",
+        pre_total, post_total, task.freed(), moved);
+  }
+}
@@ -38,12 +38,15 @@
 class JvmtiTagHashmap;
 class JvmtiTagHashmapEntry;
 class JvmtiTagHashmapEntryClosure;
+class FlexibleWorkGang;
 
 class JvmtiTagMap :  public CHeapObj<mtInternal> {
  private:
 
   enum{
-    max_free_entries = 4096         // maximum number of free entries per env
+    max_free_entries = 4096,        // maximum number of free entries per env
+    parallel_weak_oops_threshold = 100000  // entries above which GC workers
+                                           // rebuild the tag map
   };
 
   JvmtiEnv*             _env;                       // the jvmti environment
@@ -61,6 +64,8 @@ class JvmtiTagMap :  public CHeapObj<mtInternal> {
   inline JvmtiEnv* env() const              { return _env; }
 
   void do_weak_oops(BoolObjectClosure* is_alive, OopClosure* f);
+  void do_weak_oops_par(BoolObjectClosure* is_alive, OopClosure* f,
+                        FlexibleWorkGang* workers, bool post_object_free);
 
   // iterate over all entries in this tag map
   void entry_iterate(JvmtiTagHashmapEntryClosure* closure);
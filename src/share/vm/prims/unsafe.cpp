@@ -36,6 +36,7 @@
 #include "runtime/prefetch.inline.hpp"
 #include "runtime/orderAccess.inline.hpp"
 #include "runtime/reflection.hpp"
+#include "runtime/stubRoutines.hpp"
 #include "runtime/synchronizer.hpp"
 #include "services/threadService.hpp"
 #include "trace/tracing.hpp"
@@ -690,6 +691,38 @@ UNSAFE_ENTRY(void, Unsafe_CopyMemory2(JNIEnv *env, jobject unsafe, jobject srcOb
   Copy::conjoint_memory_atomic(src, dst, sz);
 UNSAFE_END
 
+// Copy elemSize (2, 4 or 8) byte elements, reversing the byte order of each,
+// e.g. between a heap array and a buffer in non-native byte order.  As for
+// copyMemory, only primitive arrays or off-heap memory may be written to.
+UNSAFE_ENTRY(void, Unsafe_CopySwapMemory(JNIEnv *env, jobject unsafe, jobject srcObj, jlong srcOffset, jobject dstObj, jlong dstOffset, jlong size, jlong elemSize))
+  UnsafeWrapper("Unsafe_CopySwapMemory");
+  if (elemSize != 2 && elemSize != 4 && elemSize != 8) {
+    THROW(vmSymbols::java_lang_IllegalArgumentException());
+  }
+  size_t sz = (size_t)size;
+  if (sz != (julong)size || size < 0 || size % elemSize != 0) {
+    THROW(vmSymbols::java_lang_IllegalArgumentException());
+  }
+  if (size == 0) {
+    return;
+  }
+  oop srcp = JNIHandles::resolve(srcObj);
+  oop dstp = JNIHandles::resolve(dstObj);
+  if (dstp != NULL && !dstp->is_typeArray()) {
+    THROW(vmSymbols::java_lang_IllegalArgumentException());
+  }
+  void* src = index_oop_from_field_offset_long(srcp, srcOffset);
+  void* dst = index_oop_from_field_offset_long(dstp, dstOffset);
+  address stub = StubRoutines::swapcopy((size_t)elemSize);
+  if (stub != NULL) {
+    // No safepoint can occur between resolving the oops above and the copy.
+    typedef void (*swapcopy_stub_t)(void* src, void* dst, size_t count);
+    ((swapcopy_stub_t)stub)(src, dst, sz / (size_t)elemSize);
+  } else {
+    Copy::conjoint_swap(src, dst, sz, (size_t)elemSize);
+  }
+UNSAFE_END
+
 
 ////// Random queries
 
@@ -1650,6 +1683,10 @@ JNINativeMethod memcopy_methods_17[] = {
     {CC"setMemory",          CC"("OBJ"JJB)V",            FN_PTR(Unsafe_SetMemory2)}
 };
 
+JNINativeMethod copyswap_methods[] = {
+    {CC"copySwapMemory",     CC"("OBJ"J"OBJ"JJJ)V",      FN_PTR(Unsafe_CopySwapMemory)}
+};
+
 JNINativeMethod memcopy_methods_15[] = {
     {CC"setMemory",          CC"("ADR"JB)V",             FN_PTR(Unsafe_SetMemory)},
     {CC"copyMemory",         CC"("ADR ADR"J)V",          FN_PTR(Unsafe_CopyMemory)}
@@ -1756,6 +1793,9 @@ JVM_ENTRY(void, JVM_RegisterUnsafeMethods(JNIEnv *env, jclass unsafecls))
       }
     }
 
+    // Unsafe.copySwapMemory
+    register_natives("1.9 copy swap memory method", env, unsafecls, copyswap_methods, sizeof(copyswap_methods)/sizeof(JNINativeMethod));
+
     // Unsafe.defineAnonymousClass
     if (EnableInvokeDynamic) {
       register_natives("1.7 define anonymous class method", env, unsafecls, anonk_methods, sizeof(anonk_methods)/sizeof(JNINativeMethod));
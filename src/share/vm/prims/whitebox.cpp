@@ -302,6 +302,20 @@ WB_ENTRY(jboolean, WB_G1IsHumongous(JNIEnv* env, jobject o, jobject obj))
   return hr->isHumongous();
 WB_END
 
+// Pin obj like a JNI critical section does, returns false if the heap
+// does not support pinning.
+WB_ENTRY(jboolean, WB_G1PinObject(JNIEnv* env, jobject o, jobject obj))
+  if (!Universe::heap()->supports_object_pinning()) {
+    return false;
+  }
+  Universe::heap()->pin_object(thread, JNIHandles::resolve_non_null(obj));
+  return true;
+WB_END
+
+WB_ENTRY(void, WB_G1UnpinObject(JNIEnv* env, jobject o, jobject obj))
+  Universe::heap()->unpin_object(thread, JNIHandles::resolve_non_null(obj));
+WB_END
+
 WB_ENTRY(jlong, WB_G1NumFreeRegions(JNIEnv* env, jobject o))
   G1CollectedHeap* g1 = G1CollectedHeap::heap();
   size_t nr = g1->num_free_regions();
@@ -995,6 +1009,8 @@ static JNINativeMethod methods[] = {
 #if INCLUDE_ALL_GCS
   {CC"g1InConcurrentMark", CC"()Z",                   (void*)&WB_G1InConcurrentMark},
   {CC"g1IsHumongous",      CC"(Ljava/lang/Object;)Z", (void*)&WB_G1IsHumongous     },
+  {CC"g1PinObject",        CC"(Ljava/lang/Object;)Z", (void*)&WB_G1PinObject       },
+  {CC"g1UnpinObject",      CC"(Ljava/lang/Object;)V", (void*)&WB_G1UnpinObject     },
   {CC"g1NumFreeRegions",   CC"()J",                   (void*)&WB_G1NumFreeRegions  },
   {CC"g1RegionSize",       CC"()I",                   (void*)&WB_G1RegionSize      },
 #endif // INCLUDE_ALL_GCS
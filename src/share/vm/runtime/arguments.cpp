@@ -2196,6 +2196,10 @@ bool Arguments::check_vm_args_consistency() {
   status = status && verify_interval(SymbolTableSize, minimumSymbolTableSize,
     (max_uintx / SymbolTable::bucket_size()), "SymbolTable size");
 
+  // The service thread polls for perf map records; 0 would never wake it.
+  status = status && verify_interval(PerfMapFlushInterval, 1, max_jint,
+                                     "PerfMapFlushInterval");
+
   {
     // Using "else if" below to avoid printing two error messages if min > max.
     // This will also prevent us from reporting both min>100 and max>100 at the
@@ -4085,6 +4089,16 @@ jint Arguments::parse(const JavaVMInitArgs* args) {
   no_shared_spaces("CDS Disabled");
 #endif // INCLUDE_CDS
 
+#if INCLUDE_NMT
+  if (NativeMemoryTrackingSampleInterval > 0) {
+    if (MemTracker::tracking_level() == NMT_detail) {
+      MallocTracker::set_sample_interval(NativeMemoryTrackingSampleInterval);
+    } else if (!FLAG_IS_DEFAULT(NativeMemoryTrackingSampleInterval)) {
+      warning("NativeMemoryTrackingSampleInterval is ignored without -XX:NativeMemoryTracking=detail");
+    }
+  }
+#endif // INCLUDE_NMT
+
   return JNI_OK;
 }
 
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "memory/allocation.inline.hpp"
+#include "runtime/asyncLogWriter.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "runtime/os.hpp"
+#include "runtime/threadLocalStorage.hpp"
+#include "utilities/ostream.hpp"
+
+AsyncLogWriter*  AsyncLogWriter::_writer = NULL;
+gcLogFileStream* AsyncLogWriter::_stream = NULL;
+
+char*          AsyncLogWriter::_buffer = NULL;
+size_t         AsyncLogWriter::_capacity = 0;
+volatile uintx AsyncLogWriter::_head = 0;
+volatile uintx AsyncLogWriter::_tail = 0;
+volatile jint  AsyncLogWriter::_producers = 0;
+volatile jint  AsyncLogWriter::_accepting = 0;
+volatile jint  AsyncLogWriter::_should_terminate = 0;
+volatile jint  AsyncLogWriter::_terminated = 0;
+volatile jint  AsyncLogWriter::_dropped_messages = 0;
+
+// How long the writer sleeps when there is nothing to write, in milliseconds.
+// Producers wake it up early once the buffer is half full.
+static const jlong writer_poll_interval = 10;
+
+AsyncLogWriter::AsyncLogWriter() : NamedThread() {
+  set_name("GC Log Writer");
+}
+
+void AsyncLogWriter::initialize(gcLogFileStream* stream) {
+  if (!AsyncGCLogging || !stream->is_open()) {
+    return;
+  }
+
+  size_t capacity = 4 * K;
+  while (capacity < AsyncGCLogBufferSize) {
+    capacity <<= 1;
+  }
+  _buffer = NEW_C_HEAP_ARRAY(char, capacity, mtInternal);
+  memset(_buffer, 0, capacity);
+  _capacity = capacity;
+  _stream = stream;
+
+  AsyncLogWriter* writer = new AsyncLogWriter();
+  if (os::create_thread(writer, os::os_thread)) {
+    _writer = writer;
+    OrderAccess::release_store(&_accepting, 1);
+    os::start_thread(writer);
+  } else {
+    warning("Could not create the GC log writer thread, logging synchronously");
+  }
+}
+
+bool AsyncLogWriter::is_writer_thread() {
+  return _writer != NULL &&
+         ThreadLocalStorage::is_initialized() &&
+         ThreadLocalStorage::get_thread_slow() == _writer;
+}
+
+void AsyncLogWriter::copy_in(uintx pos, const char* s, size_t len) {
+  size_t offset = pos & (_capacity - 1);
+  size_t first = MIN2(len, _capacity - offset);
+  memcpy(_buffer + offset, s, first);
+  memcpy(_buffer, s + first, len - first);
+}
+
+void AsyncLogWriter::write_out(uintx pos, size_t len) {
+  size_t offset = pos & (_capacity - 1);
+  size_t first = MIN2(len, _capacity - offset);
+  _stream->write_to_file(_buffer + offset, first);
+  _stream->write_to_file(_buffer, len - first);
+}
+
+bool AsyncLogWriter::reserve_and_publish(juint kind, const char* s, size_t len) {
+  Atomic::inc(&_producers);
+  if (OrderAccess::load_acquire(&_accepting) == 0) {
+    Atomic::dec(&_producers);
+    if (OrderAccess::load_acquire(&_terminated) != 0) {
+      return false;
+    }
+    // The writer is stopping and may still be writing to the file; the
+    // caller must not write to it as well.
+    Atomic::inc(&_dropped_messages);
+    return true;
+  }
+
+  // Records start at a multiple of 8 bytes, so their header never wraps
+  size_t size = align_size_up(sizeof(Record) + len, BytesPerLong);
+  uintx head;
+  while (true) {
+    head = _head;
+    uintx tail = (uintx)OrderAccess::load_ptr_acquire((volatile intptr_t*)&_tail);
+    if (head + size - tail > _capacity) {
+      Atomic::inc(&_dropped_messages);
+      Atomic::dec(&_producers);
+      return true;
+    }
+    if ((uintx)Atomic::cmpxchg_ptr((intptr_t)(head + size), (volatile intptr_t*)&_head,
+                                   (intptr_t)head) == head) {
+      break;
+    }
+  }
+
+  Record* r = (Record*)(_buffer + (head & (_capacity - 1)));
+  r->_length = (juint)len;
+  copy_in(head + sizeof(Record), s, len);
+  OrderAccess::release_store(&r->_state, kind);
+
+  // Still counted as a producer here, so stop() cannot clear _writer
+  if (head + size - _tail > _capacity / 2) {
+    _writer->_ParkEvent->unpark();
+  }
+  Atomic::dec(&_producers);
+  return true;
+}
+
+bool AsyncLogWriter::enqueue(const char* s, size_t len) {
+  if (_writer == NULL || is_writer_thread()) {
+    return false;
+  }
+  // Messages larger than a quarter of the buffer are split so that they
+  // cannot starve everybody else.
+  size_t max_len = _capacity / 4 - sizeof(Record);
+  while (len > max_len) {
+    if (!reserve_and_publish(message_record, s, max_len)) {
+      return false;
+    }
+    s += max_len;
+    len -= max_len;
+  }
+  return reserve_and_publish(message_record, s, len);
+}
+
+bool AsyncLogWriter::request_rotation() {
+  if (_writer == NULL || is_writer_thread()) {
+    return false;
+  }
+  return reserve_and_publish(rotate_record, NULL, 0);
+}
+
+void AsyncLogWriter::report_dropped() {
+  jint dropped = _dropped_messages;
+  if (dropped != 0) {
+    Atomic::add(-dropped, &_dropped_messages);
+    char msg[128];
+    jio_snprintf(msg, sizeof(msg),
+                 "[%d log messages dropped, AsyncGCLogBufferSize is too small]\n", dropped);
+    _stream->write_to_file(msg, strlen(msg));
+  }
+}
+
+// Write out all published records, returns false if there was nothing to do
+bool AsyncLogWriter::drain() {
+  bool wrote = false;
+  uintx tail = _tail;
+  while (tail != (uintx)OrderAccess::load_ptr_acquire((volatile intptr_t*)&_head)) {
+    Record* r = (Record*)(_buffer + (tail & (_capacity - 1)));
+    juint state = OrderAccess::load_acquire(&r->_state);
+    if (state == empty_record) {
+      // reserved, but still being copied in
+      os::naked_short_sleep(1);
+      continue;
+    }
+    size_t len = r->_length;
+    size_t size = align_size_up(sizeof(Record) + len, BytesPerLong);
+    if (state == message_record) {
+      write_out(tail + sizeof(Record), len);
+    }
+    if (state == rotate_record ||
+        (UseGCLogFileRotation && _stream->should_rotate(false))) {
+      _stream->rotate_log_file(state == rotate_record, NULL);
+    }
+
+    // Clear the record so a stale header is never mistaken for a
+    // published one on the next lap.
+    size_t offset = tail & (_capacity - 1);
+    size_t first = MIN2(size, _capacity - offset);
+    memset(_buffer + offset, 0, first);
+    memset(_buffer, 0, size - first);
+    tail += size;
+    OrderAccess::release_store_ptr((volatile intptr_t*)&_tail, (intptr_t)tail);
+    wrote = true;
+  }
+  if (wrote || _dropped_messages != 0) {
+    report_dropped();
+    _stream->flush();
+  }
+  return wrote;
+}
+
+void AsyncLogWriter::run() {
+  this->record_stack_base_and_size();
+  this->initialize_thread_local_storage();
+
+  while (OrderAccess::load_acquire(&_should_terminate) == 0) {
+    if (!drain()) {
+      _ParkEvent->park(writer_poll_interval);
+    }
+  }
+  drain();
+  OrderAccess::release_store(&_terminated, 1);
+}
+
+void AsyncLogWriter::stop() {
+  if (_writer == NULL) {
+    return;
+  }
+  // Turn away new messages and wait for the ones being copied in
+  OrderAccess::release_store(&_accepting, 0);
+  OrderAccess::fence();
+  while (_producers != 0) {
+    os::naked_short_sleep(1);
+  }
+
+  OrderAccess::release_store(&_should_terminate, 1);
+  _writer->_ParkEvent->unpark();
+  // Bounded, a stuck disk must not hang the exit. If the writer does not
+  // finish in time, it keeps the file and later output is dropped.
+  for (int i = 0; OrderAccess::load_acquire(&_terminated) == 0 && i < 5000; i++) {
+    os::naked_short_sleep(1);
+  }
+  if (OrderAccess::load_acquire(&_terminated) != 0) {
+    _writer = NULL;
+  }
+}
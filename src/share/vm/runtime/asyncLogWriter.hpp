@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#ifndef SHARE_VM_RUNTIME_ASYNCLOGWRITER_HPP
+#define SHARE_VM_RUNTIME_ASYNCLOGWRITER_HPP
+
+#include "runtime/thread.hpp"
+
+class gcLogFileStream;
+
+// With -XX:+AsyncGCLogging the output for the -Xloggc file is appended to
+// a bounded, lock-free buffer instead of being written synchronously, and
+// the "GC Log Writer" thread writes it to the file. A thread logging inside
+// a pause therefore never waits for the disk.
+//
+// The buffer holds records of a length header followed by the text. Any
+// thread reserves space by advancing the head with a CAS, copies its text
+// and then publishes the record by setting its state. The writer consumes
+// published records in order from the tail. When the buffer is full the
+// message is dropped; the number of dropped messages is written to the log
+// once there is room again.
+//
+// The writer also performs the log file rotation, both when the file has
+// reached GCLogFileSize and when a rotation is requested with jcmd.
+
+class AsyncLogWriter : public NamedThread {
+ private:
+  struct Record {
+    volatile juint _state;
+    juint          _length;
+  };
+  enum {
+    empty_record   = 0,
+    message_record = 1,
+    rotate_record  = 2
+  };
+
+  static AsyncLogWriter* _writer;
+  static gcLogFileStream* _stream;
+
+  static char*          _buffer;
+  static size_t         _capacity;          // a power of 2
+  static volatile uintx _head;              // next position to reserve
+  static volatile uintx _tail;              // next position to write out
+  static volatile jint  _producers;         // threads reserving or copying
+  static volatile jint  _accepting;
+  static volatile jint  _should_terminate;
+  static volatile jint  _terminated;
+  static volatile jint  _dropped_messages;
+
+  AsyncLogWriter();
+
+  static bool reserve_and_publish(juint kind, const char* s, size_t len);
+  static void copy_in(uintx pos, const char* s, size_t len);
+  static void write_out(uintx pos, size_t len);
+  static void report_dropped();
+  static bool drain();
+
+ public:
+  // Start the writer for the given -Xloggc stream if AsyncGCLogging is set.
+  static void initialize(gcLogFileStream* stream);
+
+  // Write the buffered output and stop the writer. Later output is
+  // written synchronously again once the writer has finished; until then,
+  // and for good if it does not finish in time, it is dropped.
+  static void stop();
+
+  static bool is_active() { return _writer != NULL; }
+  static bool is_writer_thread();
+
+  // Buffer the text, returns false if the caller must write it itself
+  static bool enqueue(const char* s, size_t len);
+
+  // Ask the writer to rotate the log file after the buffered output
+  static bool request_rotation();
+
+  void run();
+};
+
+#endif // SHARE_VM_RUNTIME_ASYNCLOGWRITER_HPP
@@ -41,6 +41,7 @@
 #include "runtime/biasedLocking.hpp"
 #include "runtime/compilationPolicy.hpp"
 #include "runtime/deoptimization.hpp"
+#include "runtime/deoptimizationProfile.hpp"
 #include "runtime/interfaceSupport.hpp"
 #include "runtime/sharedRuntime.hpp"
 #include "runtime/signature.hpp"
@@ -1832,6 +1833,9 @@ JRT_ENTRY(void, Deoptimization::uncommon_trap_inner(JavaThread* thread, jint tra
 
     }
 
+    // Count this trap against its site, noting whether it discards the code.
+    DeoptimizationProfile::record(thread, nm, trap_method(), trap_bci, reason, action, make_not_entrant);
+
     // Take requested actions on the method:
 
     // Recompile
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "code/nmethod.hpp"
+#include "memory/allocation.inline.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/method.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/deoptimization.hpp"
+#include "runtime/deoptimizationProfile.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "runtime/os.hpp"
+#include "trace/tracing.hpp"
+#include "utilities/events.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/ostream.hpp"
+#include "utilities/vmError.hpp"
+
+// Ring of the most recent trap events.  Registering it as an EventLog
+// gets it printed with the other event logs in hs_err files.
+class DeoptimizationProfile::EventRing : public EventLog {
+ private:
+  Event*         _events;
+  jlong          _length;
+  volatile jlong _cursor;
+
+ public:
+  EventRing(uintx length) : _length((jlong)length), _cursor(0) {
+    _events = NEW_C_HEAP_ARRAY(Event, length, mtCompiler);
+    memset(_events, 0, sizeof(Event) * length);
+  }
+
+  jlong cursor() const { return _cursor; }
+
+  void log(JavaThread* thread, nmethod* nm, const char* method, int bci,
+           int reason, int action, double timestamp) {
+    jlong seq = Atomic::add((jlong)1, &_cursor);
+    Event* e = &_events[(seq - 1) % _length];
+    // Mark the slot as being written before touching the payload.
+    OrderAccess::release_store(&e->_seq, (jlong)0);
+    e->_timestamp  = timestamp;
+    e->_thread_id  = (intx)os::current_thread_id();
+    e->_compile_id = nm->compile_id();
+    e->_comp_level = nm->comp_level();
+    e->_bci        = bci;
+    e->_reason     = reason;
+    e->_action     = action;
+    strncpy(e->_method, method, method_name_length - 1);
+    e->_method[method_name_length - 1] = '\0';
+    OrderAccess::release_store(&e->_seq, seq);
+  }
+
+  // Copy out the event with sequence number seq.  Returns false if the
+  // slot has been overwritten or is being written concurrently.
+  bool read(jlong seq, Event* result) const {
+    const Event* e = &_events[(seq - 1) % _length];
+    if (OrderAccess::load_acquire((volatile jlong*)&e->_seq) != seq) {
+      return false;
+    }
+    memcpy(result, e, sizeof(Event));
+    OrderAccess::loadload();
+    return OrderAccess::load_acquire((volatile jlong*)&e->_seq) == seq;
+  }
+
+  void print_events_on(outputStream* st, jlong from) const {
+    jlong end = _cursor;
+    jlong start = MAX2(from, end - _length);
+    st->print_cr("Recent deoptimization events (%d):", (int)(end - start));
+    for (jlong seq = start + 1; seq <= end; seq++) {
+      Event e;
+      if (read(seq, &e)) {
+        e.print_on(st);
+      }
+    }
+  }
+
+  virtual void print_log_on(outputStream* out) {
+    // Printed at crash time: do not allocate or lock.
+    print_events_on(out, 0);
+    out->cr();
+  }
+};
+
+DeoptimizationProfile::EventRing*       DeoptimizationProfile::_ring = NULL;
+DeoptimizationProfile::Site* volatile   DeoptimizationProfile::_table[DeoptimizationProfile::table_size];
+volatile jlong                          DeoptimizationProfile::_reset_mark = 0;
+volatile jint                           DeoptimizationProfile::_site_count = 0;
+volatile jint                           DeoptimizationProfile::_dropped_traps = 0;
+volatile jlong                          DeoptimizationProfile::_total_events = 0;
+
+void DeoptimizationProfile::Event::print_on(outputStream* st) const {
+  st->print_cr("Event: %.3f thread=" INTX_FORMAT " compile_id=%d level=%d reason=%s action=%s %s @ %d",
+               _timestamp, _thread_id, _compile_id, _comp_level,
+               Deoptimization::trap_reason_name(_reason),
+               Deoptimization::trap_action_name(_action),
+               _method, _bci);
+}
+
+bool DeoptimizationProfile::Site::equals(unsigned int hash, const char* method, int bci,
+                                         int reason, int action) const {
+  return _hash == hash && _bci == bci && _reason == reason && _action == action &&
+         strcmp(_method, method) == 0;
+}
+
+void DeoptimizationProfile::initialize() {
+  if (ProfileDeoptimizationEvents && DeoptimizationEventLogSize > 0) {
+    _ring = new EventRing(DeoptimizationEventLogSize);
+  }
+}
+
+unsigned int DeoptimizationProfile::hash_for(const char* method, int bci, int reason, int action) {
+  unsigned int hash = 0;
+  for (const char* p = method; *p != '\0'; p++) {
+    hash = 31 * hash + (unsigned int)*p;
+  }
+  return hash ^ ((unsigned int)bci << 8) ^ ((unsigned int)reason << 3) ^ (unsigned int)action;
+}
+
+DeoptimizationProfile::Site* DeoptimizationProfile::lookup_or_add(unsigned int hash, const char* method,
+                                                                  int bci, int reason, int action) {
+  Site* volatile* bucket = &_table[hash % table_size];
+  Site* new_site = NULL;
+  while (true) {
+    Site* head = (Site*)OrderAccess::load_ptr_acquire((volatile intptr_t*)bucket);
+    for (Site* s = head; s != NULL; s = s->_next) {
+      if (s->equals(hash, method, bci, reason, action)) {
+        if (new_site != NULL) {
+          // Lost an insertion race against the same site.
+          delete new_site;
+          Atomic::dec(&_site_count);
+        }
+        return s;
+      }
+    }
+    if (new_site == NULL) {
+      if (Atomic::add(1, &_site_count) > (jint)DeoptimizationProfileMaxSites) {
+        Atomic::dec(&_site_count);
+        Atomic::inc(&_dropped_traps);
+        return NULL;
+      }
+      new_site = new (std::nothrow) Site();
+      if (new_site == NULL) {
+        Atomic::dec(&_site_count);
+        Atomic::inc(&_dropped_traps);
+        return NULL;
+      }
+      new_site->_hash = hash;
+      new_site->_bci = bci;
+      new_site->_reason = reason;
+      new_site->_action = action;
+      new_site->_count = 0;
+      new_site->_recompiles = 0;
+      new_site->_first_timestamp = os::elapsedTime();
+      new_site->_last_timestamp = new_site->_first_timestamp;
+      strncpy(new_site->_method, method, method_name_length - 1);
+      new_site->_method[method_name_length - 1] = '\0';
+    }
+    new_site->_next = head;
+    if (Atomic::cmpxchg_ptr(new_site, bucket, head) == head) {
+      return new_site;
+    }
+    // Somebody else pushed onto this bucket; rescan it.
+  }
+}
+
+void DeoptimizationProfile::record(JavaThread* thread, nmethod* nm, Method* trap_method,
+                                   int trap_bci, int reason, int action, bool make_not_entrant) {
+  if (!ProfileDeoptimizationEvents || VMError::fatal_error_in_progress()) {
+    return;
+  }
+
+  char method[method_name_length];
+  trap_method->name_and_sig_as_C_string(method, sizeof(method));
+  double now = os::elapsedTime();
+
+  Atomic::add((jlong)1, &_total_events);
+  if (_ring != NULL) {
+    _ring->log(thread, nm, method, trap_bci, reason, action, now);
+  }
+
+  Site* site = lookup_or_add(hash_for(method, trap_bci, reason, action), method, trap_bci, reason, action);
+  if (site != NULL) {
+    Atomic::inc(&site->_count);
+    if (make_not_entrant) {
+      Atomic::inc(&site->_recompiles);
+    }
+    // Racy, but a slightly stale timestamp is fine for reporting.
+    site->_last_timestamp = now;
+  }
+
+  EventDeoptimization event;
+  if (event.should_commit()) {
+    event.set_compileID(nm->compile_id());
+    event.set_compileLevel(nm->comp_level());
+    event.set_method(trap_method);
+    event.set_bci(trap_bci);
+    event.set_reason(Deoptimization::trap_reason_name(reason));
+    event.set_action(Deoptimization::trap_action_name(action));
+    event.commit();
+  }
+}
+
+static int compare_sites(DeoptimizationProfile::Site** a, DeoptimizationProfile::Site** b) {
+  jint ca = (*a)->_count;
+  jint cb = (*b)->_count;
+  if (ca != cb) {
+    return ca > cb ? -1 : 1;
+  }
+  return strcmp((*a)->_method, (*b)->_method);
+}
+
+void DeoptimizationProfile::print_on(outputStream* st, bool print_events, int min_count) {
+  if (!ProfileDeoptimizationEvents) {
+    st->print_cr("Deoptimization profiling is disabled, use -XX:+ProfileDeoptimizationEvents");
+    return;
+  }
+
+  ResourceMark rm;
+  GrowableArray<Site*> sites(64);
+  for (int i = 0; i < table_size; i++) {
+    for (Site* s = (Site*)OrderAccess::load_ptr_acquire((volatile intptr_t*)&_table[i]);
+         s != NULL; s = s->_next) {
+      if (s->_count > 0 && s->_count >= min_count) {
+        sites.append(s);
+      }
+    }
+  }
+  sites.sort(compare_sites);
+
+  st->print_cr("Deoptimization profile: " JLONG_FORMAT " events, %d sites (%d traps at unrecorded sites dropped)",
+               _total_events, _site_count, _dropped_traps);
+  st->print_cr("%8s %8s %10s %10s  %-24s %-16s %6s  %s",
+               "count", "recomp", "first", "last", "reason", "action", "bci", "method");
+  for (int i = 0; i < sites.length(); i++) {
+    Site* s = sites.at(i);
+    st->print_cr("%8d %8d %10.3f %10.3f  %-24s %-16s %6d  %s",
+                 s->_count, s->_recompiles, s->_first_timestamp, s->_last_timestamp,
+                 Deoptimization::trap_reason_name(s->_reason),
+                 Deoptimization::trap_action_name(s->_action),
+                 s->_bci, s->_method);
+  }
+
+  if (print_events && _ring != NULL) {
+    st->cr();
+    _ring->print_events_on(st, _reset_mark);
+  }
+}
+
+void DeoptimizationProfile::reset() {
+  // Sites are never unlinked, which keeps concurrent updaters safe;
+  // resetting just clears their counters.
+  for (int i = 0; i < table_size; i++) {
+    for (Site* s = _table[i]; s != NULL; s = s->_next) {
+      s->_count = 0;
+      s->_recompiles = 0;
+    }
+  }
+  if (_ring != NULL) {
+    OrderAccess::release_store(&_reset_mark, _ring->cursor());
+  }
+  _total_events = 0;
+  _dropped_traps = 0;
+}
+
+void deoptimizationProfile_init() {
+  DeoptimizationProfile::initialize();
+}
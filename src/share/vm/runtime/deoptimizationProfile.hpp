@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#ifndef SHARE_VM_RUNTIME_DEOPTIMIZATIONPROFILE_HPP
+#define SHARE_VM_RUNTIME_DEOPTIMIZATIONPROFILE_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class JavaThread;
+class Method;
+class nmethod;
+class outputStream;
+
+// DeoptimizationProfile is a production view of uncommon traps.  The
+// per-method trap counts kept in MDOs only say that a method trapped
+// and -XX:+TraceDeoptimization is far too noisy to leave on, so this
+// keeps two cheap structures that are updated without taking locks:
+//
+//  - a bounded ring of the most recent trap events, which is also
+//    registered as an EventLog so that it shows up in hs_err files;
+//  - a hashtable of counters keyed by (method, bci, reason, action),
+//    which is what points at a recompilation loop.
+//
+// Methods are recorded by name rather than by Method* so that entries
+// stay printable after class unloading or redefinition.  Both
+// structures are printed with jcmd Compiler.deoptimizations and cleared
+// with jcmd Compiler.deoptimizations_reset.
+
+class DeoptimizationProfile : AllStatic {
+ public:
+  enum {
+    method_name_length = 200
+  };
+
+  // One slot in the event ring.  The writer claims a slot by bumping
+  // the ring cursor and publishes it by storing its sequence number
+  // last; readers skip slots whose sequence number does not match.
+  class Event VALUE_OBJ_CLASS_SPEC {
+   public:
+    volatile jlong _seq;
+    double         _timestamp;
+    intx           _thread_id;
+    int            _compile_id;
+    int            _comp_level;
+    int            _bci;
+    int            _reason;
+    int            _action;
+    char           _method[method_name_length];
+
+    void print_on(outputStream* st) const;
+  };
+
+  // Aggregated trap count for one site.  Entries are only ever added
+  // (by CAS on the bucket head) and never freed while the VM runs.
+  class Site : public CHeapObj<mtCompiler> {
+   public:
+    Site*          _next;
+    unsigned int   _hash;
+    int            _bci;
+    int            _reason;
+    int            _action;
+    volatile jint  _count;
+    volatile jint  _recompiles;
+    double         _first_timestamp;
+    double         _last_timestamp;
+    char           _method[method_name_length];
+
+    bool equals(unsigned int hash, const char* method, int bci, int reason, int action) const;
+  };
+
+ private:
+  enum {
+    table_size = 1021
+  };
+
+  class EventRing;
+
+  static EventRing*     _ring;
+  static Site* volatile _table[table_size];
+  static volatile jlong _reset_mark;
+  static volatile jint  _site_count;
+  static volatile jint  _dropped_traps;
+  static volatile jlong _total_events;
+
+  static unsigned int hash_for(const char* method, int bci, int reason, int action);
+  static Site* lookup_or_add(unsigned int hash, const char* method, int bci, int reason, int action);
+
+ public:
+  static void initialize();
+
+  // Called from Deoptimization::uncommon_trap_inner for every trap.
+  static void record(JavaThread* thread, nmethod* nm, Method* trap_method,
+                     int trap_bci, int reason, int action, bool make_not_entrant);
+
+  static jlong total_events()  { return _total_events; }
+  static jint  site_count()    { return _site_count; }
+
+  // Print the counters, sorted by decreasing count, and optionally the
+  // recent events.  Sites with fewer than min_count traps are omitted.
+  static void print_on(outputStream* st, bool print_events, int min_count);
+  static void reset();
+};
+
+void deoptimizationProfile_init();
+
+#endif // SHARE_VM_RUNTIME_DEOPTIMIZATIONPROFILE_HPP
@@ -957,12 +957,24 @@ class CommandLineFlags {
   product(ccstr, NativeMemoryTracking, "off",                               \
           "Native memory tracking options")                                 \
                                                                             \
+  product(uintx, NativeMemoryTrackingSampleInterval, 0,                     \
+          "With detail tracking, only record the call sites of mallocs "    \
+          "sampled on average once per this many bytes (rounded to a "      \
+          "power of 2) and scale the site totals; 0 records every malloc")  \
+                                                                            \
   diagnostic(bool, PrintNMTStatistics, false,                               \
           "Print native memory tracking summary data if it is on")          \
                                                                             \
   diagnostic(bool, LogCompilation, false,                                   \
           "Log compilation activity in detail to LogFile")                  \
                                                                             \
+  product(bool, LogCompilationEvents, true,                                 \
+          "Record compilation events in a compact binary ring buffer "      \
+          "(see jcmd Compiler.event_log)")                                  \
+                                                                            \
+  product(uintx, CompilationEventLogSize, 2048,                             \
+          "Number of records in the compilation event ring buffer")         \
+                                                                            \
   product(bool, PrintCompilation, false,                                    \
           "Print compilations")                                             \
                                                                             \
@@ -1636,6 +1648,10 @@ class CommandLineFlags {
   product(bool, AlwaysPreTouch, false,                                      \
           "Force all freshly committed pages to be pre-touched")            \
                                                                             \
+  product(uintx, PreTouchParallelChunkSize, 1 * G,                          \
+          "Size of the chunks of memory that the GC worker threads "        \
+          "pre-touch in parallel for AlwaysPreTouch")                       \
+                                                                            \
   product_pd(uintx, CMSYoungGenPerWorker,                                   \
           "The maximum size of young gen chosen by default per GC worker "  \
           "thread available")                                               \
@@ -2478,6 +2494,14 @@ class CommandLineFlags {
           "GC log file size, requires UseGCLogFileRotation. "               \
           "Set to 0 to only trigger rotation via jcmd")                     \
                                                                             \
+  product(bool, AsyncGCLogging, false,                                      \
+          "Write the -Xloggc file from a separate thread through a "        \
+          "bounded buffer, output is dropped if the buffer is full")        \
+                                                                            \
+  product(uintx, AsyncGCLogBufferSize, 2*M,                                 \
+          "Size in bytes of the buffer for AsyncGCLogging, rounded up to "  \
+          "a power of 2")                                                   \
+                                                                            \
   /* JVMTI heap profiling */                                                \
                                                                             \
   diagnostic(bool, TraceJVMTIObjectTagging, false,                          \
@@ -2973,6 +2997,18 @@ class CommandLineFlags {
   develop(bool, DebugDeoptimization, false,                                 \
           "Tracing various information while debugging deoptimization")     \
                                                                             \
+  product(bool, ProfileDeoptimizationEvents, true,                          \
+          "Keep a ring of recent uncommon traps and per-site trap counts "  \
+          "(see jcmd Compiler.deoptimizations)")                            \
+                                                                            \
+  product(uintx, DeoptimizationEventLogSize, 256,                           \
+          "Number of recent deoptimization events kept when "               \
+          "ProfileDeoptimizationEvents is on")                              \
+                                                                            \
+  product(uintx, DeoptimizationProfileMaxSites, 4096,                       \
+          "Maximum number of distinct (method, bci, reason, action) "       \
+          "sites counted when ProfileDeoptimizationEvents is on")           \
+                                                                            \
   product(intx, SelfDestructTimer, 0,                                       \
           "Will cause VM to terminate after a given time (in minutes) "     \
           "(0 means off)")                                                  \
@@ -3794,12 +3830,27 @@ class CommandLineFlags {
   product(bool, ManagementServer, false,                                    \
           "Create JMX Management Server")                                   \
                                                                             \
+  product(ccstr, MetricsServerPath, NULL,                                   \
+          "Serve VM metrics in Prometheus text format on a UNIX domain "    \
+          "socket created at this path")                                    \
+                                                                            \
+  product(uintx, MetricsServerPort, 0,                                      \
+          "Serve VM metrics in Prometheus text format on this TCP port "    \
+          "of the loopback interface, 0 disables")                          \
+                                                                            \
   product(bool, DisableAttachMechanism, false,                              \
           "Disable mechanism that allows tools to attach to this VM")       \
                                                                             \
   product(bool, StartAttachListener, false,                                 \
           "Always start Attach Listener at VM startup")                     \
                                                                             \
+  product(uintx, AttachListenerWorkerThreads, 3,                            \
+          "Maximum number of threads running attach operations "           \
+          "concurrently, 0 runs them on the Attach Listener thread")        \
+                                                                            \
+  product(bool, PrintAttachOperations, false,                               \
+          "Print the queueing and execution time of attach operations")     \
+                                                                            \
   manageable(bool, PrintConcurrentLocks, false,                             \
           "Print java.util.concurrent locks in thread dump")                \
                                                                             \
@@ -3904,6 +3955,18 @@ class CommandLineFlags {
   product(bool, DTraceMonitorProbes, false,                                 \
           "Enable dtrace probes for monitor events")                        \
                                                                             \
+  product(bool, WritePerfMap, false,                                        \
+          "Write /tmp/perf-<pid>.map describing JIT-compiled code for the " \
+          "Linux perf profiler")                                            \
+                                                                            \
+  product(bool, WriteJitDump, false,                                        \
+          "Write a jit-<pid>.dump file with code and line tables of "       \
+          "JIT-compiled code for perf inject --jit")                        \
+                                                                            \
+  product(uintx, PerfMapFlushInterval, 100,                                 \
+          "Milliseconds between writes of queued perf map and jitdump "     \
+          "records")                                                        \
+                                                                            \
   product(bool, RelaxAccessControlCheck, false,                             \
           "Relax the access control checks in the verifier")                \
                                                                             \
@@ -50,7 +50,9 @@ void management_init();
 void bytecodes_init();
 void classLoader_init();
 void codeCache_init();
+void perfMap_init();
 void VM_Version_init();
+void bitMap_init();             // depends on VM_Version_init
 void os_init_globals();        // depends on VM_Version_init, before universe_init
 void stubRoutines_init1();
 jint universe_init();          // depends on codeCache_init and stubRoutines_init
@@ -69,7 +71,9 @@ void vtableStubs_init();
 void InlineCacheBuffer_init();
 void compilerOracle_init();
 void compilationPolicy_init();
+void compilationEventLog_init();
 void compileBroker_init();
+void deoptimizationProfile_init();
 
 // Initialization after compiler initialization
 bool universe_post_init();  // must happen after compiler_init
@@ -98,7 +102,9 @@ jint init_globals() {
   bytecodes_init();
   classLoader_init();
   codeCache_init();
+  perfMap_init();
   VM_Version_init();
+  bitMap_init();
   os_init_globals();
   stubRoutines_init1();
   jint status = universe_init();  // dependent on codeCache_init and
@@ -124,7 +130,9 @@ jint init_globals() {
   InlineCacheBuffer_init();
   compilerOracle_init();
   compilationPolicy_init();
+  compilationEventLog_init();
   compileBroker_init();
+  deoptimizationProfile_init();
   VMRegImpl::set_regName();
 
   if (!universe_post_init()) {
@@ -27,6 +27,7 @@
 #include "classfile/symbolTable.hpp"
 #include "classfile/systemDictionary.hpp"
 #include "code/codeCache.hpp"
+#include "code/perfMap.hpp"
 #include "compiler/compileBroker.hpp"
 #include "compiler/compilerOracle.hpp"
 #include "interpreter/bytecodeHistogram.hpp"
@@ -47,6 +48,7 @@
 #include "oops/symbol.hpp"
 #include "prims/jvmtiExport.hpp"
 #include "runtime/arguments.hpp"
+#include "runtime/asyncLogWriter.hpp"
 #include "runtime/biasedLocking.hpp"
 #include "runtime/compilationPolicy.hpp"
 #include "runtime/fprofiler.hpp"
@@ -62,6 +64,7 @@
 #include "runtime/timer.hpp"
 #include "runtime/vm_operations.hpp"
 #include "services/memTracker.hpp"
+#include "services/metricsServer.hpp"
 #include "trace/tracing.hpp"
 #include "utilities/dtrace.hpp"
 #include "utilities/globalDefinitions.hpp"
@@ -519,10 +522,16 @@ void before_exit(JavaThread * thread) {
     FlatProfiler::print(10);
   }
 
+  // Stop serving metrics before the PerfData they read is torn down
+  MetricsServer::stop();
+
   // shut down the StatSampler task
   StatSampler::disengage();
   StatSampler::destroy();
 
+  // Write out the remaining perf map and jitdump records
+  PerfMap::shutdown();
+
   // Stop concurrent GC threads
   Universe::heap()->stop();
 
@@ -562,6 +571,9 @@ void before_exit(JavaThread * thread) {
   print_statistics();
   Universe::heap()->print_tracing_info();
 
+  // Write out the buffered GC log, further output is written synchronously
+  AsyncLogWriter::stop();
+
   { MutexLocker ml(BeforeExit_lock);
     _before_exit_status = BEFORE_EXIT_DONE;
     BeforeExit_lock->notify_all();
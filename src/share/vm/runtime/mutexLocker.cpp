@@ -125,6 +125,7 @@ Monitor* GCTaskManager_lock           = NULL;
 
 Mutex*   Management_lock              = NULL;
 Monitor* Service_lock                 = NULL;
+Monitor* AttachOperation_lock         = NULL;
 Monitor* PeriodicTask_lock            = NULL;
 
 #ifdef INCLUDE_TRACE
@@ -267,6 +268,7 @@ void mutex_init() {
   def(JvmtiThreadState_lock        , Mutex  , nonleaf+2,   false); // Used by JvmtiThreadState/JvmtiEventController
   def(JvmtiPendingEvent_lock       , Monitor, nonleaf,     false); // Used by JvmtiCodeBlobEvents
   def(Management_lock              , Mutex  , nonleaf+2,   false); // used for JVM management
+  def(AttachOperation_lock         , Monitor, nonleaf,     true ); // used for the attach operation queue
 
   def(Compile_lock                 , Mutex  , nonleaf+3,   true );
   def(MethodData_lock              , Mutex  , nonleaf+3,   false);
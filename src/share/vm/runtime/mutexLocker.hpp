@@ -141,6 +141,7 @@ extern Mutex*   HotCardCache_lock;               // protects the hot card cache
 
 extern Mutex*   Management_lock;                 // a lock used to serialize JVM management
 extern Monitor* Service_lock;                    // a lock used for service thread operation
+extern Monitor* AttachOperation_lock;            // a lock used for the attach operation queue
 extern Monitor* PeriodicTask_lock;               // protects the periodic task structure
 
 #ifdef INCLUDE_TRACE
@@ -325,6 +325,10 @@ void os::init_before_ergo() {
   // We need to initialize large page support here because ergonomics takes some
   // decisions depending on large page support and the calculated large page size.
   large_page_init();
+
+  // Platform specific setup, such as reading the cgroup limits before the
+  // ergonomics size the heap and the thread pools.
+  pd_init_before_ergo();
 }
 
 void os::signal_init() {
@@ -1488,6 +1492,16 @@ void os::commit_memory_or_exit(char* addr, size_t size, size_t alignment_hint,
   MemTracker::record_virtual_memory_commit((address)addr, size, CALLER_PC);
 }
 
+void os::pretouch_memory(char* start, char* end) {
+  // Note the use of a write here; the value read would be unused, so the
+  // optimizer could remove a plain read. Writing back the value read keeps
+  // any contents intact.
+  for (volatile char* p = (char*)align_ptr_down(start, os::vm_page_size()); p < end;
+       p += os::vm_page_size()) {
+    char t = *p; *p = t;
+  }
+}
+
 bool os::uncommit_memory(char* addr, size_t bytes) {
   bool res;
   if (MemTracker::tracking_level() > NMT_minimal) {
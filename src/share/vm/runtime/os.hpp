@@ -153,6 +153,8 @@ class os: AllStatic {
   static void   pd_free_memory(char *addr, size_t bytes, size_t alignment_hint);
   static void   pd_realign_memory(char *addr, size_t bytes, size_t alignment_hint);
 
+  static void   pd_init_before_ergo();
+
 
  public:
   static void init(void);                      // Called before command line parsing
@@ -324,6 +326,10 @@ class os: AllStatic {
   static bool   uncommit_memory(char* addr, size_t bytes);
   static bool   release_memory(char* addr, size_t bytes);
 
+  // Touch every page of the committed range [start, end) so that the OS
+  // backs it with memory now rather than on first use.
+  static void   pretouch_memory(char* start, char* end);
+
   enum ProtType { MEM_PROT_NONE, MEM_PROT_READ, MEM_PROT_RW, MEM_PROT_RWX };
   static bool   protect_memory(char* addr, size_t bytes, ProtType prot,
                                bool is_committed = true);
@@ -372,6 +378,13 @@ class os: AllStatic {
   static bool   can_commit_large_page_memory();
   static bool   can_execute_large_page_memory();
 
+  // Transparent huge pages for the code cache and the compressed class
+  // space: the huge page size to align them to, 0 if they are not backed
+  // by huge pages, and advising a committed range. Committing memory may
+  // drop the advice, so a range is advised again after every expansion.
+  static size_t code_huge_page_size();
+  static void   advise_huge_pages_for_code(char* addr, size_t bytes);
+
   // OS interface to polling page
   static address get_polling_page()             { return _polling_page; }
   static void    set_polling_page(address page) { _polling_page = page; }
@@ -662,6 +662,7 @@ class PerfDataList : public CHeapObj<mtInternal> {
 class PerfDataManager : AllStatic {
 
   friend class StatSampler;   // for access to protected PerfDataList methods
+  friend class MetricsServer; // for access to the list of all items
 
   private:
     static PerfDataList* _all;
@@ -23,6 +23,7 @@
  */
 
 #include "precompiled.hpp"
+#include "code/perfMap.hpp"
 #include "runtime/interfaceSupport.hpp"
 #include "runtime/javaCalls.hpp"
 #include "runtime/serviceThread.hpp"
@@ -88,6 +89,7 @@ void ServiceThread::service_thread_entry(JavaThread* jt, TRAPS) {
     bool has_gc_notification_event = false;
     bool has_dcmd_notification_event = false;
     bool acs_notify = false;
+    bool has_perf_map_entries = false;
     JvmtiDeferredEvent jvmti_event;
     {
       // Need state transition ThreadBlockInVM so that this thread
@@ -105,10 +107,13 @@ void ServiceThread::service_thread_entry(JavaThread* jt, TRAPS) {
              !(has_jvmti_events = JvmtiDeferredEventQueue::has_events()) &&
               !(has_gc_notification_event = GCNotifier::has_event()) &&
               !(has_dcmd_notification_event = DCmdFactory::has_pending_jmx_notification()) &&
-             !(acs_notify = AllocationContextService::should_notify())) {
+             !(acs_notify = AllocationContextService::should_notify()) &&
+             !(has_perf_map_entries = PerfMap::has_pending_entries())) {
         // wait until one of the sensors has pending requests, or there is a
-        // pending JVMTI event or JMX GC notification to post
-        Service_lock->wait(Mutex::_no_safepoint_check_flag);
+        // pending JVMTI event or JMX GC notification to post.  Perf map
+        // records are queued without notification and picked up by polling.
+        Service_lock->wait(Mutex::_no_safepoint_check_flag,
+                           PerfMap::is_enabled() ? PerfMapFlushInterval : 0);
       }
 
       if (has_jvmti_events) {
@@ -135,6 +140,10 @@ void ServiceThread::service_thread_entry(JavaThread* jt, TRAPS) {
     if (acs_notify) {
       AllocationContextService::notify(CHECK);
     }
+
+    if (has_perf_map_entries) {
+      PerfMap::write_pending(jt);
+    }
   }
 }
 
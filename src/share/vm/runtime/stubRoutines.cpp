@@ -112,6 +112,10 @@ address StubRoutines::_checkcast_arraycopy_uninit        = NULL;
 address StubRoutines::_unsafe_arraycopy                  = NULL;
 address StubRoutines::_generic_arraycopy                 = NULL;
 
+address StubRoutines::_jshort_swapcopy                   = NULL;
+address StubRoutines::_jint_swapcopy                     = NULL;
+address StubRoutines::_jlong_swapcopy                    = NULL;
+
 
 address StubRoutines::_jbyte_fill;
 address StubRoutines::_jshort_fill;
@@ -192,6 +192,12 @@ class StubRoutines: AllStatic {
   static address _unsafe_arraycopy;
   static address _generic_arraycopy;
 
+  // Byte swapping copies used by Unsafe.copySwapMemory: (src, dst, element count).
+  // The ranges may overlap.
+  static address _jshort_swapcopy;
+  static address _jint_swapcopy;
+  static address _jlong_swapcopy;
+
   static address _jbyte_fill;
   static address _jshort_fill;
   static address _jint_fill;
@@ -353,6 +359,18 @@ class StubRoutines: AllStatic {
   static address unsafe_arraycopy()        { return _unsafe_arraycopy; }
   static address generic_arraycopy()       { return _generic_arraycopy; }
 
+  static address jshort_swapcopy()         { return _jshort_swapcopy; }
+  static address jint_swapcopy()           { return _jint_swapcopy; }
+  static address jlong_swapcopy()          { return _jlong_swapcopy; }
+  static address swapcopy(size_t elem_size) {
+    switch (elem_size) {
+    case 2:  return _jshort_swapcopy;
+    case 4:  return _jint_swapcopy;
+    case 8:  return _jlong_swapcopy;
+    default: return NULL;
+    }
+  }
+
   static address jbyte_fill()          { return _jbyte_fill; }
   static address jshort_fill()         { return _jshort_fill; }
   static address jint_fill()           { return _jint_fill; }
@@ -50,6 +50,7 @@
 #include "prims/jvmtiThreadState.hpp"
 #include "prims/privilegedStack.hpp"
 #include "runtime/arguments.hpp"
+#include "runtime/asyncLogWriter.hpp"
 #include "runtime/biasedLocking.hpp"
 #include "runtime/deoptimization.hpp"
 #include "runtime/fprofiler.hpp"
@@ -80,6 +81,7 @@
 #include "services/attachListener.hpp"
 #include "services/management.hpp"
 #include "services/memTracker.hpp"
+#include "services/metricsServer.hpp"
 #include "services/threadService.hpp"
 #include "trace/tracing.hpp"
 #include "trace/traceMacros.hpp"
@@ -250,6 +252,7 @@ Thread::Thread() {
   NOT_PRODUCT(_skip_gcalot = false;)
   _jvmti_env_iteration_count = 0;
   set_allocated_bytes(0);
+  _nmt_bytes_until_sample = 0;
   _vm_operation_started_count = 0;
   _vm_operation_completed_count = 0;
   _current_pending_monitor = NULL;
@@ -3533,6 +3536,11 @@ jint Threads::create_vm(JavaVMInitArgs* args, bool* canTryAgain) {
     }
   }
 
+  // Start the writer for the -Xloggc file
+  if (AsyncGCLogging && Arguments::gc_log_filename() != NULL) {
+    AsyncLogWriter::initialize((gcLogFileStream*)gclog_or_tty);
+  }
+
   assert (Universe::is_fully_initialized(), "not initialized");
   if (VerifyDuringStartup) {
     // Make sure we're starting with a clean slate.
@@ -3691,6 +3699,9 @@ jint Threads::create_vm(JavaVMInitArgs* args, bool* canTryAgain) {
     }
   }
 
+  // Start the metrics server if -XX:MetricsServerPath or -XX:MetricsServerPort
+  MetricsServer::initialize();
+
   // Launch -Xrun agents
   // Must be done in the JVMTI live phase so that for backward compatibility the JDWP
   // back-end can launch with -Xdebug -Xrunjdwp.
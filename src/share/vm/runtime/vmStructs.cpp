@@ -854,6 +854,9 @@ typedef BinaryTreeDictionary<Metablock, FreeList<Metablock> > MetablockTreeDicti
      static_field(StubRoutines,                _checkcast_arraycopy_uninit,                   address)                               \
      static_field(StubRoutines,                _unsafe_arraycopy,                             address)                               \
      static_field(StubRoutines,                _generic_arraycopy,                            address)                               \
+     static_field(StubRoutines,                _jshort_swapcopy,                              address)                               \
+     static_field(StubRoutines,                _jint_swapcopy,                                address)                               \
+     static_field(StubRoutines,                _jlong_swapcopy,                               address)                               \
                                                                                                                                      \
   /*****************/                                                                                                                \
   /* SharedRuntime */                                                                                                                \
@@ -32,10 +32,12 @@
 #include "runtime/globals.hpp"
 #include "runtime/java.hpp"
 #include "runtime/javaCalls.hpp"
+#include "runtime/mutexLocker.hpp"
 #include "runtime/os.hpp"
 #include "services/attachListener.hpp"
 #include "services/diagnosticCommand.hpp"
 #include "services/heapDumper.hpp"
+#include "utilities/events.hpp"
 
 volatile bool AttachListener::_initialized;
 
@@ -404,9 +406,273 @@ static AttachOperationFunctionInfo funcs[] = {
 
 
 
+// Looks up and runs a single operation, then sends the result to the client.
+static void run_operation(AttachOperation* op, jlong queued_time) {
+  ResourceMark rm;
+  bufferedStream st;
+  jint res = JNI_OK;
+  jlong start_time = os::javaTimeNanos();
+
+  // find the function to dispatch too
+  AttachOperationFunctionInfo* info = NULL;
+  for (int i=0; funcs[i].name != NULL; i++) {
+    const char* name = funcs[i].name;
+    assert(strlen(name) <= AttachOperation::name_length_max, "operation <= name_length_max");
+    if (strcmp(op->name(), name) == 0) {
+      info = &(funcs[i]);
+      break;
+    }
+  }
+
+  // check for platform dependent attach operation
+  if (info == NULL) {
+    info = AttachListener::pd_find_operation(op->name());
+  }
+
+  if (info != NULL) {
+    // dispatch to the function that implements this operation
+    res = (info->func)(op, &st);
+  } else {
+    st.print("Operation %s not recognized!", op->name());
+    res = JNI_ERR;
+  }
+
+  jlong end_time = os::javaTimeNanos();
+  double queued_ms = (double)(start_time - queued_time) / NANOSECS_PER_MILLISEC;
+  double run_ms = (double)(end_time - start_time) / NANOSECS_PER_MILLISEC;
+  // jcmd passes the command line as the first argument
+  const char* detail = strcmp(op->name(), "jcmd") == 0 ? op->arg(0) : "";
+  Events::log(Thread::current(), "Attach operation %s %s: result %d, queued %.3f ms, ran %.3f ms",
+              op->name(), detail, res, queued_ms, run_ms);
+  if (PrintAttachOperations) {
+    ttyLocker ttyl;
+    tty->print_cr("[Attach operation %s %s: result %d, queued %.3f ms, ran %.3f ms]",
+                  op->name(), detail, res, queued_ms, run_ms);
+  }
+
+  // operation complete - send result and output to client
+  op->complete(res, &st);
+}
+
+// Operations that must not overlap share a serialization key; keys are
+// bits so that a multi-line jcmd request, which runs as one operation,
+// can hold the keys of all of its commands.  Zero means the operation may
+// run alongside any other.  Diagnostic commands are already run
+// concurrently by the DiagnosticCommand MBean, so only the ones that walk
+// the heap or change global state are keyed.
+enum {
+  serialize_heap  = 1 << 0,
+  serialize_agent = 1 << 1,
+  serialize_flags = 1 << 2,
+  serialize_jfr   = 1 << 3
+};
+
+static uint jcmd_serialization_keys(const char* cmd) {
+  while (*cmd == ' ') cmd++;
+  if (strncmp(cmd, "GC.", 3) == 0) {
+    return serialize_heap;
+  }
+  if (strncmp(cmd, "ManagementAgent.", 16) == 0 ||
+      strncmp(cmd, "JVMTI.", 6) == 0) {
+    return serialize_agent;
+  }
+  if (strncmp(cmd, "VM.set_flag", 11) == 0 ||
+      strncmp(cmd, "VM.unlock_commercial_features", 29) == 0) {
+    return serialize_flags;
+  }
+  if (strncmp(cmd, "JFR.", 4) == 0) {
+    return serialize_jfr;
+  }
+  return 0;
+}
+
+static uint serialization_keys(AttachOperation* op) {
+  const char* name = op->name();
+  if (strcmp(name, "dumpheap") == 0 || strcmp(name, "inspectheap") == 0) {
+    return serialize_heap;
+  }
+  if (strcmp(name, "load") == 0) {
+    return serialize_agent;
+  }
+  if (strcmp(name, "setflag") == 0) {
+    return serialize_flags;
+  }
+  if (strcmp(name, "jcmd") == 0) {
+    // The commands are separated as in DCmd::parse_and_execute
+    uint keys = 0;
+    for (const char* line = op->arg(0); line != NULL; ) {
+      keys |= jcmd_serialization_keys(line);
+      line = strchr(line, '\n');
+      if (line != NULL) line++;
+    }
+    return keys;
+  }
+  return 0;
+}
+
+// A queued attach operation
+class AttachTask : public CHeapObj<mtInternal> {
+ public:
+  AttachOperation* _op;
+  uint             _keys;
+  jlong            _queued_time;
+  AttachTask*      _next;
+
+  AttachTask(AttachOperation* op) :
+    _op(op), _keys(serialization_keys(op)), _queued_time(os::javaTimeNanos()), _next(NULL) { }
+};
+
+// A small pool of worker threads runs the attach operations, so that a
+// long heap dump or class histogram does not hold up other clients.
+// Workers are started on demand, up to AttachListenerWorkerThreads.
+// All state is protected by AttachOperation_lock.
+class AttachWorkers : AllStatic {
+ private:
+  static AttachTask*  _head;
+  static AttachTask*  _tail;
+  static uint         _num_workers;
+  static uint         _next_slot;
+  static uint         _idle_workers;
+  // Keys of the operations currently running, one slot per worker
+  static uint*        _running_keys;
+
+  static bool is_running(uint keys) {
+    if (keys == 0) return false;
+    for (uint i = 0; i < _num_workers; i++) {
+      if ((_running_keys[i] & keys) != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Remove the first task none of whose keys are running
+  static AttachTask* take_runnable() {
+    AttachTask* prev = NULL;
+    for (AttachTask* t = _head; t != NULL; prev = t, t = t->_next) {
+      if (!is_running(t->_keys)) {
+        if (prev == NULL) {
+          _head = t->_next;
+        } else {
+          prev->_next = t->_next;
+        }
+        if (_tail == t) {
+          _tail = prev;
+        }
+        t->_next = NULL;
+        return t;
+      }
+    }
+    return NULL;
+  }
+
+  static void worker_entry(JavaThread* thread, TRAPS);
+
+ public:
+  // Returns false if the operation could not be handed to a worker
+  static bool enqueue(AttachOperation* op, TRAPS);
+};
+
+AttachTask*  AttachWorkers::_head = NULL;
+AttachTask*  AttachWorkers::_tail = NULL;
+uint         AttachWorkers::_num_workers = 0;
+uint         AttachWorkers::_next_slot = 0;
+uint         AttachWorkers::_idle_workers = 0;
+uint*        AttachWorkers::_running_keys = NULL;
+
+static JavaThread* create_attach_thread(const char* name, ThreadFunction entry, bool required, TRAPS);
+
+bool AttachWorkers::enqueue(AttachOperation* op, TRAPS) {
+  AttachTask* task = new AttachTask(op);
+  uint worker_id = 0;
+  bool start_worker = false;
+  {
+    MonitorLockerEx ml(AttachOperation_lock);
+    if (_running_keys == NULL) {
+      _running_keys = NEW_C_HEAP_ARRAY(uint, AttachListenerWorkerThreads, mtInternal);
+      for (uint i = 0; i < AttachListenerWorkerThreads; i++) {
+        _running_keys[i] = 0;
+      }
+    }
+    if (_tail == NULL) {
+      _head = _tail = task;
+    } else {
+      _tail->_next = task;
+      _tail = task;
+    }
+    if (_idle_workers == 0 && _num_workers < AttachListenerWorkerThreads) {
+      worker_id = _num_workers;
+      start_worker = true;
+    } else {
+      ml.notify_all();
+    }
+  }
+
+  if (start_worker) {
+    char name[32];
+    jio_snprintf(name, sizeof(name), "Attach Worker %u", worker_id);
+    JavaThread* worker = create_attach_thread(name, &worker_entry, false, THREAD);
+    if (worker != NULL) {
+      {
+        MonitorLockerEx ml(AttachOperation_lock);
+        _num_workers++;
+      }
+      MutexLocker mu(Threads_lock);
+      Thread::start(worker);
+    } else {
+      // Creating the thread may have failed with a pending exception,
+      // don't let it leak into the operation run by the listener
+      CLEAR_PENDING_EXCEPTION;
+      MonitorLockerEx ml(AttachOperation_lock);
+      if (_num_workers == 0) {
+        // Nobody will pick the task up, run it on the listener thread
+        assert(_head == task && _tail == task, "only the listener queues tasks");
+        _head = _tail = NULL;
+        delete task;
+        return false;
+      }
+      ml.notify_all();
+    }
+  }
+  return true;
+}
+
+void AttachWorkers::worker_entry(JavaThread* thread, TRAPS) {
+  uint slot;
+  {
+    MonitorLockerEx ml(AttachOperation_lock);
+    slot = _next_slot++;
+  }
+  for (;;) {
+    AttachTask* task;
+    {
+      MonitorLockerEx ml(AttachOperation_lock);
+      _idle_workers++;
+      while ((task = take_runnable()) == NULL) {
+        ml.wait();
+      }
+      _idle_workers--;
+      _running_keys[slot] = task->_keys;
+    }
+
+    run_operation(task->_op, task->_queued_time);
+
+    {
+      MonitorLockerEx ml(AttachOperation_lock);
+      _running_keys[slot] = 0;
+      // A task waiting on these keys may now run
+      if (task->_keys != 0 && _head != NULL) {
+        ml.notify_all();
+      }
+    }
+    delete task;
+  }
+}
+
 // The Attach Listener threads services a queue. It dequeues an operation
-// from the queue, examines the operation name (command), and dispatches
-// to the corresponding function to perform the operation.
+// from the queue and hands it to the attach workers, which examine the
+// operation name (command), and dispatch to the corresponding function to
+// perform the operation.
 
 static void attach_listener_thread_entry(JavaThread* thread, TRAPS) {
   os::set_priority(thread, NearMaxPriority);
@@ -424,53 +690,32 @@ static void attach_listener_thread_entry(JavaThread* thread, TRAPS) {
       return;   // dequeue failed or shutdown
     }
 
-    ResourceMark rm;
-    bufferedStream st;
-    jint res = JNI_OK;
-
     // handle special detachall operation
     if (strcmp(op->name(), AttachOperation::detachall_operation_name()) == 0) {
+      ResourceMark rm;
+      bufferedStream st;
       AttachListener::detachall();
-    } else {
-      // find the function to dispatch too
-      AttachOperationFunctionInfo* info = NULL;
-      for (int i=0; funcs[i].name != NULL; i++) {
-        const char* name = funcs[i].name;
-        assert(strlen(name) <= AttachOperation::name_length_max, "operation <= name_length_max");
-        if (strcmp(op->name(), name) == 0) {
-          info = &(funcs[i]);
-          break;
-        }
-      }
-
-      // check for platform dependent attach operation
-      if (info == NULL) {
-        info = AttachListener::pd_find_operation(op->name());
-      }
-
-      if (info != NULL) {
-        // dispatch to the function that implements this operation
-        res = (info->func)(op, &st);
-      } else {
-        st.print("Operation %s not recognized!", op->name());
-        res = JNI_ERR;
-      }
+      op->complete(JNI_OK, &st);
+      continue;
     }
 
-    // operation complete - send result and output to client
-    op->complete(res, &st);
+    if (AttachListenerWorkerThreads == 0 || !AttachWorkers::enqueue(op, thread)) {
+      run_operation(op, os::javaTimeNanos());
+    }
+    if (HAS_PENDING_EXCEPTION) {
+      CLEAR_PENDING_EXCEPTION;
+    }
   }
 }
 
-// Starts the Attach Listener thread
-void AttachListener::init() {
-  EXCEPTION_MARK;
-  Klass* k = SystemDictionary::resolve_or_fail(vmSymbols::java_lang_Thread(), true, CHECK);
+// Creates a daemon thread in the system thread group, the caller starts it.
+// Failing to create a required thread exits the VM.
+static JavaThread* create_attach_thread(const char* name, ThreadFunction entry, bool required, TRAPS) {
+  Klass* k = SystemDictionary::resolve_or_fail(vmSymbols::java_lang_Thread(), true, CHECK_NULL);
   instanceKlassHandle klass (THREAD, k);
-  instanceHandle thread_oop = klass->allocate_instance_handle(CHECK);
+  instanceHandle thread_oop = klass->allocate_instance_handle(CHECK_NULL);
 
-  const char thread_name[] = "Attach Listener";
-  Handle string = java_lang_String::create_from_str(thread_name, CHECK);
+  Handle string = java_lang_String::create_from_str(name, CHECK_NULL);
 
   // Initialize thread_oop to put it into the system threadGroup
   Handle thread_group (THREAD, Universe::system_thread_group());
@@ -490,7 +735,7 @@ void AttachListener::init() {
 
     CLEAR_PENDING_EXCEPTION;
 
-    return;
+    return NULL;
   }
 
   KlassHandle group(THREAD, SystemDictionary::ThreadGroup_klass());
@@ -509,23 +754,49 @@ void AttachListener::init() {
 
     CLEAR_PENDING_EXCEPTION;
 
-    return;
+    return NULL;
   }
 
-  { MutexLocker mu(Threads_lock);
-    JavaThread* listener_thread = new JavaThread(&attach_listener_thread_entry);
+  {
+    MutexLocker mu(Threads_lock);
+    JavaThread* new_thread = new JavaThread(entry);
 
     // Check that thread and osthread were created
-    if (listener_thread == NULL || listener_thread->osthread() == NULL) {
+    if (new_thread != NULL && new_thread->osthread() != NULL) {
+      java_lang_Thread::set_thread(thread_oop(), new_thread);
+      java_lang_Thread::set_daemon(thread_oop());
+
+      new_thread->set_threadObj(thread_oop());
+      Threads::add(new_thread);
+      return new_thread;
+    }
+    if (required) {
       vm_exit_during_initialization("java.lang.OutOfMemoryError",
                                     "unable to create new native thread");
     }
+    if (new_thread != NULL) {
+      delete new_thread;
+    }
+  }
 
-    java_lang_Thread::set_thread(thread_oop(), listener_thread);
-    java_lang_Thread::set_daemon(thread_oop());
+  // The thread will never start, take it out of the thread group again
+  JavaCalls::call_special(&result,
+                        thread_group,
+                        group,
+                        vmSymbols::remove_method_name(),
+                        vmSymbols::thread_void_signature(),
+                        thread_oop,
+                        THREAD);
+  CLEAR_PENDING_EXCEPTION;
+  return NULL;
+}
 
-    listener_thread->set_threadObj(thread_oop());
-    Threads::add(listener_thread);
+// Starts the Attach Listener thread
+void AttachListener::init() {
+  EXCEPTION_MARK;
+  JavaThread* listener_thread = create_attach_thread("Attach Listener", &attach_listener_thread_entry, true, THREAD);
+  if (listener_thread != NULL) {
+    MutexLocker mu(Threads_lock);
     Thread::start(listener_thread);
   }
 }
@@ -23,7 +23,9 @@
  */
 
 #include "precompiled.hpp"
+#include "compiler/compilationEventLog.hpp"
 #include "gc_implementation/shared/vmGCOperations.hpp"
+#include "runtime/deoptimizationProfile.hpp"
 #include "runtime/javaCalls.hpp"
 #include "services/diagnosticArgument.hpp"
 #include "services/diagnosticCommand.hpp"
@@ -56,6 +58,9 @@ void DCmdRegistrant::register_dcmds(){
 #endif // INCLUDE_SERVICES
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ThreadDumpDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<RotateGCLogDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<DeoptimizationsDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<DeoptimizationsResetDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<CompilationEventLogDCmd>(full_export, true, false));
 
   // Enhanced JMX Agent Support
   // These commands won't be exported via the DiagnosticCommandMBean until an
@@ -427,6 +432,65 @@ int ThreadDumpDCmd::num_arguments() {
   }
 }
 
+DeoptimizationsDCmd::DeoptimizationsDCmd(outputStream* output, bool heap) :
+                                         DCmdWithParser(output, heap),
+  _events("-events", "Also print the most recent deoptimization events",
+          "BOOLEAN", false, "false"),
+  _min_count("min_count", "Only print sites that trapped at least this often",
+             "INT", false, "1") {
+  _dcmdparser.add_dcmd_option(&_events);
+  _dcmdparser.add_dcmd_option(&_min_count);
+}
+
+void DeoptimizationsDCmd::execute(DCmdSource source, TRAPS) {
+  // The profile is updated without locks, so no safepoint is needed.
+  DeoptimizationProfile::print_on(output(), _events.value(), (int)_min_count.value());
+}
+
+int DeoptimizationsDCmd::num_arguments() {
+  ResourceMark rm;
+  DeoptimizationsDCmd* dcmd = new DeoptimizationsDCmd(NULL, false);
+  if (dcmd != NULL) {
+    DCmdMark mark(dcmd);
+    return dcmd->_dcmdparser.num_arguments();
+  } else {
+    return 0;
+  }
+}
+
+CompilationEventLogDCmd::CompilationEventLogDCmd(outputStream* output, bool heap) :
+                                                 DCmdWithParser(output, heap),
+  _filename("filename", "Name of the file to write the binary log to; "
+            "if omitted the log is printed", "STRING", false),
+  _count("count", "Number of most recent events to print (-1 for all)",
+         "INT", false, "-1") {
+  _dcmdparser.add_dcmd_option(&_count);
+  _dcmdparser.add_dcmd_argument(&_filename);
+}
+
+void CompilationEventLogDCmd::execute(DCmdSource source, TRAPS) {
+  if (_filename.has_value()) {
+    CompilationEventLog::dump(_filename.value(), output());
+  } else {
+    CompilationEventLog::print_on(output(), (int)_count.value());
+  }
+}
+
+int CompilationEventLogDCmd::num_arguments() {
+  ResourceMark rm;
+  CompilationEventLogDCmd* dcmd = new CompilationEventLogDCmd(NULL, false);
+  if (dcmd != NULL) {
+    DCmdMark mark(dcmd);
+    return dcmd->_dcmdparser.num_arguments();
+  } else {
+    return 0;
+  }
+}
+
+void DeoptimizationsResetDCmd::execute(DCmdSource source, TRAPS) {
+  DeoptimizationProfile::reset();
+}
+
 // Enhanced JMX Agent support
 
 JMXStartRemoteDCmd::JMXStartRemoteDCmd(outputStream *output, bool heap_allocated) :
@@ -271,6 +271,70 @@ public:
   virtual void execute(DCmdSource source, TRAPS);
 };
 
+class DeoptimizationsDCmd : public DCmdWithParser {
+protected:
+  DCmdArgument<bool>  _events;
+  DCmdArgument<jlong> _min_count;
+public:
+  DeoptimizationsDCmd(outputStream* output, bool heap);
+  static const char* name() { return "Compiler.deoptimizations"; }
+  static const char* description() {
+    return "Print uncommon trap counts by method, bci, reason and action, "
+           "and optionally the most recent deoptimization events. "
+           "Requires -XX:+ProfileDeoptimizationEvents.";
+  }
+  static const char* impact() {
+    return "Low";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  static int num_arguments();
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
+class CompilationEventLogDCmd : public DCmdWithParser {
+protected:
+  DCmdArgument<char*> _filename;
+  DCmdArgument<jlong> _count;
+public:
+  CompilationEventLogDCmd(outputStream* output, bool heap);
+  static const char* name() { return "Compiler.event_log"; }
+  static const char* description() {
+    return "Print the compilation event log, or write it in binary form "
+           "to a file. Requires -XX:+LogCompilationEvents.";
+  }
+  static const char* impact() {
+    return "Low";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  static int num_arguments();
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
+class DeoptimizationsResetDCmd : public DCmd {
+public:
+  DeoptimizationsResetDCmd(outputStream* output, bool heap) : DCmd(output, heap) {}
+  static const char* name() { return "Compiler.deoptimizations_reset"; }
+  static const char* description() {
+    return "Clear the uncommon trap counters and the deoptimization event ring.";
+  }
+  static const char* impact() { return "Low"; }
+  virtual void execute(DCmdSource source, TRAPS);
+  static int num_arguments() { return 0; }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "control", NULL};
+    return p;
+  }
+};
+
 // Enhanced JMX Agent support
 
 class JMXStartRemoteDCmd : public DCmdWithParser {
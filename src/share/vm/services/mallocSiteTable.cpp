@@ -26,6 +26,7 @@
 
 #include "memory/allocation.inline.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/orderAccess.inline.hpp"
 #include "services/mallocSiteTable.hpp"
 
 /*
@@ -57,11 +58,7 @@ size_t MallocSiteTable::_hash_entry_allocation_site[CALC_OBJ_SIZE_IN_TYPE(Malloc
 // Malloc site hashtable buckets
 MallocSiteHashtableEntry*  MallocSiteTable::_table[MallocSiteTable::table_size];
 
-// concurrent access counter
-volatile int MallocSiteTable::_access_count = 0;
-
-// Tracking hashtable contention
-NOT_PRODUCT(int MallocSiteTable::_peak_count = 0;)
+volatile bool MallocSiteTable::_shutdown = false;
 
 
 /*
@@ -76,7 +73,7 @@ bool MallocSiteTable::initialize() {
   assert(sizeof(_hash_entry_allocation_stack) >= sizeof(NativeCallStack), "Sanity Check");
   assert(sizeof(_hash_entry_allocation_site) >= sizeof(MallocSiteHashtableEntry),
     "Sanity Check");
-  assert((size_t)table_size <= MAX_MALLOCSITE_TABLE_SIZE, "Hashtable overflow");
+  assert((size_t)table_size < MAX_MALLOCSITE_TABLE_SIZE, "Hashtable overflow");
 
   // Fake the call stack for hashtable entry allocation
   assert(NMT_TrackingStackDepth > 1, "At least one tracking stack");
@@ -198,64 +195,15 @@ MallocSiteHashtableEntry* MallocSiteTable::new_entry(const NativeCallStack& key)
   return ::new (p) MallocSiteHashtableEntry(key);
 }
 
-void MallocSiteTable::reset() {
-  for (int index = 0; index < table_size; index ++) {
-    MallocSiteHashtableEntry* head = _table[index];
-    _table[index] = NULL;
-    delete_linked_list(head);
-  }
-}
-
-void MallocSiteTable::delete_linked_list(MallocSiteHashtableEntry* head) {
-  MallocSiteHashtableEntry* p;
-  while (head != NULL) {
-    p = head;
-    head = (MallocSiteHashtableEntry*)head->next();
-    if (p != (MallocSiteHashtableEntry*)_hash_entry_allocation_site) {
-      delete p;
-    }
-  }
-}
-
+// Entries are not freed: without reader tracking there is no point at
+// which no other thread can be looking at them.
 void MallocSiteTable::shutdown() {
-  AccessLock locker(&_access_count);
-  locker.exclusiveLock();
-  reset();
+  _shutdown = true;
+  OrderAccess::fence();
 }
 
 bool MallocSiteTable::walk_malloc_site(MallocSiteWalker* walker) {
   assert(walker != NULL, "NuLL walker");
-  AccessLock locker(&_access_count);
-  if (locker.sharedLock()) {
-    NOT_PRODUCT(_peak_count = MAX2(_peak_count, _access_count);)
-    return walk(walker);
-  }
-  return false;
-}
-
-
-void MallocSiteTable::AccessLock::exclusiveLock() {
-  jint target;
-  jint val;
-
-  assert(_lock_state != ExclusiveLock, "Can only call once");
-  assert(*_lock >= 0, "Can not content exclusive lock");
-
-  // make counter negative to block out shared locks
-  do {
-    val = *_lock;
-    target = _MAGIC_ + *_lock;
-  } while (Atomic::cmpxchg(target, _lock, val) != val);
-
-  // wait for all readers to exit
-  while (*_lock != _MAGIC_) {
-#ifdef _WINDOWS
-    os::naked_short_sleep(1);
-#else
-    os::NakedYield();
-#endif
-  }
-  _lock_state = ExclusiveLock;
+  if (_shutdown) return false;
+  return walk(walker);
 }
-
-
@@ -44,8 +44,8 @@ class MallocSite : public AllocationSite<MemoryCounter> {
   MallocSite(const NativeCallStack& stack) :
     AllocationSite<MemoryCounter>(stack) { }
 
-  void allocate(size_t size)      { data()->allocate(size);   }
-  void deallocate(size_t size)    { data()->deallocate(size); }
+  void allocate(size_t size, size_t count)   { data()->allocate(size, count);   }
+  void deallocate(size_t size, size_t count) { data()->deallocate(size, count); }
 
   // Memory allocated from this code path
   size_t size()  const { return peek()->size(); }
@@ -89,8 +89,8 @@ class MallocSiteHashtableEntry : public CHeapObj<mtNMT> {
     return _malloc_site.equals(stack);
   }
   // Allocation/deallocation on this allocation site
-  inline void allocate(size_t size)   { _malloc_site.allocate(size);   }
-  inline void deallocate(size_t size) { _malloc_site.deallocate(size); }
+  inline void allocate(size_t size, size_t count)   { _malloc_site.allocate(size, count);   }
+  inline void deallocate(size_t size, size_t count) { _malloc_site.deallocate(size, count); }
   // Memory counters
   inline size_t size() const  { return _malloc_site.size();  }
   inline size_t count() const { return _malloc_site.count(); }
@@ -105,6 +105,12 @@ class MallocSiteWalker : public StackObj {
 /*
  * Native memory tracking call site table.
  * The table is only needed when detail tracking is enabled.
+ *
+ * The table is lock-free: entries are only ever appended to the bucket
+ * chains with compare-and-swap and are never removed while the VM is
+ * running, so lookups, counter updates and walks need no synchronization.
+ * Once detail tracking is turned off the entries are simply abandoned,
+ * since threads that sampled the old tracking level may still be using them.
  */
 class MallocSiteTable : AllStatic {
  private:
@@ -121,76 +127,26 @@ class MallocSiteTable : AllStatic {
     table_size = (table_base_size * NMT_TrackingStackDepth - 1)
   };
 
-
-  // This is a very special lock, that allows multiple shared accesses (sharedLock), but
-  // once exclusive access (exclusiveLock) is requested, all shared accesses are
-  // rejected forever.
-  class AccessLock : public StackObj {
-    enum LockState {
-      NoLock,
-      SharedLock,
-      ExclusiveLock
-    };
-
-   private:
-    // A very large negative number. The only possibility to "overflow"
-    // this number is when there are more than -min_jint threads in
-    // this process, which is not going to happen in foreseeable future.
-    const static int _MAGIC_ = min_jint;
-
-    LockState      _lock_state;
-    volatile int*  _lock;
-   public:
-    AccessLock(volatile int* lock) :
-      _lock(lock), _lock_state(NoLock) {
-    }
-
-    ~AccessLock() {
-      if (_lock_state == SharedLock) {
-        Atomic::dec((volatile jint*)_lock);
-      }
-    }
-    // Acquire shared lock.
-    // Return true if shared access is granted.
-    inline bool sharedLock() {
-      jint res = Atomic::add(1, _lock);
-      if (res < 0) {
-        Atomic::add(-1, _lock);
-        return false;
-      }
-      _lock_state = SharedLock;
-      return true;
-    }
-    // Acquire exclusive lock
-    void exclusiveLock();
- };
-
  public:
   static bool initialize();
   static void shutdown();
 
-  NOT_PRODUCT(static int access_peak_count() { return _peak_count; })
-
   // Number of hash buckets
   static inline int hash_buckets()      { return (int)table_size; }
 
-  // Access and copy a call stack from this table. Shared lock should be
-  // acquired before access the entry.
+  // Access and copy a call stack from this table.
   static inline bool access_stack(NativeCallStack& stack, size_t bucket_idx,
     size_t pos_idx) {
-    AccessLock locker(&_access_count);
-    if (locker.sharedLock()) {
-      NOT_PRODUCT(_peak_count = MAX2(_peak_count, _access_count);)
-      MallocSite* site = malloc_site(bucket_idx, pos_idx);
-      if (site != NULL) {
-        stack = *site->call_stack();
-        return true;
-      }
+    if (_shutdown) return false;
+    MallocSite* site = malloc_site(bucket_idx, pos_idx);
+    if (site != NULL) {
+      stack = *site->call_stack();
+      return true;
     }
     return false;
   }
 
-  // Record a new allocation from specified call path.
+  // Record count allocations of size bytes in total from specified call path.
   // Return true if the allocation is recorded successfully, bucket_idx
   // and pos_idx are also updated to indicate the entry where the allocation
   // information was recorded.
@@ -198,28 +154,21 @@ class MallocSiteTable : AllStatic {
   //  1. out of memory
   //  2. overflow hash bucket
   static inline bool allocation_at(const NativeCallStack& stack, size_t size,
-    size_t* bucket_idx, size_t* pos_idx) {
-    AccessLock locker(&_access_count);
-    if (locker.sharedLock()) {
-      NOT_PRODUCT(_peak_count = MAX2(_peak_count, _access_count);)
-      MallocSite* site = lookup_or_add(stack, bucket_idx, pos_idx);
-      if (site != NULL) site->allocate(size);
-      return site != NULL;
-    }
-    return false;
+    size_t count, size_t* bucket_idx, size_t* pos_idx) {
+    if (_shutdown) return false;
+    MallocSite* site = lookup_or_add(stack, bucket_idx, pos_idx);
+    if (site != NULL) site->allocate(size, count);
+    return site != NULL;
   }
 
   // Record memory deallocation. bucket_idx and pos_idx indicate where the allocation
   // information was recorded.
-  static inline bool deallocation_at(size_t size, size_t bucket_idx, size_t pos_idx) {
-    AccessLock locker(&_access_count);
-    if (locker.sharedLock()) {
-      NOT_PRODUCT(_peak_count = MAX2(_peak_count, _access_count);)
-      MallocSite* site = malloc_site(bucket_idx, pos_idx);
-      if (site != NULL) {
-        site->deallocate(size);
-        return true;
-      }
+  static inline bool deallocation_at(size_t size, size_t count, size_t bucket_idx, size_t pos_idx) {
+    if (_shutdown) return false;
+    MallocSite* site = malloc_site(bucket_idx, pos_idx);
+    if (site != NULL) {
+      site->deallocate(size, count);
+      return true;
     }
     return false;
   }
@@ -229,10 +178,6 @@ class MallocSiteTable : AllStatic {
 
  private:
   static MallocSiteHashtableEntry* new_entry(const NativeCallStack& key);
-  static void reset();
-
-  // Delete a bucket linked list
-  static void delete_linked_list(MallocSiteHashtableEntry* head);
 
   static MallocSite* lookup_or_add(const NativeCallStack& key, size_t* bucket_idx, size_t* pos_idx);
   static MallocSite* malloc_site(size_t bucket_idx, size_t pos_idx);
@@ -248,8 +193,8 @@ class MallocSiteTable : AllStatic {
   }
 
  private:
-  // Counter for counting concurrent access
-  static volatile int                _access_count;
+  // Set once detail tracking has been turned off
+  static volatile bool               _shutdown;
 
   // The callsite hashtable. It has to be a static table,
   // since malloc call can come from C runtime linker.
@@ -262,7 +207,6 @@ class MallocSiteTable : AllStatic {
   static size_t _hash_entry_allocation_stack[CALC_OBJ_SIZE_IN_TYPE(NativeCallStack, size_t)];
   // The memory for hashtable entry allocation callsite object
   static size_t _hash_entry_allocation_site[CALC_OBJ_SIZE_IN_TYPE(MallocSiteHashtableEntry, size_t)];
-  NOT_PRODUCT(static int     _peak_count;)
 };
 
 #endif // INCLUDE_NMT
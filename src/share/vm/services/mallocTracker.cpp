@@ -25,6 +25,8 @@
 
 #include "runtime/atomic.hpp"
 #include "runtime/atomic.inline.hpp"
+#include "runtime/thread.inline.hpp"
+#include "runtime/threadLocalStorage.hpp"
 #include "services/mallocSiteTable.hpp"
 #include "services/mallocTracker.hpp"
 #include "services/mallocTracker.inline.hpp"
@@ -32,6 +34,9 @@
 
 size_t MallocMemorySummary::_snapshot[CALC_OBJ_SIZE_IN_TYPE(MallocMemorySnapshot, size_t)];
 
+volatile int MallocTracker::_sample_shift       = 0;
+jlong        MallocTracker::_bytes_until_sample = 0;
+
 // Total malloc'd memory amount
 size_t MallocMemorySnapshot::total() const {
   size_t amount = 0;
@@ -72,14 +77,24 @@ void MallocHeader::release() const {
 
   MallocMemorySummary::record_free(size(), flags());
   MallocMemorySummary::record_free_malloc_header(sizeof(MallocHeader));
-  if (MemTracker::tracking_level() == NMT_detail) {
-    MallocSiteTable::deallocation_at(size(), _bucket_idx, _pos_idx);
+  if (MemTracker::tracking_level() == NMT_detail && has_malloc_site()) {
+    size_t count = 1;
+    size_t scaled_size = size();
+    if (_sample_shift != 0) {
+      MallocTracker::scale_sample(size(), _sample_shift, &count, &scaled_size);
+    }
+    MallocSiteTable::deallocation_at(scaled_size, count, _bucket_idx, _pos_idx);
   }
 }
 
 bool MallocHeader::record_malloc_site(const NativeCallStack& stack, size_t size,
   size_t* bucket_idx, size_t* pos_idx) const {
-  bool ret =  MallocSiteTable::allocation_at(stack, size, bucket_idx, pos_idx);
+  size_t count = 1;
+  size_t scaled_size = size;
+  if (_sample_shift != 0) {
+    MallocTracker::scale_sample(size, _sample_shift, &count, &scaled_size);
+  }
+  bool ret =  MallocSiteTable::allocation_at(stack, scaled_size, count, bucket_idx, pos_idx);
 
   // Something went wrong, could be OOM or overflow malloc site table.
   // We want to keep tracking data under OOM circumstance, so transition to
@@ -91,6 +106,7 @@ bool MallocHeader::record_malloc_site(const NativeCallStack& stack, size_t size,
 }
 
 bool MallocHeader::get_stack(NativeCallStack& stack) const {
+  if (!has_malloc_site()) return false;
   return MallocSiteTable::access_stack(stack, _bucket_idx, _pos_idx);
 }
 
@@ -117,6 +133,57 @@ bool MallocTracker::transition(NMT_TrackingLevel from, NMT_TrackingLevel to) {
   return true;
 }
 
+size_t MallocTracker::set_sample_interval(size_t interval) {
+  int shift = 0;
+  if (interval > 0) {
+    shift = log2_intptr(interval);
+    if (((size_t)1 << shift) < interval) {
+      shift ++;
+    }
+    shift = MIN2(MAX2(shift, 1), (int)max_sample_shift);
+  }
+  _sample_shift = shift;
+  OrderAccess::fence();
+  return sample_interval();
+}
+
+// Draw the number of bytes until the next sample from an exponential
+// distribution with a mean of 2^shift bytes, so that the sampled bytes
+// form a Poisson process independent of allocation patterns.
+jlong MallocTracker::next_sample_distance(int shift) {
+  double u = ((double)os::random() + 1.0) / 2147483648.0;   // (0, 1]
+  jlong distance = (jlong)(-log(u) * (double)((jlong)1 << shift));
+  return MAX2(distance, (jlong)1);
+}
+
+// Each thread counts down its own bytes, so the common case touches
+// no shared state. Threads unknown to the VM share one counter; races
+// on it only perturb the sampling.
+bool MallocTracker::should_sample(size_t size, int shift) {
+  Thread* thread = ThreadLocalStorage::is_initialized() ?
+    ThreadLocalStorage::get_thread_slow() : NULL;
+  jlong* left = (thread != NULL) ? thread->nmt_bytes_until_sample_addr() : &_bytes_until_sample;
+  if (*left == 0) {
+    *left = next_sample_distance(shift);
+  }
+  *left -= (jlong)size;
+  if (*left > 0) {
+    return false;
+  }
+  *left = next_sample_distance(shift);
+  return true;
+}
+
+// A malloc of size bytes is picked with probability p = 1 - e^(-size/2^shift),
+// so it stands for 1/p such allocations. The result only depends on the
+// arguments, which lets free() subtract exactly what malloc() added.
+void MallocTracker::scale_sample(size_t size, int shift, size_t* count, size_t* scaled_size) {
+  double sz = (double)MAX2(size, (size_t)1);
+  double p = 1.0 - exp(-sz / (double)((jlong)1 << shift));
+  *count = (size_t)(1.0 / p + 0.5);
+  *scaled_size = (size_t)(sz / p + 0.5);
+}
+
 // Record a malloc memory allocation
 void* MallocTracker::record_malloc(void* malloc_base, size_t size, MEMFLAGS flags,
   const NativeCallStack& stack, NMT_TrackingLevel level) {
@@ -133,7 +200,21 @@ void* MallocTracker::record_malloc(void* malloc_base, size_t size, MEMFLAGS flag
     return malloc_base;
   }
 
-  header = ::new (malloc_base)MallocHeader(size, flags, stack, level);
+  int shift = _sample_shift;
+  if (level == NMT_detail && shift != 0 && flags != mtNMT) {
+    // The callers did not walk the stack (see CURRENT_PC), only pay
+    // for it if this malloc is picked. NMT's own allocations keep their
+    // pre-installed call site to avoid recursing into the site table.
+    if (should_sample(size, shift)) {
+      // Skip this frame and the os::malloc()/os::realloc() frame
+      NativeCallStack sampled_stack(2, NMT_stack_walkable);
+      header = ::new (malloc_base)MallocHeader(size, flags, sampled_stack, level, true, shift);
+    } else {
+      header = ::new (malloc_base)MallocHeader(size, flags, stack, level, false);
+    }
+  } else {
+    header = ::new (malloc_base)MallocHeader(size, flags, stack, level);
+  }
   memblock = (void*)((char*)malloc_base + sizeof(MallocHeader));
 
   // The alignment check: 8 bytes alignment for 32 bit systems.
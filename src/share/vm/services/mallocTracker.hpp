@@ -69,6 +69,25 @@ class MemoryCounter VALUE_OBJ_CLASS_SPEC {
     }
   }
 
+  // Record cnt allocations of sz bytes in total, for scaled samples
+  inline void allocate(size_t sz, size_t cnt) {
+    Atomic::add((MemoryCounterType)cnt, (volatile MemoryCounterType*)&_count);
+    if (sz > 0) {
+      Atomic::add((MemoryCounterType)sz, (volatile MemoryCounterType*)&_size);
+      DEBUG_ONLY(_peak_size = MAX2(_peak_size, _size));
+    }
+    DEBUG_ONLY(_peak_count = MAX2(_peak_count, _count);)
+  }
+
+  inline void deallocate(size_t sz, size_t cnt) {
+    assert(_count >= cnt, "Negative counter");
+    assert(_size >= sz, "Negative size");
+    Atomic::add(-(MemoryCounterType)cnt, (volatile MemoryCounterType*)&_count);
+    if (sz > 0) {
+      Atomic::add(-(MemoryCounterType)sz, (volatile MemoryCounterType*)&_size);
+    }
+  }
+
   inline void resize(long sz) {
     if (sz != 0) {
       Atomic::add((MemoryCounterType)sz, (volatile MemoryCounterType*)&_size);
@@ -235,27 +254,35 @@ class MallocMemorySummary : AllStatic {
  * Malloc tracking header.
  * To satisfy malloc alignment requirement, NMT uses 2 machine words for tracking purpose,
  * which ensures 8-bytes alignment on 32-bit systems and 16-bytes on 64-bit systems (Product build).
+ *
+ * With detail tracking, a bucket index of NO_MALLOCSITE marks a block whose call site was
+ * not recorded, and a non-zero sample shift marks a block recorded as a sample standing for
+ * the allocations of 2^shift bytes on average (see MallocTracker::scale_sample()).
  */
 
 class MallocHeader VALUE_OBJ_CLASS_SPEC {
 #ifdef _LP64
-  size_t           _size      : 64;
-  size_t           _flags     : 8;
-  size_t           _pos_idx   : 16;
-  size_t           _bucket_idx: 40;
-#define MAX_MALLOCSITE_TABLE_SIZE right_n_bits(40)
+  size_t           _size        : 64;
+  size_t           _flags       : 8;
+  size_t           _pos_idx     : 16;
+  size_t           _bucket_idx  : 32;
+  size_t           _sample_shift: 8;
+#define MAX_MALLOCSITE_TABLE_SIZE right_n_bits(32)
 #define MAX_BUCKET_LENGTH         right_n_bits(16)
 #else
-  size_t           _size      : 32;
-  size_t           _flags     : 8;
-  size_t           _pos_idx   : 8;
-  size_t           _bucket_idx: 16;
-#define MAX_MALLOCSITE_TABLE_SIZE  right_n_bits(16)
+  size_t           _size        : 32;
+  size_t           _flags       : 8;
+  size_t           _pos_idx     : 8;
+  size_t           _bucket_idx  : 11;
+  size_t           _sample_shift: 5;
+#define MAX_MALLOCSITE_TABLE_SIZE  right_n_bits(11)
 #define MAX_BUCKET_LENGTH          right_n_bits(8)
 #endif  // _LP64
+#define NO_MALLOCSITE              MAX_MALLOCSITE_TABLE_SIZE
 
  public:
-  MallocHeader(size_t size, MEMFLAGS flags, const NativeCallStack& stack, NMT_TrackingLevel level) {
+  MallocHeader(size_t size, MEMFLAGS flags, const NativeCallStack& stack, NMT_TrackingLevel level,
+               bool record_site = true, int sample_shift = 0) {
     assert(sizeof(MallocHeader) == sizeof(void*) * 2,
       "Wrong header size");
 
@@ -268,8 +295,11 @@ class MallocHeader VALUE_OBJ_CLASS_SPEC {
     if (level == NMT_detail) {
       size_t bucket_idx;
       size_t pos_idx;
-      if (record_malloc_site(stack, size, &bucket_idx, &pos_idx)) {
-        assert(bucket_idx <= MAX_MALLOCSITE_TABLE_SIZE, "Overflow bucket index");
+      _bucket_idx = NO_MALLOCSITE;
+      _pos_idx = 0;
+      _sample_shift = sample_shift;
+      if (record_site && record_malloc_site(stack, size, &bucket_idx, &pos_idx)) {
+        assert(bucket_idx < MAX_MALLOCSITE_TABLE_SIZE, "Overflow bucket index");
         assert(pos_idx <= MAX_BUCKET_LENGTH, "Overflow bucket position index");
         _bucket_idx = bucket_idx;
         _pos_idx = pos_idx;
@@ -282,6 +312,7 @@ class MallocHeader VALUE_OBJ_CLASS_SPEC {
 
   inline size_t   size()  const { return _size; }
   inline MEMFLAGS flags() const { return (MEMFLAGS)_flags; }
+  inline bool     has_malloc_site() const { return _bucket_idx != NO_MALLOCSITE; }
   bool get_stack(NativeCallStack& stack) const;
 
   // Cleanup tracking information before the memory is released.
@@ -298,12 +329,40 @@ class MallocHeader VALUE_OBJ_CLASS_SPEC {
 
 // Main class called from MemTracker to track malloc activities
 class MallocTracker : AllStatic {
+ private:
+  // Detail sampling: when non-zero, only mallocs picked at random
+  // intervals averaging 2^_sample_shift bytes have their call site
+  // recorded, and the site counters are scaled up accordingly.
+  static volatile int _sample_shift;
+  // Countdown for threads the VM does not know about
+  static jlong        _bytes_until_sample;
+
+  enum {
+    max_sample_shift = 30
+  };
+
+  static jlong next_sample_distance(int shift);
+  static bool  should_sample(size_t size, int shift);
+
  public:
   // Initialize malloc tracker for specific tracking level
   static bool initialize(NMT_TrackingLevel level);
 
   static bool transition(NMT_TrackingLevel from, NMT_TrackingLevel to);
 
+  // Set the mean sampling interval in bytes, 0 turns sampling off.
+  // Returns the interval actually used.
+  static size_t set_sample_interval(size_t interval);
+  static size_t sample_interval() {
+    int shift = _sample_shift;
+    return shift == 0 ? 0 : ((size_t)1 << shift);
+  }
+  static inline bool is_sampling() { return _sample_shift != 0; }
+
+  // The estimated number and total size of the allocations that a
+  // sampled malloc of the given size stands for.
+  static void scale_sample(size_t size, int shift, size_t* count, size_t* scaled_size);
+
   // malloc tracking header size for specific tracking level
   static inline size_t malloc_header_size(NMT_TrackingLevel level) {
     return (level == NMT_off) ? 0 : sizeof(MallocHeader);
@@ -181,10 +181,48 @@ void MemDetailReporter::report_detail() {
   outputStream* out = output();
   out->print_cr("Details:\n");
 
+  size_t sample_interval = MallocTracker::sample_interval();
+  if (sample_interval > 0) {
+    out->print_cr("Malloc sites are estimated from allocations sampled every " SIZE_FORMAT
+                  " bytes on average\n", sample_interval);
+  }
+
   report_malloc_sites();
   report_virtual_memory_allocation_sites();
 }
 
+void MemDetailReporter::decode_call_stacks() {
+  // Collect the stacks of the same sites and regions that are reported
+  MallocSiteIterator malloc_itr = _baseline.malloc_sites(MemBaseline::by_size);
+  const MallocSite* malloc_site;
+  while ((malloc_site = malloc_itr.next()) != NULL) {
+    if (amount_in_current_scale(malloc_site->size()) == 0) continue;
+    _stackprinter.collect(malloc_site->call_stack());
+  }
+
+  VirtualMemorySiteIterator virtual_memory_itr = _baseline.virtual_memory_sites(MemBaseline::by_size);
+  const VirtualMemoryAllocationSite* virtual_memory_site;
+  while ((virtual_memory_site = virtual_memory_itr.next()) != NULL) {
+    if (amount_in_current_scale(virtual_memory_site->reserved()) == 0) continue;
+    _stackprinter.collect(virtual_memory_site->call_stack());
+  }
+
+  VirtualMemoryAllocationIterator rgn_itr = _baseline.virtual_memory_allocations();
+  const ReservedMemoryRegion* rgn;
+  while ((rgn = rgn_itr.next()) != NULL) {
+    if (amount_in_current_scale(rgn->size()) == 0) continue;
+    _stackprinter.collect(rgn->call_stack());
+    CommittedRegionIterator committed_itr = rgn->iterate_committed_regions();
+    const CommittedMemoryRegion* committed_rgn;
+    while ((committed_rgn = committed_itr.next()) != NULL) {
+      if (amount_in_current_scale(committed_rgn->size()) == 0) continue;
+      _stackprinter.collect(committed_rgn->call_stack());
+    }
+  }
+
+  _stackprinter.decode_collected();
+}
+
 void MemDetailReporter::report_malloc_sites() {
   MallocSiteIterator         malloc_itr = _baseline.malloc_sites(MemBaseline::by_size);
   if (malloc_itr.is_empty()) return;
@@ -198,7 +236,7 @@ void MemDetailReporter::report_malloc_sites() {
       continue;
 
     const NativeCallStack* stack = malloc_site->call_stack();
-    stack->print_on(out);
+    stack->print_on(out, 0, &_stackprinter);
     out->print("%29s", " ");
     print_malloc(malloc_site->size(), malloc_site->count());
     out->print_cr("\n");
@@ -220,7 +258,7 @@ void MemDetailReporter::report_virtual_memory_allocation_sites()  {
       continue;
 
     const NativeCallStack* stack = virtual_memory_site->call_stack();
-    stack->print_on(out);
+    stack->print_on(out, 0, &_stackprinter);
     out->print("%28s (", " ");
     print_total(virtual_memory_site->reserved(), virtual_memory_site->committed());
     out->print_cr(")\n");
@@ -257,7 +295,7 @@ void MemDetailReporter::report_virtual_memory_region(const ReservedMemoryRegion*
     out->print_cr(" ");
   } else {
     out->print_cr(" from");
-    stack->print_on(out, 4);
+    stack->print_on(out, 4, &_stackprinter);
   }
 
   if (all_committed) return;
@@ -274,7 +312,7 @@ void MemDetailReporter::report_virtual_memory_region(const ReservedMemoryRegion*
       out->print_cr(" ");
     } else {
       out->print_cr(" from");
-      stack->print_on(out, 12);
+      stack->print_on(out, 12, &_stackprinter);
     }
   }
 }
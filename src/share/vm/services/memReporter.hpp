@@ -118,6 +118,8 @@ class MemSummaryReporter : public MemReporterBase {
 class MemDetailReporter : public MemSummaryReporter {
  private:
   MemBaseline&   _baseline;
+  // decodes and caches the call stack frames shared by the report
+  NativeCallStackPrinter _stackprinter;
 
  public:
   MemDetailReporter(MemBaseline& baseline, outputStream* output, size_t scale = K) :
@@ -128,11 +130,14 @@ class MemDetailReporter : public MemSummaryReporter {
   // The report contains summary and detail sections.
   virtual void report() {
     MemSummaryReporter::report();
+    decode_call_stacks();
     report_virtual_memory_map();
     report_detail();
   }
 
  private:
+  // Decode the frames of all call stacks in the report as one batch
+  void decode_call_stacks();
   // Report detail tracking data.
   void report_detail();
   // Report virtual memory map
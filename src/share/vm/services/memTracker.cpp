@@ -319,7 +319,7 @@ void MemTracker::tuning_statistics(outputStream* out) {
   out->print_cr("Native Memory Tracking Statistics:");
   out->print_cr("Malloc allocation site table size: %d", MallocSiteTable::hash_buckets());
   out->print_cr("             Tracking stack depth: %d", NMT_TrackingStackDepth);
-  NOT_PRODUCT(out->print_cr("Peak concurrent access: %d", MallocSiteTable::access_peak_count());)
+  out->print_cr("         Malloc sampling interval: " SIZE_FORMAT, MallocTracker::sample_interval());
   out->print_cr(" ");
   walker.report_statistics(out);
 }
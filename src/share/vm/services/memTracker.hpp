@@ -82,9 +82,13 @@ class MemTracker : AllStatic {
 
 extern volatile bool NMT_stack_walkable;
 
-#define CURRENT_PC ((MemTracker::tracking_level() == NMT_detail && NMT_stack_walkable) ? \
+// When detail tracking samples mallocs, the call stack is only walked
+// for the picked allocations, by MallocTracker::record_malloc().
+#define CURRENT_PC ((MemTracker::tracking_level() == NMT_detail && NMT_stack_walkable && \
+                     !MallocTracker::is_sampling()) ?                                    \
                     NativeCallStack(0, true) : NativeCallStack::EMPTY_STACK)
-#define CALLER_PC  ((MemTracker::tracking_level() == NMT_detail && NMT_stack_walkable) ?  \
+#define CALLER_PC  ((MemTracker::tracking_level() == NMT_detail && NMT_stack_walkable && \
+                     !MallocTracker::is_sampling()) ?                                    \
                     NativeCallStack(1, true) : NativeCallStack::EMPTY_STACK)
 
 class MemBaseline;
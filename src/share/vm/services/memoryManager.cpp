@@ -202,8 +202,18 @@ void GCStatInfo::clear() {
 }
 
 
+const jlong GCMemoryManager::_duration_limits_us[GCMemoryManager::duration_buckets] = {
+  500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+  1000000, 5000000
+};
+
 GCMemoryManager::GCMemoryManager() : MemoryManager() {
   _num_collections = 0;
+  _gc_start_counter = 0;
+  for (int i = 0; i <= duration_buckets; i++) {
+    _duration_counts[i] = 0;
+  }
+  _duration_sum_us = 0;
   _last_gc_stat = NULL;
   _last_gc_lock = new Mutex(Mutex::leaf, "_last_gc_lock", true);
   _current_gc_stat = NULL;
@@ -231,6 +241,7 @@ void GCMemoryManager::gc_begin(bool recordGCBeginTime, bool recordPreGCUsage,
   if (recordAccumulatedGCTime) {
     _accumulated_timer.start();
   }
+  _gc_start_counter = os::elapsed_counter();
   // _num_collections now increases in gc_end, to count completed collections
   if (recordGCBeginTime) {
     _current_gc_stat->set_index(_num_collections+1);
@@ -311,6 +322,8 @@ void GCMemoryManager::gc_end(bool recordPostGCUsage,
 
   if (countCollection) {
     _num_collections++;
+    record_duration((os::elapsed_counter() - _gc_start_counter) * 1000000 /
+                    os::elapsed_frequency());
     // alternately update two objects making one public when complete
     {
       MutexLockerEx ml(_last_gc_lock, Mutex::_no_safepoint_check_flag);
@@ -329,6 +342,15 @@ void GCMemoryManager::gc_end(bool recordPostGCUsage,
   }
 }
 
+void GCMemoryManager::record_duration(jlong duration_us) {
+  int bucket = 0;
+  while (bucket < duration_buckets && duration_us > _duration_limits_us[bucket]) {
+    bucket++;
+  }
+  _duration_counts[bucket]++;
+  _duration_sum_us += duration_us;
+}
+
 size_t GCMemoryManager::get_last_gc_stat(GCStatInfo* dest) {
   MutexLockerEx ml(_last_gc_lock, Mutex::_no_safepoint_check_flag);
   if (_last_gc_stat->gc_index() != 0) {
@@ -177,6 +177,16 @@ private:
   GCStatInfo*  _current_gc_stat;
   int          _num_gc_threads;
   volatile bool _notification_enabled;
+
+  // Histogram of collection durations, read racily by the metrics server.
+  // The last bucket counts collections longer than every limit.
+  enum { duration_buckets = 12 };
+  static const jlong _duration_limits_us[duration_buckets];
+  jlong        _gc_start_counter;
+  size_t       _duration_counts[duration_buckets + 1];
+  jlong        _duration_sum_us;
+
+  void   record_duration(jlong duration_us);
 public:
   GCMemoryManager();
   ~GCMemoryManager();
@@ -200,6 +210,11 @@ public:
   // the collection count. Zero signifies no gc has taken place.
   size_t get_last_gc_stat(GCStatInfo* dest);
 
+  static int   num_duration_buckets()          { return duration_buckets; }
+  static jlong duration_limit_us(int bucket)   { return _duration_limits_us[bucket]; }
+  size_t       duration_count(int bucket)      { return _duration_counts[bucket]; }
+  jlong        duration_sum_us()               { return _duration_sum_us; }
+
   void set_notification_enabled(bool enabled) { _notification_enabled = enabled; }
   bool is_notification_enabled() { return _notification_enabled; }
   virtual MemoryManager::Name kind() = 0;
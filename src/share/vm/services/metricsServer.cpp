@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "compiler/compileBroker.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/java.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "runtime/os.hpp"
+#include "runtime/perfData.hpp"
+#include "services/memoryManager.hpp"
+#include "services/memoryPool.hpp"
+#include "services/memoryService.hpp"
+#include "services/metricsServer.hpp"
+#ifndef TARGET_OS_FAMILY_windows
+# include <netinet/in.h>
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/time.h>
+# include <sys/un.h>
+# include <unistd.h>
+#endif
+
+MetricsServer* MetricsServer::_server = NULL;
+volatile bool  MetricsServer::_should_terminate = false;
+Mutex*         MetricsServer::_render_lock = NULL;
+int            MetricsServer::_listen_fd = -1;
+
+// Requests larger than this are rejected; a scrape is a single GET line
+// plus a few headers.
+static const size_t max_request_size = 4 * K;
+
+MetricsServer::MetricsServer() : NamedThread() {
+  set_name("VM Metrics Server");
+}
+
+int MetricsServer::open_unix_socket(const char* path) {
+#ifdef TARGET_OS_FAMILY_windows
+  warning("MetricsServerPath is not supported on this platform");
+  return -1;
+#else
+  struct sockaddr_un addr;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    warning("MetricsServerPath is too long: %s", path);
+    return -1;
+  }
+  int fd = os::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == -1) {
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  // Remove a stale socket left behind by a previous VM, but never
+  // anything else the user may have at that path.
+  struct stat st;
+  if (::stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+    ::unlink(path);
+  }
+  if (os::bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1) {
+    os::socket_close(fd);
+    return -1;
+  }
+  // only the owner of the VM may read its metrics
+  ::chmod(path, S_IREAD|S_IWRITE);
+  if (os::listen(fd, 5) == -1) {
+    os::socket_close(fd);
+    ::unlink(path);
+    return -1;
+  }
+  return fd;
+#endif
+}
+
+int MetricsServer::open_tcp_socket(uintx port) {
+  if (port > 65535) {
+    warning("MetricsServerPort out of range: " UINTX_FORMAT, port);
+    return -1;
+  }
+  int fd = os::socket(AF_INET, SOCK_STREAM, 0);
+  if (fd == -1) {
+    return -1;
+  }
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons((u_short)port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (os::bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1 ||
+      os::listen(fd, 5) == -1) {
+    os::socket_close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+void MetricsServer::initialize() {
+  if (MetricsServerPath == NULL && MetricsServerPort == 0) {
+    return;
+  }
+  if (MetricsServerPath != NULL) {
+    _listen_fd = open_unix_socket(MetricsServerPath);
+  } else {
+    _listen_fd = open_tcp_socket(MetricsServerPort);
+  }
+  if (_listen_fd == -1) {
+    warning("Could not start the metrics server");
+    return;
+  }
+
+  _render_lock = new Mutex(Mutex::leaf, "MetricsServer_lock", true);
+  MetricsServer* server = new MetricsServer();
+  if (os::create_thread(server, os::os_thread)) {
+    _server = server;
+    os::set_priority(server, MinPriority);
+    if (!DisableStartThread) {
+      os::start_thread(server);
+    }
+  } else {
+    warning("Could not create the metrics server thread");
+    os::socket_close(_listen_fd);
+    _listen_fd = -1;
+  }
+}
+
+void MetricsServer::stop() {
+  if (_server == NULL) {
+    return;
+  }
+  _should_terminate = true;
+  OrderAccess::fence();
+  // wakes up the server thread blocked in accept()
+  os::socket_shutdown(_listen_fd, 2);
+
+  // The PerfData memory must stay valid while a request is being
+  // rendered. Wait for a scrape that holds the lock; any later one sees
+  // _should_terminate under the lock and renders nothing.
+  {
+    MutexLockerEx ml(_render_lock, Mutex::_no_safepoint_check_flag);
+  }
+#ifndef TARGET_OS_FAMILY_windows
+  if (MetricsServerPath != NULL) {
+    ::unlink(MetricsServerPath);
+  }
+#endif
+}
+
+void MetricsServer::run() {
+  this->record_stack_base_and_size();
+  this->initialize_thread_local_storage();
+
+  while (!_should_terminate) {
+    int fd = os::accept(_listen_fd, NULL, NULL);
+    if (fd == -1) {
+      if (!_should_terminate) {
+        // transient failure such as running out of descriptors
+        os::naked_short_sleep(10);
+      }
+      continue;
+    }
+    if (!_should_terminate) {
+      handle_request(fd);
+    }
+    os::socket_close(fd);
+  }
+  os::socket_close(_listen_fd);
+}
+
+static void send_fully(int fd, const char* buf, size_t len) {
+  while (len > 0) {
+    int n = os::send(fd, (char*)buf, len, 0);
+    if (n <= 0) {
+      return;
+    }
+    buf += n;
+    len -= n;
+  }
+}
+
+void MetricsServer::handle_request(int fd) {
+#ifndef TARGET_OS_FAMILY_windows
+  // a client that connects and never sends must not stall later scrapes
+  struct timeval tv;
+  tv.tv_sec = 2;
+  tv.tv_usec = 0;
+  ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, (char*)&tv, sizeof(tv));
+#endif
+
+  char request[max_request_size + 1];
+  size_t len = 0;
+  while (len < max_request_size) {
+    int n = os::recv(fd, request + len, max_request_size - len, 0);
+    if (n <= 0) {
+      break;
+    }
+    len += n;
+    request[len] = '\0';
+    if (strstr(request, "\r\n\r\n") != NULL || strstr(request, "\n\n") != NULL) {
+      break;
+    }
+  }
+  request[len] = '\0';
+
+  const char* status;
+  bufferedStream body(32 * K, 4 * M);
+  if (strncmp(request, "GET ", 4) != 0) {
+    status = "405 Method Not Allowed";
+  } else if (strncmp(request + 4, "/ ", 2) == 0 ||
+             strncmp(request + 4, "/metrics ", 9) == 0 ||
+             strncmp(request + 4, "/metrics\r", 9) == 0) {
+    // Only the rendering reads VM data; the response is sent from the
+    // buffer after the lock is released.
+    MutexLockerEx ml(_render_lock, Mutex::_no_safepoint_check_flag);
+    if (_should_terminate) {
+      status = "503 Service Unavailable";
+    } else {
+      status = "200 OK";
+      print_metrics(&body);
+    }
+  } else {
+    status = "404 Not Found";
+  }
+
+  char header[256];
+  int hlen = jio_snprintf(header, sizeof(header),
+                          "HTTP/1.0 %s\r\n"
+                          "Content-Type: text/plain; version=0.0.4\r\n"
+                          "Content-Length: " SIZE_FORMAT "\r\n"
+                          "Connection: close\r\n"
+                          "\r\n",
+                          status, body.size());
+  send_fully(fd, header, hlen);
+  send_fully(fd, body.base(), body.size());
+}
+
+// Metric names may only contain [a-zA-Z0-9_:]
+static void print_metric_name(outputStream* st, const char* prefix, const char* name) {
+  st->print("%s", prefix);
+  for (const char* p = name; *p != '\0'; p++) {
+    char c = *p;
+    bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                 (c >= '0' && c <= '9') || c == '_' || c == ':';
+    st->put(valid ? c : '_');
+  }
+}
+
+static void print_label_value(outputStream* st, const char* value) {
+  st->put('"');
+  for (const char* p = value; *p != '\0'; p++) {
+    if (*p == '"' || *p == '\\') {
+      st->put('\\');
+    } else if (*p == '\n') {
+      st->print("\\n");
+      continue;
+    }
+    st->put(*p);
+  }
+  st->put('"');
+}
+
+void MetricsServer::print_perf_data(outputStream* st) {
+  if (!UsePerfData) {
+    return;
+  }
+  PerfDataList* list = PerfDataManager::all();
+  if (list == NULL) {
+    return;
+  }
+  for (int i = 0; i < list->length(); i++) {
+    PerfData* p = list->at(i);
+    // everything that is not a string is a single jlong
+    if (!p->is_valid() || p->units() == PerfData::U_String) {
+      continue;
+    }
+    const char* type = p->variability() == PerfData::V_Monotonic ? "counter" : "gauge";
+    st->print("# TYPE ");
+    print_metric_name(st, "hsperf_", p->name());
+    st->print_cr(" %s", type);
+    print_metric_name(st, "hsperf_", p->name());
+    st->print_cr(" " JLONG_FORMAT, *(jlong*)p->get_address());
+  }
+  delete list;
+}
+
+void MetricsServer::print_memory_pools(outputStream* st) {
+  static const char* const kinds[] = { "used", "committed", "max" };
+  for (int k = 0; k < 3; k++) {
+    st->print_cr("# TYPE jvm_memory_pool_%s_bytes gauge", kinds[k]);
+    for (int i = 0; i < MemoryService::num_memory_pools(); i++) {
+      MemoryPool* pool = MemoryService::get_memory_pool(i);
+      MemoryUsage usage = pool->get_memory_usage();
+      size_t value = k == 0 ? usage.used() : k == 1 ? usage.committed() : usage.max_size();
+      if (value == (size_t)-1) {
+        continue;   // undefined maximum
+      }
+      st->print("jvm_memory_pool_%s_bytes{pool=", kinds[k]);
+      print_label_value(st, pool->name());
+      st->print_cr("} " SIZE_FORMAT, value);
+    }
+  }
+}
+
+void MetricsServer::print_gc_durations(outputStream* st) {
+  st->print_cr("# TYPE jvm_gc_collection_seconds histogram");
+  for (int i = 0; i < MemoryService::num_memory_managers(); i++) {
+    MemoryManager* mgr = MemoryService::get_memory_manager(i);
+    if (!mgr->is_gc_memory_manager()) {
+      continue;
+    }
+    GCMemoryManager* gc = (GCMemoryManager*)mgr;
+    // The counts are updated without synchronization; summing them here
+    // keeps the exported buckets cumulative and consistent with _count.
+    size_t cumulative = 0;
+    for (int b = 0; b <= GCMemoryManager::num_duration_buckets(); b++) {
+      cumulative += gc->duration_count(b);
+      st->print("jvm_gc_collection_seconds_bucket{gc=");
+      print_label_value(st, gc->name());
+      if (b < GCMemoryManager::num_duration_buckets()) {
+        st->print_cr(",le=\"%g\"} " SIZE_FORMAT,
+                     GCMemoryManager::duration_limit_us(b) / 1000000.0, cumulative);
+      } else {
+        st->print_cr(",le=\"+Inf\"} " SIZE_FORMAT, cumulative);
+      }
+    }
+    st->print("jvm_gc_collection_seconds_sum{gc=");
+    print_label_value(st, gc->name());
+    st->print_cr("} %.6f", gc->duration_sum_us() / 1000000.0);
+    st->print("jvm_gc_collection_seconds_count{gc=");
+    print_label_value(st, gc->name());
+    st->print_cr("} " SIZE_FORMAT, cumulative);
+  }
+}
+
+void MetricsServer::print_compiler(outputStream* st) {
+  st->print_cr("# TYPE jvm_compiler_compilations_total counter");
+  st->print_cr("jvm_compiler_compilations_total %d", CompileBroker::get_total_compile_count());
+  st->print_cr("# TYPE jvm_compiler_bailouts_total counter");
+  st->print_cr("jvm_compiler_bailouts_total %d", CompileBroker::get_total_bailout_count());
+  st->print_cr("# TYPE jvm_compiler_invalidations_total counter");
+  st->print_cr("jvm_compiler_invalidations_total %d", CompileBroker::get_total_invalidated_count());
+  st->print_cr("# TYPE jvm_compiler_nmethod_code_bytes_total counter");
+  st->print_cr("jvm_compiler_nmethod_code_bytes_total %d", CompileBroker::get_sum_nmethod_code_size());
+  st->print_cr("# TYPE jvm_compiler_compilation_seconds_total counter");
+  st->print_cr("jvm_compiler_compilation_seconds_total %.3f",
+               CompileBroker::get_total_compilation_time() / 1000.0);
+}
+
+void MetricsServer::print_metrics(outputStream* st) {
+  print_memory_pools(st);
+  print_gc_durations(st);
+  print_compiler(st);
+  print_perf_data(st);
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#ifndef SHARE_VM_SERVICES_METRICSSERVER_HPP
+#define SHARE_VM_SERVICES_METRICSSERVER_HPP
+
+#include "runtime/thread.hpp"
+#include "utilities/ostream.hpp"
+
+// The MetricsServer is a non-Java thread which answers HTTP GET requests
+// with a snapshot of the VM's counters in the Prometheus text exposition
+// format. It listens on a UNIX domain socket (-XX:MetricsServerPath) or on
+// a loopback TCP port (-XX:MetricsServerPort); the socket path wins when
+// both are given.
+//
+// A scrape reads the PerfData memory, the memory pool usage, the collection
+// duration histograms of the GC memory managers and the compiler totals
+// directly. None of these require a safepoint or a Java thread, so serving
+// a request never interferes with the application.
+
+class MetricsServer : public NamedThread {
+ private:
+  static MetricsServer* _server;
+  static volatile bool  _should_terminate;
+  static Mutex*         _render_lock;    // held while a scrape reads VM data
+  static int            _listen_fd;
+
+  MetricsServer();
+
+  static int  open_unix_socket(const char* path);
+  static int  open_tcp_socket(uintx port);
+  static void handle_request(int fd);
+
+  static void print_perf_data(outputStream* st);
+  static void print_memory_pools(outputStream* st);
+  static void print_gc_durations(outputStream* st);
+  static void print_compiler(outputStream* st);
+
+ public:
+  // Start the server if either flag is set. Failure to open a socket is
+  // reported as a warning and does not prevent the VM from starting.
+  static void initialize();
+
+  // Close the sockets and wait until no request reads VM data. No request
+  // reads any after this returns.
+  static void stop();
+
+  // Print all metrics in the exposition format.
+  static void print_metrics(outputStream* st);
+
+  void run();
+};
+
+#endif // SHARE_VM_SERVICES_METRICSSERVER_HPP
@@ -53,6 +53,10 @@ NMTDCmd::NMTDCmd(outputStream* output,
             "BOOLEAN", false, "false"),
   _statistics("statistics", "print tracker statistics for tuning purpose.", \
             "BOOLEAN", false, "false"),
+  _sample_interval("sample_interval", "with detail tracking, only record the " \
+            "call sites of mallocs sampled on average once per this many bytes " \
+            "and scale the site totals, 0 records every malloc.",
+            "MEMORY SIZE", false, "0"),
   _scale("scale", "Memory usage in which scale, KB, MB or GB",
        "STRING", false, "KB") {
   _dcmdparser.add_dcmd_option(&_summary);
@@ -62,6 +66,7 @@ NMTDCmd::NMTDCmd(outputStream* output,
   _dcmdparser.add_dcmd_option(&_detail_diff);
   _dcmdparser.add_dcmd_option(&_shutdown);
   _dcmdparser.add_dcmd_option(&_statistics);
+  _dcmdparser.add_dcmd_option(&_sample_interval);
   _dcmdparser.add_dcmd_option(&_scale);
 }
 
@@ -97,10 +102,12 @@ void NMTDCmd::execute(DCmdSource source, TRAPS) {
   if (_detail_diff.is_set() && _detail_diff.value()) { ++nopt; }
   if (_shutdown.is_set() && _shutdown.value()) { ++nopt; }
   if (_statistics.is_set() && _statistics.value()) { ++nopt; }
+  if (_sample_interval.is_set()) { ++nopt; }
 
   if (nopt > 1) {
       output()->print_cr("At most one of the following option can be specified: " \
-        "summary, detail, baseline, summary.diff, detail.diff, shutdown");
+        "summary, detail, baseline, summary.diff, detail.diff, shutdown, " \
+        "statistics, sample_interval");
       return;
   } else if (nopt == 0) {
     if (_summary.is_set()) {
@@ -152,6 +159,15 @@ void NMTDCmd::execute(DCmdSource source, TRAPS) {
     if (check_detail_tracking_level(output())) {
       MemTracker::tuning_statistics(output());
     }
+  } else if (_sample_interval.is_set()) {
+    if (check_detail_tracking_level(output())) {
+      size_t interval = MallocTracker::set_sample_interval((size_t)_sample_interval.value()._size);
+      if (interval == 0) {
+        output()->print_cr("Recording the call site of every malloc");
+      } else {
+        output()->print_cr("Sampling malloc call sites every " SIZE_FORMAT " bytes on average", interval);
+      }
+    }
   } else {
     ShouldNotReachHere();
     output()->print_cr("Unknown command");
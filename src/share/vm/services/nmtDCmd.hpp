@@ -44,6 +44,7 @@ class NMTDCmd: public DCmdWithParser {
   DCmdArgument<bool>  _detail_diff;
   DCmdArgument<bool>  _shutdown;
   DCmdArgument<bool>  _statistics;
+  DCmdArgument<MemorySizeArgument> _sample_interval;
   DCmdArgument<char*> _scale;
 
  public:
@@ -24,6 +24,7 @@
 
 #include "precompiled.hpp"
 #include "memory/allocation.inline.hpp"
+#include "runtime/os.hpp"
 #include "utilities/bitMap.inline.hpp"
 #include "utilities/copy.hpp"
 #ifdef TARGET_OS_FAMILY_linux
@@ -42,6 +43,92 @@
 # include "os_bsd.inline.hpp"
 #endif
 
+typedef BitMap::idx_t     idx_t;
+typedef BitMap::bm_word_t bm_word_t;
+
+// Portable kernels of the bulk operations.  The loops avoid early exits and
+// accumulate the changed bits instead of branching, so that compilers can
+// vectorize them.
+
+static bool union_words(bm_word_t* dst, const bm_word_t* src, idx_t words) {
+  bm_word_t changed = 0;
+  for (idx_t i = 0; i < words; i++) {
+    bm_word_t orig = dst[i];
+    bm_word_t temp = orig | src[i];
+    changed |= temp ^ orig;
+    dst[i] = temp;
+  }
+  return changed != 0;
+}
+
+static bool intersection_words(bm_word_t* dst, const bm_word_t* src, idx_t words) {
+  bm_word_t changed = 0;
+  for (idx_t i = 0; i < words; i++) {
+    bm_word_t orig = dst[i];
+    bm_word_t temp = orig & src[i];
+    changed |= temp ^ orig;
+    dst[i] = temp;
+  }
+  return changed != 0;
+}
+
+static bool difference_words(bm_word_t* dst, const bm_word_t* src, idx_t words) {
+  bm_word_t changed = 0;
+  for (idx_t i = 0; i < words; i++) {
+    bm_word_t orig = dst[i];
+    bm_word_t temp = orig & ~src[i];
+    changed |= temp ^ orig;
+    dst[i] = temp;
+  }
+  return changed != 0;
+}
+
+static bool same_words(const bm_word_t* a, const bm_word_t* b, idx_t words) {
+  for (idx_t i = 0; i < words; i++) {
+    if (a[i] != b[i]) return false;
+  }
+  return true;
+}
+
+// Count the one bits of a word with shifts and masks, which needs no table
+// and works on all words in parallel.
+static inline idx_t population_count(bm_word_t w) {
+  const bm_word_t all  = ~(bm_word_t)0;
+  const bm_word_t m1   = all / 3;          // 0x5555...
+  const bm_word_t m2   = all / 15 * 3;     // 0x3333...
+  const bm_word_t m4   = all / 255 * 15;   // 0x0f0f...
+  const bm_word_t h01  = all / 255;        // 0x0101...
+  w = w - ((w >> 1) & m1);
+  w = (w & m2) + ((w >> 2) & m2);
+  w = (w + (w >> 4)) & m4;
+  return (idx_t)((w * h01) >> (BitsPerWord - BitsPerByte));
+}
+
+static idx_t count_one_bits_in_words(const bm_word_t* map, idx_t words) {
+  idx_t sum = 0;
+  for (idx_t i = 0; i < words; i++) {
+    sum += population_count(map[i]);
+  }
+  return sum;
+}
+
+const BitMap::Kernels BitMap::_portable_kernels = {
+  union_words,
+  intersection_words,
+  difference_words,
+  same_words,
+  count_one_bits_in_words
+};
+
+BitMap::Kernels BitMap::_kernels = BitMap::_portable_kernels;
+
+void BitMap::initialize_kernels() {
+  X86_ONLY(pd_initialize_kernels(&_kernels);)
+}
+
+void bitMap_init() {
+  BitMap::initialize_kernels();
+}
 
 BitMap::BitMap(bm_word_t* map, idx_t size_in_bits) :
   _map(map), _size(size_in_bits), _map_allocator(false)
@@ -154,6 +241,16 @@ void BitMap::clear_range(idx_t beg, idx_t end) {
   }
 }
 
+// Whole-word fills go through Copy, which may use streaming stores for
+// ranges large enough that caching them would only evict other data.
+void BitMap::set_large_range_of_words(idx_t beg, idx_t end) {
+  Copy::fill_to_words((HeapWord*)(_map + beg), end - beg, ~(juint)0);
+}
+
+void BitMap::clear_large_range_of_words(idx_t beg, idx_t end) {
+  Copy::zero_to_words((HeapWord*)(_map + beg), end - beg);
+}
+
 void BitMap::set_large_range(idx_t beg, idx_t end) {
   verify_range(beg, end);
 
@@ -282,7 +379,7 @@ bool BitMap::contains(const BitMap other) const {
   bm_word_t* dest_map = map();
   bm_word_t* other_map = other.map();
   idx_t size = size_in_words();
-  for (idx_t index = 0; index < size_in_words(); index++) {
+  for (idx_t index = 0; index < size; index++) {
     bm_word_t word_union = dest_map[index] | other_map[index];
     // If this has more bits set than dest_map[index], then other is not a
     // subset.
@@ -296,7 +393,7 @@ bool BitMap::intersects(const BitMap other) const {
   bm_word_t* dest_map = map();
   bm_word_t* other_map = other.map();
   idx_t size = size_in_words();
-  for (idx_t index = 0; index < size_in_words(); index++) {
+  for (idx_t index = 0; index < size; index++) {
     if ((dest_map[index] & other_map[index]) != 0) return true;
   }
   // Otherwise, no intersection.
@@ -305,34 +402,19 @@ bool BitMap::intersects(const BitMap other) const {
 
 void BitMap::set_union(BitMap other) {
   assert(size() == other.size(), "must have same size");
-  bm_word_t* dest_map = map();
-  bm_word_t* other_map = other.map();
-  idx_t size = size_in_words();
-  for (idx_t index = 0; index < size_in_words(); index++) {
-    dest_map[index] = dest_map[index] | other_map[index];
-  }
+  _kernels.set_union(map(), other.map(), size_in_words());
 }
 
 
 void BitMap::set_difference(BitMap other) {
   assert(size() == other.size(), "must have same size");
-  bm_word_t* dest_map = map();
-  bm_word_t* other_map = other.map();
-  idx_t size = size_in_words();
-  for (idx_t index = 0; index < size_in_words(); index++) {
-    dest_map[index] = dest_map[index] & ~(other_map[index]);
-  }
+  _kernels.set_difference(map(), other.map(), size_in_words());
 }
 
 
 void BitMap::set_intersection(BitMap other) {
   assert(size() == other.size(), "must have same size");
-  bm_word_t* dest_map = map();
-  bm_word_t* other_map = other.map();
-  idx_t size = size_in_words();
-  for (idx_t index = 0; index < size; index++) {
-    dest_map[index]  = dest_map[index] & other_map[index];
-  }
+  _kernels.set_intersection(map(), other.map(), size_in_words());
 }
 
 
@@ -353,47 +435,19 @@ void BitMap::set_intersection_at_offset(BitMap other, idx_t offset) {
 
 bool BitMap::set_union_with_result(BitMap other) {
   assert(size() == other.size(), "must have same size");
-  bool changed = false;
-  bm_word_t* dest_map = map();
-  bm_word_t* other_map = other.map();
-  idx_t size = size_in_words();
-  for (idx_t index = 0; index < size; index++) {
-    idx_t temp = map(index) | other_map[index];
-    changed = changed || (temp != map(index));
-    map()[index] = temp;
-  }
-  return changed;
+  return _kernels.set_union(map(), other.map(), size_in_words());
 }
 
 
 bool BitMap::set_difference_with_result(BitMap other) {
   assert(size() == other.size(), "must have same size");
-  bool changed = false;
-  bm_word_t* dest_map = map();
-  bm_word_t* other_map = other.map();
-  idx_t size = size_in_words();
-  for (idx_t index = 0; index < size; index++) {
-    bm_word_t temp = dest_map[index] & ~(other_map[index]);
-    changed = changed || (temp != dest_map[index]);
-    dest_map[index] = temp;
-  }
-  return changed;
+  return _kernels.set_difference(map(), other.map(), size_in_words());
 }
 
 
 bool BitMap::set_intersection_with_result(BitMap other) {
   assert(size() == other.size(), "must have same size");
-  bool changed = false;
-  bm_word_t* dest_map = map();
-  bm_word_t* other_map = other.map();
-  idx_t size = size_in_words();
-  for (idx_t index = 0; index < size; index++) {
-    bm_word_t orig = dest_map[index];
-    bm_word_t temp = orig & other_map[index];
-    changed = changed || (temp != orig);
-    dest_map[index]  = temp;
-  }
-  return changed;
+  return _kernels.set_intersection(map(), other.map(), size_in_words());
 }
 
 
@@ -410,13 +464,7 @@ void BitMap::set_from(BitMap other) {
 
 bool BitMap::is_same(BitMap other) {
   assert(size() == other.size(), "must have same size");
-  bm_word_t* dest_map = map();
-  bm_word_t* other_map = other.map();
-  idx_t size = size_in_words();
-  for (idx_t index = 0; index < size; index++) {
-    if (dest_map[index] != other_map[index]) return false;
-  }
-  return true;
+  return _kernels.is_same(map(), other.map(), size_in_words());
 }
 
 bool BitMap::is_full() const {
@@ -457,68 +505,23 @@ bool BitMap::iterate(BitMapClosure* blk, idx_t leftOffset, idx_t rightOffset) {
        offset < rightOffset && index < endIndex;
        offset = (++index) << LogBitsPerWord) {
     idx_t rest = map(index) >> (offset & (BitsPerWord - 1));
-    for (; offset < rightOffset && rest != (bm_word_t)NoBits; offset++) {
-      if (rest & 1) {
-        if (!blk->do_bit(offset)) return false;
-        //  resample at each closure application
-        // (see, for instance, CMS bug 4525989)
-        rest = map(index) >> (offset & (BitsPerWord -1));
-      }
-      rest = rest >> 1;
+    while (offset < rightOffset && rest != (bm_word_t)NoBits) {
+      // skip to the next 1-bit
+      unsigned zeros = count_trailing_zeros(rest);
+      offset += zeros;
+      if (offset >= rightOffset) break;
+      if (!blk->do_bit(offset)) return false;
+      //  resample at each closure application
+      // (see, for instance, CMS bug 4525989)
+      rest = (map(index) >> (offset & (BitsPerWord -1))) >> 1;
+      offset++;
     }
   }
   return true;
 }
 
-BitMap::idx_t* BitMap::_pop_count_table = NULL;
-
-void BitMap::init_pop_count_table() {
-  if (_pop_count_table == NULL) {
-    BitMap::idx_t *table = NEW_C_HEAP_ARRAY(idx_t, 256, mtInternal);
-    for (uint i = 0; i < 256; i++) {
-      table[i] = num_set_bits(i);
-    }
-
-    intptr_t res = Atomic::cmpxchg_ptr((intptr_t)  table,
-                                       (intptr_t*) &_pop_count_table,
-                                       (intptr_t)  NULL_WORD);
-    if (res != NULL_WORD) {
-      guarantee( _pop_count_table == (void*) res, "invariant" );
-      FREE_C_HEAP_ARRAY(bm_word_t, table, mtInternal);
-    }
-  }
-}
-
-BitMap::idx_t BitMap::num_set_bits(bm_word_t w) {
-  idx_t bits = 0;
-
-  while (w != 0) {
-    while ((w & 1) == 0) {
-      w >>= 1;
-    }
-    bits++;
-    w >>= 1;
-  }
-  return bits;
-}
-
-BitMap::idx_t BitMap::num_set_bits_from_table(unsigned char c) {
-  assert(_pop_count_table != NULL, "precondition");
-  return _pop_count_table[c];
-}
-
 BitMap::idx_t BitMap::count_one_bits() const {
-  init_pop_count_table(); // If necessary.
-  idx_t sum = 0;
-  typedef unsigned char uchar;
-  for (idx_t i = 0; i < size_in_words(); i++) {
-    bm_word_t w = map()[i];
-    for (size_t j = 0; j < sizeof(bm_word_t); j++) {
-      sum += num_set_bits_from_table(uchar(w & 255));
-      w >>= 8;
-    }
-  }
-  return sum;
+  return _kernels.count_one_bits(map(), size_in_words());
 }
 
 void BitMap::print_on_error(outputStream* st, const char* prefix) const {
@@ -551,3 +554,205 @@ BitMap2D::BitMap2D(idx_t size_in_slots, idx_t bits_per_slot)
   , _map(size_in_slots * bits_per_slot)
 {
 }
+
+#ifndef PRODUCT
+
+// Checks the kernels in use against the portable kernels, and the find-next
+// primitives against a scan bit by bit, on bitmaps of different densities.
+// With -XX:+VerboseInternalVMTests the kernels are also timed, which makes
+// this a microbenchmark of the bulk operations.
+class TestBitMap : AllStatic {
+  // The size of the mark bitmap of a 128M heap, in words on 64 bit.
+  static const idx_t words = 32 * K;
+  static const int   repetitions = 100;
+
+  static julong _seed;
+
+  static julong next_random() {
+    // xorshift64
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 7;
+    _seed ^= _seed << 17;
+    return _seed;
+  }
+
+  // Sets one bit in 'one_in' on average, no bit for 0.
+  static void fill(bm_word_t* map, idx_t words, uint one_in) {
+    for (idx_t i = 0; i < words; i++) {
+      bm_word_t w = 0;
+      for (uint bit = 0; one_in != 0 && bit < (uint)BitsPerWord; bit++) {
+        if (next_random() % one_in == 0) {
+          w |= (bm_word_t)1 << bit;
+        }
+      }
+      map[i] = w;
+    }
+  }
+
+  static void copy(bm_word_t* dst, const bm_word_t* src, idx_t words) {
+    for (idx_t i = 0; i < words; i++) {
+      dst[i] = src[i];
+    }
+  }
+
+  static const char* combine_name(int op) {
+    return op == 0 ? "union" : (op == 1 ? "intersection" : "difference");
+  }
+
+  static bool combine(const BitMap::Kernels& k, int op, bm_word_t* dst, const bm_word_t* src, idx_t n) {
+    switch (op) {
+      case 0:  return k.set_union(dst, src, n);
+      case 1:  return k.set_intersection(dst, src, n);
+      default: return k.set_difference(dst, src, n);
+    }
+  }
+
+  static void test_kernels(bm_word_t* a, bm_word_t* b, bm_word_t* c1, bm_word_t* c2) {
+    const BitMap::Kernels& k = BitMap::kernels();
+    const BitMap::Kernels& p = BitMap::portable_kernels();
+
+    // Odd lengths and misaligned starts exercise the scalar tails.
+    idx_t starts[]  = { 0, 1, 3 };
+    idx_t lengths[] = { words, words - 5, 7, 1, 0 };
+    for (uint s = 0; s < ARRAY_SIZE(starts); s++) {
+      for (uint l = 0; l < ARRAY_SIZE(lengths); l++) {
+        idx_t n = MIN2(lengths[l], words - starts[s]);
+        const bm_word_t* src = b + starts[s];
+
+        assert(k.count_one_bits(a + starts[s], n) == p.count_one_bits(a + starts[s], n),
+               "count_one_bits differs");
+        assert(k.is_same(a, src, n) == p.is_same(a, src, n), "is_same differs");
+        copy(c1, src, n);
+        assert(k.is_same(c1, src, n), "must be same");
+        if (n > 0) {
+          c1[n - 1] ^= 1;
+          assert(!k.is_same(c1, src, n), "must differ in the last word");
+        }
+
+        for (int op = 0; op < 3; op++) {
+          copy(c1, a, n);
+          copy(c2, a, n);
+          bool r1 = combine(k, op, c1, src, n);
+          bool r2 = combine(p, op, c2, src, n);
+          assert(r1 == r2, err_msg("%s: result differs", combine_name(op)));
+          assert(p.is_same(c1, c2, n), err_msg("%s: words differ", combine_name(op)));
+          // A second application changes nothing.
+          assert(!combine(k, op, c1, src, n), err_msg("%s: must be idempotent", combine_name(op)));
+        }
+      }
+    }
+  }
+
+  class CountClosure : public BitMapClosure {
+   public:
+    idx_t _count;
+    idx_t _last;
+    CountClosure() : _count(0), _last(0) { }
+    bool do_bit(idx_t offset) {
+      assert(_count == 0 || offset > _last, "must be increasing");
+      _count++;
+      _last = offset;
+      return true;
+    }
+  };
+
+  static void test_find(bm_word_t* a) {
+    BitMap map(a, words * BitsPerWord);
+    idx_t size = map.size();
+
+    for (int i = 0; i < 1000; i++) {
+      idx_t l = (idx_t)(next_random() % size);
+      idx_t r = l + (idx_t)(next_random() % MIN2(size - l, (idx_t)(4 * BitsPerWord)));
+      idx_t one = l;
+      while (one < r && !map.at(one)) one++;
+      idx_t zero = l;
+      while (zero < r && map.at(zero)) zero++;
+      assert(map.get_next_one_offset(l, r) == one, "get_next_one_offset");
+      assert(map.get_next_zero_offset(l, r) == zero, "get_next_zero_offset");
+
+      idx_t aligned_r = BitMap::word_align_up(r);
+      while (one < aligned_r && !map.at(one)) one++;
+      assert(map.get_next_one_offset_inline_aligned_right(l, aligned_r) == one,
+             "get_next_one_offset_inline_aligned_right");
+    }
+
+    CountClosure cl;
+    map.iterate(&cl);
+    assert(cl._count == map.count_one_bits(), "iterate must visit all bits");
+  }
+
+  static double nanos_per_word(jlong start) {
+    return (double)(os::javaTimeNanos() - start) / ((double)words * repetitions);
+  }
+
+  static void benchmark(const BitMap::Kernels& k, const char* name, uint one_in,
+                        bm_word_t* a, bm_word_t* b, bm_word_t* c) {
+    volatile idx_t sink = 0;
+    tty->print("  %-8s 1/%-5u", name, one_in);
+    for (int op = 0; op < 3; op++) {
+      copy(c, a, words);
+      jlong start = os::javaTimeNanos();
+      for (int i = 0; i < repetitions; i++) {
+        sink += combine(k, op, c, b, words);
+      }
+      tty->print(" %s %.3f", combine_name(op), nanos_per_word(start));
+    }
+    jlong start = os::javaTimeNanos();
+    for (int i = 0; i < repetitions; i++) {
+      sink += k.is_same(a, a, words);
+    }
+    tty->print(" is_same %.3f", nanos_per_word(start));
+    start = os::javaTimeNanos();
+    for (int i = 0; i < repetitions; i++) {
+      sink += k.count_one_bits(a, words);
+    }
+    tty->print(" count_one_bits %.3f", nanos_per_word(start));
+
+    BitMap map(a, words * BitsPerWord);
+    start = os::javaTimeNanos();
+    for (int i = 0; i < repetitions; i++) {
+      for (idx_t bit = map.get_next_one_offset(0); bit < map.size(); bit = map.get_next_one_offset(bit + 1)) {
+        sink += bit;
+      }
+    }
+    tty->print_cr(" get_next_one_offset %.3f ns/word", nanos_per_word(start));
+  }
+
+ public:
+  static void test() {
+    // From empty over the sparse marking bitmaps to dense live data.
+    const uint densities[] = { 0, 4096, 256, 16, 2, 1 };
+
+    bm_word_t* a  = NEW_C_HEAP_ARRAY(bm_word_t, words, mtInternal);
+    bm_word_t* b  = NEW_C_HEAP_ARRAY(bm_word_t, words, mtInternal);
+    bm_word_t* c1 = NEW_C_HEAP_ARRAY(bm_word_t, words, mtInternal);
+    bm_word_t* c2 = NEW_C_HEAP_ARRAY(bm_word_t, words, mtInternal);
+
+    if (VerboseInternalVMTests) {
+      tty->print_cr("BitMap kernels, ns/word over " SIZE_FORMAT " words:", words);
+    }
+    for (uint d = 0; d < ARRAY_SIZE(densities); d++) {
+      fill(a, words, densities[d]);
+      fill(b, words, densities[d]);
+      test_kernels(a, b, c1, c2);
+      test_find(a);
+      if (VerboseInternalVMTests) {
+        benchmark(BitMap::portable_kernels(), "portable", densities[d], a, b, c1);
+        benchmark(BitMap::kernels(),          "in use",   densities[d], a, b, c1);
+      }
+    }
+
+    FREE_C_HEAP_ARRAY(bm_word_t, a, mtInternal);
+    FREE_C_HEAP_ARRAY(bm_word_t, b, mtInternal);
+    FREE_C_HEAP_ARRAY(bm_word_t, c1, mtInternal);
+    FREE_C_HEAP_ARRAY(bm_word_t, c2, mtInternal);
+  }
+};
+
+julong TestBitMap::_seed = UCONST64(0x9E3779B97F4A7C15);
+
+void TestBitMap_test() {
+  TestBitMap::test();
+}
+
+#endif // PRODUCT
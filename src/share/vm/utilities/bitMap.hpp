@@ -47,7 +47,23 @@ class BitMap VALUE_OBJ_CLASS_SPEC {
     unknown_range, small_range, large_range
   } RangeSizeHint;
 
+  // Word-parallel kernels behind the bulk operations.  The combining
+  // kernels update dst and return whether any word changed.
+  struct Kernels {
+    bool  (*set_union)       (bm_word_t* dst, const bm_word_t* src, idx_t words);
+    bool  (*set_intersection)(bm_word_t* dst, const bm_word_t* src, idx_t words);
+    bool  (*set_difference)  (bm_word_t* dst, const bm_word_t* src, idx_t words);
+    bool  (*is_same)         (const bm_word_t* a, const bm_word_t* b, idx_t words);
+    idx_t (*count_one_bits)  (const bm_word_t* map, idx_t words);
+  };
+
  private:
+  // The kernels in use start out portable and are replaced by
+  // initialize_kernels once the CPU features are known.
+  static Kernels       _kernels;
+  static const Kernels _portable_kernels;
+  X86_ONLY(static void pd_initialize_kernels(Kernels* kernels);)
+
   ArrayAllocator<bm_word_t, mtInternal> _map_allocator;
   bm_word_t* _map;     // First word in bitmap
   idx_t      _size;    // Size of bitmap (in bits)
@@ -105,13 +121,11 @@ class BitMap VALUE_OBJ_CLASS_SPEC {
   inline void verify_range(idx_t beg_index, idx_t end_index) const
     NOT_DEBUG_RETURN;
 
-  // Statistics.
-  static idx_t* _pop_count_table;
-  static void init_pop_count_table();
-  static idx_t num_set_bits(bm_word_t w);
-  static idx_t num_set_bits_from_table(unsigned char c);
-
  public:
+  // Select the kernels for the bulk operations, depends on VM_Version_init.
+  static void initialize_kernels();
+  static const Kernels& kernels()          { return _kernels; }
+  static const Kernels& portable_kernels() { return _portable_kernels; }
 
   // Constructs a bitmap with no map, and size 0.
   BitMap() : _map(NULL), _size(0), _map_allocator(false) {}
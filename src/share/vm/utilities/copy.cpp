@@ -24,7 +24,23 @@
 
 #include "precompiled.hpp"
 #include "runtime/sharedRuntime.hpp"
+#include "runtime/stubRoutines.hpp"
 #include "utilities/copy.hpp"
+#ifdef TARGET_ARCH_x86
+# include "bytes_x86.hpp"
+#endif
+#ifdef TARGET_ARCH_sparc
+# include "bytes_sparc.hpp"
+#endif
+#ifdef TARGET_ARCH_zero
+# include "bytes_zero.hpp"
+#endif
+#ifdef TARGET_ARCH_arm
+# include "bytes_arm.hpp"
+#endif
+#ifdef TARGET_ARCH_ppc
+# include "bytes_ppc.hpp"
+#endif
 
 
 // Copy bytes; larger units are filled atomically if everything is aligned.
@@ -54,6 +70,42 @@ void Copy::conjoint_memory_atomic(void* from, void* to, size_t size) {
 }
 
 
+// Byte swapping copy of 2, 4 or 8 byte elements.  The element accessors
+// in Bytes cope with unaligned addresses, so no alignment is assumed here.
+template <typename T, T swap(T), T get(address), void put(address, T)>
+static void conjoint_swap_elements(address src, address dst, size_t byte_count) {
+  if (src >= dst || dst >= src + byte_count) {
+    for (size_t off = 0; off < byte_count; off += sizeof(T)) {
+      put(dst + off, swap(get(src + off)));
+    }
+  } else {
+    // Overlapping with dst above src: copy backwards.
+    for (size_t off = byte_count; off > 0; off -= sizeof(T)) {
+      put(dst + off - sizeof(T), swap(get(src + off - sizeof(T))));
+    }
+  }
+}
+
+void Copy::conjoint_swap(void* from, void* to, size_t byte_count, size_t elem_size) {
+  address src = (address) from;
+  address dst = (address) to;
+  assert(byte_count % elem_size == 0, "must be a whole number of elements");
+
+  switch (elem_size) {
+  case 2:
+    conjoint_swap_elements<u2, Bytes::swap_u2, Bytes::get_native_u2, Bytes::put_native_u2>(src, dst, byte_count);
+    break;
+  case 4:
+    conjoint_swap_elements<u4, Bytes::swap_u4, Bytes::get_native_u4, Bytes::put_native_u4>(src, dst, byte_count);
+    break;
+  case 8:
+    conjoint_swap_elements<u8, Bytes::swap_u8, Bytes::get_native_u8, Bytes::put_native_u8>(src, dst, byte_count);
+    break;
+  default:
+    ShouldNotReachHere();
+  }
+}
+
 // Fill bytes; larger units are filled atomically if everything is aligned.
 void Copy::fill_to_memory_atomic(void* to, size_t size, jubyte value) {
   address dst = (address) to;
@@ -91,3 +143,67 @@ void Copy::fill_to_memory_atomic(void* to, size_t size, jubyte value) {
     Copy::fill_to_bytes(dst, size, value);
   }
 }
+
+#ifndef PRODUCT
+
+// Checks the swapcopy stubs against Copy::conjoint_swap for 2, 4 and 8 byte
+// elements, with all source and destination alignments and with ranges
+// that overlap in either direction.  The lengths cover the vector loops of
+// the stubs as well as their element by element tail.
+class TestCopySwap : AllStatic {
+  static const size_t buffer_size = 1024;
+  static const size_t max_bytes   = 256;
+  static const int    max_shift   = 40;
+
+  typedef void (*swapcopy_stub_t)(void* src, void* dst, size_t count);
+
+  static void fill(u1* buffer) {
+    for (size_t i = 0; i < buffer_size; i++) {
+      buffer[i] = (u1)(i * 7 + 1);
+    }
+  }
+
+  static void check(size_t elem_size, size_t src_off, size_t dst_off, size_t bytes) {
+    u1 expected[buffer_size];
+    u1 actual[buffer_size];
+    fill(expected);
+    fill(actual);
+    Copy::conjoint_swap(expected + src_off, expected + dst_off, bytes, elem_size);
+    swapcopy_stub_t stub = (swapcopy_stub_t)StubRoutines::swapcopy(elem_size);
+    stub(actual + src_off, actual + dst_off, bytes / elem_size);
+    for (size_t i = 0; i < buffer_size; i++) {
+      assert(actual[i] == expected[i],
+             err_msg("swapcopy of " SIZE_FORMAT " byte elements differs at " SIZE_FORMAT
+                     " (src " SIZE_FORMAT ", dst " SIZE_FORMAT ", " SIZE_FORMAT " bytes)",
+                     elem_size, i, src_off, dst_off, bytes));
+    }
+  }
+
+ public:
+  static void test() {
+    for (size_t elem_size = 2; elem_size <= 8; elem_size *= 2) {
+      if (StubRoutines::swapcopy(elem_size) == NULL) {
+        continue;
+      }
+      for (size_t bytes = 0; bytes <= max_bytes; bytes += elem_size) {
+        // Disjoint ranges
+        for (size_t src_off = 0; src_off < 8; src_off++) {
+          for (size_t dst_off = 0; dst_off < 8; dst_off++) {
+            check(elem_size, src_off, buffer_size / 2 + dst_off, bytes);
+          }
+        }
+        // Overlapping ranges, the destination below or above the source
+        const size_t base = buffer_size / 4;
+        for (int shift = -max_shift; shift <= max_shift; shift++) {
+          check(elem_size, base, (size_t)((int)base + shift), bytes);
+        }
+      }
+    }
+  }
+};
+
+void TestCopySwap_test() {
+  TestCopySwap::test();
+}
+
+#endif // PRODUCT
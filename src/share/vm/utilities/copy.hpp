@@ -166,6 +166,11 @@ class Copy : AllStatic {
   // of two which divides all of from, to, and size, whichever is smaller.
   static void conjoint_memory_atomic(void* from, void* to, size_t size);
 
+  // Copy a span of memory of elements of elem_size bytes (2, 4 or 8),
+  // reversing the byte order of each element.  The spans may overlap;
+  // each element is read before its destination is written.
+  static void conjoint_swap(void* from, void* to, size_t byte_count, size_t elem_size);
+
   // bytes,                 conjoint array, atomic on each byte (not that it matters)
   static void arrayof_conjoint_jbytes(HeapWord* from, HeapWord* to, size_t count) {
     pd_arrayof_conjoint_bytes(from, to, count);
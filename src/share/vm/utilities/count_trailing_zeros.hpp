@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#ifndef SHARE_VM_UTILITIES_COUNT_TRAILING_ZEROS_HPP
+#define SHARE_VM_UTILITIES_COUNT_TRAILING_ZEROS_HPP
+
+#include "utilities/globalDefinitions.hpp"
+
+// unsigned count_trailing_zeros(uintx x)
+// Return the number of least significant zero bits in x, i.e. the index of
+// the lowest set bit.  The result is undefined if x is zero.  Compilers
+// turn this into a single bsf or tzcnt instruction on x86.
+
+#if defined(TARGET_COMPILER_gcc)
+
+inline unsigned count_trailing_zeros(uintx x) {
+  STATIC_ASSERT(sizeof(unsigned long) == sizeof(uintx));
+  assert(x != 0, "precondition");
+  return __builtin_ctzl(x);
+}
+
+#elif defined(TARGET_COMPILER_visCPP)
+
+#include <intrin.h>
+
+#ifdef _LP64
+#pragma intrinsic(_BitScanForward64)
+#else
+#pragma intrinsic(_BitScanForward)
+#endif
+
+inline unsigned count_trailing_zeros(uintx x) {
+  assert(x != 0, "precondition");
+  unsigned long index;
+#ifdef _LP64
+  _BitScanForward64(&index, x);
+#else
+  _BitScanForward(&index, x);
+#endif
+  return index;
+}
+
+#elif defined(TARGET_COMPILER_xlc)
+
+#include <builtins.h>
+
+inline unsigned count_trailing_zeros(uintx x) {
+  assert(x != 0, "precondition");
+#ifdef _LP64
+  return __cnttz8(x);
+#else
+  return __cnttz4(x);
+#endif
+}
+
+#else
+
+// Binary search for the lowest set bit.
+inline unsigned count_trailing_zeros(uintx x) {
+  assert(x != 0, "precondition");
+  unsigned n = 0;
+#ifdef _LP64
+  if ((x & 0xFFFFFFFF) == 0) { n += 32; x >>= 32; }
+#endif
+  if ((x & 0xFFFF) == 0) { n += 16; x >>= 16; }
+  if ((x & 0xFF) == 0)   { n += 8;  x >>= 8;  }
+  if ((x & 0xF) == 0)    { n += 4;  x >>= 4;  }
+  if ((x & 0x3) == 0)    { n += 2;  x >>= 2;  }
+  if ((x & 0x1) == 0)    { n += 1; }
+  return n;
+}
+
+#endif
+
+#endif // SHARE_VM_UTILITIES_COUNT_TRAILING_ZEROS_HPP
@@ -27,12 +27,18 @@
 #if !defined(_WINDOWS) && !defined(__APPLE__)
 
 #include "memory/allocation.inline.hpp"
+#include "runtime/atomic.inline.hpp"
 #include "utilities/elfFuncDescTable.hpp"
 #include "utilities/elfSymbolTable.hpp"
 
+volatile intptr_t ElfSymbolTable::_index_memory = 0;
+
 ElfSymbolTable::ElfSymbolTable(FILE* file, Elf_Shdr shdr) {
   assert(file, "null file handle");
   m_symbols = NULL;
+  m_index = NULL;
+  m_index_length = 0;
+  m_index_built = false;
   m_next = NULL;
   m_file = file;
   m_status = NullDecoder::no_error;
@@ -64,11 +70,118 @@ ElfSymbolTable::~ElfSymbolTable() {
     os::free(m_symbols);
   }
 
+  if (m_index != NULL) {
+    os::free(m_index);
+    Atomic::add_ptr(-(intptr_t)(m_index_length * sizeof(IndexEntry)), &_index_memory);
+  }
+
   if (m_next != NULL) {
     delete m_next;
   }
 }
 
+int ElfSymbolTable::compare_index_entries(const void* e1, const void* e2) {
+  address a1 = ((const IndexEntry*)e1)->addr;
+  address a2 = ((const IndexEntry*)e2)->addr;
+  return a1 < a2 ? -1 : (a1 > a2 ? 1 : 0);
+}
+
+// Collect the function symbols, sorted by address. Returns false if the
+// index does not fit into the budget or can't be read, in which case the
+// lookups walk the symbols linearly.
+bool ElfSymbolTable::build_index(ElfFuncDescTable* funcDescTable) {
+  size_t sym_size = sizeof(Elf_Sym);
+  int count = m_shdr.sh_size / sym_size;
+  if (count == 0) {
+    return false;
+  }
+
+  size_t bytes = count * sizeof(IndexEntry);
+  if (Atomic::add_ptr((intptr_t)bytes, &_index_memory) > (intptr_t)index_budget) {
+    Atomic::add_ptr(-(intptr_t)bytes, &_index_memory);
+    return false;
+  }
+  IndexEntry* index = (IndexEntry*)os::malloc(bytes, mtInternal);
+  if (index == NULL) {
+    Atomic::add_ptr(-(intptr_t)bytes, &_index_memory);
+    return false;
+  }
+
+  long cur_pos = -1;
+  if (m_symbols == NULL) {
+    if ((cur_pos = ftell(m_file)) == -1 ||
+      fseek(m_file, m_shdr.sh_offset, SEEK_SET)) {
+      os::free(index);
+      Atomic::add_ptr(-(intptr_t)bytes, &_index_memory);
+      return false;
+    }
+  }
+
+  int length = 0;
+  for (int i = 0; i < count; i ++) {
+    Elf_Sym sym;
+    if (m_symbols != NULL) {
+      sym = m_symbols[i];
+    } else if (fread(&sym, sym_size, 1, m_file) != 1) {
+      fseek(m_file, cur_pos, SEEK_SET);
+      os::free(index);
+      Atomic::add_ptr(-(intptr_t)bytes, &_index_memory);
+      return false;
+    }
+    if (STT_FUNC == ELF_ST_TYPE(sym.st_info) && sym.st_size > 0) {
+      if (funcDescTable != NULL && funcDescTable->get_index() == sym.st_shndx) {
+        // We need to go another step trough the function descriptor table (currently PPC64 only)
+        index[length].addr = funcDescTable->lookup(sym.st_value);
+      } else {
+        index[length].addr = (address)sym.st_value;
+      }
+      index[length].size = sym.st_size;
+      index[length].name = sym.st_name;
+      length ++;
+    }
+  }
+  if (m_symbols == NULL) {
+    fseek(m_file, cur_pos, SEEK_SET);
+  }
+
+  qsort(index, length, sizeof(IndexEntry), compare_index_entries);
+
+  // give back the unused part of the budget
+  Atomic::add_ptr(-(intptr_t)((count - length) * sizeof(IndexEntry)), &_index_memory);
+  m_index = index;
+  m_index_length = length;
+
+  // the index replaces the loaded symbols
+  if (m_symbols != NULL) {
+    os::free(m_symbols);
+    m_symbols = NULL;
+  }
+  return true;
+}
+
+bool ElfSymbolTable::lookup_in_index(address addr, int* posIndex, int* offset) {
+  // find the last symbol that starts at or below addr
+  int lo = 0;
+  int hi = m_index_length;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (m_index[mid].addr <= addr) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  // symbols may nest, so also look at a few of the preceding ones
+  for (int i = lo - 1; i >= 0 && i >= lo - 8; i --) {
+    if ((Elf_Word)(addr - m_index[i].addr) < m_index[i].size) {
+      *offset = (int)(addr - m_index[i].addr);
+      *posIndex = m_index[i].name;
+      return true;
+    }
+  }
+  return false;
+}
+
 bool ElfSymbolTable::lookup(address addr, int* stringtableIndex, int* posIndex, int* offset, ElfFuncDescTable* funcDescTable) {
   assert(stringtableIndex, "null string table index pointer");
   assert(posIndex, "null string table offset pointer");
@@ -78,6 +191,18 @@ bool ElfSymbolTable::lookup(address addr, int* stringtableIndex, int* posIndex,
     return false;
   }
 
+  if (!m_index_built) {
+    m_index_built = true;
+    build_index(funcDescTable);
+  }
+  if (m_index != NULL) {
+    if (lookup_in_index(addr, posIndex, offset)) {
+      *stringtableIndex = m_shdr.sh_link;
+      return true;
+    }
+    return false;
+  }
+
   size_t  sym_size = sizeof(Elf_Sym);
   assert((m_shdr.sh_size % sym_size) == 0, "check size");
   int count = m_shdr.sh_size / sym_size;
@@ -134,7 +259,7 @@ bool ElfSymbolTable::lookup(address addr, int* stringtableIndex, int* posIndex,
     }
     fseek(m_file, cur_pos, SEEK_SET);
   }
-  return true;
+  return false;
 }
 
 #endif // !_WINDOWS && !__APPLE__
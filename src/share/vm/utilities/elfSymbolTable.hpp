@@ -37,6 +37,11 @@
  * Whenever possible, it will load all symbols from the corresponding section
  * of the elf file into memory. Otherwise, it will walk the section in file
  * to look up the symbol that nearest the given address.
+ *
+ * On the first lookup, the function symbols are collected into an index
+ * sorted by address, which is binary searched by all further lookups. The
+ * indexes of all symbol tables share a memory budget; a table that does not
+ * fit falls back to the linear walk.
  */
 class ElfSymbolTable: public CHeapObj<mtInternal> {
   friend class ElfFile;
@@ -49,6 +54,27 @@ class ElfSymbolTable: public CHeapObj<mtInternal> {
 
   NullDecoder::decoder_status get_status() { return m_status; };
 
+ private:
+  // a function symbol in the sorted index
+  struct IndexEntry {
+    address   addr;
+    Elf_Word  size;
+    Elf_Word  name;
+  };
+
+  // memory budget for the indexes of all symbol tables
+  static const size_t index_budget = 32 * M;
+  static volatile intptr_t _index_memory;
+
+  static int compare_index_entries(const void* e1, const void* e2);
+
+  bool build_index(ElfFuncDescTable* funcDescTable);
+  bool lookup_in_index(address addr, int* posIndex, int* offset);
+
+  IndexEntry*         m_index;
+  int                 m_index_length;
+  bool                m_index_built;
+
  protected:
   ElfSymbolTable*  m_next;
 
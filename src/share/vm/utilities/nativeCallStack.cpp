@@ -23,8 +23,10 @@
  */
 
 #include "precompiled.hpp"
+#include "memory/allocation.inline.hpp"
 #include "runtime/os.hpp"
 #include "utilities/globalDefinitions.hpp"
+#include "utilities/growableArray.hpp"
 #include "utilities/nativeCallStack.hpp"
 
 const NativeCallStack NativeCallStack::EMPTY_STACK(0, false);
@@ -117,3 +119,106 @@ void NativeCallStack::print_on(outputStream* out, int indent) const {
   }
 }
 
+void NativeCallStack::print_on(outputStream* out, int indent, NativeCallStackPrinter* printer) const {
+  if (printer == NULL || is_empty()) {
+    print_on(out, indent);
+    return;
+  }
+  // decode all frames of this stack as one batch
+  printer->collect(this);
+  printer->decode_collected();
+  for (int frame = 0; frame < NMT_TrackingStackDepth; frame ++) {
+    address pc = get_frame(frame);
+    if (pc == NULL) break;
+    for (int index = 0; index < indent; index ++) out->print(" ");
+    printer->print_frame(out, pc);
+  }
+}
+
+NativeCallStackPrinter::NativeCallStackPrinter() {
+  _table = NEW_C_HEAP_ARRAY(Entry*, table_size, mtNMT);
+  memset(_table, 0, table_size * sizeof(Entry*));
+  _pending = new (ResourceObj::C_HEAP, mtNMT) GrowableArray<address>(256, true, mtNMT);
+}
+
+NativeCallStackPrinter::~NativeCallStackPrinter() {
+  for (int index = 0; index < table_size; index ++) {
+    Entry* entry = _table[index];
+    while (entry != NULL) {
+      Entry* next = entry->next;
+      if (entry->name != NULL) {
+        FREE_C_HEAP_ARRAY(char, entry->name, mtNMT);
+      }
+      FREE_C_HEAP_OBJ(entry, mtNMT);
+      entry = next;
+    }
+  }
+  FREE_C_HEAP_ARRAY(Entry*, _table, mtNMT);
+  delete _pending;
+}
+
+int NativeCallStackPrinter::compare_pcs(address* pc1, address* pc2) {
+  return *pc1 < *pc2 ? -1 : (*pc1 > *pc2 ? 1 : 0);
+}
+
+NativeCallStackPrinter::Entry* NativeCallStackPrinter::find(address pc) const {
+  Entry* entry = _table[((uintptr_t)pc >> 2) % table_size];
+  while (entry != NULL && entry->pc != pc) {
+    entry = entry->next;
+  }
+  return entry;
+}
+
+NativeCallStackPrinter::Entry* NativeCallStackPrinter::decode(address pc) {
+  char buf[1024];
+  int  offset = 0;
+  Entry* entry = NEW_C_HEAP_OBJ(Entry, mtNMT);
+  entry->pc = pc;
+  entry->name = NULL;
+  entry->offset = 0;
+  if (os::dll_address_to_function_name(pc, buf, sizeof(buf), &offset)) {
+    size_t len = strlen(buf) + 1;
+    entry->name = NEW_C_HEAP_ARRAY(char, len, mtNMT);
+    memcpy(entry->name, buf, len);
+    entry->offset = offset;
+  }
+  int index = ((uintptr_t)pc >> 2) % table_size;
+  entry->next = _table[index];
+  _table[index] = entry;
+  return entry;
+}
+
+void NativeCallStackPrinter::collect(const NativeCallStack* stack) {
+  for (int frame = 0; frame < NMT_TrackingStackDepth; frame ++) {
+    address pc = stack->get_frame(frame);
+    if (pc == NULL) break;
+    if (find(pc) == NULL) {
+      _pending->append(pc);
+    }
+  }
+}
+
+void NativeCallStackPrinter::decode_collected() {
+  _pending->sort(compare_pcs);
+  address last = NULL;
+  for (int index = 0; index < _pending->length(); index ++) {
+    address pc = _pending->at(index);
+    if (pc != last && find(pc) == NULL) {
+      decode(pc);
+    }
+    last = pc;
+  }
+  _pending->clear();
+}
+
+void NativeCallStackPrinter::print_frame(outputStream* out, address pc) {
+  Entry* entry = find(pc);
+  if (entry == NULL) {
+    entry = decode(pc);
+  }
+  if (entry->name != NULL) {
+    out->print_cr("[" PTR_FORMAT "] %s+0x%x", p2i(pc), entry->name, entry->offset);
+  } else {
+    out->print_cr("[" PTR_FORMAT "]", p2i(pc));
+  }
+}
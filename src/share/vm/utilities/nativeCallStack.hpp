@@ -29,6 +29,9 @@
 #include "services/nmtCommon.hpp"
 #include "utilities/ostream.hpp"
 
+class NativeCallStackPrinter;
+template <class E> class GrowableArray;
+
 /*
  * This class represents a native call path (does not include Java frame)
  *
@@ -93,6 +96,51 @@ class NativeCallStack : public StackObj {
 
   void print_on(outputStream* out) const;
   void print_on(outputStream* out, int indent) const;
+  // print with the function names decoded and cached by the printer
+  void print_on(outputStream* out, int indent, NativeCallStackPrinter* printer) const;
+};
+
+/*
+ * Decodes the function names of native call stack frames and caches them,
+ * so that the many call stacks of a report, which share most of their
+ * frames, decode each pc only once.
+ *
+ * The frames of all stacks to print can be collected up front and decoded
+ * as one batch, sorted by address, so that the lookups in each library's
+ * symbol table are done together.
+ */
+class NativeCallStackPrinter : public StackObj {
+ private:
+  struct Entry {
+    address   pc;
+    char*     name;     // NULL if the pc could not be decoded
+    int       offset;
+    Entry*    next;
+  };
+
+  enum {
+    table_size = 1024
+  };
+
+  Entry**                 _table;
+  GrowableArray<address>* _pending;   // collected frames to decode
+
+  static int compare_pcs(address* pc1, address* pc2);
+
+  Entry* find(address pc) const;
+  Entry* decode(address pc);
+
+ public:
+  NativeCallStackPrinter();
+  ~NativeCallStackPrinter();
+
+  // remember the frames of the stack for decode_collected()
+  void collect(const NativeCallStack* stack);
+  // decode all collected frames in address order
+  void decode_collected();
+
+  // print one frame, decoding it if it has not been decoded yet
+  void print_frame(outputStream* out, address pc);
 };
 
 #endif
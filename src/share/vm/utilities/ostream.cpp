@@ -27,6 +27,7 @@
 #include "gc_implementation/shared/gcId.hpp"
 #include "oops/oop.inline.hpp"
 #include "runtime/arguments.hpp"
+#include "runtime/asyncLogWriter.hpp"
 #include "utilities/defaultStream.hpp"
 #include "utilities/ostream.hpp"
 #include "utilities/top.hpp"
@@ -709,8 +710,16 @@ gcLogFileStream::gcLogFileStream(const char* file_name) {
   }
 }
 
+// With AsyncGCLogging the position is updated by the GC log writer thread
+// when it writes the text out, so that logging threads only copy the text.
 void gcLogFileStream::write(const char* s, size_t len) {
-  if (_file != NULL) {
+  if (!AsyncLogWriter::enqueue(s, len)) {
+    write_to_file(s, len);
+  }
+}
+
+void gcLogFileStream::write_to_file(const char* s, size_t len) {
+  if (_file != NULL && len > 0) {
     size_t count = fwrite(s, 1, len, _file);
     _bytes_written += count;
   }
@@ -725,7 +734,26 @@ void gcLogFileStream::write(const char* s, size_t len) {
 // write to gc log file at safepoint. If in future, changes made for mutator threads or
 // concurrent GC threads to run parallel with VMThread at safepoint, write and rotate_log
 // must be synchronized.
+//
+// With AsyncGCLogging the file is rotated by the GC log writer thread, after it has
+// written all output buffered before the request, see rotate_log_file.
 void gcLogFileStream::rotate_log(bool force, outputStream* out) {
+  if (AsyncLogWriter::is_active() && !AsyncLogWriter::is_writer_thread()) {
+    if (!force) {
+      // the writer checks the file size itself
+      return;
+    }
+    if (AsyncLogWriter::request_rotation()) {
+      if (out != NULL) {
+        out->print_cr("GC log rotation has been requested.");
+      }
+      return;
+    }
+  }
+  rotate_log_file(force, out);
+}
+
+void gcLogFileStream::rotate_log_file(bool force, outputStream* out) {
   char time_msg[O_BUFLEN];
   char time_str[EXTRACHARLEN];
   char current_file_name[JVM_MAXPATHLEN];
@@ -738,8 +766,9 @@ void gcLogFileStream::rotate_log(bool force, outputStream* out) {
 #ifdef ASSERT
   Thread *thread = Thread::current();
   assert(thread == NULL ||
-         (thread->is_VM_thread() && SafepointSynchronize::is_at_safepoint()),
-         "Must be VMThread at safepoint");
+         (thread->is_VM_thread() && SafepointSynchronize::is_at_safepoint()) ||
+         AsyncLogWriter::is_writer_thread(),
+         "Must be VMThread at safepoint or the GC log writer");
 #endif
   if (NumberOfGCLogFiles == 1) {
     // rotate in same file
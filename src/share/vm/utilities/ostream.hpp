@@ -247,6 +247,11 @@ class gcLogFileStream : public fileStream {
   virtual void rotate_log(bool force, outputStream* out = NULL);
   void dump_loggc_header();
 
+  // Used by the AsyncLogWriter, bypasses the asynchronous buffer and
+  // updates the position
+  void write_to_file(const char* c, size_t len);
+  void rotate_log_file(bool force, outputStream* out);
+
   /* If "force" sets true, force log file rotation from outside JVM */
   bool should_rotate(bool force) {
     return force ||
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Large arraycopies and allocations that use non-temporal stores
+ * @run main/othervm -XX:+IgnoreUnrecognizedVMOptions -XX:NonTemporalStoreThreshold=64k -Xbatch TestNonTemporalStores
+ * @run main/othervm -XX:+IgnoreUnrecognizedVMOptions -XX:NonTemporalStoreThreshold=0 -Xbatch TestNonTemporalStores
+ */
+
+public class TestNonTemporalStores {
+    static final int SIZE = 256 * 1024;
+
+    static void check(boolean ok, String msg) {
+        if (!ok) {
+            throw new RuntimeException(msg);
+        }
+    }
+
+    static void testCopy(int len, int srcPos, int dstPos) {
+        long[] src = new long[SIZE];
+        for (int i = 0; i < src.length; i++) {
+            src[i] = i;
+        }
+        long[] dst = new long[SIZE];
+        System.arraycopy(src, srcPos, dst, dstPos, len);
+        for (int i = 0; i < dst.length; i++) {
+            long expected = (i >= dstPos && i < dstPos + len) ? i - dstPos + srcPos : 0;
+            check(dst[i] == expected, "disjoint copy of " + len + " at " + i);
+        }
+        // Overlapping copies, forward and backward.
+        System.arraycopy(src, srcPos + 3, src, srcPos, len);
+        for (int i = srcPos; i < srcPos + len; i++) {
+            check(src[i] == i + 3, "forward overlapping copy of " + len + " at " + i);
+        }
+        System.arraycopy(dst, dstPos, dst, dstPos + 5, len);
+        for (int i = dstPos + 5; i < dstPos + 5 + len; i++) {
+            check(dst[i] == i - 5 - dstPos + srcPos, "backward overlapping copy of " + len + " at " + i);
+        }
+    }
+
+    static void testBytes(int len, int srcPos, int dstPos) {
+        byte[] src = new byte[SIZE * 8];
+        for (int i = 0; i < src.length; i++) {
+            src[i] = (byte) i;
+        }
+        byte[] dst = new byte[SIZE * 8];
+        System.arraycopy(src, srcPos, dst, dstPos, len);
+        for (int i = 0; i < dst.length; i++) {
+            byte expected = (i >= dstPos && i < dstPos + len) ? (byte) (i - dstPos + srcPos) : 0;
+            check(dst[i] == expected, "byte copy of " + len + " at " + i);
+        }
+    }
+
+    static void testAllocation() {
+        for (int i = 0; i < 16; i++) {
+            int[] a = new int[SIZE * 2 + i];
+            for (int j = 0; j < a.length; j++) {
+                check(a[j] == 0, "allocated array is not zeroed at " + j);
+                a[j] = -1;
+            }
+        }
+    }
+
+    public static void main(String[] args) {
+        for (int iter = 0; iter < 20; iter++) {
+            for (int len : new int[] { 8191, 8192, 8197, 100000, SIZE - 16 }) {
+                testCopy(len, 1, 2);
+                testCopy(len, 7, 0);
+            }
+            for (int len : new int[] { 65535, 65536, 65541, 1000003 }) {
+                testBytes(len, 3, 1);
+                testBytes(len, 0, 8);
+            }
+            testAllocation();
+        }
+    }
+}
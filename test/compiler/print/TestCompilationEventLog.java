@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @key jcmd
+ * @summary compilation events are recorded and can be printed and dumped with Compiler.event_log
+ * @library /testlibrary
+ * @run main/othervm -XX:-BackgroundCompilation -XX:+LogCompilationEvents TestCompilationEventLog
+ */
+
+import java.io.File;
+import com.oracle.java.testlibrary.*;
+
+public class TestCompilationEventLog {
+
+    static int sum(int n) {
+        int s = 0;
+        for (int i = 0; i < n; i++) {
+            s += i;
+        }
+        return s;
+    }
+
+    public static void main(String args[]) throws Exception {
+        int total = 0;
+        for (int i = 0; i < 20000; i++) {
+            total += sum(10);
+        }
+        System.out.println(total);
+
+        ProcessBuilder pb = new ProcessBuilder();
+        OutputAnalyzer output;
+        String pid = Integer.toString(ProcessTools.getProcessId());
+
+        pb.command(new String[] { JDKToolFinder.getJDKTool("jcmd"), pid, "Compiler.event_log" });
+        output = new OutputAnalyzer(pb.start());
+        output.shouldContain("Compilation event log");
+        output.shouldContain("enqueue");
+        output.shouldContain("install");
+        output.shouldMatch("install .*TestCompilationEventLog.sum\\(I\\)I");
+
+        pb.command(new String[] { JDKToolFinder.getJDKTool("jcmd"), pid, "Compiler.event_log", "count=1" });
+        output = new OutputAnalyzer(pb.start());
+        output.shouldContain("(1 of ");
+
+        File dump = new File("compilation_events.bin");
+        pb.command(new String[] { JDKToolFinder.getJDKTool("jcmd"), pid, "Compiler.event_log", dump.getAbsolutePath() });
+        output = new OutputAnalyzer(pb.start());
+        output.shouldContain("compilation events to");
+        Asserts.assertTrue(dump.length() > 32, "dump should contain records");
+    }
+}
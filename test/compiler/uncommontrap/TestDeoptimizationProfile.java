@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @key jcmd
+ * @summary uncommon traps are counted per site and printed by Compiler.deoptimizations
+ * @library /testlibrary
+ * @run main/othervm -XX:-TieredCompilation -XX:-BackgroundCompilation -XX:-UseOnStackReplacement -XX:CompileCommand=dontinline,TestDeoptimizationProfile::m TestDeoptimizationProfile
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class TestDeoptimizationProfile {
+
+    static int m(Object o) {
+        if (o instanceof Integer) {
+            return ((Integer) o).intValue();
+        }
+        return o.hashCode();
+    }
+
+    public static void main(String args[]) throws Exception {
+        int sum = 0;
+        Integer i = 42;
+        // Compile m() with only Integer seen, then take the unstable if.
+        for (int n = 0; n < 20000; n++) {
+            sum += m(i);
+        }
+        sum += m("trap");
+        System.out.println(sum);
+
+        ProcessBuilder pb = new ProcessBuilder();
+        OutputAnalyzer output;
+        String pid = Integer.toString(ProcessTools.getProcessId());
+
+        pb.command(new String[] { JDKToolFinder.getJDKTool("jcmd"), pid, "Compiler.deoptimizations", "-events" });
+        output = new OutputAnalyzer(pb.start());
+        output.shouldContain("Deoptimization profile:");
+        output.shouldContain("TestDeoptimizationProfile.m(Ljava/lang/Object;)I");
+        output.shouldContain("Recent deoptimization events");
+
+        pb.command(new String[] { JDKToolFinder.getJDKTool("jcmd"), pid, "Compiler.deoptimizations_reset" });
+        output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+
+        pb.command(new String[] { JDKToolFinder.getJDKTool("jcmd"), pid, "Compiler.deoptimizations" });
+        output = new OutputAnalyzer(pb.start());
+        output.shouldNotContain("TestDeoptimizationProfile.m(Ljava/lang/Object;)I");
+    }
+}
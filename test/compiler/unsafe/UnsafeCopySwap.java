@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Byte swapping Unsafe.copySwapMemory on and off heap, including overlapping ranges
+ * @library /testlibrary
+ * @run main/othervm -Xbatch UnsafeCopySwap
+ * @run main/othervm -Xbatch -XX:+IgnoreUnrecognizedVMOptions -XX:UseAVX=0 UnsafeCopySwap
+ * @run main/othervm -Xbatch -XX:+IgnoreUnrecognizedVMOptions -XX:UseSSE=2 UnsafeCopySwap
+ */
+
+import com.oracle.java.testlibrary.Utils;
+import java.lang.invoke.MethodHandle;
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.MethodType;
+import java.util.Random;
+
+public class UnsafeCopySwap {
+  static final sun.misc.Unsafe unsafe = Utils.getUnsafe();
+  static final long BASE = sun.misc.Unsafe.ARRAY_BYTE_BASE_OFFSET;
+  static MethodHandle copySwapMemory;
+
+  static void copySwap(Object src, long srcOffset, Object dst, long dstOffset, long bytes, long elemSize) throws Throwable {
+    copySwapMemory.invokeExact(unsafe, src, srcOffset, dst, dstOffset, bytes, elemSize);
+  }
+
+  // Reference implementation working on a copy of the source.
+  static byte[] expected(byte[] dst, int dstPos, byte[] src, int srcPos, int bytes, int elemSize) {
+    byte[] result = dst.clone();
+    byte[] from = src.clone();
+    for (int i = 0; i < bytes; i += elemSize) {
+      for (int j = 0; j < elemSize; j++) {
+        result[dstPos + i + j] = from[srcPos + i + elemSize - 1 - j];
+      }
+    }
+    return result;
+  }
+
+  static void check(byte[] actual, byte[] expected, String what) {
+    if (!java.util.Arrays.equals(actual, expected)) {
+      throw new RuntimeException("wrong result for " + what);
+    }
+  }
+
+  static void testHeap(Random rnd, int elemSize) throws Throwable {
+    int bytes = rnd.nextInt(40) * elemSize;
+    int srcPos = rnd.nextInt(16);
+    int dstPos = rnd.nextInt(16);
+    byte[] src = new byte[bytes + 16];
+    byte[] dst = new byte[bytes + 16];
+    rnd.nextBytes(src);
+    rnd.nextBytes(dst);
+    byte[] expect = expected(dst, dstPos, src, srcPos, bytes, elemSize);
+    copySwap(src, BASE + srcPos, dst, BASE + dstPos, bytes, elemSize);
+    check(dst, expect, "heap copy, elemSize " + elemSize);
+  }
+
+  static void testOverlap(Random rnd, int elemSize) throws Throwable {
+    int bytes = rnd.nextInt(40) * elemSize;
+    int srcPos = rnd.nextInt(16);
+    int dstPos = rnd.nextInt(16);
+    byte[] buf = new byte[bytes + 16];
+    rnd.nextBytes(buf);
+    byte[] expect = expected(buf, dstPos, buf, srcPos, bytes, elemSize);
+    copySwap(buf, BASE + srcPos, buf, BASE + dstPos, bytes, elemSize);
+    check(buf, expect, "overlapping copy, elemSize " + elemSize);
+  }
+
+  static void testOffHeap(Random rnd, int elemSize) throws Throwable {
+    int bytes = rnd.nextInt(40) * elemSize;
+    byte[] src = new byte[bytes];
+    byte[] dst = new byte[bytes];
+    rnd.nextBytes(src);
+    long mem = unsafe.allocateMemory(bytes + 1);
+    try {
+      // Heap to unaligned off-heap and back swaps twice.
+      copySwap(src, BASE, null, mem + 1, bytes, elemSize);
+      copySwap(null, mem + 1, dst, BASE, bytes, elemSize);
+      check(dst, src, "off-heap round trip, elemSize " + elemSize);
+    } finally {
+      unsafe.freeMemory(mem);
+    }
+  }
+
+  static void testIllegal(long bytes, long elemSize) throws Throwable {
+    byte[] buf = new byte[64];
+    try {
+      copySwap(buf, BASE, buf, BASE + 8, bytes, elemSize);
+    } catch (IllegalArgumentException e) {
+      return;
+    }
+    throw new RuntimeException("expected IllegalArgumentException for bytes " + bytes + ", elemSize " + elemSize);
+  }
+
+  public static void main(String[] args) throws Throwable {
+    MethodType type = MethodType.methodType(void.class, Object.class, long.class, Object.class, long.class, long.class, long.class);
+    try {
+      copySwapMemory = MethodHandles.lookup().findVirtual(sun.misc.Unsafe.class, "copySwapMemory", type);
+    } catch (NoSuchMethodException e) {
+      System.out.println("Unsafe.copySwapMemory is not declared by this class library, skipping");
+      return;
+    }
+    Random rnd = new Random();
+    for (int i = 0; i < 20000; i++) {
+      for (int elemSize = 2; elemSize <= 8; elemSize <<= 1) {
+        testHeap(rnd, elemSize);
+        testOverlap(rnd, elemSize);
+        testOffHeap(rnd, elemSize);
+      }
+    }
+    testIllegal(8, 3);
+    testIllegal(6, 4);
+    testIllegal(-8, 8);
+  }
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test TestAlwaysPreTouch
+ * @summary AlwaysPreTouch pre-touches the heap in parallel chunks with every collector
+ * @library /testlibrary
+ * @run main TestAlwaysPreTouch
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class TestAlwaysPreTouch {
+
+    public static void main(String args[]) throws Exception {
+        String[] gcs = { "-XX:+UseSerialGC", "-XX:+UseParallelGC", "-XX:+UseConcMarkSweepGC", "-XX:+UseG1GC" };
+        for (String gc : gcs) {
+            // Small chunks so that every worker gets some of the heap
+            ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                gc, "-XX:+AlwaysPreTouch", "-XX:PreTouchParallelChunkSize=1m",
+                "-XX:ParallelGCThreads=4", "-Xms128m", "-Xmx256m", "-Xmn32m",
+                "-XX:+UnlockDiagnosticVMOptions", "-XX:+PrintFlagsFinal", "-version");
+            OutputAnalyzer output = new OutputAnalyzer(pb.start());
+            output.shouldHaveExitValue(0);
+            output.shouldMatch("PreTouchParallelChunkSize\\s+:=\\s+1048576");
+        }
+    }
+}
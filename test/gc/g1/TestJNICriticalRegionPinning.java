@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2012, 2013, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test TestJNICriticalRegionPinning
+ * @summary G1: regions of arrays held by JNI critical sections must stay in place across young and full GCs
+ * @library /testlibrary /testlibrary/whitebox
+ * @build TestJNICriticalRegionPinning
+ * @run main ClassFileInstaller sun.hotspot.WhiteBox
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI -XX:+UseG1GC -XX:+UnlockExperimentalVMOptions -XX:+G1RegionPinning -Xmx64m -XX:G1HeapRegionSize=1m TestJNICriticalRegionPinning
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI -XX:+UseG1GC -XX:+UnlockExperimentalVMOptions -XX:-G1RegionPinning -Xmx64m -XX:G1HeapRegionSize=1m TestJNICriticalRegionPinning
+ */
+
+import java.lang.management.GarbageCollectorMXBean;
+import java.lang.management.ManagementFactory;
+import java.util.Arrays;
+import java.util.Random;
+import java.util.zip.CRC32;
+import java.util.zip.Deflater;
+import java.util.zip.Inflater;
+import sun.hotspot.WhiteBox;
+
+// Deflater, Inflater and CRC32 access their arrays through
+// Get/ReleasePrimitiveArrayCritical, so the worker threads keep entering
+// critical sections while other threads force young and full GCs.
+public class TestJNICriticalRegionPinning {
+    private static final int WORKERS = 4;
+    private static final int ITERATIONS = 200;
+    private static final int DATA_SIZE = 128 * 1024;
+
+    private static volatile boolean done;
+    private static volatile Throwable failure;
+
+    private static void compressAndCheck(Random random) throws Exception {
+        byte[] data = new byte[DATA_SIZE];
+        for (int i = 0; i < data.length; i++) {
+            data[i] = (byte) (random.nextInt(16) + 'a');
+        }
+        CRC32 crc = new CRC32();
+        crc.update(data);
+        long expected = crc.getValue();
+
+        Deflater deflater = new Deflater();
+        deflater.setInput(data);
+        deflater.finish();
+        byte[] compressed = new byte[DATA_SIZE];
+        int compressedLength = 0;
+        while (!deflater.finished()) {
+            compressedLength += deflater.deflate(compressed, compressedLength, compressed.length - compressedLength);
+        }
+        deflater.end();
+
+        Inflater inflater = new Inflater();
+        inflater.setInput(compressed, 0, compressedLength);
+        byte[] result = new byte[DATA_SIZE];
+        int resultLength = 0;
+        while (!inflater.finished()) {
+            resultLength += inflater.inflate(result, resultLength, result.length - resultLength);
+        }
+        inflater.end();
+
+        crc.reset();
+        crc.update(result, 0, resultLength);
+        if (resultLength != DATA_SIZE || crc.getValue() != expected || !Arrays.equals(data, result)) {
+            throw new RuntimeException("Data corrupted by a concurrent GC");
+        }
+    }
+
+    private static long collectionCount(String name) {
+        long count = 0;
+        for (GarbageCollectorMXBean gc : ManagementFactory.getGarbageCollectorMXBeans()) {
+            if (name == null || gc.getName().equals(name)) {
+                count += gc.getCollectionCount();
+            }
+        }
+        return count;
+    }
+
+    private static void checkCollection(WhiteBox wb, byte[] pinned, long address,
+                                        String collector, boolean full) {
+        long before = collectionCount(collector);
+        if (full) {
+            wb.fullGC();
+        } else {
+            wb.youngGC();
+        }
+        if (collectionCount(collector) <= before) {
+            throw new RuntimeException("No " + collector + " collection ran while the array was pinned");
+        }
+        if (wb.getObjectAddress(pinned) != address) {
+            throw new RuntimeException("Pinned array was moved by a " + collector + " collection");
+        }
+        for (int i = 0; i < pinned.length; i++) {
+            if (pinned[i] != (byte) i) {
+                throw new RuntimeException("Pinned array corrupted by a " + collector + " collection");
+            }
+        }
+    }
+
+    // Pin an array the way a JNI critical section does, and check that young
+    // and full collections still run and leave it in place.
+    private static void checkCollectionsWhilePinned() {
+        WhiteBox wb = WhiteBox.getWhiteBox();
+        byte[] pinned = new byte[DATA_SIZE];
+        for (int i = 0; i < pinned.length; i++) {
+            pinned[i] = (byte) i;
+        }
+        if (!wb.g1PinObject(pinned)) {
+            // Critical sections use the GC_locker, which blocks the collections
+            return;
+        }
+        try {
+            long address = wb.getObjectAddress(pinned);
+            checkCollection(wb, pinned, address, "G1 Young Generation", false);
+            checkCollection(wb, pinned, address, "G1 Old Generation", true);
+            checkCollection(wb, pinned, address, "G1 Young Generation", false);
+        } finally {
+            wb.g1UnpinObject(pinned);
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        checkCollectionsWhilePinned();
+
+        long collectionsBefore = collectionCount(null);
+        Thread[] workers = new Thread[WORKERS];
+        for (int i = 0; i < WORKERS; i++) {
+            final long seed = i;
+            workers[i] = new Thread() {
+                public void run() {
+                    Random random = new Random(seed);
+                    try {
+                        for (int n = 0; n < ITERATIONS; n++) {
+                            compressAndCheck(random);
+                        }
+                    } catch (Throwable t) {
+                        failure = t;
+                    }
+                }
+            };
+            workers[i].start();
+        }
+
+        Thread allocator = new Thread() {
+            public void run() {
+                Object[] keep = new Object[64];
+                int n = 0;
+                while (!done) {
+                    keep[n++ % keep.length] = new byte[16 * 1024];
+                    if (n % 20000 == 0) {
+                        System.gc();
+                    }
+                }
+            }
+        };
+        allocator.start();
+
+        for (Thread worker : workers) {
+            worker.join();
+        }
+        done = true;
+        allocator.join();
+
+        if (failure != null) {
+            throw new RuntimeException("Worker failed", failure);
+        }
+        if (collectionCount(null) <= collectionsBefore) {
+            throw new RuntimeException("No GC ran while the workers were in critical sections");
+        }
+    }
+}
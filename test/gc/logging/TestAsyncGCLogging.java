@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test TestAsyncGCLogging
+ * @summary Check that the GC log is complete and rotated with -XX:+AsyncGCLogging
+ * @library /testlibrary
+ * @run main TestAsyncGCLogging
+ */
+
+import com.oracle.java.testlibrary.*;
+import java.io.File;
+import java.io.FilenameFilter;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+
+public class TestAsyncGCLogging {
+
+    static final int NUM_GCS = 20;
+
+    public static void main(String[] args) throws Exception {
+        testComplete();
+        testRotation();
+    }
+
+    static void testComplete() throws Exception {
+        String logName = "async_gc.log";
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-Xloggc:" + logName,
+            "-XX:+AsyncGCLogging",
+            "-XX:+PrintGCDetails",
+            GCProducer.class.getName());
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+
+        String log = new String(Files.readAllBytes(Paths.get(logName)));
+        int count = 0;
+        for (int i = log.indexOf("System.gc()"); i >= 0; i = log.indexOf("System.gc()", i + 1)) {
+            count++;
+        }
+        if (count != NUM_GCS) {
+            throw new RuntimeException("Expected " + NUM_GCS + " System.gc() entries in the log, found " + count);
+        }
+        if (!log.contains("Heap")) {
+            throw new RuntimeException("The heap printed at exit is missing from the log");
+        }
+    }
+
+    static void testRotation() throws Exception {
+        final String logName = "async_rotate.log";
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-Xloggc:" + logName,
+            "-XX:+AsyncGCLogging",
+            "-XX:+PrintGCDetails",
+            "-XX:+UseGCLogFileRotation",
+            "-XX:NumberOfGCLogFiles=3",
+            "-XX:GCLogFileSize=8k",
+            GCProducer.class.getName());
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+
+        File[] logs = new File(".").listFiles(new FilenameFilter() {
+            @Override
+            public boolean accept(File dir, String name) {
+                return name.startsWith(logName);
+            }
+        });
+        if (logs.length != 3) {
+            throw new RuntimeException("Expected 3 rotated log files, found " + logs.length);
+        }
+    }
+
+    static class GCProducer {
+        public static void main(String[] args) {
+            for (int i = 0; i < NUM_GCS; i++) {
+                System.gc();
+            }
+        }
+    }
+}
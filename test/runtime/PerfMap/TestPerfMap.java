@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary -XX:+WritePerfMap and -XX:+WriteJitDump describe JIT-compiled code for perf
+ * @requires os.family == "linux"
+ * @library /testlibrary
+ * @run main/othervm -XX:-BackgroundCompilation -XX:+WritePerfMap -XX:+WriteJitDump -XX:PerfMapFlushInterval=10 TestPerfMap
+ */
+
+import java.io.DataInputStream;
+import java.io.File;
+import java.io.FileInputStream;
+import java.nio.file.Files;
+import java.util.List;
+import com.oracle.java.testlibrary.*;
+
+public class TestPerfMap {
+
+    static int sum(int n) {
+        int s = 0;
+        for (int i = 0; i < n; i++) {
+            s += i;
+        }
+        return s;
+    }
+
+    public static void main(String args[]) throws Exception {
+        int total = 0;
+        for (int i = 0; i < 20000; i++) {
+            total += sum(10);
+        }
+        System.out.println(total);
+
+        // Give the ServiceThread a few flush intervals to write the records.
+        Thread.sleep(500);
+
+        int pid = ProcessTools.getProcessId();
+        File map = new File("/tmp/perf-" + pid + ".map");
+        Asserts.assertTrue(map.exists(), map + " should exist");
+        List<String> lines = Files.readAllLines(map.toPath());
+        boolean found = false;
+        for (String line : lines) {
+            String[] fields = line.split(" ", 3);
+            Asserts.assertEquals(fields.length, 3, "malformed line: " + line);
+            Long.parseLong(fields[0], 16);
+            Integer.parseInt(fields[1], 16);
+            if (fields[2].startsWith("TestPerfMap.sum(I)I")) {
+                found = true;
+            }
+        }
+        Asserts.assertTrue(found, "perf map should describe TestPerfMap.sum");
+        map.delete();
+
+        File dump = new File(System.getProperty("java.io.tmpdir"), "jit-" + pid + ".dump");
+        Asserts.assertTrue(dump.exists(), dump + " should exist");
+        try (DataInputStream in = new DataInputStream(new FileInputStream(dump))) {
+            // The header is written in native byte order.
+            int magic = Integer.reverseBytes(in.readInt());
+            Asserts.assertTrue(magic == 0x4A695444 || Integer.reverseBytes(magic) == 0x4A695444,
+                               "bad jitdump magic " + Integer.toHexString(magic));
+        }
+        Asserts.assertTrue(dump.length() > 40, "jitdump should contain records");
+        dump.delete();
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary PerfDataUseShmBacking publishes the PerfData memory through a symlink that tools can attach to
+ * @requires os.family == "linux"
+ * @library /testlibrary
+ * @run main PerfDataShmBacking
+ */
+
+import java.io.*;
+import java.nio.file.*;
+import com.oracle.java.testlibrary.*;
+
+public class PerfDataShmBacking {
+
+    public static void main(String args[]) throws Exception {
+        if (args.length > 0) {
+            // Child: report the pid and stay alive until killed
+            System.out.println(ProcessTools.getProcessId());
+            System.out.flush();
+            Thread.sleep(Long.MAX_VALUE);
+        }
+
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:+PerfDataUseShmBacking",
+            "PerfDataShmBacking", "child");
+        Process child = pb.start();
+        Path link = null;
+        try {
+            BufferedReader in = new BufferedReader(new InputStreamReader(child.getInputStream()));
+            String pid = in.readLine();
+            link = Paths.get("/tmp", "hsperfdata_" + System.getProperty("user.name"), pid);
+
+            if (!Files.isSymbolicLink(link)) {
+                throw new RuntimeException(link + " is not a symbolic link");
+            }
+            String target = Files.readSymbolicLink(link).toString();
+            if (!target.startsWith("/dev/shm/hsperfdata_")) {
+                throw new RuntimeException("Unexpected link target " + target);
+            }
+
+            // jstat attaches to the PerfData memory through the link
+            OutputAnalyzer output = new OutputAnalyzer(new ProcessBuilder(
+                JDKToolFinder.getJDKTool("jstat"), "-gcutil", pid).start());
+            output.shouldHaveExitValue(0);
+            output.shouldContain("YGC");
+        } finally {
+            child.destroy();
+            child.waitFor();
+        }
+
+        // an orderly exit removes both the link and the shared memory object
+        if (Files.exists(link, LinkOption.NOFOLLOW_LINKS)) {
+            throw new RuntimeException(link + " was not removed");
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+import java.io.*;
+import java.util.*;
+
+/**
+ * Benchmark for the pauses the PerfData memory can add to safepoints when it
+ * is backed by a file and the host is under page cache pressure. Not run by
+ * jtreg.
+ *
+ * Usage: java PerfDataWritebackStall [seconds] [directory]
+ *
+ * Runs an allocating child VM once with the default file backing and once
+ * with -XX:+PerfDataUseShmBacking. While each child runs, this process
+ * keeps writing a large file in the given directory (by default the
+ * temporary directory, which also holds hsperfdata_<user>) so that the
+ * kernel is continuously writing back dirty pages. The child measures how
+ * late a thread sleeping for 1 ms wakes up, which includes every safepoint
+ * during which a collection updates the PerfData counters, and reports the
+ * worst delays.
+ */
+public class PerfDataWritebackStall {
+
+    public static void main(String args[]) throws Exception {
+        if (args.length > 0 && args[0].equals("child")) {
+            child(Integer.parseInt(args[1]));
+            return;
+        }
+        int seconds = args.length > 0 ? Integer.parseInt(args[0]) : 60;
+        File dir = new File(args.length > 1 ? args[1] : System.getProperty("java.io.tmpdir"));
+
+        System.out.println("file backing: " + run(seconds, dir, "-XX:-PerfDataUseShmBacking"));
+        System.out.println("shm backing:  " + run(seconds, dir, "-XX:+PerfDataUseShmBacking"));
+    }
+
+    private static String run(int seconds, File dir, String backing) throws Exception {
+        String java = System.getProperty("java.home") + File.separator + "bin" + File.separator + "java";
+        Process child = new ProcessBuilder(java, "-cp", System.getProperty("java.class.path"),
+                                           "-Xmx256m", "-Xmn16m", backing,
+                                           "PerfDataWritebackStall", "child", Integer.toString(seconds))
+                            .redirectErrorStream(true).start();
+
+        Thread writer = new Thread(() -> dirtyPageCache(dir));
+        writer.setDaemon(true);
+        writer.start();
+
+        BufferedReader in = new BufferedReader(new InputStreamReader(child.getInputStream()));
+        String result = in.readLine();
+        child.waitFor();
+        writer.interrupt();
+        writer.join();
+        return result;
+    }
+
+    // Rewrite a file of several GB in a loop without ever syncing it
+    private static void dirtyPageCache(File dir) {
+        byte[] buf = new byte[1024 * 1024];
+        new Random().nextBytes(buf);
+        File f = new File(dir, "PerfDataWritebackStall." + System.nanoTime());
+        f.deleteOnExit();
+        try {
+            while (!Thread.currentThread().isInterrupted()) {
+                try (FileOutputStream out = new FileOutputStream(f)) {
+                    for (int i = 0; i < 4096 && !Thread.currentThread().isInterrupted(); i++) {
+                        out.write(buf);
+                    }
+                }
+            }
+        } catch (IOException e) {
+            System.err.println("writer stopped: " + e);
+        } finally {
+            f.delete();
+        }
+    }
+
+    private static volatile Object sink;
+
+    private static void child(int seconds) throws Exception {
+        Thread allocator = new Thread(() -> {
+            while (true) {
+                sink = new byte[4096];
+            }
+        });
+        allocator.setDaemon(true);
+        allocator.start();
+
+        long[] delays = new long[seconds * 1000];
+        int n = 0;
+        long end = System.nanoTime() + seconds * 1_000_000_000L;
+        while (n < delays.length && System.nanoTime() < end) {
+            long start = System.nanoTime();
+            Thread.sleep(1);
+            delays[n++] = (System.nanoTime() - start) / 1000 - 1000;
+        }
+        Arrays.sort(delays, 0, n);
+        System.out.printf("samples %d, p99 %d us, p99.9 %d us, max %d us%n",
+                          n, delays[(int)(n * 0.99)], delays[(int)(n * 0.999)], delays[n - 1]);
+    }
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @library /testlibrary
+ * @summary Check that linked call sites use the new methods after a retransform
+ *          and a redefinition of an interface with a default method and of a
+ *          class with final methods, also with enough loaded classes to adjust
+ *          them in parallel
+ * @run main RedefineLinkedCallSites buildagent
+ * @run main/othervm -javaagent:redefineagent.jar -XX:TraceRedefineClasses=16384 RedefineLinkedCallSites
+ * @run main/othervm -javaagent:redefineagent.jar RedefineLinkedCallSites manyclasses
+ */
+
+import com.oracle.java.testlibrary.*;
+import java.io.FileNotFoundException;
+import java.io.PrintWriter;
+import java.lang.instrument.ClassDefinition;
+import java.lang.instrument.ClassFileTransformer;
+import java.lang.instrument.Instrumentation;
+import java.security.ProtectionDomain;
+import java.util.ArrayList;
+import java.util.List;
+
+interface RedefineLinkedCallSitesWithDefault {
+    default int value() { return 1; }
+}
+
+class RedefineLinkedCallSitesFinalMethods {
+    final int finalValue() { return 2; }
+    static int staticValue() { return 3; }
+}
+
+public class RedefineLinkedCallSites {
+    static Instrumentation inst;
+    public static void premain(String agentArgs, Instrumentation inst) {
+        RedefineLinkedCallSites.inst = inst;
+    }
+
+    // Loaded classes that keep the class count above the threshold for
+    // adjusting the constant pool caches in parallel (4096)
+    static List<Class<?>> loaded = new ArrayList<>();
+
+    static class Implementor implements RedefineLinkedCallSitesWithDefault {
+    }
+
+    static class Caller {
+        static int call(RedefineLinkedCallSitesWithDefault d, RedefineLinkedCallSitesFinalMethods f) {
+            return d.value() + f.finalValue() + RedefineLinkedCallSitesFinalMethods.staticValue();
+        }
+    }
+
+    // Retransforms without changing the class file, which makes the
+    // existing methods of the class EMCP methods that must be replaced
+    // in vtables, itables and constant pool caches.
+    static class Transformer implements ClassFileTransformer {
+        public byte[] transform(ClassLoader loader, String className,
+                                Class<?> classBeingRedefined,
+                                ProtectionDomain protectionDomain, byte[] classfileBuffer) {
+            return null;
+        }
+    }
+
+    private static void buildAgent() {
+        try {
+            ClassFileInstaller.main("RedefineLinkedCallSites");
+        } catch (Exception e) {
+            throw new RuntimeException("Could not write agent classfile", e);
+        }
+
+        try {
+            PrintWriter pw = new PrintWriter("MANIFEST.MF");
+            pw.println("Premain-Class: RedefineLinkedCallSites");
+            pw.println("Agent-Class: RedefineLinkedCallSites");
+            pw.println("Can-Redefine-Classes: true");
+            pw.println("Can-Retransform-Classes: true");
+            pw.close();
+        } catch (FileNotFoundException e) {
+            throw new RuntimeException("Could not write manifest file for the agent", e);
+        }
+
+        sun.tools.jar.Main jarTool = new sun.tools.jar.Main(System.out, System.err, "jar");
+        if (!jarTool.run(new String[] { "-cmf", "MANIFEST.MF", "redefineagent.jar", "RedefineLinkedCallSites.class" })) {
+            throw new RuntimeException("Could not write the agent jar file");
+        }
+    }
+
+    private static void loadManyClasses() throws Exception {
+        byte[] bytes = InMemoryJavaCompiler.compile("Filler", "public class Filler { int f() { return 1; } }");
+        // every loader defines its own class
+        for (int i = 0; i < 5000; i++) {
+            loaded.add(ByteCodeLoader.load("Filler", bytes));
+        }
+    }
+
+    // Redefines the classes with method bodies that return the given values
+    private static void redefine(int value, int finalValue, int staticValue) throws Exception {
+        byte[] withDefault = InMemoryJavaCompiler.compile("RedefineLinkedCallSitesWithDefault",
+            "interface RedefineLinkedCallSitesWithDefault {" +
+            "    default int value() { return " + value + "; }" +
+            "}");
+        byte[] finalMethods = InMemoryJavaCompiler.compile("RedefineLinkedCallSitesFinalMethods",
+            "class RedefineLinkedCallSitesFinalMethods {" +
+            "    final int finalValue() { return " + finalValue + "; }" +
+            "    static int staticValue() { return " + staticValue + "; }" +
+            "}");
+        inst.redefineClasses(new ClassDefinition(RedefineLinkedCallSitesWithDefault.class, withDefault),
+                             new ClassDefinition(RedefineLinkedCallSitesFinalMethods.class, finalMethods));
+    }
+
+    public static void main(String argv[]) throws Exception {
+        if (argv.length == 1 && argv[0].equals("buildagent")) {
+            buildAgent();
+            return;
+        }
+
+        if (inst == null) {
+            throw new RuntimeException("Instrumentation object was null");
+        }
+
+        if (argv.length == 1 && argv[0].equals("manyclasses")) {
+            loadManyClasses();
+        }
+
+        RedefineLinkedCallSitesWithDefault d = new Implementor();
+        RedefineLinkedCallSitesFinalMethods f = new RedefineLinkedCallSitesFinalMethods();
+        Asserts.assertEquals(Caller.call(d, f), 6);
+
+        Transformer transformer = new Transformer();
+        inst.addTransformer(transformer, true);
+        for (int i = 0; i < 3; i++) {
+            inst.retransformClasses(RedefineLinkedCallSitesWithDefault.class, RedefineLinkedCallSitesFinalMethods.class);
+            Asserts.assertEquals(Caller.call(d, f), 6);
+        }
+        inst.removeTransformer(transformer);
+
+        // The call sites in Caller are linked, they must see the new bodies
+        redefine(10, 20, 30);
+        Asserts.assertEquals(Caller.call(d, f), 60);
+        redefine(100, 200, 300);
+        Asserts.assertEquals(Caller.call(d, f), 600);
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary the ergonomics honor the CPU and memory limits of a mocked cgroup v1 and v2 file system
+ * @requires os.family == "linux"
+ * @library /testlibrary
+ * @run main TestCgroupLimits
+ */
+
+import java.io.*;
+import java.nio.file.*;
+import java.util.regex.*;
+import com.oracle.java.testlibrary.*;
+
+public class TestCgroupLimits {
+
+    public static void main(String args[]) throws Exception {
+        if (args.length > 0) {
+            System.out.println("availableProcessors=" + Runtime.getRuntime().availableProcessors());
+            return;
+        }
+
+        Path v1 = Files.createTempDirectory("cgroupv1");
+        write(v1, "proc/self/cgroup",
+              "4:memory:/docker/abc\n" +
+              "3:cpu,cpuacct:/docker/abc\n" +
+              "2:cpuset:/docker/abc\n");
+        write(v1, "proc/self/mountinfo",
+              "21 20 0:19 / /sys rw,nosuid - sysfs sysfs rw\n" +
+              "30 25 0:26 / /sys/fs/cgroup/memory rw,nosuid shared:12 - cgroup cgroup rw,memory\n" +
+              "31 25 0:27 / /sys/fs/cgroup/cpu,cpuacct rw,nosuid shared:13 - cgroup cgroup rw,cpu,cpuacct\n" +
+              "32 25 0:28 / /sys/fs/cgroup/cpuset rw,nosuid shared:14 - cgroup cgroup rw,cpuset\n");
+        write(v1, "sys/fs/cgroup/memory/docker/abc/memory.limit_in_bytes", "268435456\n");
+        write(v1, "sys/fs/cgroup/cpu,cpuacct/docker/abc/cpu.cfs_quota_us", "50000\n");
+        write(v1, "sys/fs/cgroup/cpu,cpuacct/docker/abc/cpu.cfs_period_us", "100000\n");
+        write(v1, "sys/fs/cgroup/cpuset/docker/abc/cpuset.cpus", "0-3,8\n");
+
+        OutputAnalyzer output = run(v1);
+        output.shouldContain("container (cgroup v1) information:");
+        output.shouldContain("memory limit: 262144k");
+        output.shouldContain("cpu limit: 1");
+        output.shouldContain("availableProcessors=1");
+        checkMaxHeapSize(output, 268435456L);
+
+        // Inside a cgroup namespace the mount root is the cgroup itself
+        Path v2 = Files.createTempDirectory("cgroupv2");
+        write(v2, "proc/self/cgroup", "0::/\n");
+        write(v2, "proc/self/mountinfo",
+              "25 22 0:22 /user.slice/test /sys/fs/cgroup rw,nosuid shared:4 - cgroup2 cgroup2 rw,nsdelegate\n");
+        write(v2, "sys/fs/cgroup/memory.max", "536870912\n");
+        write(v2, "sys/fs/cgroup/cpu.max", "max 100000\n");
+        write(v2, "sys/fs/cgroup/cpuset.cpus.effective", "0\n");
+
+        output = run(v2);
+        output.shouldContain("container (cgroup v2) information:");
+        output.shouldContain("memory limit: 524288k");
+        output.shouldContain("cpu limit: 1");
+        output.shouldContain("availableProcessors=1");
+        checkMaxHeapSize(output, 536870912L);
+
+        // ActiveProcessorCount overrides the cgroup limit
+        output = run(v2, "-XX:ActiveProcessorCount=3");
+        output.shouldContain("availableProcessors=3");
+
+        // -UseContainerSupport ignores the cgroup
+        output = run(v2, "-XX:-UseContainerSupport");
+        output.shouldNotContain("container (cgroup");
+    }
+
+    private static void write(Path root, String file, String content) throws IOException {
+        Path path = root.resolve(file);
+        Files.createDirectories(path.getParent());
+        Files.write(path, content.getBytes("US-ASCII"));
+    }
+
+    private static OutputAnalyzer run(Path root, String... extra) throws Exception {
+        String[] args = new String[extra.length + 6];
+        args[0] = "-XX:+UnlockDiagnosticVMOptions";
+        args[1] = "-XX:CgroupFileSystemRoot=" + root;
+        args[2] = "-XX:+PrintContainerInfo";
+        args[3] = "-XX:+PrintFlagsFinal";
+        System.arraycopy(extra, 0, args, 4, extra.length);
+        args[extra.length + 4] = "TestCgroupLimits";
+        args[extra.length + 5] = "child";
+        OutputAnalyzer output = new OutputAnalyzer(ProcessTools.createJavaProcessBuilder(args).start());
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    // The default maximum heap is a fraction of the container's memory
+    private static void checkMaxHeapSize(OutputAnalyzer output, long limit) {
+        Matcher m = Pattern.compile("MaxHeapSize\\s+:?=\\s+(\\d+)").matcher(output.getStdout());
+        if (!m.find()) {
+            throw new RuntimeException("MaxHeapSize not printed");
+        }
+        long maxHeapSize = Long.parseLong(m.group(1));
+        if (maxHeapSize > limit / 2) {
+            throw new RuntimeException("MaxHeapSize " + maxHeapSize + " not limited by the container memory " + limit);
+        }
+    }
+}
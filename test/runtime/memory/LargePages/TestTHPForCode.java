@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/* @test TestTHPForCode
+ * @summary Run with transparent huge pages for the code cache and the compressed class space.
+ * @requires os.family == "linux"
+ * @library /testlibrary
+ * @run main TestTHPForCode
+ */
+
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestTHPForCode {
+
+  public static void main(String[] args) throws Exception {
+    // The flag is turned off with a warning if the OS does not support
+    // transparent huge pages, the VM has to start either way.
+    run("-XX:+UseTransparentHugePagesForCode",
+        "-XX:ReservedCodeCacheSize=64m",
+        "-XX:InitialCodeCacheSize=4m",
+        "-Xcomp",
+        "-version");
+
+    run("-XX:+UseTransparentHugePagesForCode",
+        "-XX:+UseCompressedClassPointers",
+        "-XX:CompressedClassSpaceSize=32m",
+        "-version");
+
+    // Large pages for the heap and THP for the code are independent.
+    run("-XX:+UseTransparentHugePagesForCode",
+        "-XX:-UseLargePages",
+        "-version");
+
+    // Aligning the code cache to huge pages must not make it larger than
+    // ReservedCodeCacheSize.
+    OutputAnalyzer output = run("-XX:+UseTransparentHugePagesForCode",
+                                "-XX:-UseLargePages",
+                                "-XX:ReservedCodeCacheSize=9m",
+                                "-XX:InitialCodeCacheSize=3m",
+                                "-XX:+PrintCodeCache",
+                                "-version");
+    String size = output.firstMatch("CodeCache: size=(\\d+)Kb", 1);
+    if (size == null || Long.parseLong(size) > 9 * 1024) {
+      throw new RuntimeException("code cache larger than ReservedCodeCacheSize: " + size + "Kb");
+    }
+  }
+
+  private static OutputAnalyzer run(String... flags) throws Exception {
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(flags);
+    OutputAnalyzer output = new OutputAnalyzer(pb.start());
+    output.shouldHaveExitValue(0);
+    return output;
+  }
+}
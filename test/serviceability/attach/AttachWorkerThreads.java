@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @key jcmd
+ * @summary attach operations run on attach worker threads, and a heap walk does not block other operations
+ * @library /testlibrary
+ * @run main/othervm -XX:AttachListenerWorkerThreads=2 AttachWorkerThreads
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class AttachWorkerThreads {
+
+    public static void main(String args[]) throws Exception {
+        String pid = Integer.toString(ProcessTools.getProcessId());
+
+        // The operation runs on a worker, which shows up in its own thread dump
+        ProcessBuilder pb = new ProcessBuilder(JDKToolFinder.getJDKTool("jcmd"), pid, "Thread.print");
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("\"Attach Worker 0\"");
+
+        // Start a class histogram and query the flags while it may still be running
+        Process histogram = new ProcessBuilder(JDKToolFinder.getJDKTool("jcmd"), pid, "GC.class_histogram").start();
+        pb = new ProcessBuilder(JDKToolFinder.getJDKTool("jcmd"), pid, "VM.flags");
+        output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("AttachListenerWorkerThreads=2");
+
+        output = new OutputAnalyzer(histogram);
+        output.shouldHaveExitValue(0);
+        output.shouldContain("java.lang.String");
+    }
+}
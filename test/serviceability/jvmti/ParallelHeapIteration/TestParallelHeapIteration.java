@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+// Driven by TestParallelHeapIteration.sh, which builds the agent.
+public class TestParallelHeapIteration {
+
+    static class Serial {}
+    static class Parallel {}
+
+    static final int COUNT = 100000;
+
+    static native void setThreadSafe(boolean threadSafe);
+    static native int iterateThroughHeap(Class<?> klass);
+    static native int followReferences(Class<?> klass);
+    static native int taggedCount();
+    static native long tagSum();
+
+    static void check(String what, long actual, long expected) {
+        if (actual != expected) {
+            throw new RuntimeException(what + ": expected " + expected + " but was " + actual);
+        }
+        System.out.println(what + ": " + actual);
+    }
+
+    public static void main(String[] args) {
+        Object[] serialObjects = new Object[COUNT];
+        Object[] parallelObjects = new Object[COUNT];
+        for (int i = 0; i < COUNT; i++) {
+            serialObjects[i] = new Serial();
+            parallelObjects[i] = new Parallel();
+        }
+
+        // Tag serially, then check that the parallel walk sees the same tags
+        setThreadSafe(false);
+        check("serial IterateThroughHeap", iterateThroughHeap(Serial.class), COUNT);
+        check("serial tagged before", taggedCount(), 0);
+        long serialSum = tagSum();
+        setThreadSafe(true);
+        check("parallel IterateThroughHeap", iterateThroughHeap(Serial.class), COUNT);
+        check("parallel tagged", taggedCount(), COUNT);
+        check("parallel tag sum", tagSum(), serialSum);
+
+        // Tag in parallel, then check that the serial walk sees the same tags
+        check("parallel IterateThroughHeap", iterateThroughHeap(Parallel.class), COUNT);
+        check("parallel tagged before", taggedCount(), 0);
+        long parallelSum = tagSum();
+        System.gc();
+        setThreadSafe(false);
+        check("serial IterateThroughHeap", iterateThroughHeap(Parallel.class), COUNT);
+        check("serial tagged", taggedCount(), COUNT);
+        check("serial tag sum", tagSum(), parallelSum);
+
+        // FollowReferences reports the same objects and tags in both modes
+        for (boolean threadSafe : new boolean[] { false, true }) {
+            setThreadSafe(threadSafe);
+            String mode = threadSafe ? "thread safe" : "not thread safe";
+            check("FollowReferences " + mode, followReferences(Serial.class), COUNT);
+            check("FollowReferences " + mode + " tagged", taggedCount(), COUNT);
+            check("FollowReferences " + mode + " tag sum", tagSum(), serialSum);
+        }
+
+        // Keep the objects reachable until all walks are done
+        System.out.println(serialObjects.length + parallelObjects.length);
+    }
+}
@@ -0,0 +1,84 @@
+#!/bin/sh
+
+#
+#  Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+#  DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+#
+#  This code is free software; you can redistribute it and/or modify it
+#  under the terms of the GNU General Public License version 2 only, as
+#  published by the Free Software Foundation.
+#
+#  This code is distributed in the hope that it will be useful, but WITHOUT
+#  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+#  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+#  version 2 for more details (a copy is included in the LICENSE file that
+#  accompanied this code).
+#
+#  You should have received a copy of the GNU General Public License version
+#  2 along with this work; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+#
+#  Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+#  or visit www.oracle.com if you need additional information or have any
+#  questions.
+#
+
+##
+## @test TestParallelHeapIteration.sh
+## @summary IterateThroughHeap and FollowReferences report the same objects and tags with and without thread safe heap callbacks
+## @run shell/timeout=120 TestParallelHeapIteration.sh
+##
+
+if [ "${TESTSRC}" = "" ]
+then
+  TESTSRC=${PWD}
+  echo "TESTSRC not set.  Using "${TESTSRC}" as default"
+fi
+echo "TESTSRC=${TESTSRC}"
+## Adding common setup Variables for running shell tests.
+. ${TESTSRC}/../../../test_env.sh
+
+OS=`uname -s`
+case "$OS" in
+  Linux)
+    gcc_cmd=`which gcc`
+    if [ "x$gcc_cmd" == "x" ]; then
+        echo "WARNING: gcc not found. Cannot execute test." 2>&1
+        exit 0;
+    fi
+    ;;
+  *)
+    echo "Test passed; only valid for Linux"
+    exit 0;
+    ;;
+esac
+
+THIS_DIR=`pwd`
+
+cp ${TESTSRC}${FS}TestParallelHeapIteration.java ${THIS_DIR}
+${COMPILEJAVA}${FS}bin${FS}javac TestParallelHeapIteration.java
+
+$gcc_cmd -DLINUX -fPIC -shared \
+    -o ${THIS_DIR}${FS}libHeapIterationAgent.so \
+    -I${COMPILEJAVA}${FS}include \
+    -I${COMPILEJAVA}${FS}include${FS}linux \
+    ${TESTSRC}${FS}libHeapIterationAgent.c
+
+# G1 walks the heap on its worker threads, Parallel GC keeps the serial walk
+for gc in "-XX:+UseG1GC -XX:ParallelGCThreads=4" "-XX:+UseParallelGC"
+do
+  cmd="${TESTJAVA}${FS}bin${FS}java ${TESTVMOPTS} $gc \
+      -agentpath:${THIS_DIR}${FS}libHeapIterationAgent.so \
+      -cp ${THIS_DIR} TestParallelHeapIteration"
+  echo "$cmd"
+  eval $cmd
+  if [ $? != 0 ]
+  then
+    echo "Test Failed with $gc"
+    exit 1
+  fi
+done
+
+echo "Test Passed"
+exit 0
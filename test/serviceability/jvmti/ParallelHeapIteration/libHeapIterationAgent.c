@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <jni.h>
+#include <jvmti.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Agent for TestParallelHeapIteration: counts and tags objects with
+// IterateThroughHeap and FollowReferences. The callbacks only use atomic
+// updates, so they may be declared thread safe.
+
+typedef jvmtiError (JNICALL *SetThreadSafeFn)(jvmtiEnv* env, jboolean thread_safe, ...);
+
+static jvmtiEnv* jvmti = NULL;
+static SetThreadSafeFn set_thread_safe = NULL;
+
+static volatile jint  callbacks = 0;
+static volatile jint  tagged = 0;
+static volatile jlong tag_sum = 0;
+static volatile jlong next_tag = 0;
+
+static void reset_counts() {
+  callbacks = 0;
+  tagged = 0;
+  tag_sum = 0;
+}
+
+static void count_object(jlong* tag_ptr) {
+  __sync_fetch_and_add(&callbacks, 1);
+  if (*tag_ptr == 0) {
+    *tag_ptr = __sync_add_and_fetch(&next_tag, 1);
+  } else {
+    __sync_fetch_and_add(&tagged, 1);
+  }
+  __sync_fetch_and_add(&tag_sum, *tag_ptr);
+}
+
+static jint JNICALL
+heap_iteration_callback(jlong class_tag, jlong size, jlong* tag_ptr,
+                        jint length, void* user_data) {
+  count_object(tag_ptr);
+  return 0;
+}
+
+static jint JNICALL
+heap_reference_callback(jvmtiHeapReferenceKind reference_kind,
+                        const jvmtiHeapReferenceInfo* reference_info,
+                        jlong class_tag, jlong referrer_class_tag, jlong size,
+                        jlong* tag_ptr, jlong* referrer_tag_ptr,
+                        jint length, void* user_data) {
+  count_object(tag_ptr);
+  return JVMTI_VISIT_OBJECTS;
+}
+
+JNIEXPORT jint JNICALL
+Agent_OnLoad(JavaVM* vm, char* options, void* reserved) {
+  jvmtiCapabilities caps;
+  jvmtiExtensionFunctionInfo* ext;
+  jint count;
+  int i;
+
+  if ((*vm)->GetEnv(vm, (void**)&jvmti, JVMTI_VERSION_1_2) != JNI_OK) {
+    printf("Agent: could not get a JVMTI environment\n");
+    return JNI_ERR;
+  }
+  memset(&caps, 0, sizeof(caps));
+  caps.can_tag_objects = 1;
+  if ((*jvmti)->AddCapabilities(jvmti, &caps) != JVMTI_ERROR_NONE) {
+    printf("Agent: could not add can_tag_objects\n");
+    return JNI_ERR;
+  }
+  if ((*jvmti)->GetExtensionFunctions(jvmti, &count, &ext) != JVMTI_ERROR_NONE) {
+    printf("Agent: could not get the extension functions\n");
+    return JNI_ERR;
+  }
+  for (i = 0; i < count; i++) {
+    if (strcmp(ext[i].id, "com.sun.hotspot.functions.SetHeapCallbacksThreadSafe") == 0) {
+      set_thread_safe = (SetThreadSafeFn)ext[i].func;
+    }
+  }
+  if (set_thread_safe == NULL) {
+    printf("Agent: SetHeapCallbacksThreadSafe is not available\n");
+    return JNI_ERR;
+  }
+  return JNI_OK;
+}
+
+JNIEXPORT void JNICALL
+Java_TestParallelHeapIteration_setThreadSafe(JNIEnv* env, jclass cls, jboolean thread_safe) {
+  set_thread_safe(jvmti, thread_safe);
+}
+
+JNIEXPORT jint JNICALL
+Java_TestParallelHeapIteration_iterateThroughHeap(JNIEnv* env, jclass cls, jclass klass) {
+  jvmtiHeapCallbacks callbacks_table;
+  memset(&callbacks_table, 0, sizeof(callbacks_table));
+  callbacks_table.heap_iteration_callback = &heap_iteration_callback;
+  reset_counts();
+  if ((*jvmti)->IterateThroughHeap(jvmti, 0, klass, &callbacks_table, NULL) != JVMTI_ERROR_NONE) {
+    return -1;
+  }
+  return callbacks;
+}
+
+JNIEXPORT jint JNICALL
+Java_TestParallelHeapIteration_followReferences(JNIEnv* env, jclass cls, jclass klass) {
+  jvmtiHeapCallbacks callbacks_table;
+  memset(&callbacks_table, 0, sizeof(callbacks_table));
+  callbacks_table.heap_reference_callback = &heap_reference_callback;
+  reset_counts();
+  if ((*jvmti)->FollowReferences(jvmti, 0, klass, NULL, &callbacks_table, NULL) != JVMTI_ERROR_NONE) {
+    return -1;
+  }
+  return callbacks;
+}
+
+// Counts of the last iteration
+JNIEXPORT jint JNICALL
+Java_TestParallelHeapIteration_taggedCount(JNIEnv* env, jclass cls) {
+  return tagged;
+}
+
+JNIEXPORT jlong JNICALL
+Java_TestParallelHeapIteration_tagSum(JNIEnv* env, jclass cls) {
+  return tag_sum;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2015, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary the metrics server answers a scrape with counters in the Prometheus text format
+ * @library /testlibrary
+ * @run main MetricsServerTest
+ */
+
+import java.io.*;
+import java.net.*;
+import com.oracle.java.testlibrary.*;
+
+public class MetricsServerTest {
+
+    public static void main(String args[]) throws Exception {
+        if (args.length > 0) {
+            // Child: produce a collection, then stay alive until killed
+            System.gc();
+            Thread.sleep(Long.MAX_VALUE);
+        }
+
+        int port;
+        try (ServerSocket s = new ServerSocket(0)) {
+            port = s.getLocalPort();
+        }
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:MetricsServerPort=" + port, "MetricsServerTest", "child");
+        Process child = pb.start();
+        try {
+            String response = scrape(port);
+            if (!response.startsWith("HTTP/1.0 200 OK")) {
+                throw new RuntimeException("Unexpected response: " + response);
+            }
+            for (String s : new String[] { "# TYPE jvm_memory_pool_used_bytes gauge",
+                                           "jvm_gc_collection_seconds_count{gc=",
+                                           "le=\"+Inf\"}",
+                                           "jvm_compiler_compilations_total ",
+                                           "hsperf_sun_os_hrt_frequency " }) {
+                if (!response.contains(s)) {
+                    throw new RuntimeException("Missing '" + s + "' in response:\n" + response);
+                }
+            }
+        } finally {
+            child.destroy();
+            child.waitFor();
+        }
+    }
+
+    private static String scrape(int port) throws Exception {
+        for (int attempt = 0; ; attempt++) {
+            try (Socket s = new Socket(InetAddress.getLoopbackAddress(), port)) {
+                s.getOutputStream().write("GET /metrics HTTP/1.0\r\n\r\n".getBytes("US-ASCII"));
+                ByteArrayOutputStream out = new ByteArrayOutputStream();
+                InputStream in = s.getInputStream();
+                byte[] buf = new byte[8192];
+                int n;
+                while ((n = in.read(buf)) > 0) {
+                    out.write(buf, 0, n);
+                }
+                return out.toString("US-ASCII");
+            } catch (ConnectException e) {
+                // the child VM has not started listening yet
+                if (attempt == 100) {
+                    throw e;
+                }
+                Thread.sleep(100);
+            }
+        }
+    }
+}
@@ -97,6 +97,8 @@ public class WhiteBox {
   // G1
   public native boolean g1InConcurrentMark();
   public native boolean g1IsHumongous(Object o);
+  public native boolean g1PinObject(Object o);
+  public native void    g1UnpinObject(Object o);
   public native long    g1NumFreeRegions();
   public native int     g1RegionSize();
   public native Object[]    parseCommandLine(String commandline, DiagnosticCommand[] args);